@@ -56,6 +56,7 @@ class TrainCfg {
     this->loss_name_ = rhs.loss_name_;
     this->mix_precision_cfg_ = rhs.mix_precision_cfg_;
     this->accumulate_gradients_ = rhs.accumulate_gradients_;
+    this->recompute_activations_ = rhs.recompute_activations_;
   }
   ~TrainCfg() = default;
 
@@ -64,6 +65,7 @@ class TrainCfg {
     "loss_fct", "_loss_fn", "SigmoidCrossEntropy"}; /**< Set part of the name that identify a loss kernel */
   MixPrecisionCfg mix_precision_cfg_;               /**< Mix precision configuration */
   bool accumulate_gradients_ = false;
+  bool recompute_activations_ = false; /**< Recompute cheap activations in the backward pass to save memory */
 };
 }  // namespace mindspore
 #endif  // MINDSPORE_INCLUDE_API_CFG_H
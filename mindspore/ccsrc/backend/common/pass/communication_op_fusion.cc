@@ -420,6 +420,16 @@ AnfNodePtr CommunicationOpFusion::CreateFusedCommunicationOp(const FuncGraphPtr
   if (common::AnfAlgo::HasNodeAttr(kAttrNotDelayFusion, final_node)) {
     common::AnfAlgo::CopyNodeAttr(kAttrNotDelayFusion, final_node, fused_node);
   }
+  // The fused node reduces gradients only if all the nodes fused into it do.
+  bool gradient_reduce = true;
+  for (size_t idx = start_index; idx <= end_index; ++idx) {
+    auto node = communication_op_info.communication_op_nodes[idx];
+    gradient_reduce = gradient_reduce && common::AnfAlgo::HasNodeAttr(kAttrGradientReduce, node) &&
+                      common::AnfAlgo::GetNodeAttr<bool>(node, kAttrGradientReduce);
+  }
+  if (gradient_reduce) {
+    common::AnfAlgo::SetNodeAttr(kAttrGradientReduce, MakeValue(true), fused_node);
+  }
   return fused_node;
 }
 
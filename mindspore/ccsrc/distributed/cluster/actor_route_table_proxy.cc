@@ -16,6 +16,7 @@
 
 #include <string>
 #include <vector>
+#include "distributed/recovery/recovery_context.h"
 #include "distributed/cluster/actor_route_table_proxy.h"
 
 namespace mindspore {
@@ -44,9 +45,12 @@ topology::ActorAddress ActorRouteTableProxy::LookupRoute(const std::string &acto
   // Lookup last timestamp before timeout.
   auto timeout_ts = CURRENT_TIMESTAMP_MILLI + lookup_timeout_;
   topology::ActorAddress lookup_route_rsp_msg;
+  // The route of an actor is registered only once unless the process of this actor is restarted for recovery, so it is
+  // served from the cache of the compute graph node.
+  bool use_cache = !recovery::IsEnableRecovery();
 
   do {
-    auto route = cgn_->GetMetadata(actor_id);
+    auto route = use_cache ? cgn_->GetCachedMetadata(actor_id) : cgn_->GetMetadata(actor_id);
     if (route.length() == 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(kLookupInterval));
     } else {
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <utility>
 #include <nlohmann/json.hpp>
 #include "utils/log_adapter.h"
@@ -33,6 +34,12 @@ constexpr char kStartExchangeMetaPrefix[] = "START_EXCHANGE_META_";
 constexpr char kExchangeMetaDonePrefix[] = "EXCHANGE_META_DONE_";
 constexpr char kMetaFlagValue[] = "1";
 constexpr char kMetaDeleteFlagValue[] = "";
+// The minimum interval of heartbeat in seconds.
+constexpr uint32_t kHeartbeatInterval = 3;
+// The number of heartbeats the meta server node is expected to handle per second.
+constexpr uint32_t kHeartbeatsPerSecond = 500;
+// The minimum number of heartbeats sent within the node timeout of the meta server node.
+constexpr uint64_t kHeartbeatsPerNodeTimeout = 3;
 
 ComputeGraphNode::~ComputeGraphNode() {
   if (!finalized_) {
@@ -201,6 +208,9 @@ bool ComputeGraphNode::Register() {
   if (reg_resp_msg.success()) {
     authenticated_ = true;
     rank_id_ = reg_resp_msg.rank_id();
+    if (reg_resp_msg.node_num() > 0) {
+      node_num_ = reg_resp_msg.node_num();
+    }
     MS_LOG(INFO) << "The compute graph node: " << node_id_ << " has been registered successfully.";
     return true;
   } else {
@@ -240,7 +250,6 @@ bool ComputeGraphNode::Heartbeat() {
     MS_EXCEPTION_IF_NULL(hb_client_);
 
     MS_LOG(INFO) << "The heartbeat thread is started.";
-    uint32_t interval = 3;
     uint32_t timeout = 10;
 
     while (enable_hb_) {
@@ -276,6 +285,7 @@ bool ComputeGraphNode::Heartbeat() {
         (void)resp_msg.ParseFromArray(body.c_str(), SizeToInt(body.length()));
         topo_state_ = static_cast<TopoState>(resp_msg.topo_state());
         auto nodes_num = resp_msg.nodes_num();
+        node_num_ = nodes_num;
         auto abnormal_nodes_num = resp_msg.abnormal_nodes_num();
         if (abnormal_nodes_num > 0 && !recovery::IsEnableRecovery()) {
           topo_state_ = TopoState::kFailed;
@@ -290,7 +300,7 @@ bool ComputeGraphNode::Heartbeat() {
         delete response;
       }
 
-      (void)sleep(interval);
+      (void)sleep(HeartbeatInterval());
     }
 
     MS_LOG(INFO) << "The heartbeat thread is finished.";
@@ -300,6 +310,11 @@ bool ComputeGraphNode::Heartbeat() {
   return true;
 }
 
+uint32_t ComputeGraphNode::HeartbeatInterval() const {
+  const uint32_t max_interval = static_cast<uint32_t>(kDefaultNodeTimeout / kHeartbeatsPerNodeTimeout);
+  return std::min(max_interval, std::max(kHeartbeatInterval, node_num_.load() / kHeartbeatsPerSecond));
+}
+
 bool ComputeGraphNode::ReconnectIfNeeded(const std::function<bool(void)> &func, const std::string &error,
                                          size_t retry) {
   bool success = false;
@@ -321,6 +336,12 @@ bool ComputeGraphNode::Reconnect() {
   MS_ERROR_IF_NULL_W_RET_VAL(tcp_client_, false);
   MS_ERROR_IF_NULL_W_RET_VAL(hb_client_, false);
 
+  // The meta server node may have been restarted, so the cached metadata is read from it again.
+  {
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+    metadata_cache_.clear();
+  }
+
   auto server_url = meta_server_addr_.GetUrl();
   // Disconnect from meta server node firstly.
   while (tcp_client_->IsConnected(server_url)) {
@@ -398,6 +419,22 @@ std::string ComputeGraphNode::GetMetadata(const std::string &name, uint32_t time
   return "";
 }
 
+std::string ComputeGraphNode::GetCachedMetadata(const std::string &name, uint32_t timeout) {
+  {
+    std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+    auto iter = metadata_cache_.find(name);
+    if (iter != metadata_cache_.end()) {
+      return iter->second;
+    }
+  }
+  auto value = GetMetadata(name, timeout);
+  if (value.length() > 0) {
+    std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+    metadata_cache_[name] = value;
+  }
+  return value;
+}
+
 bool ComputeGraphNode::DeleteMetadata(const std::string &name, uint32_t timeout) {
   MetadataMessage metadata;
   metadata.set_name(name);
@@ -506,10 +543,23 @@ bool ComputeGraphNode::ExchangeMetadata(const std::string &biz, const size_t &ra
 }
 
 std::vector<std::string> ComputeGraphNode::GetHostNames(const std::string &role) {
+  {
+    std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+    auto iter = hostnames_cache_.find(role);
+    if (iter != hostnames_cache_.end()) {
+      return iter->second;
+    }
+  }
   auto retval = RetrieveMessageFromMSN(std::to_string(static_cast<int>(MessageName::kGetHostNames)), role);
   if (retval != nullptr) {
     nlohmann::json hostnames = nlohmann::json::parse(*retval);
-    return hostnames.at(kHostNames).get<std::vector<std::string>>();
+    auto result = hostnames.at(kHostNames).get<std::vector<std::string>>();
+    // The meta server node returns an empty list until all the nodes have registered.
+    if (!result.empty()) {
+      std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+      hostnames_cache_[role] = result;
+    }
+    return result;
   } else {
     return std::vector<std::string>();
   }
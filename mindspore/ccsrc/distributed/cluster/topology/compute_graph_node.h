@@ -56,6 +56,11 @@ class BACKEND_EXPORT ComputeGraphNode : public NodeBase {
 
   std::string GetMetadata(const std::string &name, uint32_t timeout = 5);
 
+  // Read the metadata which is written only once, e.g. the address of an actor. The value is cached in this node after
+  // it has been read successfully, so that later reads do not go to the meta server node. The cache is dropped when
+  // this node reconnects to the meta server node.
+  std::string GetCachedMetadata(const std::string &name, uint32_t timeout = 5);
+
   bool DeleteMetadata(const std::string &name, uint32_t timeout = 5);
 
   // Exchange metadata(name:value) between all the compute graph nodes.
@@ -64,7 +69,8 @@ class BACKEND_EXPORT ComputeGraphNode : public NodeBase {
                         const std::vector<std::string> &values, std::map<std::string, std::string> *results,
                         uint32_t timeout = 90);
 
-  // Get all the hostnames of compute graph nodes.
+  // Get all the hostnames of compute graph nodes. The hostnames do not change once all the nodes have registered, so
+  // they are only retrieved from the meta server node once for each role.
   std::vector<std::string> GetHostNames(const std::string &role);
 
   void set_abnormal_callback(std::shared_ptr<std::function<void(void)>> abnormal_callback) override;
@@ -79,6 +85,9 @@ class BACKEND_EXPORT ComputeGraphNode : public NodeBase {
   // Send the heartbeat message to the meta server node.
   bool Heartbeat();
 
+  // The interval of heartbeat grows with the size of cluster to bound the heartbeat load of the meta server node.
+  uint32_t HeartbeatInterval() const;
+
   // Call the `Reconnect` function if the input func execution failed.
   bool ReconnectIfNeeded(const std::function<bool(void)> &func, const std::string &error, size_t retry);
 
@@ -109,6 +118,14 @@ class BACKEND_EXPORT ComputeGraphNode : public NodeBase {
   std::shared_ptr<std::function<void(void)>> abnormal_callback_;
 
   mutable std::shared_mutex exchange_meta_mutex_;
+
+  // The total number of compute graph nodes of this cluster, which is sent back by the meta server node.
+  std::atomic<uint32_t> node_num_{0};
+
+  // The metadata and hostnames read from the meta server node which do not change any more.
+  std::map<std::string, std::string> metadata_cache_;
+  std::map<std::string, std::vector<std::string>> hostnames_cache_;
+  mutable std::shared_mutex cache_mutex_;
 };
 }  // namespace topology
 }  // namespace cluster
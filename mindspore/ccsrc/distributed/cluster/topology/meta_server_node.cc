@@ -34,6 +34,7 @@ namespace topology {
 constexpr char kComputeNodeStates[] = "compute_node_states";
 constexpr char kNodeId[] = "node_id";
 constexpr char kRecoveryFileName[] = "recovery.dat";
+constexpr char kMetadataLogFileName[] = "metadata.wal";
 constexpr char kHostName[] = "host_name";
 constexpr char kRole[] = "role";
 constexpr char kRankId[] = "rank_id";
@@ -241,6 +242,7 @@ MessageBase *const MetaServerNode::ProcessUnregister(MessageBase *const message)
     return response.release();
   }
   (void)nodes_.erase(node_id);
+  hostnames_cache_.clear();
   if (nodes_.size() == 0) {
     topo_state_ = TopoState::kFinished;
   }
@@ -256,27 +258,46 @@ MessageBase *const MetaServerNode::ProcessHeartbeat(MessageBase *const message)
   const std::string &body = message->Body();
   (void)heartbeat.ParseFromArray(body.c_str(), SizeToInt(body.length()));
 
-  // Update the state(timestamp) of this node.
   const auto &node_id = heartbeat.node_id();
-  std::shared_lock<std::shared_mutex> lock(nodes_mutex_);
-  if (nodes_.find(node_id) != nodes_.end()) {
-    auto &node = nodes_[node_id];
-    MS_ERROR_IF_NULL_W_RET_VAL(node, rpc::NULL_MSG);
-    (void)time(&(node->last_update));
-    node->state = NodeState::kRegistered;
-
-    HeartbeatRespMessage resp_msg;
-    resp_msg.set_success(static_cast<bool>(MessageName::kSuccess));
-    resp_msg.set_topo_state(static_cast<uint32_t>(topo_state_));
-    resp_msg.set_nodes_num(SizeToUint(total_node_num_));
-    resp_msg.set_abnormal_nodes_num(SizeToUint(abnormal_node_num_));
-    auto content = resp_msg.SerializeAsString();
-    auto response = CreateMessage(meta_server_addr_.GetUrl(), MessageName::kSuccess, content);
-    MS_EXCEPTION_IF_NULL(response);
-    return response.release();
-  } else {
-    MS_LOG(ERROR) << "Invalid node: " << node_id << ".";
-    return rpc::NULL_MSG;
+  {
+    std::shared_lock<std::shared_mutex> lock(nodes_mutex_);
+    if (nodes_.find(node_id) == nodes_.end()) {
+      MS_LOG(ERROR) << "Invalid node: " << node_id << ".";
+      return rpc::NULL_MSG;
+    }
+  }
+  // The state(timestamp) of this node is updated by the topo monitor in the next round.
+  {
+    std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+    pending_heartbeats_.push_back(node_id);
+  }
+
+  HeartbeatRespMessage resp_msg;
+  resp_msg.set_success(static_cast<bool>(MessageName::kSuccess));
+  resp_msg.set_topo_state(static_cast<uint32_t>(topo_state_));
+  resp_msg.set_nodes_num(SizeToUint(total_node_num_));
+  resp_msg.set_abnormal_nodes_num(SizeToUint(abnormal_node_num_));
+  auto content = resp_msg.SerializeAsString();
+  auto response = CreateMessage(meta_server_addr_.GetUrl(), MessageName::kSuccess, content);
+  MS_EXCEPTION_IF_NULL(response);
+  return response.release();
+}
+
+void MetaServerNode::ApplyHeartbeats() {
+  std::vector<std::string> heartbeats;
+  {
+    std::lock_guard<std::mutex> lock(heartbeat_mutex_);
+    heartbeats.swap(pending_heartbeats_);
+  }
+  time_t now = time(&now);
+  for (const auto &node_id : heartbeats) {
+    auto iter = nodes_.find(node_id);
+    // The node may have unregistered after its last heartbeat.
+    if (iter == nodes_.end() || iter->second == nullptr) {
+      continue;
+    }
+    iter->second->last_update = now;
+    iter->second->state = NodeState::kRegistered;
   }
 }
 
@@ -289,8 +310,9 @@ MessageBase *const MetaServerNode::ProcessWriteMetadata(MessageBase *const messa
     MS_LOG(ERROR) << "Empty metadata name.";
     return rpc::NULL_MSG;
   }
-  std::shared_lock<std::shared_mutex> lock(meta_mutex_);
-  metadata_[meta_msg.name()] = meta_msg.value();
+  if (!metadata_.Put(meta_msg.name(), meta_msg.value())) {
+    MS_LOG(ERROR) << "Failed to write the metadata: " << meta_msg.name();
+  }
   return rpc::NULL_MSG;
 }
 
@@ -300,15 +322,14 @@ MessageBase *const MetaServerNode::ProcessReadMetadata(MessageBase *const messag
   MetadataMessage meta_msg;
   (void)meta_msg.ParseFromArray(body.c_str(), SizeToInt(body.length()));
 
-  std::shared_lock<std::shared_mutex> lock(meta_mutex_);
   MessageName result;
   std::unique_ptr<MessageBase> response;
 
-  if (metadata_.find(meta_msg.name()) == metadata_.end()) {
+  std::string meta_value;
+  if (!metadata_.Get(meta_msg.name(), &meta_value)) {
     result = MessageName::kInvalidMetadata;
   } else {
     result = MessageName::kValidMetadata;
-    std::string meta_value = metadata_[meta_msg.name()];
     meta_msg.set_value(meta_value);
   }
   response = CreateMessage(meta_server_addr_.GetUrl(), result, meta_msg.SerializeAsString());
@@ -322,15 +343,13 @@ MessageBase *const MetaServerNode::ProcessDeleteMetadata(MessageBase *const mess
   MetadataMessage meta_msg;
   (void)meta_msg.ParseFromArray(body.c_str(), SizeToInt(body.length()));
 
-  std::shared_lock<std::shared_mutex> lock(meta_mutex_);
   MessageName result;
   std::unique_ptr<MessageBase> response;
 
-  if (metadata_.find(meta_msg.name()) == metadata_.end()) {
+  if (!metadata_.Delete(meta_msg.name())) {
     result = MessageName::kInvalidMetadata;
   } else {
     result = MessageName::kValidMetadata;
-    (void)metadata_.erase(meta_msg.name());
   }
   response = CreateMessage(meta_server_addr_.GetUrl(), result, meta_msg.SerializeAsString());
   MS_EXCEPTION_IF_NULL(response);
@@ -339,55 +358,74 @@ MessageBase *const MetaServerNode::ProcessDeleteMetadata(MessageBase *const mess
 
 MessageBase *const MetaServerNode::ProcessGetHostNames(MessageBase *const message) {
   MS_ERROR_IF_NULL_W_RET_VAL(message, rpc::NULL_MSG);
-  // Convert result to the message.
-  nlohmann::json hostnames = nlohmann::json::array();
-  nlohmann::json retval = nlohmann::json::object();
   MessageName result;
+  std::string content;
 
+  std::shared_lock<std::shared_mutex> lock(nodes_mutex_);
   if (nodes_.size() != total_node_num_) {
     result = MessageName::kInvalidMetadata;
+    nlohmann::json retval = nlohmann::json::object();
+    retval[kHostNames] = nlohmann::json::array();
+    content = retval.dump();
   } else {
     result = MessageName::kValidMetadata;
+    const auto &node_role = message->body;
+    auto iter = hostnames_cache_.find(node_role);
+    content = iter != hostnames_cache_.end() ? iter->second : CollectHostNames(node_role);
+  }
 
-    auto node_role = message->body;
+  auto response = CreateMessage(meta_server_addr_.GetUrl(), result, content);
+  MS_EXCEPTION_IF_NULL(response);
+  return response.release();
+}
 
-    // Collect all the hostnames from nodes info.
-    std::vector<std::string> tmp_hostnames(nodes_.size(), "");
-    std::shared_lock<std::shared_mutex> lock(nodes_mutex_);
+std::string MetaServerNode::CollectHostNames(const std::string &role) {
+  // Collect all the hostnames from nodes info.
+  std::vector<std::string> tmp_hostnames(nodes_.size(), "");
 
-    // The hostnames must are sorted strictly by the rank id.
-    for (auto iter = nodes_.begin(); iter != nodes_.end(); ++iter) {
-      auto node_info = iter->second;
-      MS_EXCEPTION_IF_NULL(node_info);
-      if (node_info->role != node_role) {
-        continue;
-      }
-      if (node_info->rank_id >= 0 && node_info->rank_id < tmp_hostnames.size()) {
-        tmp_hostnames[node_info->rank_id] = node_info->host_name;
-      } else {
-        MS_LOG(ERROR) << "Invalid rank id: " << node_info->rank_id << " for node: " << node_info->node_id;
-        continue;
-      }
+  // The hostnames must are sorted strictly by the rank id.
+  for (auto iter = nodes_.begin(); iter != nodes_.end(); ++iter) {
+    auto node_info = iter->second;
+    MS_EXCEPTION_IF_NULL(node_info);
+    if (node_info->role != role) {
+      continue;
     }
-
-    // The hostname of the node whose role name not match is empty, and should be skipped.
-    for (size_t i = 0; i < tmp_hostnames.size(); ++i) {
-      if (tmp_hostnames[i] != "") {
-        hostnames.push_back(tmp_hostnames[i]);
-      }
+    if (node_info->rank_id >= 0 && node_info->rank_id < tmp_hostnames.size()) {
+      tmp_hostnames[node_info->rank_id] = node_info->host_name;
+    } else {
+      MS_LOG(ERROR) << "Invalid rank id: " << node_info->rank_id << " for node: " << node_info->node_id;
+      continue;
     }
   }
 
+  // The hostname of the node whose role name not match is empty, and should be skipped.
+  nlohmann::json hostnames = nlohmann::json::array();
+  for (size_t i = 0; i < tmp_hostnames.size(); ++i) {
+    if (tmp_hostnames[i] != "") {
+      hostnames.push_back(tmp_hostnames[i]);
+    }
+  }
+  nlohmann::json retval = nlohmann::json::object();
   retval[kHostNames] = hostnames;
-  auto response = CreateMessage(meta_server_addr_.GetUrl(), result, retval.dump());
-  MS_EXCEPTION_IF_NULL(response);
-  return response.release();
+  return retval.dump();
+}
+
+void MetaServerNode::CacheHostNames() {
+  hostnames_cache_.clear();
+  for (auto iter = nodes_.begin(); iter != nodes_.end(); ++iter) {
+    MS_EXCEPTION_IF_NULL(iter->second);
+    const auto &role = iter->second->role;
+    if (hostnames_cache_.count(role) == 0) {
+      hostnames_cache_[role] = CollectHostNames(role);
+    }
+  }
 }
 
 void MetaServerNode::UpdateTopoState() {
   try {
     while (enable_monitor_) {
       nodes_mutex_.lock();
+      ApplyHeartbeats();
 
       // Update the state of topology.
       if (topo_state_ == TopoState::kInitializing) {
@@ -451,6 +489,7 @@ bool MetaServerNode::TransitionToInitialized() {
         MS_LOG(EXCEPTION) << "Failed to persist the metadata of the cluster.";
       }
     }
+    CacheHostNames();
     topo_state_ = TopoState::kInitialized;
     MS_LOG(INFO) << "The cluster topology has been constructed successfully";
     return true;
@@ -467,7 +506,13 @@ bool MetaServerNode::Recovery() {
   RETURN_IF_FALSE_WITH_LOG(configuration_->Initialize(),
                            "Failed to initialize the recovery file configuration from file path: " << recovery_path);
 
-  if (configuration_->Empty()) {
+  // The metadata written by users is recovered from the write-ahead log. In the first start, the log left by a former
+  // cluster in the same path is truncated instead of replayed.
+  bool first_start = configuration_->Empty();
+  RETURN_IF_FALSE_WITH_LOG(metadata_.Open(recovery_path + "/" + kMetadataLogFileName, first_start),
+                           "Failed to recover the metadata from file path: " << recovery_path);
+
+  if (first_start) {
     MS_LOG(INFO) << "The meta server node is started for the first time.";
     return true;
 
@@ -499,6 +544,7 @@ bool MetaServerNode::Recovery() {
     }
 
     if (nodes_.size() == total_node_num_) {
+      CacheHostNames();
       topo_state_ = TopoState::kInitialized;
     }
     MS_LOG(INFO) << "The meta server node has been recovered successfully.";
@@ -20,10 +20,13 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <thread>
+#include <vector>
 #include <shared_mutex>
 #include "distributed/rpc/tcp/tcp_server.h"
 #include "distributed/recovery/configuration.h"
+#include "distributed/cluster/topology/metadata_store.h"
 #include "distributed/cluster/topology/node_base.h"
 
 namespace mindspore {
@@ -119,9 +122,18 @@ class MetaServerNode : public NodeBase {
   // Gather all the hostname of registered compute graph nodes.
   MessageBase *const ProcessGetHostNames(MessageBase *const message);
 
+  // Collect the hostnames of the given role sorted by rank id in json format, and cache them for all the roles once
+  // the cluster is initialized. The caller should hold the lock of nodes.
+  std::string CollectHostNames(const std::string &role);
+  void CacheHostNames();
+
   // Maintain the state which is type of `TopoState` of this cluster topology.
   void UpdateTopoState();
 
+  // Apply the heartbeats received since the last round of the topo monitor to the state of the nodes. The caller should
+  // hold the lock of nodes.
+  void ApplyHeartbeats();
+
   // Try to transition the state of cluster to be initialized.
   bool TransitionToInitialized();
 
@@ -165,10 +177,16 @@ class MetaServerNode : public NodeBase {
   // The switch for the topo monitor thread.
   std::atomic<bool> enable_monitor_;
 
-  // The metadata written and read by users.
-  std::map<std::string, std::string> metadata_;
+  // The heartbeats are only recorded here by the tcp server thread and applied to the nodes in batch by the topo
+  // monitor, so the handling of a heartbeat never waits for the exclusive lock of nodes.
+  std::vector<std::string> pending_heartbeats_;
+  std::mutex heartbeat_mutex_;
+
+  // The hostnames of each role, which are collected once after all the nodes have registered.
+  std::map<std::string, std::string> hostnames_cache_;
 
-  mutable std::shared_mutex meta_mutex_;
+  // The metadata written and read by users, which is logged for failover recovery if enabled.
+  MetadataStore metadata_;
 
   uint64_t node_timeout_;
 
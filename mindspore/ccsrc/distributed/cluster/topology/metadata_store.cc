@@ -0,0 +1,304 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "distributed/cluster/topology/metadata_store.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace distributed {
+namespace cluster {
+namespace topology {
+namespace {
+// Every record is laid out as: op(1 byte) | name length(4 bytes) | value length(4 bytes) | name | value | checksum.
+constexpr char kOpPut = 'P';
+constexpr char kOpDelete = 'D';
+constexpr size_t kRecordHeaderSize = sizeof(char) + sizeof(uint32_t) + sizeof(uint32_t);
+constexpr size_t kMinRecordsToCompact = 1024;
+constexpr size_t kCompactRatio = 4;
+
+// FNV-1a, which is enough to detect a record torn by a crash.
+uint32_t Checksum(const char *data, size_t size, uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+void EncodeRecord(char op, const std::string &name, const std::string &value, std::string *record) {
+  uint32_t name_len = static_cast<uint32_t>(name.size());
+  uint32_t value_len = static_cast<uint32_t>(value.size());
+  record->clear();
+  record->reserve(kRecordHeaderSize + name.size() + value.size() + sizeof(uint32_t));
+  record->push_back(op);
+  record->append(reinterpret_cast<const char *>(&name_len), sizeof(name_len));
+  record->append(reinterpret_cast<const char *>(&value_len), sizeof(value_len));
+  record->append(name);
+  record->append(value);
+  uint32_t checksum = Checksum(record->data(), record->size());
+  record->append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+}
+
+bool WriteAll(int fd, const std::string &data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    auto ret = write(fd, data.data() + written, data.size() - written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    written += static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+// Sync the directory of the path so that the entries created or renamed in it survive a crash of the host.
+bool SyncParentDirectory(const std::string &path) {
+  auto pos = path.find_last_of('/');
+  std::string dir = (pos == std::string::npos) ? "." : (pos == 0 ? "/" : path.substr(0, pos));
+  int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir_fd < 0) {
+    MS_LOG(ERROR) << "Failed to open the directory " << dir << ", errno: " << errno;
+    return false;
+  }
+  bool ret = (fsync(dir_fd) == 0);
+  if (!ret) {
+    MS_LOG(ERROR) << "Failed to sync the directory " << dir << ", errno: " << errno;
+  }
+  (void)close(dir_fd);
+  return ret;
+}
+}  // namespace
+
+MetadataStore::~MetadataStore() { CloseLog(); }
+
+bool MetadataStore::Open(const std::string &wal_path, bool truncate) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  CloseLog();
+  wal_path_ = wal_path;
+  if (truncate) {
+    values_.clear();
+    wal_record_num_ = 0;
+  } else if (!Replay()) {
+    return false;
+  }
+  int flags = O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0);
+  wal_fd_ = open(wal_path_.c_str(), flags, S_IRUSR | S_IWUSR);
+  if (wal_fd_ < 0) {
+    MS_LOG(ERROR) << "Failed to open the metadata log " << wal_path_ << ", errno: " << errno;
+    return false;
+  }
+  // Make the truncated or created log durable before any record is appended to it.
+  if ((truncate && fsync(wal_fd_) != 0) || !SyncParentDirectory(wal_path_)) {
+    MS_LOG(ERROR) << "Failed to sync the metadata log " << wal_path_ << ", errno: " << errno;
+    CloseLog();
+    return false;
+  }
+  MS_LOG(INFO) << "Recovered " << values_.size() << " metadata from the log " << wal_path_;
+  return true;
+}
+
+bool MetadataStore::Put(const std::string &name, const std::string &value) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!Append(kOpPut, name, value)) {
+    return false;
+  }
+  values_[name] = value;
+  CompactIfNeeded();
+  return true;
+}
+
+bool MetadataStore::Get(const std::string &name, std::string *value) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto iter = values_.find(name);
+  if (iter == values_.end()) {
+    return false;
+  }
+  if (value != nullptr) {
+    *value = iter->second;
+  }
+  return true;
+}
+
+bool MetadataStore::Delete(const std::string &name) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (values_.count(name) == 0) {
+    return false;
+  }
+  if (!Append(kOpDelete, name, "")) {
+    return false;
+  }
+  (void)values_.erase(name);
+  CompactIfNeeded();
+  return true;
+}
+
+size_t MetadataStore::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return values_.size();
+}
+
+bool MetadataStore::Compact() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return CompactLog();
+}
+
+bool MetadataStore::CompactLog() {
+  if (wal_fd_ < 0) {
+    return true;
+  }
+  // Write the live metadata into a new log and replace the old one by renaming, which is atomic, so a crash during the
+  // compaction leaves either the old or the new log.
+  std::string tmp_path = wal_path_ + ".tmp";
+  int tmp_fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (tmp_fd < 0) {
+    MS_LOG(ERROR) << "Failed to create the metadata log " << tmp_path << ", errno: " << errno;
+    return false;
+  }
+  std::string buffer;
+  std::string record;
+  for (const auto &item : values_) {
+    EncodeRecord(kOpPut, item.first, item.second, &record);
+    buffer.append(record);
+  }
+  if (!WriteAll(tmp_fd, buffer) || fsync(tmp_fd) != 0) {
+    MS_LOG(ERROR) << "Failed to write the metadata log " << tmp_path << ", errno: " << errno;
+    (void)close(tmp_fd);
+    (void)unlink(tmp_path.c_str());
+    return false;
+  }
+  if (rename(tmp_path.c_str(), wal_path_.c_str()) != 0) {
+    MS_LOG(ERROR) << "Failed to replace the metadata log " << wal_path_ << ", errno: " << errno;
+    (void)close(tmp_fd);
+    (void)unlink(tmp_path.c_str());
+    return false;
+  }
+  (void)close(wal_fd_);
+  // The new log is opened in append mode again.
+  (void)close(tmp_fd);
+  wal_fd_ = open(wal_path_.c_str(), O_WRONLY | O_APPEND, S_IRUSR | S_IWUSR);
+  if (wal_fd_ < 0) {
+    MS_LOG(ERROR) << "Failed to reopen the metadata log " << wal_path_ << ", errno: " << errno;
+    return false;
+  }
+  wal_record_num_ = values_.size();
+  // The rename is only durable after the directory is synced.
+  return SyncParentDirectory(wal_path_);
+}
+
+// Every record is synced before the write is acknowledged, so an acknowledged metadata also survives a crash of the host.
+bool MetadataStore::Append(char op, const std::string &name, const std::string &value) {
+  if (wal_fd_ < 0) {
+    return true;
+  }
+  std::string record;
+  EncodeRecord(op, name, value, &record);
+  if (!WriteAll(wal_fd_, record) || fsync(wal_fd_) != 0) {
+    MS_LOG(ERROR) << "Failed to append the metadata " << name << " to the log " << wal_path_ << ", errno: " << errno;
+    return false;
+  }
+  ++wal_record_num_;
+  return true;
+}
+
+bool MetadataStore::Replay() {
+  values_.clear();
+  wal_record_num_ = 0;
+  int fd = open(wal_path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    // There is no log if the meta server node is started for the first time.
+    return errno == ENOENT;
+  }
+  std::string content;
+  std::vector<char> buffer(1 << 16);
+  while (true) {
+    auto ret = read(fd, buffer.data(), buffer.size());
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      break;
+    }
+    content.append(buffer.data(), static_cast<size_t>(ret));
+  }
+  (void)close(fd);
+
+  size_t offset = 0;
+  while (offset + kRecordHeaderSize <= content.size()) {
+    const char *record = content.data() + offset;
+    uint32_t name_len;
+    uint32_t value_len;
+    (void)memcpy(&name_len, record + sizeof(char), sizeof(uint32_t));
+    (void)memcpy(&value_len, record + sizeof(char) + sizeof(uint32_t), sizeof(uint32_t));
+    size_t body_size = kRecordHeaderSize + static_cast<size_t>(name_len) + value_len;
+    if (content.size() - offset < body_size + sizeof(uint32_t)) {
+      break;
+    }
+    uint32_t checksum;
+    (void)memcpy(&checksum, record + body_size, sizeof(uint32_t));
+    if (checksum != Checksum(record, body_size) || (record[0] != kOpPut && record[0] != kOpDelete)) {
+      break;
+    }
+    std::string name(record + kRecordHeaderSize, name_len);
+    if (record[0] == kOpPut) {
+      values_[name] = std::string(record + kRecordHeaderSize + name_len, value_len);
+    } else {
+      (void)values_.erase(name);
+    }
+    offset += body_size + sizeof(uint32_t);
+    ++wal_record_num_;
+  }
+  if (offset != content.size()) {
+    MS_LOG(WARNING) << "Drop the incomplete tail of " << (content.size() - offset) << " bytes of the metadata log "
+                    << wal_path_;
+    if (truncate(wal_path_.c_str(), static_cast<off_t>(offset)) != 0) {
+      MS_LOG(ERROR) << "Failed to truncate the metadata log " << wal_path_ << ", errno: " << errno;
+      return false;
+    }
+  }
+  return true;
+}
+
+void MetadataStore::CompactIfNeeded() {
+  if (wal_fd_ < 0 || wal_record_num_ < kMinRecordsToCompact || wal_record_num_ < kCompactRatio * values_.size()) {
+    return;
+  }
+  // The metadata has been logged, a failed compaction only leaves a longer log.
+  if (!CompactLog()) {
+    MS_LOG(WARNING) << "Failed to compact the metadata log " << wal_path_;
+  }
+}
+
+void MetadataStore::CloseLog() {
+  if (wal_fd_ >= 0) {
+    (void)close(wal_fd_);
+    wal_fd_ = -1;
+  }
+}
+}  // namespace topology
+}  // namespace cluster
+}  // namespace distributed
+}  // namespace mindspore
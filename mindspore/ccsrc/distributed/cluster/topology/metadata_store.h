@@ -0,0 +1,77 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_DISTRIBUTED_CLUSTER_TOPOLOGY_METADATA_STORE_H_
+#define MINDSPORE_CCSRC_DISTRIBUTED_CLUSTER_TOPOLOGY_METADATA_STORE_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace distributed {
+namespace cluster {
+namespace topology {
+// The key-value store of the user defined metadata kept by the meta server node. All the reads are served from memory.
+// If a write-ahead log is opened, every write and delete is appended to the log before it takes effect, so that a
+// restarted meta server node recovers the metadata by replaying the log instead of waiting for the nodes to write it
+// again. The log is compacted when it grows much larger than the live metadata.
+class BACKEND_EXPORT MetadataStore {
+ public:
+  MetadataStore() = default;
+  ~MetadataStore();
+
+  // Open the write-ahead log in the given path and replay the records in it. An incomplete record at the tail, which is
+  // left by a crash in the middle of appending, is dropped. If `truncate` is true, the records left by a former cluster
+  // are discarded instead of replayed.
+  bool Open(const std::string &wal_path, bool truncate = false);
+
+  bool Put(const std::string &name, const std::string &value);
+
+  // Returns false if there is no metadata of this name.
+  bool Get(const std::string &name, std::string *value) const;
+  bool Delete(const std::string &name);
+
+  // Rewrite the log so that it only contains the live metadata.
+  bool Compact();
+
+  size_t size() const;
+
+ private:
+  bool Append(char op, const std::string &name, const std::string &value);
+  bool Replay();
+  bool CompactLog();
+  void CompactIfNeeded();
+  void CloseLog();
+
+  std::unordered_map<std::string, std::string> values_;
+  mutable std::shared_mutex mutex_;
+
+  // The file descriptor of the write-ahead log, which is -1 if the log is disabled.
+  int wal_fd_{-1};
+  std::string wal_path_;
+
+  // The number of records in the log, used to decide when to compact it.
+  size_t wal_record_num_{0};
+};
+}  // namespace topology
+}  // namespace cluster
+}  // namespace distributed
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_DISTRIBUTED_CLUSTER_TOPOLOGY_METADATA_STORE_H_
@@ -192,6 +192,104 @@ void EmbeddingCacheTableManager::GetEmbeddingTableSliceBound() {
 
 int EmbeddingCacheTableManager::cache_indices_lower_bound() const { return local_device_cache_bounds_.first; }
 
+bool HotIdTracker::Record(const int *ids, size_t ids_num, int begin, int end) {
+  MS_EXCEPTION_IF_NULL(ids);
+  for (size_t i = 0; i < ids_num; ++i) {
+    if (ids[i] >= begin && ids[i] < end) {
+      ++id_frequency_[ids[i]];
+    }
+  }
+  if (++batch_count_ < refresh_interval_) {
+    return false;
+  }
+  batch_count_ = 0;
+  Refresh();
+  return true;
+}
+
+void HotIdTracker::Refresh() {
+  std::vector<std::pair<size_t, int>> candidates;
+  candidates.reserve(id_frequency_.size());
+  for (auto iter = id_frequency_.begin(); iter != id_frequency_.end();) {
+    (void)candidates.emplace_back(iter->second, iter->first);
+    iter->second >>= 1;
+    if (iter->second == 0) {
+      iter = id_frequency_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  // Sort by descending frequency, the ids with the same frequency are sorted in ascending order.
+  auto hot_id_num = std::min(hot_id_num_, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + SizeToLong(hot_id_num), candidates.end(),
+                    [](const std::pair<size_t, int> &lhs, const std::pair<size_t, int> &rhs) {
+                      return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+                    });
+  hot_ids_.resize(hot_id_num);
+  for (size_t i = 0; i < hot_id_num; ++i) {
+    hot_ids_[i] = candidates[i].second;
+  }
+}
+
+void HotIdTracker::CollectHostResidentIds(const EmbeddingHashMap &host_hash_map,
+                                          const EmbeddingHashMap &device_hash_map, std::vector<int> *ids,
+                                          std::vector<int> *host_indices) const {
+  MS_EXCEPTION_IF_NULL(ids);
+  MS_EXCEPTION_IF_NULL(host_indices);
+  ids->clear();
+  host_indices->clear();
+  const auto &host_id_to_index = host_hash_map.hash_id_to_index();
+  const auto &device_id_to_index = device_hash_map.hash_id_to_index();
+  for (int id : hot_ids_) {
+    const auto &iter = host_id_to_index.find(id);
+    if (iter == host_id_to_index.end() || device_id_to_index.find(id) != device_id_to_index.end()) {
+      continue;
+    }
+    ids->push_back(id);
+    host_indices->push_back(iter->second);
+  }
+}
+
+RemoteEmbeddingSharding::RemoteEmbeddingSharding(size_t vocab_size, size_t server_num, RemoteShardingPolicy policy)
+    : vocab_size_(vocab_size), server_num_(server_num), policy_(policy) {
+  if (server_num_ == 0) {
+    MS_LOG(EXCEPTION) << "The server num is 0";
+  }
+  size_t average_slice_size = vocab_size_ / server_num_;
+  size_t rest_vocab_size = vocab_size_ % server_num_;
+  size_t begin = 0;
+  for (size_t i = 0; i < server_num_; i++) {
+    size_t slice_size = average_slice_size + (i < rest_vocab_size ? 1 : 0);
+    (void)slice_bounds_.emplace_back(begin, begin + slice_size - 1);
+    begin += slice_size;
+  }
+}
+
+bool RemoteEmbeddingSharding::Locate(int id, size_t *server_rank_id, int *row) const {
+  MS_EXCEPTION_IF_NULL(server_rank_id);
+  MS_EXCEPTION_IF_NULL(row);
+  if (id < 0 || IntToSize(id) >= vocab_size_) {
+    return false;
+  }
+  if (policy_ == RemoteShardingPolicy::kHash) {
+    *server_rank_id = IntToSize(id) % server_num_;
+    *row = SizeToInt(IntToSize(id) / server_num_);
+    return true;
+  }
+
+  // The slices are contiguous and sorted, find the first slice whose end is not less than the id.
+  auto iter =
+    std::lower_bound(slice_bounds_.begin(), slice_bounds_.end(), IntToSize(id),
+                     [](const std::pair<size_t, size_t> &bound, size_t value) { return bound.second < value; });
+  if (iter == slice_bounds_.end()) {
+    return false;
+  }
+  *server_rank_id = LongToSize(iter - slice_bounds_.begin());
+  *row = id - SizeToInt(iter->first);
+  return true;
+}
+
 void EmbeddingCacheTableManager::DumpHashTables() const {
   MS_EXCEPTION_IF_NULL(embedding_device_cache_);
   for (const auto &item : hash_tables_) {
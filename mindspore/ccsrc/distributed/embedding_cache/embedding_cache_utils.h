@@ -21,6 +21,7 @@
 #include <string>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "kernel/kernel.h"
 #include "distributed/embedding_cache/embedding_hash_map.h"
 #include "distributed/embedding_cache/embedding_store.h"
@@ -165,6 +166,69 @@ class RandomGenerator {
   std::unique_ptr<Distribution> distri_;
 };
 
+// The HotIdTracker class counts the access frequency of the feature ids, and selects the hottest ids every
+// `refresh_interval` batches. The frequencies are halved at each selection, so that the hot ids follow the change of
+// the data distribution.
+class BACKEND_EXPORT HotIdTracker {
+ public:
+  HotIdTracker(size_t hot_id_num, size_t refresh_interval)
+      : hot_id_num_(hot_id_num), refresh_interval_(refresh_interval == 0 ? 1 : refresh_interval) {}
+  ~HotIdTracker() = default;
+
+  // Count the ids of a batch in the range [begin, end), return true if the hot ids are reselected by this batch.
+  bool Record(const int *ids, size_t ids_num, int begin, int end);
+
+  // The hot ids in descending order of frequency.
+  const std::vector<int> &hot_ids() const { return hot_ids_; }
+
+  // Collect the hot ids whose latest embeddings are in the local host cache, and their host cache indices. The hot ids
+  // resident in the device cache are skipped, since their host copies are stale until they are swapped out of device.
+  void CollectHostResidentIds(const EmbeddingHashMap &host_hash_map, const EmbeddingHashMap &device_hash_map,
+                              std::vector<int> *ids, std::vector<int> *host_indices) const;
+
+ private:
+  // Select the hottest ids and decay the frequencies.
+  void Refresh();
+
+  // The maximum number of the hot ids.
+  size_t hot_id_num_;
+  // The number of batches between two selections of the hot ids.
+  size_t refresh_interval_;
+  // The number of batches recorded since the last selection.
+  size_t batch_count_{0};
+  // The decayed access frequency of each id.
+  mindspore::HashMap<int, size_t> id_frequency_;
+  std::vector<int> hot_ids_;
+};
+
+// The policy to shard the embedding table rows over servers. The range policy assigns contiguous id ranges to servers,
+// the hash policy assigns the id to the server `id % server_num` at row `id / server_num`, which spreads the skewed ids
+// of neighbouring ranges over all servers. Both policies give each server the same number of rows.
+enum class RemoteShardingPolicy { kRange = 0, kHash };
+
+// The RemoteEmbeddingSharding class maps the feature ids to the servers and the rows in the embedding table slices of
+// the servers.
+class BACKEND_EXPORT RemoteEmbeddingSharding {
+ public:
+  RemoteEmbeddingSharding(size_t vocab_size, size_t server_num, RemoteShardingPolicy policy);
+  ~RemoteEmbeddingSharding() = default;
+
+  // Get the server and the row in the server's embedding table slice of an id, return false if the id is out of the
+  // range of the embedding table.
+  bool Locate(int id, size_t *server_rank_id, int *row) const;
+
+  // The range of the origin ids [first, second] which are put in the rows of each server under the range policy. The
+  // row number of a server is the same under both policies.
+  const std::vector<std::pair<size_t, size_t>> &slice_bounds() const { return slice_bounds_; }
+  RemoteShardingPolicy policy() const { return policy_; }
+
+ private:
+  size_t vocab_size_;
+  size_t server_num_;
+  RemoteShardingPolicy policy_;
+  std::vector<std::pair<size_t, size_t>> slice_bounds_;
+};
+
 // The EmbeddingCacheTableManager class is used to save all Parameter information for enabling cache, such as device
 // cache size, host cache size, etc., and can allocate memory for the embedding cache table.
 class BACKEND_EXPORT EmbeddingCacheTableManager {
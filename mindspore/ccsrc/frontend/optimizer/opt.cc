@@ -171,7 +171,7 @@ static void UpdateTransformingListWithUserNodes(const OptimizerPtr &optimizer, c
   if (users_iterator == node_users.end()) {
     return;
   }
-  auto users = users_iterator->second;
+  const auto &users = users_iterator->second;
   for (auto &use : users) {
     auto use_node = use.first;
     if (use_node == nullptr) {
@@ -291,13 +291,24 @@ bool SubstitutionList::ApplySubstitutionsToIR(const OptimizerPtr &optimizer, con
 
   bool changes = false;
   bool loop = true;
+  // The number of the substitutions applied since the graph was changed last time. Once every substitution has been
+  // applied to the current graph without changing it, the graph reaches the fixed point, so the rest substitutions of
+  // the round are skipped.
+  // Each substitution still sweeps the whole graph from its output instead of only the users of the changed nodes:
+  // the patterns match several levels of inputs and some substitutions read the analyses of the manager, so a change
+  // may make a node far from it match.
+  size_t unchanged_num = 0;
   while (loop) {
     loop = false;
     for (size_t i = 0; i < list_.size(); i++) {
+      if (unchanged_num >= list_.size()) {
+        break;
+      }
       const auto &substitution = list_[i];
       bool change = ApplySubstitutionToIR(optimizer, func_graph, substitution);
       changes = changes || change;
       loop = loop || change;
+      unchanged_num = change ? 0 : unchanged_num + 1;
 #ifdef ENABLE_DUMP_IR
       static const auto enable_dump_pass_ir = GetDumpConfig().enable_dump_pass_ir;
       if (enable_dump_pass_ir && MsContext::GetInstance()->get_param<bool>(MS_CTX_SAVE_GRAPHS_FLAG)) {
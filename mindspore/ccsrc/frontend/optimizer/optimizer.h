@@ -160,18 +160,30 @@ class Optimizer : public std::enable_shared_from_this<Optimizer> {
     // Set the initial value to true, so the renormalization can be executed once if it's the
     // only pass.
     bool changes_since_last_renorm = true;
+    // The number of the passes run since the graph was changed last time. Once every pass has run on the current graph
+    // without changing it, the rest passes of the round are skipped, since they can not change the graph either.
+    size_t unchanged_pass_num = 0;
 
     while (changes) {
       changes = false;
-      auto run_runc = [&counter, &func_graph, &changes, &changes_since_last_renorm, use_profile, this]() {
+      auto run_runc = [&counter, &func_graph, &changes, &changes_since_last_renorm, &unchanged_pass_num, use_profile,
+                       this]() {
         for (size_t i = 0; i < passes_.size(); ++i) {
+          if (unchanged_pass_num >= passes_.size()) {
+            MS_LOG(DEBUG) << "Optimizer " << name_ << " reaches the fixed point at pass " << pass_names_[i]
+                          << " of round " << counter;
+            break;
+          }
           const OptPass &opt = passes_[i];
           CurPass_ = {counter, pass_names_[i]};
-          auto opt_func = [&func_graph, &changes, &opt, &changes_since_last_renorm, this]() {
+          bool pass_changed = false;
+          auto opt_func = [&func_graph, &pass_changed, &opt, &changes_since_last_renorm, &unchanged_pass_num, this]() {
             if (opt.is_renormalize()) {
               if (!changes_since_last_renorm) {
                 return;
               }
+              // The renormalized types may be matched by the passes run before.
+              unchanged_pass_num = 0;
               auto resource = std::dynamic_pointer_cast<pipeline::Resource>(resource_);
               if (resource != nullptr) {
                 // StepParallel may replace the AbstractValue of the parameters of func_graph,
@@ -196,11 +208,18 @@ class Optimizer : public std::enable_shared_from_this<Optimizer> {
               }
               changes_since_last_renorm = false;
             } else if (opt(func_graph, shared_from_this())) {
-              changes = true;
+              pass_changed = true;
               changes_since_last_renorm = true;
             }
           };
           use_profile ? (WITH(MsProfile::GetProfile()->Step(pass_names_[i])) opt_func) : opt_func();
+          if (pass_changed) {
+            changes = true;
+            // The changed pass itself has to run again on the changed graph.
+            unchanged_pass_num = 0;
+          } else {
+            ++unchanged_pass_num;
+          }
 #ifdef ENABLE_DUMP_IR
           static const auto enable_dump_pass_ir = GetDumpConfig().enable_dump_pass_ir;
           if (enable_dump_pass_ir && MsContext::GetInstance()->get_param<bool>(MS_CTX_SAVE_GRAPHS_FLAG)) {
@@ -21,17 +21,33 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdlib>
+#include <numeric>
 #include "utils/hash_map.h"
 #include "utils/hash_set.h"
+#include "utils/ms_utils.h"
+#include "utils/shape_utils.h"
+#include "utils/flags.h"
+#include "utils/convert_utils_base.h"
+#include "abstract/abstract_value.h"
+#include "abstract/utils.h"
 #include "ir/func_graph.h"
 #include "mindspore/core/ops/core_ops.h"
+#include "mindspore/core/ops/op_name.h"
 #include "include/common/utils/utils.h"
+#include "frontend/optimizer/recompute_planner.h"
 
 namespace mindspore {
 namespace opt {
 namespace {
 constexpr auto kGradientsFlag = "Gradients";
 const int64_t fusion_id_increasement_size = 2000;
+// The memory budget of the activations in MB, with which the nodes to recompute are planned automatically.
+constexpr auto kRecomputeMemoryBudgetEnv = "MS_DEV_RECOMPUTE_MEMORY_BUDGET";
+constexpr size_t kMBToByte = 1 << 20;
+constexpr double kFlopsPerMac = 2;
+constexpr size_t kMatrixRank = 2;
+constexpr size_t kConvWeightRank = 4;
 bool CanNotRecomputed(const CNodePtr &node) {
   static mindspore::HashSet<PrimitivePtr> not_recomputed_op_list{
     prim::kPrimDropoutGenMask, prim::kPrimLoad, prim::kPrimTupleGetItem, prim::kPrimSend, prim::kPrimReceive};
@@ -450,6 +466,229 @@ void DuplicateRecomputedNodes(const FuncGraphPtr &graph, const mindspore::HashSe
     mng->Replace(target_node, new_target_node);
   }
 }
+
+size_t GetRecomputeMemoryBudget() {
+  auto budget = common::GetEnv(kRecomputeMemoryBudgetEnv);
+  if (budget.empty()) {
+    return 0;
+  }
+  auto value = std::strtol(budget.c_str(), nullptr, 10);
+  if (value <= 0) {
+    MS_LOG(WARNING) << "The " << kRecomputeMemoryBudgetEnv << " should be a positive number of MB, but got " << budget;
+    return 0;
+  }
+  return LongToSize(value) * kMBToByte;
+}
+
+ShapeVector GetTensorShape(const AbstractBasePtr &abstract) {
+  if (abstract == nullptr || !abstract->isa<abstract::AbstractTensor>()) {
+    return {};
+  }
+  auto shape = abstract->cast_ptr<abstract::AbstractTensor>()->shape();
+  return shape == nullptr ? ShapeVector() : shape->shape();
+}
+
+size_t GetElementNum(const ShapeVector &shape) {
+  if (IsDynamic(shape)) {
+    return 0;
+  }
+  return std::accumulate(shape.begin(), shape.end(), size_t(1),
+                         [](size_t num, int64_t dim) { return num * LongToSize(dim); });
+}
+
+// The bytes of the outputs of a node, the dynamic shapes are not counted.
+size_t GetOutputSize(const AbstractBasePtr &abstract) {
+  if (abstract == nullptr) {
+    return 0;
+  }
+  if (abstract->isa<abstract::AbstractTuple>()) {
+    const auto &elements = abstract->cast_ptr<abstract::AbstractTuple>()->elements();
+    return std::accumulate(elements.begin(), elements.end(), size_t(0),
+                           [](size_t size, const AbstractBasePtr &element) { return size + GetOutputSize(element); });
+  }
+  if (!abstract->isa<abstract::AbstractTensor>()) {
+    return 0;
+  }
+  auto element = abstract->cast_ptr<abstract::AbstractTensor>()->element();
+  MS_EXCEPTION_IF_NULL(element);
+  auto type = element->BuildType();
+  MS_EXCEPTION_IF_NULL(type);
+  return GetElementNum(GetTensorShape(abstract)) * abstract::TypeIdSize(type->type_id());
+}
+
+// A rough estimate of the floating point operations of a node, which is the multiply-adds of the matrix products and
+// the convolutions, and one operation per output element for the others.
+double EstimateFlops(const CNodePtr &node) {
+  double output_num = static_cast<double>(GetElementNum(GetTensorShape(node->abstract())));
+  if ((IsPrimitiveCNode(node, prim::kPrimMatMul) || IsPrimitiveCNode(node, prim::kPrimBatchMatMul)) &&
+      node->size() > kIndex2) {
+    auto shape = GetTensorShape(node->input(kIndex1)->abstract());
+    auto prim = GetCNodePrimitive(node);
+    MS_EXCEPTION_IF_NULL(prim);
+    auto transpose_a = prim->GetAttr(ops::kTransposeA);
+    bool transpose = transpose_a != nullptr && transpose_a->isa<BoolImm>() && GetValue<bool>(transpose_a);
+    if (shape.size() >= kMatrixRank && !IsDynamic(shape)) {
+      auto reduce_dim = shape[shape.size() - (transpose ? kMatrixRank : 1)];
+      return kFlopsPerMac * output_num * static_cast<double>(reduce_dim);
+    }
+  }
+  if (IsPrimitiveCNode(node, prim::kPrimConv2D) && node->size() > kIndex2) {
+    auto weight_shape = GetTensorShape(node->input(kIndex2)->abstract());
+    if (weight_shape.size() == kConvWeightRank && !IsDynamic(weight_shape) && weight_shape[0] > 0) {
+      auto weight_num = static_cast<double>(GetElementNum(weight_shape));
+      return kFlopsPerMac * output_num * weight_num / static_cast<double>(weight_shape[0]);
+    }
+  }
+  return output_num;
+}
+
+// The nodes whose outputs share the memory of their inputs, their users are the users of the inputs.
+bool IsAliasNode(const AnfNodePtr &node) {
+  return IsPrimitiveCNode(node, prim::kPrimTupleGetItem) || IsPrimitiveCNode(node, prim::kPrimDepend) ||
+         IsPrimitiveCNode(node, prim::kPrimMakeTuple);
+}
+
+bool HasActivation(const CNodePtr &node) {
+  return !IsAliasNode(node) && !IsPrimitiveCNode(node, prim::kPrimUpdateState) &&
+         !IsPrimitiveCNode(node, prim::kPrimLoad) && !IsPrimitiveCNode(node, prim::kPrimReturn);
+}
+
+// Get the nodes which read the output of the node, through the alias nodes.
+void GetRealUsers(const FuncGraphManagerPtr &mng, const AnfNodePtr &node, mindspore::HashSet<AnfNodePtr> *visited,
+                  std::vector<CNodePtr> *users) {
+  const auto &node_users = mng->node_users();
+  auto output_set_iter = node_users.find(node);
+  if (output_set_iter == node_users.end()) {
+    return;
+  }
+  for (const auto &node_index : output_set_iter->second) {
+    const auto &user = node_index.first;
+    if (!visited->insert(user).second || IsPrimitiveCNode(user, prim::kPrimUpdateState)) {
+      continue;
+    }
+    bool alias = IsPrimitiveCNode(user, prim::kPrimTupleGetItem) || IsPrimitiveCNode(user, prim::kPrimMakeTuple) ||
+                 (IsPrimitiveCNode(user, prim::kPrimDepend) && node_index.second == kRealInputIndexInDepend);
+    if (alias) {
+      GetRealUsers(mng, user, visited, users);
+    } else if (user->isa<CNode>()) {
+      (void)users->emplace_back(user->cast<CNodePtr>());
+    }
+  }
+}
+
+// Get the node producing the memory of the output of the node.
+AnfNodePtr GetRealProducer(const AnfNodePtr &node) {
+  auto real_node = node;
+  while (true) {
+    if (IsPrimitiveCNode(real_node, prim::kPrimTupleGetItem)) {
+      real_node = real_node->cast_ptr<CNode>()->input(kRealInputNodeIndexInTupleGetItem);
+    } else if (IsPrimitiveCNode(real_node, prim::kPrimDepend)) {
+      real_node = real_node->cast_ptr<CNode>()->input(kRealInputIndexInDepend);
+    } else {
+      return real_node;
+    }
+  }
+}
+
+bool HasDirectBpropUser(const FuncGraphManagerPtr &mng, const CNodePtr &node) {
+  const auto &node_users = mng->node_users();
+  auto output_set_iter = node_users.find(node);
+  if (output_set_iter == node_users.end()) {
+    return false;
+  }
+  return std::any_of(output_set_iter->second.begin(), output_set_iter->second.end(),
+                     [](const auto &node_index) { return IsBpropNode(node_index.first); });
+}
+
+bool CanBePlannedRecomputed(const FuncGraphManagerPtr &mng, const CNodePtr &node,
+                            mindspore::HashMap<AnfNodePtr, bool> *has_grad_inputs_map) {
+  if (IsBpropNode(node) || CanNotRecomputed(node) || IsSetNoRecomputeCNodeAttr(node) || node->abstract() == nullptr ||
+      !node->abstract()->isa<abstract::AbstractTensor>()) {
+    return false;
+  }
+  auto prim = GetCNodePrimitive(node);
+  if (prim == nullptr || GetPrimitiveFlag(prim, GRAPH_FLAG_SIDE_EFFECT_MEM)) {
+    return false;
+  }
+  return HasDirectBpropUser(mng, node) && !HasGradInputs(node, has_grad_inputs_map);
+}
+
+// Pick the nodes to recompute by the lifetimes of the activations in the execution order, so that the peak memory of
+// the activations fits the budget. The picked nodes are set the 'recompute' cnode attr like the annotated ones.
+void PlanRecomputedNodes(const FuncGraphPtr &graph, const std::vector<CNodePtr> &origin_nodes_topological,
+                         size_t memory_budget) {
+  auto mng = graph->manager();
+  MS_EXCEPTION_IF_NULL(mng);
+  mindspore::HashMap<AnfNodePtr, size_t> node_steps;
+  for (size_t i = 0; i < origin_nodes_topological.size(); ++i) {
+    (void)node_steps.emplace(origin_nodes_topological[i], i);
+  }
+
+  RecomputePlanner planner;
+  mindspore::HashMap<AnfNodePtr, size_t> activation_ids;
+  std::vector<CNodePtr> activation_nodes;
+  mindspore::HashMap<AnfNodePtr, bool> has_grad_inputs_map;
+  for (size_t step = 0; step < origin_nodes_topological.size(); ++step) {
+    const auto &node = origin_nodes_topological[step];
+    MS_EXCEPTION_IF_NULL(node);
+    if (!HasActivation(node)) {
+      continue;
+    }
+    ActivationInfo activation;
+    activation.size = GetOutputSize(node->abstract());
+    activation.start = step;
+    activation.end = step;
+    activation.last_forward_use = step;
+    activation.first_backward_use = origin_nodes_topological.size();
+    mindspore::HashSet<AnfNodePtr> visited;
+    std::vector<CNodePtr> users;
+    GetRealUsers(mng, node, &visited, &users);
+    for (const auto &user : users) {
+      auto step_iter = node_steps.find(user);
+      if (step_iter == node_steps.end()) {
+        continue;
+      }
+      activation.end = std::max(activation.end, step_iter->second);
+      if (IsBpropNode(user)) {
+        activation.first_backward_use = std::min(activation.first_backward_use, step_iter->second);
+      } else {
+        activation.last_forward_use = std::max(activation.last_forward_use, step_iter->second);
+      }
+    }
+    activation.recomputable = CanBePlannedRecomputed(mng, node, &has_grad_inputs_map);
+    activation.flops = EstimateFlops(node);
+    for (size_t i = 1; i < node->size(); ++i) {
+      auto input_iter = activation_ids.find(GetRealProducer(node->input(i)));
+      if (input_iter != activation_ids.end()) {
+        (void)activation.inputs.emplace_back(input_iter->second);
+      }
+    }
+    auto id = planner.AddActivation(activation);
+    (void)activation_ids.emplace(node, id);
+    (void)activation_nodes.emplace_back(node);
+    if (IsSetRecomputeCNodeAttr(node)) {
+      planner.SetRecomputed(id);
+    }
+  }
+
+  size_t origin_peak = planner.PeakMemory();
+  double origin_flops = planner.ExtraFlops();
+  auto planned = planner.Plan(memory_budget);
+  for (auto id : planned) {
+    MS_LOG(DEBUG) << "Plan to recompute the node " << activation_nodes[id]->DebugString();
+    activation_nodes[id]->AddAttr(kAttrRecompute, MakeValue(true));
+  }
+  size_t peak = planner.PeakMemory();
+  MS_LOG(INFO) << "The automatic recomputation picks " << planned.size() << " nodes of the graph " << graph->ToString()
+               << ", the predicted peak memory of the activations is " << peak / kMBToByte << " MB from "
+               << origin_peak / kMBToByte << " MB with the budget " << memory_budget / kMBToByte
+               << " MB, the extra computation is " << planner.ExtraFlops() - origin_flops << " flops.";
+  if (peak > memory_budget) {
+    MS_LOG(WARNING) << "The predicted peak memory of the activations " << peak / kMBToByte
+                    << " MB exceeds the recomputation budget " << memory_budget / kMBToByte
+                    << " MB set by " << kRecomputeMemoryBudgetEnv << ", there are no more activations to recompute.";
+  }
+}
 }  // namespace
 
 void InsertRecomputedNodes(const FuncGraphPtr &graph) {
@@ -459,6 +698,10 @@ void InsertRecomputedNodes(const FuncGraphPtr &graph) {
   std::list<CNodePtr> orders = graph->GetOrderedCnodes();
   std::vector<CNodePtr> origin_nodes_topological(orders.cbegin(), orders.cend());
   SetRecomputedAttr(graph, origin_nodes_topological);
+  auto memory_budget = GetRecomputeMemoryBudget();
+  if (memory_budget > 0) {
+    PlanRecomputedNodes(graph, origin_nodes_topological, memory_budget);
+  }
   // Get candidate origin recomputed nodes which have no grad inputs and output to at least one grad node directly.
   std::vector<CNodePtr> candidate_recomputed_nodes = FindCandidateRecomputedNodes(mng, origin_nodes_topological);
   mindspore::HashSet<CNodePtr> visited_nodes;
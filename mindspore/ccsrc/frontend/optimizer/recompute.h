@@ -21,7 +21,9 @@
 
 namespace mindspore {
 namespace opt {
-// Automatically insert duplicated recomputed nodes.
+// Automatically insert duplicated recomputed nodes. When MS_DEV_RECOMPUTE_MEMORY_BUDGET is set to a number of MB, more
+// nodes are picked to be recomputed besides the annotated ones, until the predicted peak memory of the activations fits
+// the budget.
 void InsertRecomputedNodes(const FuncGraphPtr &graph);
 }  // namespace opt
 }  // namespace mindspore
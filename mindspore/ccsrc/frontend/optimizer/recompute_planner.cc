@@ -0,0 +1,326 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frontend/optimizer/recompute_planner.h"
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <queue>
+#include <vector>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace opt {
+namespace {
+constexpr size_t kTreeSizeFactor = 4;
+}  // namespace
+
+// The memory usage of the steps in a segment tree, the memory is added to a range of steps and the peak step is found
+// in logarithmic time.
+class RecomputeUsageTree {
+ public:
+  explicit RecomputeUsageTree(const std::vector<size_t> &usage)
+      : step_num_(usage.size()), max_(kTreeSizeFactor * step_num_, 0), added_(kTreeSizeFactor * step_num_, 0) {
+    if (step_num_ > 0) {
+      Build(usage, 1, 0, step_num_ - 1);
+    }
+  }
+  ~RecomputeUsageTree() = default;
+
+  void Add(size_t first, size_t last, int64_t size) { Add(first, last, size, 1, 0, step_num_ - 1); }
+
+  // Returns the peak memory, and the first step reaching it.
+  size_t Peak(size_t *step) const {
+    size_t node = 1;
+    size_t left = 0;
+    size_t right = step_num_ - 1;
+    while (left < right) {
+      size_t mid = left + (right - left) / 2;
+      if (max_[node * 2] == max_[node] - added_[node]) {
+        node = node * 2;
+        right = mid;
+      } else {
+        node = node * 2 + 1;
+        left = mid + 1;
+      }
+    }
+    *step = left;
+    return static_cast<size_t>(max_[1]);
+  }
+
+  size_t At(size_t step) const {
+    size_t node = 1;
+    size_t left = 0;
+    size_t right = step_num_ - 1;
+    int64_t added = 0;
+    while (left < right) {
+      added += added_[node];
+      size_t mid = left + (right - left) / 2;
+      if (step <= mid) {
+        node = node * 2;
+        right = mid;
+      } else {
+        node = node * 2 + 1;
+        left = mid + 1;
+      }
+    }
+    return static_cast<size_t>(added + max_[node]);
+  }
+
+ private:
+  void Build(const std::vector<size_t> &usage, size_t node, size_t left, size_t right) {
+    if (left == right) {
+      max_[node] = static_cast<int64_t>(usage[left]);
+      return;
+    }
+    size_t mid = left + (right - left) / 2;
+    Build(usage, node * 2, left, mid);
+    Build(usage, node * 2 + 1, mid + 1, right);
+    max_[node] = std::max(max_[node * 2], max_[node * 2 + 1]);
+  }
+
+  void Add(size_t first, size_t last, int64_t size, size_t node, size_t left, size_t right) {
+    if (last < left || right < first) {
+      return;
+    }
+    if (first <= left && right <= last) {
+      max_[node] += size;
+      added_[node] += size;
+      return;
+    }
+    size_t mid = left + (right - left) / 2;
+    Add(first, last, size, node * 2, left, mid);
+    Add(first, last, size, node * 2 + 1, mid + 1, right);
+    max_[node] = std::max(max_[node * 2], max_[node * 2 + 1]) + added_[node];
+  }
+
+  size_t step_num_;
+  // The peak memory in the steps of a tree node, including the memory added to all the steps of the node.
+  std::vector<int64_t> max_;
+  // The memory added to all the steps of a tree node.
+  std::vector<int64_t> added_;
+};
+
+size_t RecomputePlanner::AddActivation(const ActivationInfo &activation) {
+  size_t id = activations_.size();
+  if (activation.start > activation.end) {
+    MS_LOG(EXCEPTION) << "The activation " << id << " starts at " << activation.start << " after its end "
+                      << activation.end;
+  }
+  for (auto input : activation.inputs) {
+    if (input >= id) {
+      MS_LOG(EXCEPTION) << "The input " << input << " of the activation " << id << " should be added before it.";
+    }
+  }
+  (void)activations_.emplace_back(activation);
+  auto &added = activations_.back();
+  // The activation is not released by the recomputation unless its forward and backward users are apart.
+  added.recomputable = added.recomputable && added.last_forward_use >= added.start &&
+                       added.last_forward_use < added.first_backward_use && added.first_backward_use <= added.end;
+  recomputed_.push_back(false);
+  (void)users_.emplace_back();
+  for (auto input : activation.inputs) {
+    (void)users_[input].emplace_back(id);
+  }
+  step_num_ = std::max(step_num_, activation.end + 1);
+  return id;
+}
+
+void RecomputePlanner::SetRecomputed(size_t id) {
+  if (id >= activations_.size()) {
+    MS_LOG(EXCEPTION) << "The activation " << id << " out of range " << activations_.size();
+  }
+  recomputed_[id] = true;
+}
+
+RecomputePlanner::Lifetime RecomputePlanner::DeriveLifetime(size_t id, const std::vector<Lifetime> &lifetimes) const {
+  // The recomputation runs right before the first backward user. It starts the activation early when a recomputed
+  // user needs it, otherwise it keeps the activation alive until then.
+  const auto &activation = activations_[id];
+  Lifetime lifetime{activation.end, activation.first_backward_use};
+  for (auto user : users_[id]) {
+    if (!IsReproduced(user, lifetimes[user])) {
+      continue;
+    }
+    auto user_start = lifetimes[user].recompute_start;
+    lifetime.end = std::max(lifetime.end, user_start);
+    if (recomputed_[id]) {
+      lifetime.recompute_start = std::min(lifetime.recompute_start, user_start);
+    }
+  }
+  return lifetime;
+}
+
+bool RecomputePlanner::IsReproduced(size_t id, const Lifetime &lifetime) const {
+  // The activation without backward users is not recomputed if no recomputed user needs it.
+  return recomputed_[id] && lifetime.recompute_start > activations_[id].last_forward_use &&
+         lifetime.recompute_start <= lifetime.end;
+}
+
+std::vector<RecomputePlanner::Lifetime> RecomputePlanner::ComputeLifetimes() const {
+  // The users are added after their inputs, so the lifetimes of the users are final when their inputs are visited.
+  size_t num = activations_.size();
+  std::vector<Lifetime> lifetimes(num);
+  for (size_t id = num; id > 0; id--) {
+    lifetimes[id - 1] = DeriveLifetime(id - 1, lifetimes);
+  }
+  return lifetimes;
+}
+
+void RecomputePlanner::ForEachAliveRange(size_t id, const Lifetime &lifetime,
+                                         const std::function<void(size_t, size_t)> &func) const {
+  const auto &activation = activations_[id];
+  if (!IsReproduced(id, lifetime)) {
+    func(activation.start, lifetime.end);
+    return;
+  }
+  func(activation.start, activation.last_forward_use);
+  func(lifetime.recompute_start, lifetime.end);
+}
+
+std::vector<size_t> RecomputePlanner::Usage(const std::vector<Lifetime> &lifetimes) const {
+  std::vector<int64_t> deltas(step_num_ + 1, 0);
+  for (size_t id = 0; id < activations_.size(); id++) {
+    auto size = static_cast<int64_t>(activations_[id].size);
+    ForEachAliveRange(id, lifetimes[id], [&deltas, size](size_t first, size_t last) {
+      deltas[first] += size;
+      deltas[last + 1] -= size;
+    });
+  }
+  std::vector<size_t> usage(step_num_);
+  int64_t current = 0;
+  for (size_t step = 0; step < step_num_; step++) {
+    current += deltas[step];
+    usage[step] = static_cast<size_t>(current);
+  }
+  return usage;
+}
+
+size_t RecomputePlanner::PeakMemory() const {
+  auto usage = Usage(ComputeLifetimes());
+  return usage.empty() ? 0 : *std::max_element(usage.begin(), usage.end());
+}
+
+double RecomputePlanner::ExtraFlops() const {
+  auto lifetimes = ComputeLifetimes();
+  double flops = 0;
+  for (size_t id = 0; id < activations_.size(); id++) {
+    if (IsReproduced(id, lifetimes[id])) {
+      flops += activations_[id].flops;
+    }
+  }
+  return flops;
+}
+
+void RecomputePlanner::UpdateLifetime(size_t id, const Lifetime &lifetime, std::vector<Lifetime> *lifetimes,
+                                      RecomputeUsageTree *usage) const {
+  auto size = static_cast<int64_t>(activations_[id].size);
+  ForEachAliveRange(id, (*lifetimes)[id], [usage, size](size_t first, size_t last) { usage->Add(first, last, -size); });
+  (*lifetimes)[id] = lifetime;
+  ForEachAliveRange(id, lifetime, [usage, size](size_t first, size_t last) { usage->Add(first, last, size); });
+}
+
+void RecomputePlanner::Recompute(size_t id, std::vector<Lifetime> *lifetimes, RecomputeUsageTree *usage,
+                                 std::map<size_t, Lifetime> *origin_lifetimes) {
+  auto size = static_cast<int64_t>(activations_[id].size);
+  (void)origin_lifetimes->emplace(id, (*lifetimes)[id]);
+  ForEachAliveRange(id, (*lifetimes)[id], [usage, size](size_t first, size_t last) { usage->Add(first, last, -size); });
+  recomputed_[id] = true;
+  (*lifetimes)[id] = DeriveLifetime(id, *lifetimes);
+  ForEachAliveRange(id, (*lifetimes)[id], [usage, size](size_t first, size_t last) { usage->Add(first, last, size); });
+
+  // The lifetime of an activation only changes the lifetimes of its inputs, and the change goes on through the inputs
+  // whose lifetimes change.
+  std::queue<size_t> changed_users;
+  changed_users.push(id);
+  while (!changed_users.empty()) {
+    auto user = changed_users.front();
+    changed_users.pop();
+    for (auto input : activations_[user].inputs) {
+      auto lifetime = DeriveLifetime(input, *lifetimes);
+      const auto &current = (*lifetimes)[input];
+      if (lifetime.end == current.end && lifetime.recompute_start == current.recompute_start) {
+        continue;
+      }
+      (void)origin_lifetimes->emplace(input, current);
+      UpdateLifetime(input, lifetime, lifetimes, usage);
+      changed_users.push(input);
+    }
+  }
+}
+
+std::vector<size_t> RecomputePlanner::Plan(size_t memory_budget) {
+  std::vector<size_t> planned;
+  if (step_num_ == 0) {
+    return planned;
+  }
+  auto lifetimes = ComputeLifetimes();
+  RecomputeUsageTree usage(Usage(lifetimes));
+  // The candidates in the order of the most memory saved per recomputed flop, each one is tried once.
+  std::vector<size_t> sorted_ids;
+  for (size_t id = 0; id < activations_.size(); id++) {
+    if (activations_[id].recomputable && !recomputed_[id] && activations_[id].size > 0) {
+      (void)sorted_ids.emplace_back(id);
+    }
+  }
+  auto score = [this](size_t id) { return static_cast<double>(activations_[id].size) / (activations_[id].flops + 1); };
+  std::stable_sort(sorted_ids.begin(), sorted_ids.end(),
+                   [&score](size_t a, size_t b) { return score(a) > score(b); });
+  std::list<size_t> candidates(sorted_ids.begin(), sorted_ids.end());
+
+  while (true) {
+    size_t peak_step = 0;
+    size_t peak = usage.Peak(&peak_step);
+    if (peak <= memory_budget) {
+      break;
+    }
+    // Only the activations which are not used around the peak step can be released there.
+    auto best_iter = std::find_if(candidates.begin(), candidates.end(), [this, peak_step](size_t id) {
+      return activations_[id].last_forward_use < peak_step && activations_[id].first_backward_use > peak_step;
+    });
+    if (best_iter == candidates.end()) {
+      break;
+    }
+    size_t best = *best_iter;
+    (void)candidates.erase(best_iter);
+
+    std::map<size_t, Lifetime> origin_lifetimes;
+    Recompute(best, &lifetimes, &usage, &origin_lifetimes);
+    size_t new_step = 0;
+    size_t new_peak = usage.Peak(&new_step);
+    // Another step may reach the same peak, the choice still helps if it lowers the memory at this step.
+    if (new_peak < peak || (new_peak == peak && usage.At(peak_step) < peak)) {
+      (void)planned.emplace_back(best);
+      continue;
+    }
+    for (const auto &item : origin_lifetimes) {
+      auto size = static_cast<int64_t>(activations_[item.first].size);
+      ForEachAliveRange(item.first, lifetimes[item.first],
+                        [&usage, size](size_t first, size_t last) { usage.Add(first, last, -size); });
+    }
+    recomputed_[best] = false;
+    for (const auto &item : origin_lifetimes) {
+      auto size = static_cast<int64_t>(activations_[item.first].size);
+      lifetimes[item.first] = item.second;
+      ForEachAliveRange(item.first, item.second,
+                        [&usage, size](size_t first, size_t last) { usage.Add(first, last, size); });
+    }
+  }
+  return planned;
+}
+}  // namespace opt
+}  // namespace mindspore
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FRONTEND_OPTIMIZER_RECOMPUTE_PLANNER_H_
+#define MINDSPORE_CCSRC_FRONTEND_OPTIMIZER_RECOMPUTE_PLANNER_H_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace mindspore {
+namespace opt {
+// The activation produced by a node, its lifetime is the steps in the execution order from its producer to its last
+// user, like the lifetime of a tensor in SOMAS.
+struct ActivationInfo {
+  size_t size{0};
+  size_t start{0};
+  size_t end{0};
+  // Whether the activation can be recomputed before its backward users instead of being kept during the forward pass.
+  bool recomputable{false};
+  // The last forward user and the first backward user, the activation is released between them when it is recomputed.
+  size_t last_forward_use{0};
+  size_t first_backward_use{0};
+  // The estimated floating point operations of the producer, which are spent again by the recomputation.
+  double flops{0};
+  // The activations which are the inputs of the producer, they must be alive when the producer is recomputed.
+  std::vector<size_t> inputs;
+};
+
+class RecomputeUsageTree;
+
+// RecomputePlanner picks the activations to recompute so that the peak memory of the activations fits the budget.
+// It greedily releases the activations alive at the peak step, the ones of the most memory saved per recomputed flop
+// first, and keeps a choice only if it lowers the peak, since the recomputation extends the lifetimes of its inputs.
+// A choice only updates the lifetimes of the activation and of the inputs it recomputes, and the memory usage of
+// their steps, so a plan does not sweep the whole graph for every choice.
+class RecomputePlanner {
+ public:
+  RecomputePlanner() = default;
+  ~RecomputePlanner() = default;
+
+  // Add an activation, the inputs of an activation must be added before it. Returns the id of the activation.
+  size_t AddActivation(const ActivationInfo &activation);
+
+  // Mark an activation recomputed, such as the activations annotated by the user. An activation without backward users
+  // is only recomputed for the recomputation of its recomputed users, otherwise it is kept.
+  void SetRecomputed(size_t id);
+
+  // Returns the ids of the activations chosen to be recomputed in addition to the ones already marked.
+  std::vector<size_t> Plan(size_t memory_budget);
+
+  // The peak memory of the activations with the current recomputed activations.
+  size_t PeakMemory() const;
+
+  // The floating point operations spent by the activations which are actually recomputed.
+  double ExtraFlops() const;
+
+  bool recomputed(size_t id) const { return recomputed_.at(id); }
+
+ private:
+  // The lifetime of an activation with the recomputation. The end is extended to the recomputations of the recomputed
+  // users, and a recomputed activation is produced again at the recompute start.
+  struct Lifetime {
+    size_t end{0};
+    size_t recompute_start{0};
+  };
+
+  std::vector<Lifetime> ComputeLifetimes() const;
+  // Get the lifetime of an activation from the lifetimes of its recomputed users.
+  Lifetime DeriveLifetime(size_t id, const std::vector<Lifetime> &lifetimes) const;
+  // Whether the activation is released after the forward pass and produced again for the backward pass.
+  bool IsReproduced(size_t id, const Lifetime &lifetime) const;
+  // Visit the ranges of steps in which the activation is alive.
+  void ForEachAliveRange(size_t id, const Lifetime &lifetime, const std::function<void(size_t, size_t)> &func) const;
+  // The memory of the activations alive at every step.
+  std::vector<size_t> Usage(const std::vector<Lifetime> &lifetimes) const;
+  // Mark an activation recomputed and update the lifetimes and the memory usage it changes, the lifetimes before the
+  // change are saved to origin_lifetimes.
+  void Recompute(size_t id, std::vector<Lifetime> *lifetimes, RecomputeUsageTree *usage,
+                 std::map<size_t, Lifetime> *origin_lifetimes);
+  void UpdateLifetime(size_t id, const Lifetime &lifetime, std::vector<Lifetime> *lifetimes,
+                      RecomputeUsageTree *usage) const;
+
+  std::vector<ActivationInfo> activations_;
+  std::vector<std::vector<size_t>> users_;
+  std::vector<bool> recomputed_;
+  size_t step_num_{0};
+};
+}  // namespace opt
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FRONTEND_OPTIMIZER_RECOMPUTE_PLANNER_H_
@@ -0,0 +1,100 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_INCLUDE_COMMON_UTILS_CHECKPOINT_CHECKPOINT_WRITER_H_
+#define MINDSPORE_CCSRC_INCLUDE_COMMON_UTILS_CHECKPOINT_CHECKPOINT_WRITER_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ir/tensor.h"
+#include "utils/tensor_file.h"
+#include "include/common/visible.h"
+
+namespace mindspore {
+namespace checkpoint {
+// The manifest of a checkpoint lists every tensor with the tensor file holding its data. The tensor file may belong to
+// an earlier checkpoint of the same writer if the tensor did not change since then. The tensor files of a checkpoint
+// are named `<prefix>_<save>_<shard>.mst`, where `save` is unique in the directory, so saving a checkpoint again with
+// the same prefix never overwrites the files referred to by the earlier manifests.
+constexpr char kManifestSuffix[] = ".manifest";
+constexpr char kTensorFileSuffix[] = ".mst";
+
+// CheckpointWriter saves tensors into sharded tensor files in a background thread. `Save` only takes a snapshot of the
+// tensors into host buffers, so that the training continues while the files are written. The shards are written in
+// parallel with large aligned writes. An incremental save writes only the tensors whose data changed since the last
+// save of this writer, and the manifest refers to the earlier files for the others.
+class COMMON_EXPORT CheckpointWriter {
+ public:
+  CheckpointWriter(const std::string &directory, size_t shard_num);
+  ~CheckpointWriter();
+
+  // Save the tensors as the checkpoint `prefix`, which returns once the snapshot is taken. The previous save is waited
+  // before taking the snapshot.
+  void Save(const std::string &prefix, const std::vector<std::string> &names,
+            const std::vector<tensor::TensorPtr> &tensors, bool incremental);
+
+  // Wait for the background writing to finish, returns whether the last checkpoint has been saved successfully.
+  bool Wait();
+
+ private:
+  struct SnapshotItem {
+    TensorFileEntry entry;
+    // The offset of the data in the snapshot buffer, aligned like the offset in file.
+    uint64_t snapshot_offset{0};
+    // The tensor file which holds the data.
+    std::string file_name;
+  };
+
+  struct SavedTensor {
+    TypeId type{kTypeUnknown};
+    ShapeVector shape;
+    uint64_t hash{0};
+    std::string file_name;
+  };
+
+  void ReserveSnapshot(size_t size);
+  void WriteCheckpoint(const std::string &prefix, std::vector<SnapshotItem> items, bool incremental);
+  void WriteCheckpointFiles(const std::string &prefix, std::vector<SnapshotItem> *items_ptr, bool incremental);
+  void HashSnapshot(std::vector<SnapshotItem> *items) const;
+  bool WriteTensorFile(const std::string &file_name, const std::vector<SnapshotItem *> &items) const;
+  bool WriteManifest(const std::string &prefix, const std::vector<SnapshotItem> &items) const;
+  std::string NewShardPrefix(const std::string &prefix);
+  bool SyncDirectory() const;
+
+  std::string directory_;
+  size_t shard_num_;
+
+  // The page aligned snapshot buffer, which is reused by the following saves.
+  std::unique_ptr<uint8_t, void (*)(void *)> snapshot_{nullptr, free};
+  size_t snapshot_size_{0};
+
+  // The tensors saved by the last checkpoints, used to find the unchanged tensors of an incremental save. It is only
+  // accessed by the background thread or after the background thread has been joined.
+  std::map<std::string, SavedTensor> saved_tensors_;
+  // The sequence number of the next save in the tensor file names, only accessed like saved_tensors_.
+  size_t save_seq_{0};
+
+  std::thread writer_;
+  std::atomic<bool> success_{true};
+};
+using CheckpointWriterPtr = std::shared_ptr<CheckpointWriter>;
+}  // namespace checkpoint
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_INCLUDE_COMMON_UTILS_CHECKPOINT_CHECKPOINT_WRITER_H_
@@ -498,6 +498,7 @@ constexpr auto kAttrLabelForInsertStreamActive = "label_for_insert_stream_active
 constexpr auto kAttrFpBpEnd = "fpbp_end";
 constexpr auto kAttrFusion = "fusion";
 constexpr auto kAttrNotDelayFusion = "not_delay_fusion";
+constexpr auto kAttrGradientReduce = "gradient_reduce";
 constexpr auto kAttrGroup = "group";
 constexpr auto kAttrRankList = "rank_list";
 constexpr auto kAttrGroups = "groups";
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "kernel/kernel_select_cache.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include "kernel/common_utils.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+// The saved selections are dropped when the version is changed.
+constexpr int kKernelSelectCacheVersion = 1;
+constexpr char kSignature[] = "signature";
+constexpr char kKernelType[] = "kernel_type";
+constexpr char kInputsFormat[] = "inputs_format";
+constexpr char kInputsDeviceType[] = "inputs_device_type";
+constexpr char kOutputsFormat[] = "outputs_format";
+constexpr char kOutputsDeviceType[] = "outputs_device_type";
+}  // namespace
+
+KernelSelectCache::KernelSelectCache() : PersistentJsonCache("kernel selection cache", kKernelSelectCacheVersion) {}
+
+std::string KernelSelectCache::MakeSignature(const std::string &device, const std::string &op_name,
+                                             const std::string &registry_fingerprint,
+                                             const std::vector<TypeId> &input_types,
+                                             const std::vector<TypeId> &output_types,
+                                             const std::vector<int64_t> &dyn_input_sizes) {
+  std::string signature = device + "|" + op_name + "|" + registry_fingerprint + "|";
+  for (auto type : input_types) {
+    signature += std::to_string(type) + ",";
+  }
+  signature += "|";
+  for (auto type : output_types) {
+    signature += std::to_string(type) + ",";
+  }
+  signature += "|";
+  for (auto size : dyn_input_sizes) {
+    signature += std::to_string(size) + ",";
+  }
+  return signature;
+}
+
+std::string KernelSelectCache::RegistryFingerprint(const std::vector<KernelAttr> &kernel_attrs) {
+  std::ostringstream attrs;
+  for (const auto &kernel_attr : kernel_attrs) {
+    attrs << kernel_attr.GetAllSame() << kernel_attr.GetSkipCheck() << kernel_attr.GetAllOutInRef() << "(";
+    for (size_t i = 0; i < kernel_attr.GetInputSize(); ++i) {
+      attrs << kernel_attr.GetInputAttr(i).first << ":" << kernel_attr.GetInputAttr(i).second << ",";
+    }
+    attrs << ")(";
+    for (size_t i = 0; i < kernel_attr.GetOutputSize(); ++i) {
+      attrs << kernel_attr.GetOutputAttr(i).first << ":" << kernel_attr.GetOutputAttr(i).second << ",";
+    }
+    attrs << ")(";
+    for (const auto &[output_index, input_index] : kernel_attr.GetOutInRefMap()) {
+      attrs << output_index << ":" << input_index << ",";
+    }
+    attrs << ");";
+  }
+  // The cache files are only shared by the jobs of the same MindSpore build, so the hash needs not be portable.
+  return std::to_string(std::hash<std::string>()(attrs.str()));
+}
+
+size_t KernelSelectCache::FromJson(const nlohmann::json &contents) {
+  size_t loaded_num = 0;
+  for (const auto &item : contents) {
+    auto builder = std::make_shared<KernelBuildInfo::KernelBuildInfoBuilder>();
+    builder->SetKernelType(static_cast<KernelType>(item.at(kKernelType).get<int>()));
+    builder->SetInputsFormat(item.at(kInputsFormat).get<std::vector<std::string>>());
+    builder->SetInputsDeviceType(item.at(kInputsDeviceType).get<std::vector<TypeId>>());
+    builder->SetOutputsFormat(item.at(kOutputsFormat).get<std::vector<std::string>>());
+    builder->SetOutputsDeviceType(item.at(kOutputsDeviceType).get<std::vector<TypeId>>());
+    if (selections_.emplace(item.at(kSignature).get<std::string>(), builder->Build()).second) {
+      ++loaded_num;
+    }
+  }
+  return loaded_num;
+}
+
+nlohmann::json KernelSelectCache::ToJson() const {
+  nlohmann::json selections = nlohmann::json::array();
+  for (const auto &[signature, build_info] : selections_) {
+    nlohmann::json item;
+    item[kSignature] = signature;
+    item[kKernelType] = static_cast<int>(build_info->kernel_type());
+    item[kInputsFormat] = build_info->GetAllInputFormats();
+    item[kInputsDeviceType] = build_info->GetAllInputDeviceTypes();
+    item[kOutputsFormat] = build_info->GetAllOutputFormats();
+    item[kOutputsDeviceType] = build_info->GetAllOutputDeviceTypes();
+    selections.push_back(std::move(item));
+  }
+  return selections;
+}
+
+KernelBuildInfoPtr KernelSelectCache::Get(const std::string &signature) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = selections_.find(signature);
+  if (iter == selections_.end()) {
+    return nullptr;
+  }
+  return KernelBuildInfo::KernelBuildInfoBuilder(iter->second).Build();
+}
+
+void KernelSelectCache::Put(const std::string &signature, const KernelBuildInfoPtr &build_info) {
+  MS_EXCEPTION_IF_NULL(build_info);
+  auto saved_build_info = KernelBuildInfo::KernelBuildInfoBuilder(build_info).Build();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (selections_.emplace(signature, saved_build_info).second) {
+    dirty_ = true;
+  }
+}
+}  // namespace kernel
+}  // namespace mindspore
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef MINDSPORE_CCSRC_KERNEL_KERNEL_SELECT_CACHE_H_
+#define MINDSPORE_CCSRC_KERNEL_KERNEL_SELECT_CACHE_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "kernel/kernel_build_info.h"
+#include "kernel/persistent_json_cache.h"
+#include "utils/ms_utils.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace kernel {
+class KernelAttr;
+
+// KernelSelectCache keeps the kernel build info selected for the node signatures, which consist of the device, the op
+// name, the fingerprint of the kernels registered for the op and the inferred data types of the inputs and outputs, so
+// the nodes of the same signature are selected only once. When the compile cache is enabled, the selections are also
+// saved in the compile cache directory, and a restarted job skips the kernel selection of all the nodes which have been
+// selected before, unless the registered kernels of the op are changed. The other backend stages are not cached on
+// disk: the front-end graph is cached as MindIR by the compile cache, the memory plan by SOMAS, and the kernel graphs,
+// the kernel mods and the actor sets are built from them again.
+class BACKEND_EXPORT KernelSelectCache : public PersistentJsonCache {
+ public:
+  static KernelSelectCache &GetInstance() noexcept {
+    static KernelSelectCache instance;
+    return instance;
+  }
+
+  static std::string MakeSignature(const std::string &device, const std::string &op_name,
+                                   const std::string &registry_fingerprint, const std::vector<TypeId> &input_types,
+                                   const std::vector<TypeId> &output_types, const std::vector<int64_t> &dyn_input_sizes);
+  // The fingerprint of the kernel attrs registered for an op, including the ones of the custom ops.
+  static std::string RegistryFingerprint(const std::vector<KernelAttr> &kernel_attrs);
+
+  // The build info is copied in and out, since the build info of a node may be changed after the selection.
+  KernelBuildInfoPtr Get(const std::string &signature) const;
+  void Put(const std::string &signature, const KernelBuildInfoPtr &build_info);
+
+ private:
+  KernelSelectCache();
+  ~KernelSelectCache() override = default;
+  DISABLE_COPY_AND_ASSIGN(KernelSelectCache);
+
+  size_t FromJson(const nlohmann::json &contents) override;
+  nlohmann::json ToJson() const override;
+
+  std::unordered_map<std::string, KernelBuildInfoPtr> selections_;
+};
+}  // namespace kernel
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_KERNEL_KERNEL_SELECT_CACHE_H_
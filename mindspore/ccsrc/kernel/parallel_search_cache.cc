@@ -0,0 +1,71 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "kernel/parallel_search_cache.h"
+
+#include <mutex>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+// The saved results are dropped when the version is changed.
+constexpr int kParallelSearchCacheVersion = 1;
+}  // namespace
+
+ParallelSearchCache::ParallelSearchCache() : PersistentJsonCache("parallel search cache", kParallelSearchCacheVersion) {}
+
+std::string ParallelSearchCache::MakeKey(const std::string &kernel_key, size_t count, size_t thread_num) {
+  size_t count_pow = 0;
+  while ((count >> count_pow) > 1) {
+    ++count_pow;
+  }
+  return kernel_key + "|" + std::to_string(count_pow) + "|" + std::to_string(thread_num);
+}
+
+size_t ParallelSearchCache::FromJson(const nlohmann::json &contents) {
+  size_t loaded_num = 0;
+  for (const auto &[key, best_pow] : contents.items()) {
+    if (results_.emplace(key, best_pow.get<size_t>()).second) {
+      ++loaded_num;
+    }
+  }
+  return loaded_num;
+}
+
+nlohmann::json ParallelSearchCache::ToJson() const { return results_; }
+
+bool ParallelSearchCache::Get(const std::string &key, size_t *best_pow) const {
+  MS_EXCEPTION_IF_NULL(best_pow);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = results_.find(key);
+  if (iter == results_.end()) {
+    return false;
+  }
+  *best_pow = iter->second;
+  return true;
+}
+
+void ParallelSearchCache::Put(const std::string &key, size_t best_pow) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [iter, inserted] = results_.emplace(key, best_pow);
+  if (inserted || iter->second != best_pow) {
+    iter->second = best_pow;
+    dirty_ = true;
+  }
+}
+}  // namespace kernel
+}  // namespace mindspore
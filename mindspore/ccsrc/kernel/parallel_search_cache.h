@@ -0,0 +1,57 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_KERNEL_PARALLEL_SEARCH_CACHE_H_
+#define MINDSPORE_CCSRC_KERNEL_PARALLEL_SEARCH_CACHE_H_
+
+#include <string>
+#include <unordered_map>
+#include "kernel/persistent_json_cache.h"
+#include "utils/ms_utils.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace kernel {
+// ParallelSearchCache keeps the block sizes found by the auto search of the parallel launches, as the power of 2 the
+// tasks are divided by. The kernels of the same op and data types, which launch a similar number of tasks on the same
+// number of threads, share the result and skip the search. When the compile cache is enabled, the results are also
+// saved in the compile cache directory, so a restarted job does not search again.
+class BACKEND_EXPORT ParallelSearchCache : public PersistentJsonCache {
+ public:
+  static ParallelSearchCache &GetInstance() noexcept {
+    static ParallelSearchCache instance;
+    return instance;
+  }
+
+  // The count of tasks is bucketed by its power of 2.
+  static std::string MakeKey(const std::string &kernel_key, size_t count, size_t thread_num);
+
+  bool Get(const std::string &key, size_t *best_pow) const;
+  void Put(const std::string &key, size_t best_pow);
+
+ private:
+  ParallelSearchCache();
+  ~ParallelSearchCache() override = default;
+  DISABLE_COPY_AND_ASSIGN(ParallelSearchCache);
+
+  size_t FromJson(const nlohmann::json &contents) override;
+  nlohmann::json ToJson() const override;
+
+  std::unordered_map<std::string, size_t> results_;
+};
+}  // namespace kernel
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_KERNEL_PARALLEL_SEARCH_CACHE_H_
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "kernel/persistent_json_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <utility>
+#include "utils/file_utils.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+constexpr char kKey[] = "key";
+constexpr char kContents[] = "contents";
+}  // namespace
+
+std::string PersistentJsonCache::FileKey() const {
+  return name_ + "|" + std::to_string(version_) + "|" + std::string(MSVERSION);
+}
+
+void PersistentJsonCache::Open(const std::string &file_name, bool load) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_name_ == file_name) {
+    return;
+  }
+  file_name_ = file_name;
+  size_t saved_num = 0;
+  if (!load) {
+    MS_LOG(INFO) << "Skip loading the " << name_ << " from " << file_name_;
+  } else if (!Load(&saved_num)) {
+    MS_LOG(INFO) << "Nothing is loaded from the " << name_ << " " << file_name_;
+  }
+  // The file is only rewritten when it misses some contents, such as the ones found before it is opened, so a warm
+  // job finding nothing new leaves it as it is.
+  dirty_ = dirty_ || ToJson().size() > saved_num;
+}
+
+bool PersistentJsonCache::Load(size_t *saved_num) {
+  std::ifstream ifs(file_name_);
+  if (!ifs.good()) {
+    return false;
+  }
+  try {
+    auto cache = nlohmann::json::parse(ifs);
+    if (cache.at(kKey).get<std::string>() != FileKey()) {
+      MS_LOG(WARNING) << "The " << name_ << " " << file_name_ << " is saved by another version, ignore it.";
+      return false;
+    }
+    const auto &contents = cache.at(kContents);
+    auto loaded_num = FromJson(contents);
+    *saved_num = contents.size();
+    MS_LOG(INFO) << "Load " << loaded_num << " items of the " << name_ << " from " << file_name_;
+  } catch (const std::exception &e) {
+    MS_LOG(WARNING) << "Failed to parse the " << name_ << " " << file_name_ << ", error: " << e.what();
+    return false;
+  }
+  return true;
+}
+
+bool PersistentJsonCache::Save() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_name_.empty() || !dirty_) {
+    return true;
+  }
+  nlohmann::json cache;
+  cache[kKey] = FileKey();
+  cache[kContents] = ToJson();
+
+  auto pos = file_name_.find_last_of('/');
+  if (pos != std::string::npos && !FileUtils::CreateNotExistDirs(file_name_.substr(0, pos), true).has_value()) {
+    MS_LOG(WARNING) << "Failed to create the directory of the " << name_ << " " << file_name_;
+    return false;
+  }
+  // Write a temporary file and rename it, so a job killed while saving does not leave a broken cache.
+  std::string tmp_file_name = file_name_ + ".tmp";
+  std::ofstream ofs(tmp_file_name, std::ios::out | std::ios::trunc);
+  if (!ofs.is_open()) {
+    MS_LOG(WARNING) << "Failed to open the " << name_ << " " << tmp_file_name;
+    return false;
+  }
+  ofs << cache.dump();
+  ofs.close();
+  if (!ofs.good() || std::rename(tmp_file_name.c_str(), file_name_.c_str()) != 0) {
+    MS_LOG(WARNING) << "Failed to write the " << name_ << " " << file_name_;
+    (void)std::remove(tmp_file_name.c_str());
+    return false;
+  }
+  dirty_ = false;
+  MS_LOG(INFO) << "Save " << cache[kContents].size() << " items of the " << name_ << " into " << file_name_;
+  return true;
+}
+}  // namespace kernel
+}  // namespace mindspore
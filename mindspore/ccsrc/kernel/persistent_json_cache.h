@@ -0,0 +1,67 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef MINDSPORE_CCSRC_KERNEL_PERSISTENT_JSON_CACHE_H_
+#define MINDSPORE_CCSRC_KERNEL_PERSISTENT_JSON_CACHE_H_
+
+#include <mutex>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "utils/ms_utils.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace kernel {
+// PersistentJsonCache is the base of the caches which are kept in memory and saved as json in the compile cache
+// directory, so a restarted job starts with the contents found by the previous ones. The file records the name and
+// format version of the cache and the MindSpore version, and the file of another cache or version is ignored. It is
+// written to a temporary file and renamed, so a job killed while saving does not leave a broken file.
+class BACKEND_EXPORT PersistentJsonCache {
+ public:
+  // Load the contents saved in file unless load is false, and save the new contents into it later.
+  void Open(const std::string &file_name, bool load = true);
+
+  // Save the contents into the file if it misses some of them, returns false if failed to write the file.
+  bool Save();
+
+ protected:
+  PersistentJsonCache(const std::string &name, int version) : name_(name), version_(version) {}
+  virtual ~PersistentJsonCache() = default;
+  DISABLE_COPY_AND_ASSIGN(PersistentJsonCache);
+
+  // Merge the saved contents into the cache and return the number of the new items, throws if they are malformed.
+  // The contents of this process take precedence over the saved ones. Called with mutex_ locked.
+  virtual size_t FromJson(const nlohmann::json &contents) = 0;
+  // Called with mutex_ locked.
+  virtual nlohmann::json ToJson() const = 0;
+
+  mutable std::mutex mutex_;
+  // Whether the file misses some contents of the cache, updated with mutex_ locked.
+  bool dirty_{false};
+
+ private:
+  // Load the file and get the number of the items saved in it.
+  bool Load(size_t *saved_num);
+  std::string FileKey() const;
+
+  std::string name_;
+  int version_;
+  std::string file_name_;
+};
+}  // namespace kernel
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_KERNEL_PERSISTENT_JSON_CACHE_H_
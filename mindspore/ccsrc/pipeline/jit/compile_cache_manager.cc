@@ -29,6 +29,8 @@
 #include "include/common/utils/utils.h"
 #include "frontend/parallel/step_parallel.h"
 #include "mindspore/core/utils/file_utils.h"
+#include "kernel/kernel_select_cache.h"
+#include "kernel/parallel_search_cache.h"
 
 #if defined(__linux__) && defined(WITH_BACKEND)
 #include "ps/core/node.h"
@@ -46,6 +48,8 @@ constexpr char kRoleServer[] = "server_";
 constexpr char kRolePServer[] = "pserver_";
 constexpr char kRolePScheduler[] = "pscheduler_";
 constexpr char kGroupCkptFileName[] = "group.ckpt";
+constexpr char kKernelSelectCacheFileName[] = "kernel_select_cache.json";
+constexpr char kParallelSearchCacheFileName[] = "parallel_search_cache.json";
 
 std::string GetUserDefinedCachePath() {
   auto user_defined_path = MsContext::GetInstance()->get_param<std::string>(MS_CTX_COMPILE_CACHE_PATH);
@@ -284,5 +288,15 @@ void CompileCacheManager::InitParallelGroupCkptSaveFile() {
     parallel::ParallelContext::GetInstance()->set_group_ckpt_save_file(GetGroupCkptSavePath());
   }
 }
+
+void CompileCacheManager::InitKernelSelectCache(bool load) {
+  kernel::KernelSelectCache::GetInstance().Open(GetCompileCacheDir() + "/" + GetRole() + kKernelSelectCacheFileName,
+                                                load);
+}
+
+void CompileCacheManager::InitParallelSearchCache() {
+  kernel::ParallelSearchCache::GetInstance().Open(GetCompileCacheDir() + "/" + GetRole() +
+                                                  kParallelSearchCacheFileName);
+}
 }  // namespace pipeline
 }  // namespace mindspore
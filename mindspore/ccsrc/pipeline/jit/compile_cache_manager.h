@@ -37,6 +37,11 @@ class CompileCacheManager {
   void InitCompileCacheHash(const py::list &compile_cache_dep_files);
   // Init group checkpoint file path for parallel mode.
   static void InitParallelGroupCkptSaveFile();
+  // Load the kernel selections saved by the previous jobs unless load is false, and save the new ones after compiling
+  // graphs.
+  static void InitKernelSelectCache(bool load);
+  // Load the block sizes searched for the parallel launches of CPU kernels, and save the new ones at exit.
+  static void InitParallelSearchCache();
   // Compare the dependency files hash.
   bool CheckDepFilesHashConsistency();
   // Load the cached func_graph from mindir file.
@@ -27,8 +27,13 @@
 #include "include/common/utils/summary/event_writer.h"
 #endif
 #include "include/common/utils/config_manager.h"
+#ifndef _WIN32
+#include "include/common/utils/checkpoint/checkpoint_writer.h"
+#endif
 #include "include/common/utils/mpi/mpi_config.h"
 #include "utils/ms_utils.h"
+#include "ir/tensor.h"
+#include "utils/tensor_file.h"
 #include "include/common/utils/parallel_context.h"
 #include "frontend/parallel/costmodel_context.h"
 #include "frontend/optimizer/ad/dfunctor.h"
@@ -58,6 +63,9 @@ using MetaFuncGraph = mindspore::MetaFuncGraph;
 using EventWriter = mindspore::summary::EventWriter;
 #endif  // ENABLE_SECURITY
 using OpLib = mindspore::kernel::OpLib;
+#ifndef _WIN32
+using CheckpointWriter = mindspore::checkpoint::CheckpointWriter;
+#endif
 using ParallelContext = mindspore::parallel::ParallelContext;
 using CostModelContext = mindspore::parallel::CostModelContext;
 using TensorTransform = mindspore::parallel::TensorTransform;
@@ -453,6 +461,26 @@ PYBIND11_MODULE(_c_expression, m) {
     .def("Shut", &EventWriter::Shut, "Final close the write.");
 #endif  // ENABLE_SECURITY
 
+#ifndef _WIN32
+  (void)py::class_<CheckpointWriter, std::shared_ptr<CheckpointWriter>>(m, "CheckpointWriter_")
+    .def(py::init<const std::string &, size_t>())
+    .def("Save", &CheckpointWriter::Save, "Take the snapshot of the tensors and save them in background.")
+    .def("Wait", &CheckpointWriter::Wait, py::call_guard<py::gil_scoped_release>(),
+         "Wait for the saving checkpoint to finish.");
+#endif
+
+  (void)m.def(
+    "_load_tensor_file",
+    [](const std::string &file_name, bool verify) {
+      std::vector<std::pair<std::string, mindspore::tensor::TensorPtr>> tensors;
+      if (!mindspore::LoadTensorFile(file_name, verify, &tensors)) {
+        MS_LOG(EXCEPTION) << "Failed to load the tensor file " << file_name;
+      }
+      return tensors;
+    },
+    py::arg("file_name"), py::arg("verify") = false, py::call_guard<py::gil_scoped_release>(),
+    "Load the tensors of a flat tensor file, the data is mapped and read when it is used.");
+
   (void)py::class_<OpLib, std::shared_ptr<OpLib>>(m, "Oplib")
     .def(py::init())
     .def_static("reg_op", &OpLib::RegOp, "Register op info.");
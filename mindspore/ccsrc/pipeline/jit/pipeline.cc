@@ -64,6 +64,7 @@
 #include "runtime/hardware/device_context_manager.h"
 #include "runtime/device/kernel_runtime_manager.h"
 #include "runtime/pynative/op_executor.h"
+#include "kernel/parallel_search_cache.h"
 #include "runtime/device/stream_synchronizer.h"
 #include "distributed/collective/collective_manager.h"
 #include "mindspore/ccsrc/utils/dynamic_obfuscation/dynamic_obfuscation.h"
@@ -1810,6 +1811,7 @@ void ClearResPart1() {
   // When the python process exits, the kernels on the device may not have finished executing.
   device::KernelRuntimeManager::Instance().WaitTaskFinishOnDevice();
   device::DeviceContextManager::GetInstance().WaitTaskFinishOnDevice();
+  (void)kernel::ParallelSearchCache::GetInstance().Save();
 
   RecordExitStatus();
 #ifdef ENABLE_DUMP_IR
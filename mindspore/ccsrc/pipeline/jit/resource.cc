@@ -503,13 +503,17 @@ void Resource::GetCompileCacheResource(const py::list &compile_cache_dep_files,
                                        bool *compile_cache_consistent) {
   compile_cache_manager_ = std::make_shared<CompileCacheManager>(compile_cache_id);
   compile_cache_manager_->InitParallelGroupCkptSaveFile();
+  compile_cache_manager_->InitParallelSearchCache();
   MS_EXCEPTION_IF_NULL(compile_cache_consistent);
   if (!*compile_cache_consistent) {
     MS_LOG(WARNING) << "Check the consistency of dependency files hash failed. Execute all the compilation actions.";
+    compile_cache_manager_->InitKernelSelectCache(false);
     return;
   }
   compile_cache_manager_->InitCompileCacheHash(compile_cache_dep_files);
   *compile_cache_consistent = compile_cache_manager_->CheckDepFilesHashConsistency();
+  // The kernel selections saved with other dependency files may be of other custom ops, they are selected again.
+  compile_cache_manager_->InitKernelSelectCache(*compile_cache_consistent);
   if (!*compile_cache_consistent) {
     MS_LOG(WARNING) << "Check the consistency of dependency files hash failed. Execute all the compilation actions.";
     return;
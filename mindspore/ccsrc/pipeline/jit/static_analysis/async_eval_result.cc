@@ -238,12 +238,11 @@ void AnalysisResultCacheMgr::Clear() {
 }
 
 void AnalysisResultCacheMgr::InitSwitchValue(const AnfNodeConfigPtr &conf) {
-  std::lock_guard<std::mutex> lock(lock_);
-  AsyncAbstractPtr async_eval_result = switch_cache_.get(conf);
-  if (async_eval_result == nullptr) {
-    async_eval_result = std::make_shared<AsyncAbstract>();
-    switch_cache_.set(conf, async_eval_result);
-  }
+  switch_cache_.update(conf, [](AsyncAbstractPtr *async_eval_result) {
+    if (*async_eval_result == nullptr) {
+      *async_eval_result = std::make_shared<AsyncAbstract>();
+    }
+  });
 }
 
 AbstractBasePtr AnalysisResultCacheMgr::GetSwitchValue(const AnfNodeConfigPtr &conf) {
@@ -262,27 +261,25 @@ void AnalysisResultCacheMgr::SetCacheValue(const AnfNodeConfigPtr &conf, const A
   if (current_abs == nullptr) {
     MS_LOG(EXCEPTION) << conf->ToString() << " value is nullptr";
   }
-  std::lock_guard<std::mutex> lock(lock_);
-  AsyncAbstractPtr async_eval_result = cache->get(conf);
-  if (async_eval_result == nullptr) {
-    async_eval_result = std::make_shared<AsyncAbstract>();
-    async_eval_result->set_result(current_abs);
-    cache->set(conf, async_eval_result);
-  } else {
-    auto previous_abs = async_eval_result->TryGetResult();
-    AbstractBasePtrList abstract_list;
-    if (previous_abs != nullptr) {
-      abstract_list.push_back(previous_abs);
-      abstract_list.push_back(current_abs);
-      // Join two branches's result
-      MS_LOG(DEBUG) << "Join node: " << conf->node()->DebugString() << ", previous_abs: " << previous_abs->ToString()
-                    << ", and current_abs: " << current_abs->ToString();
-      auto joined_result = AnalysisEngine::ProcessEvalResults(abstract_list, conf->node());
-      async_eval_result->set_result(joined_result->abstract());
-    } else {
-      async_eval_result->set_result(current_abs);
+  // Only the shard of conf is locked, the joins of the other switch nodes go on meanwhile.
+  cache->update(conf, [&conf, &current_abs](AsyncAbstractPtr *async_eval_result) {
+    if (*async_eval_result == nullptr) {
+      *async_eval_result = std::make_shared<AsyncAbstract>();
+      (*async_eval_result)->set_result(current_abs);
+      return;
     }
-  }
+    auto previous_abs = (*async_eval_result)->TryGetResult();
+    if (previous_abs == nullptr) {
+      (*async_eval_result)->set_result(current_abs);
+      return;
+    }
+    AbstractBasePtrList abstract_list{previous_abs, current_abs};
+    // Join two branches's result
+    MS_LOG(DEBUG) << "Join node: " << conf->node()->DebugString() << ", previous_abs: " << previous_abs->ToString()
+                  << ", and current_abs: " << current_abs->ToString();
+    auto joined_result = AnalysisEngine::ProcessEvalResults(abstract_list, conf->node());
+    (*async_eval_result)->set_result(joined_result->abstract());
+  });
 }
 
 void AnalysisResultCacheMgr::CheckSwitchValueJoinable(const AnfNodeConfigPtr &conf, const AbstractBasePtr &arg) {
@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CCSRC_PIPELINE_JIT_STATIC_ANALYSIS_ASYNC_EVAL_RESULT_H_
 #define MINDSPORE_CCSRC_PIPELINE_JIT_STATIC_ANALYSIS_ASYNC_EVAL_RESULT_H_
 
+#include <array>
 #include <iostream>
 #include <utility>
 #include <future>
@@ -114,55 +115,79 @@ class AnalysisSchedule {
   static thread_local std::string thread_id_;
 };
 
+// The cache shared by the infer threads. The entries are spread over shards by the hash of the key, and every shard
+// has its own lock, so the threads looking up different keys do not wait for each other.
 template <typename KeyType, typename ValueType, typename CacheType>
 class MultiThreadCache {
  public:
-  using iterator = typename CacheType::iterator;
-  using const_iterator = typename CacheType::const_iterator;
-
   ValueType get(const KeyType &key) {
-    std::lock_guard<std::mutex> lock(lock_);
-    auto it = cache_.find(key);
-    if (it != cache_.end()) {
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto it = shard.cache.find(key);
+    if (it != shard.cache.end()) {
       return it->second;
     }
     return nullptr;
   }
 
   void set(const KeyType &key, const ValueType &data) {
-    std::lock_guard<std::mutex> lock(lock_);
-    cache_[key] = data;
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.lock);
+    shard.cache[key] = data;
+  }
+
+  // Read, modify and write the value of the key under the lock of its shard. The value is nullptr if it is absent.
+  template <typename Func>
+  void update(const KeyType &key, const Func &func) {
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto &value = shard.cache[key];
+    func(&value);
+    if (value == nullptr) {
+      (void)shard.cache.erase(key);
+    }
   }
 
   void clear() {
-    std::lock_guard<std::mutex> lock(lock_);
-    cache_.clear();
+    for (auto &shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.lock);
+      shard.cache.clear();
+    }
   }
 
-  size_t size() { return cache_.size(); }
+  size_t size() {
+    size_t total = 0;
+    for (auto &shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.lock);
+      total += shard.cache.size();
+    }
+    return total;
+  }
 
   bool empty() { return size() == 0; }
 
   std::string dump() {
     std::ostringstream buf;
-    for (auto &item : cache_) {
-      buf << "{" << item.first->ToString() << ": " << item.second->ToString() << "}" << std::endl;
+    for (auto &shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.lock);
+      for (auto &item : shard.cache) {
+        buf << "{" << item.first->ToString() << ": " << item.second->ToString() << "}" << std::endl;
+      }
     }
     return buf.str();
   }
 
-  iterator begin() { return cache_.begin(); }
-  iterator end() { return cache_.end(); }
-
-  const_iterator begin() const { return cache_.cbegin(); }
-  const_iterator end() const { return cache_.cend(); }
+ private:
+  static constexpr size_t kShardNum = 16;
+  struct Shard {
+    std::mutex lock;
+    CacheType cache;
+  };
 
-  const_iterator cbegin() const { return cache_.cbegin(); }
-  const_iterator cend() const { return cache_.cend(); }
+  Shard &GetShard(const KeyType &key) { return shards_[hasher_(key) % kShardNum]; }
 
- private:
-  std::mutex lock_;
-  CacheType cache_;
+  typename CacheType::hasher hasher_;
+  std::array<Shard, kShardNum> shards_;
 };
 
 template <typename KeyType, typename ValueType, typename CacheType>
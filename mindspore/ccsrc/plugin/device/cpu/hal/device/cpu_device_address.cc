@@ -18,6 +18,7 @@
 #include <memory>
 #include "runtime/device/convert_tensor_utils.h"
 #include "plugin/device/cpu/hal/hardware/cpu_memory_pool.h"
+#include "plugin/device/cpu/kernel/mkldnn/mkl_primitive_cache.h"
 #ifndef ENABLE_SECURITY
 #include "debug/data_dump/dump_json_parser.h"
 #endif
@@ -53,6 +54,8 @@ void CPUDeviceAddress::DoClearDeviceMemory() {
     return;
   }
   if (from_mem_pool_) {
+    // The memory may be allocated to another weight later, which must not match the version of this one.
+    kernel::MKLWeightVersion::GetInstance().Remove(ptr_);
     CPUMemoryPool::GetInstance().FreeTensorMem(ptr_);
     ptr_ = nullptr;
   }
@@ -134,6 +137,9 @@ bool CPUDeviceAddress::SyncHostToDevice(const ShapeVector &, size_t size, TypeId
     MS_LOG(ERROR) << "The pointer ptr_ is null!";
     return false;
   }
+  // The weights prepacked by the mkldnn kernels are out of date once the host writes them, which includes the host
+  // tensor sharing the memory with the device.
+  kernel::MKLWeightVersion::GetInstance().Update(ptr_);
   if (host_ptr == ptr_) {
     MS_LOG(DEBUG) << "host_ptr is equal to ptr_, request ignored.";
     return true;
@@ -156,12 +162,14 @@ bool CPUDeviceAddress::SyncHostToDevice(const ShapeVector &, size_t size, TypeId
 
     // Use the tensor host ptr to set the device ptr.
     if (from_mem_pool_) {
+      kernel::MKLWeightVersion::GetInstance().Remove(ptr_);
       CPUMemoryPool::GetInstance().FreeTensorMem(ptr_);
       from_mem_pool_ = false;
     }
     ptr_ = const_cast<void *>(host_ptr);
     original_ref_count_ = SIZE_MAX;
     ref_count_ = SIZE_MAX;
+    kernel::MKLWeightVersion::GetInstance().Update(ptr_);
   } else if (type_id_ == kNumberTypeFloat32 && type == kNumberTypeFloat16) {
     HalfToFloat(ptr_, host_ptr, size >> 1);
   } else if (type_id_ == kNumberTypeFloat32 && type == kNumberTypeFloat64) {
@@ -193,6 +201,7 @@ bool CPUDeviceAddress::SyncDeviceToDevice(const DeviceSync *src_device_addr) con
   }
   MS_EXCEPTION_IF_NULL(src_ptr);
   MS_EXCEPTION_IF_NULL(ptr_);
+  kernel::MKLWeightVersion::GetInstance().Update(ptr_);
   if (src_type == type_id_) {
     return CopySameTypeMem(ptr_, size_, src_ptr, src_size, src_type);
   } else if (type_id_ == kNumberTypeFloat32 && src_type == kNumberTypeFloat16) {
@@ -19,6 +19,7 @@
 #include "include/common/utils/anfalgo.h"
 #include "utils/ms_context.h"
 #include "include/common/utils/convert_utils.h"
+#include "plugin/device/cpu/kernel/mkldnn/mkl_primitive_cache.h"
 namespace mindspore {
 namespace device {
 namespace cpu {
@@ -129,6 +130,12 @@ void CPUMemoryManager::MemFree(void *ptr) {
   }
 }
 
+void CPUMemoryManager::FreeMemFromMemPool(void *device_ptr) {
+  // The memory may be allocated to another weight later, which must not match the version of this one.
+  kernel::MKLWeightVersion::GetInstance().Remove(device_ptr);
+  CPUMemoryPool::GetInstance().FreeTensorMem(device_ptr);
+}
+
 void CPUMemoryManager::IncreaseSummaryRefCount(const session::NamedSummaryOutputs &summary_outputs) const {
   if (!dynamic_malloc_) {
     return;
@@ -49,7 +49,7 @@ class BACKEND_EXPORT CPUMemoryManager : public MemoryManager {
   void *MallocMemFromMemPool(size_t size, bool from_persistent_mem) override {
     return CPUMemoryPool::GetInstance().AllocTensorMem(size, from_persistent_mem);
   }
-  void FreeMemFromMemPool(void *device_ptr) override { CPUMemoryPool::GetInstance().FreeTensorMem(device_ptr); }
+  void FreeMemFromMemPool(void *device_ptr) override;
   std::vector<void *> MallocContinuousMemFromMemPool(const std::vector<size_t> &size_list) override {
     return CPUMemoryPool::GetInstance().AllocContinuousTensorMem(size_list);
   }
@@ -22,6 +22,7 @@
 #include "plugin/factory/ms_factory.h"
 #include "plugin/device/cpu/kernel/cpu_kernel.h"
 #include "kernel/oplib/oplib.h"
+#include "kernel/kernel_select_cache.h"
 #include "plugin/device/cpu/kernel/pyfunc/py_func_cpu_kernel.h"
 #include "plugin/device/cpu/kernel/custom/custom_aot_cpu_kernel.h"
 #include "plugin/device/cpu/kernel/custom/custom_julia_cpu_kernel.h"
@@ -547,9 +548,23 @@ std::pair<std::string, ExceptionType> SetKernelInfoWithMsg(const CNodePtr &kerne
   MS_LOG(INFO) << "SetKernelInfo, CNode Name: " << op_name;
   GetInputDtypes(kernel_node, &input_types);
   GetOutputDtypes(kernel_node, &output_types);
+  std::vector<int64_t> dyn_input_sizes;
+  if (common::AnfAlgo::HasNodeAttr(kAttrDynInputSizes, kernel_node)) {
+    dyn_input_sizes = common::AnfAlgo::GetNodeAttr<std::vector<int64_t>>(kernel_node, kAttrDynInputSizes);
+  }
+  auto kernel_attrs = kernel::NativeCpuKernelMod::GetCpuSupportedList(op_name);
+  // The selection only depends on the signature, so the one made for the same signature before is reused.
+  auto &select_cache = kernel::KernelSelectCache::GetInstance();
+  auto fingerprint = kernel::KernelSelectCache::RegistryFingerprint(kernel_attrs);
+  auto signature = kernel::KernelSelectCache::MakeSignature(kCPUDevice, op_name, fingerprint, input_types, output_types,
+                                                            dyn_input_sizes);
+  auto cached_build_info = select_cache.Get(signature);
+  if (cached_build_info != nullptr) {
+    AnfAlgo::SetSelectKernelBuildInfo(cached_build_info, kernel_node.get());
+    return {};
+  }
   kernel::KernelAttr selected_kernel_attr;
   std::pair<bool, bool> matched = std::make_pair(false, false);
-  auto kernel_attrs = kernel::NativeCpuKernelMod::GetCpuSupportedList(op_name);
   // If GetSkipCheck is true, that means we do not check the build info between input and registered.
   // Take the input attrs to build the kernel.
   if (!kernel_attrs.empty() && kernel_attrs[0].GetSkipCheck()) {
@@ -576,6 +591,7 @@ std::pair<std::string, ExceptionType> SetKernelInfoWithMsg(const CNodePtr &kerne
     }
   }
   SetKernelBuildInfo(input_formats, input_types, selected_output_formats, selected_output_types, kernel_node.get());
+  select_cache.Put(signature, AnfAlgo::GetSelectKernelBuildInfo(kernel_node));
   return {};
 }
 
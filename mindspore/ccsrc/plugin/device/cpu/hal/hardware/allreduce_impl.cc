@@ -16,15 +16,39 @@
 
 #include "plugin/device/cpu/hal/hardware/allreduce_impl.h"
 
+#include <unistd.h>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <numeric>
 #include <vector>
 #include <functional>
 #include <memory>
+#include "utils/ms_utils.h"
+#include "nnacl/fp32/add_fp32.h"
 
 namespace mindspore {
 namespace device {
 namespace cpu {
 namespace {
 constexpr size_t kWaitTimeout = 30;
+// The bytes sent in one message of the ring, larger chunks are forwarded segment by segment.
+constexpr char kSegmentSizeEnv[] = "MS_DEV_CPU_COLLECTIVE_SEGMENT_SIZE";
+constexpr size_t kDefaultSegmentSize = 1 << 20;
+constexpr size_t kMaxSegmentSize = 1 << 30;
+// Set to 1 to reduce on each host through shared memory before running the ring among the hosts.
+constexpr char kHierarchicalEnv[] = "MS_DEV_CPU_HIERARCHICAL_ALLREDUCE";
+// The bytes of the shared memory slot of every local rank, larger buffers are reduced in several rounds.
+constexpr size_t kShmSlotSize = 4 << 20;
+constexpr char kShmNamePrefix[] = "/mindspore_mccl_";
+constexpr size_t kGetHostNamesRetry = 20;
+constexpr uint32_t kGetHostNamesInterval = 3;
+
+void AddFloats(float *dst, const float *src, size_t num) {
+  if (num != 0) {
+    (void)ElementAdd(dst, src, dst, SizeToInt(num));
+  }
+}
 }  // namespace
 
 bool AllReduceLauncher::Initialize() {
@@ -43,11 +67,26 @@ bool AllReduceLauncher::Initialize() {
 
   node_role_ = cluster_ctx->node_role();
   rank_size_ = static_cast<size_t>(cluster_ctx->node_num(cluster_ctx->node_role()));
+
+  size_t segment_size = kDefaultSegmentSize;
+  auto segment_size_env = common::GetEnv(kSegmentSizeEnv);
+  if (!segment_size_env.empty()) {
+    auto size = std::strtol(segment_size_env.c_str(), nullptr, 0);
+    if (size > 0) {
+      segment_size = std::min(LongToSize(size), kMaxSegmentSize);
+    }
+  }
+  segment_num_ = std::max(segment_size / sizeof(float), size_t(1));
+
+  if (common::GetEnv(kHierarchicalEnv) == "1" && node_role_ != distributed::kEnvRoleOfScheduler) {
+    return InitHierarchy(cgn);
+  }
   return true;
 }
 
 bool AllReduceLauncher::Finalize() {
   MS_EXCEPTION_IF_NULL(abs_node_);
+  shm_segment_ = nullptr;
   if (!abs_node_->Finish()) {
     MS_LOG(WARNING) << "Failed to finish the cpu collective node.";
   }
@@ -58,13 +97,118 @@ bool AllReduceLauncher::Finalize() {
   return true;
 }
 
-bool AllReduceLauncher::Execute(const void *input_data, void *const output_data, size_t data_size) const {
+uint64_t AllReduceLauncher::SendAsync(uint32_t rank, const void *data, size_t size) const {
+  MS_EXCEPTION_IF_NULL(abs_node_);
+  return abs_node_->CollectiveSendAsync(ps::core::NodeRole::WORKER, rank, data, size);
+}
+
+bool AllReduceLauncher::WaitSend(uint64_t request_id) const {
+  MS_EXCEPTION_IF_NULL(abs_node_);
+  return abs_node_->Wait(request_id, kWaitTimeout);
+}
+
+bool AllReduceLauncher::Receive(uint32_t rank, std::shared_ptr<std::vector<unsigned char>> *output) const {
+  MS_EXCEPTION_IF_NULL(abs_node_);
+  auto request_id = abs_node_->CollectiveReceiveAsync(ps::core::NodeRole::WORKER, rank, output);
+  return abs_node_->CollectiveWait(request_id, kWaitTimeout);
+}
+
+bool AllReduceLauncher::InitHierarchy(const std::shared_ptr<distributed::cluster::topology::ComputeGraphNode> &cgn) {
+  MS_EXCEPTION_IF_NULL(cgn);
+  std::vector<std::string> hostnames;
+  for (size_t retry = 0; retry < kGetHostNamesRetry && hostnames.size() != rank_size_; ++retry) {
+    if (retry != 0) {
+      (void)sleep(kGetHostNamesInterval);
+    }
+    hostnames = cgn->GetHostNames(node_role_);
+  }
+  if (hostnames.size() != rank_size_ || rank_id_ >= rank_size_) {
+    MS_LOG(ERROR) << "Failed to get the hostnames of all the " << rank_size_ << " ranks, got " << hostnames.size();
+    return false;
+  }
+
+  // The hostnames are sorted by rank id, so all the ranks build the same groups and choose the same leaders.
+  std::map<std::string, uint32_t> host_leaders;
+  for (size_t rank = 0; rank < rank_size_; ++rank) {
+    if (host_leaders.emplace(hostnames[rank], SizeToUint(rank)).second) {
+      leader_ranks_.push_back(SizeToUint(rank));
+    }
+    if (hostnames[rank] == hostnames[rank_id_]) {
+      local_ranks_.push_back(SizeToUint(rank));
+    }
+  }
+  if (leader_ranks_.size() == rank_size_) {
+    MS_LOG(INFO) << "Every host runs only one rank, the hierarchical allreduce is not used.";
+    return true;
+  }
+  hierarchical_ = true;
+  MS_LOG(INFO) << "Rank " << rank_id_ << " runs the hierarchical allreduce with " << local_ranks_.size()
+               << " ranks on this host and " << leader_ranks_.size() << " hosts.";
+  return InitShmSegment();
+}
+
+bool AllReduceLauncher::InitShmSegment() {
+  size_t local_rank = LongToSize(std::distance(
+    local_ranks_.begin(), std::find(local_ranks_.begin(), local_ranks_.end(), SizeToUint(rank_id_))));
+  shm_segment_ = std::make_unique<ShmCollectiveSegment>(local_rank, local_ranks_.size(), kShmSlotSize);
+  if (local_rank != 0) {
+    std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
+    if (!Receive(local_ranks_[0], &rec_ptr)) {
+      MS_LOG(ERROR) << "Failed to receive the shared memory name from rank " << local_ranks_[0];
+      return false;
+    }
+    MS_EXCEPTION_IF_NULL(rec_ptr);
+    std::string name(rec_ptr->begin(), rec_ptr->end());
+    if (!shm_segment_->Attach(name)) {
+      return false;
+    }
+    auto send_req_id = SendAsync(local_ranks_[0], name.data(), 1);
+    return WaitSend(send_req_id);
+  }
+
+  std::string name = kShmNamePrefix + std::to_string(getpid()) + "_" + std::to_string(rank_id_);
+  if (!shm_segment_->Create(name)) {
+    return false;
+  }
+  std::vector<uint64_t> send_req_ids;
+  for (size_t i = 1; i < local_ranks_.size(); ++i) {
+    send_req_ids.push_back(SendAsync(local_ranks_[i], name.data(), name.size()));
+  }
+  for (auto send_req_id : send_req_ids) {
+    if (!WaitSend(send_req_id)) {
+      MS_LOG(ERROR) << "Failed to send the shared memory name, request id: " << send_req_id;
+      return false;
+    }
+  }
+  // The name is removed once every local rank has attached, so the segment does not outlive the job.
+  for (size_t i = 1; i < local_ranks_.size(); ++i) {
+    std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
+    if (!Receive(local_ranks_[i], &rec_ptr)) {
+      MS_LOG(ERROR) << "Rank " << local_ranks_[i] << " failed to attach the shared memory " << name;
+      return false;
+    }
+  }
+  shm_segment_->Unlink();
+  return true;
+}
+
+bool AllReduceLauncher::Execute(const void *input_data, void *const output_data, size_t data_size,
+                                GradientCompressor *compressor) const {
   MS_EXCEPTION_IF_NULL(input_data);
   MS_EXCEPTION_IF_NULL(output_data);
   // If node is scheduler, don't need to participate in the reduction.
   if (node_role_ == distributed::kEnvRoleOfScheduler) {
     return true;
   }
+  if (compressor != nullptr && compressor->sparse()) {
+    MS_LOG(DEBUG) << "AllReduceLauncher executes CompressedAllReduce algorithm on the rank " << rank_id_;
+    return CompressedAllReduce(input_data, output_data, data_size, compressor);
+  }
+  auto wire_type = compressor == nullptr ? CompressionType::kNone : compressor->type();
+  if (hierarchical_) {
+    MS_LOG(DEBUG) << "AllReduceLauncher executes HierarchicalAllReduce algorithm on the rank " << rank_id_;
+    return HierarchicalAllReduce(input_data, output_data, data_size, wire_type);
+  }
   size_t data_num = data_size / sizeof(float);
   if (data_num < rank_size_) {
     MS_LOG(DEBUG) << "AllReduceLauncher executes ReduceBroadcastAllReduce algorithm on the rank " << rank_id_;
@@ -72,108 +216,330 @@ bool AllReduceLauncher::Execute(const void *input_data, void *const output_data,
   }
   // If the data number is not less than the node number, the RingAllReduce algorithm is used.
   MS_LOG(DEBUG) << "AllReduceLauncher executes RingAllReduce algorithm on the rank " << rank_id_;
-  return RingAllReduce(input_data, output_data, data_size);
+  return RingAllReduce(input_data, output_data, data_size, wire_type);
 }
 
-bool AllReduceLauncher::RingAllReduce(const void *input_data, void *const output_data, size_t data_size) const {
-  int memcpy_ret = memcpy_s(output_data, data_size, input_data, data_size);
+bool AllReduceLauncher::ReduceScatter(const void *input_data, void *const output_data, size_t output_size) const {
+  MS_EXCEPTION_IF_NULL(input_data);
+  MS_EXCEPTION_IF_NULL(output_data);
+  if (node_role_ == distributed::kEnvRoleOfScheduler || output_size == 0) {
+    return true;
+  }
+  MS_EXCEPTION_IF_CHECK_FAIL((rank_size_ != 0), "The rank size is zero.");
+  size_t block_num = output_size / sizeof(float);
+  std::vector<float> buff(block_num * rank_size_);
+  int memcpy_ret = memcpy_s(buff.data(), buff.size() * sizeof(float), input_data, buff.size() * sizeof(float));
   if (memcpy_ret != EOK) {
-    MS_LOG(ERROR) << "RingAllReduce memcpy_s input_data error, errorno(" << memcpy_ret << ")";
+    MS_LOG(ERROR) << "ReduceScatter memcpy_s input_data error, errorno(" << memcpy_ret << ")";
     return false;
   }
-  MS_EXCEPTION_IF_CHECK_FAIL((rank_size_ != 0), "The rank size is zero.");
-  size_t data_num = data_size / sizeof(float);
-  size_t chunk_size = data_num / rank_size_;
-  size_t remainder_size = data_num % rank_size_;
-  std::vector<size_t> chunk_sizes(rank_size_, chunk_size);
+  std::vector<uint32_t> ranks(rank_size_);
+  std::iota(ranks.begin(), ranks.end(), 0);
+  auto layout = MakeRingLayout(ranks, rank_id_, buff.size());
+  // Starting one chunk earlier than the ring allreduce leaves the sum of the chunk rank_id_ on this rank.
+  if (!RingPass(buff.data(), layout, (rank_id_ + rank_size_ - 1) % rank_size_, true)) {
+    return false;
+  }
+  memcpy_ret = memcpy_s(output_data, output_size, buff.data() + layout.chunk_offsets[rank_id_],
+                        block_num * sizeof(float));
+  if (memcpy_ret != EOK) {
+    MS_LOG(ERROR) << "ReduceScatter memcpy_s output_data error, errorno(" << memcpy_ret << ")";
+    return false;
+  }
+  return true;
+}
+
+bool AllReduceLauncher::AllToAll(const void *input_data, void *const output_data, size_t block_size) const {
+  MS_EXCEPTION_IF_NULL(input_data);
+  MS_EXCEPTION_IF_NULL(output_data);
+  if (node_role_ == distributed::kEnvRoleOfScheduler || block_size == 0) {
+    return true;
+  }
+  const auto *input_buff = reinterpret_cast<const uint8_t *>(input_data);
+  auto *output_buff = reinterpret_cast<uint8_t *>(output_data);
+  int memcpy_ret =
+    memcpy_s(output_buff + rank_id_ * block_size, block_size, input_buff + rank_id_ * block_size, block_size);
+  if (memcpy_ret != EOK) {
+    MS_LOG(ERROR) << "AllToAll memcpy_s input_data error, errorno(" << memcpy_ret << ")";
+    return false;
+  }
+  // At step i every rank sends to the rank i after it and receives from the rank i before it, so no rank is the target
+  // of several ranks at the same time.
+  std::vector<uint64_t> send_req_ids;
+  for (size_t i = 1; i < rank_size_; ++i) {
+    size_t peer = (rank_id_ + i) % rank_size_;
+    send_req_ids.push_back(SendAsync(SizeToUint(peer), input_buff + peer * block_size, block_size));
+  }
+  for (size_t i = 1; i < rank_size_; ++i) {
+    size_t peer = (rank_id_ + rank_size_ - i) % rank_size_;
+    std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
+    if (!Receive(SizeToUint(peer), &rec_ptr)) {
+      MS_LOG(ERROR) << "AllToAll wait receiving from rank " << peer << " failed.";
+      return false;
+    }
+    MS_EXCEPTION_IF_NULL(rec_ptr);
+    memcpy_ret = memcpy_s(output_buff + peer * block_size, block_size, rec_ptr->data(), rec_ptr->size());
+    if (memcpy_ret != EOK) {
+      MS_LOG(ERROR) << "AllToAll memcpy_s received data error, errorno(" << memcpy_ret << ")";
+      return false;
+    }
+  }
+  for (auto send_req_id : send_req_ids) {
+    if (!WaitSend(send_req_id)) {
+      MS_LOG(ERROR) << "AllToAll wait sending " << send_req_id << " failed.";
+      return false;
+    }
+  }
+  return true;
+}
+
+AllReduceLauncher::RingLayout AllReduceLauncher::MakeRingLayout(const std::vector<uint32_t> &ranks, size_t pos,
+                                                                size_t data_num) const {
+  size_t ring_size = ranks.size();
+  MS_EXCEPTION_IF_CHECK_FAIL((ring_size != 0), "The ring size is zero.");
+  RingLayout layout{ranks, pos, std::vector<size_t>(ring_size, data_num / ring_size), {}};
   // The rest of the data should be assigned to each chunk.
-  for (size_t i = 0; i < remainder_size; i++) {
-    chunk_sizes[i]++;
+  for (size_t i = 0; i < data_num % ring_size; i++) {
+    layout.chunk_sizes[i]++;
   }
   // Store offsets to get every data chunk's address.
-  std::vector<size_t> chunk_offset;
-  for (size_t i = 0; i < rank_size_; i++) {
-    size_t ofs =
-      std::accumulate(chunk_sizes.begin(), chunk_sizes.begin() + SizeToLong(i), size_t(0), std::plus<size_t>());
-    chunk_offset.push_back(ofs);
+  size_t offset = 0;
+  for (size_t i = 0; i < ring_size; i++) {
+    layout.chunk_offsets.push_back(offset);
+    offset += layout.chunk_sizes[i];
+  }
+  return layout;
+}
+
+bool AllReduceLauncher::RingPass(float *buff, const RingLayout &layout, size_t first_send_chunk, bool reduce,
+                                 CompressionType wire_type) const {
+  MS_EXCEPTION_IF_NULL(buff);
+  size_t ring_size = layout.ranks.size();
+  if (ring_size <= 1) {
+    return true;
+  }
+  uint32_t send_to_rank = layout.ranks[(layout.pos + 1) % ring_size];
+  uint32_t rec_from_rank = layout.ranks[(layout.pos + ring_size - 1) % ring_size];
+  bool half = wire_type == CompressionType::kFp16 || wire_type == CompressionType::kBf16;
+  bool bf16 = wire_type == CompressionType::kBf16;
+  size_t wire_size = half ? sizeof(uint16_t) : sizeof(float);
+  // The cast segments are kept until their sending is done.
+  using HalfBuffers = std::deque<std::vector<uint16_t>>;
+  auto send_segments = [&](float *data, size_t data_num, std::vector<uint64_t> *send_req_ids, HalfBuffers *buffers) {
+    for (size_t begin = 0; begin < data_num; begin += segment_num_) {
+      size_t num = std::min(segment_num_, data_num - begin);
+      const void *wire_data = data + begin;
+      if (half) {
+        buffers->emplace_back(num);
+        Float32ToHalf(data + begin, num, buffers->back().data(), bf16);
+        wire_data = buffers->back().data();
+      }
+      send_req_ids->push_back(SendAsync(send_to_rank, wire_data, num * wire_size));
+    }
+  };
+
+  std::vector<uint64_t> send_req_ids;
+  HalfBuffers send_buffers;
+  std::vector<float> decoded;
+  send_segments(buff + layout.chunk_offsets[first_send_chunk], layout.chunk_sizes[first_send_chunk], &send_req_ids,
+                &send_buffers);
+  for (size_t i = 0; i < ring_size - 1; i++) {
+    size_t rec_chunk_index = (first_send_chunk + ring_size - i - 1) % ring_size;
+    float *rec_chunk = buff + layout.chunk_offsets[rec_chunk_index];
+    size_t rec_num = layout.chunk_sizes[rec_chunk_index];
+    MS_LOG(DEBUG) << "Ring " << (reduce ? "ReduceScatter" : "AllGather") << " send_to_rank:" << send_to_rank
+                  << ", rec_from_rank:" << rec_from_rank << ", rec data_num:" << rec_num << ", iteration:" << i;
+
+    // The chunk received at this step is sent at the next one. Each segment is forwarded as soon as it is ready, so the
+    // reduction of a segment overlaps the transfer of the others.
+    bool forward = i + 2 < ring_size;
+    std::vector<uint64_t> next_send_req_ids;
+    HalfBuffers next_send_buffers;
+    for (size_t begin = 0; begin < rec_num; begin += segment_num_) {
+      size_t num = std::min(segment_num_, rec_num - begin);
+      std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
+      if (!Receive(rec_from_rank, &rec_ptr)) {
+        MS_LOG(ERROR) << "Ring wait receiving from rank " << rec_from_rank << " failed.";
+        return false;
+      }
+      MS_EXCEPTION_IF_NULL(rec_ptr);
+      if (rec_ptr->size() != num * wire_size) {
+        MS_LOG(ERROR) << "Ring received " << rec_ptr->size() << " bytes from rank " << rec_from_rank << ", but "
+                      << num * wire_size << " bytes are expected.";
+        return false;
+      }
+      const auto *rec_data = reinterpret_cast<const float *>(rec_ptr->data());
+      if (half) {
+        decoded.resize(num);
+        HalfToFloat32(reinterpret_cast<const uint16_t *>(rec_ptr->data()), num, decoded.data(), bf16);
+        rec_data = decoded.data();
+      }
+      if (reduce) {
+        AddFloats(rec_chunk + begin, rec_data, num);
+      } else {
+        int memcpy_ret = memcpy_s(rec_chunk + begin, (rec_num - begin) * sizeof(float), rec_data, num * sizeof(float));
+        if (memcpy_ret != EOK) {
+          MS_LOG(ERROR) << "Ring AllGather memcpy_s received data error, errorno(" << memcpy_ret << ")";
+          return false;
+        }
+      }
+      if (forward) {
+        send_segments(rec_chunk + begin, num, &next_send_req_ids, &next_send_buffers);
+      }
+    }
+    for (auto send_req_id : send_req_ids) {
+      if (!WaitSend(send_req_id)) {
+        MS_LOG(ERROR) << "Ring wait sending " << send_req_id << " failed.";
+        return false;
+      }
+    }
+    send_req_ids.swap(next_send_req_ids);
+    send_buffers.swap(next_send_buffers);
   }
+  return true;
+}
 
+bool AllReduceLauncher::RingAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                                      const std::vector<uint32_t> &ranks, size_t pos,
+                                      CompressionType wire_type) const {
+  if (input_data != output_data) {
+    int memcpy_ret = memcpy_s(output_data, data_size, input_data, data_size);
+    if (memcpy_ret != EOK) {
+      MS_LOG(ERROR) << "RingAllReduce memcpy_s input_data error, errorno(" << memcpy_ret << ")";
+      return false;
+    }
+  }
+  size_t data_num = data_size / sizeof(float);
+  auto layout = MakeRingLayout(ranks, pos, data_num);
   auto *output_buff = reinterpret_cast<float *>(output_data);
-  uint32_t send_to_rank = SizeToUint((rank_id_ + 1) % rank_size_);
-  uint32_t rec_from_rank = SizeToUint((rank_id_ - 1 + rank_size_) % rank_size_);
-  MS_LOG(DEBUG) << "AllReduce data_num:" << data_num << ", rank_size_:" << rank_size_ << ", rank_id_:" << rank_id_
-                << ", chunk_size:" << chunk_size << ", remainder_size:" << remainder_size
-                << ", chunk_sizes:" << chunk_sizes << ", send_to_rank:" << send_to_rank
-                << ", rec_from_rank:" << rec_from_rank;
+  size_t ring_size = ranks.size();
+  MS_LOG(DEBUG) << "AllReduce data_num:" << data_num << ", ring_size:" << ring_size << ", pos:" << pos
+                << ", chunk_sizes:" << layout.chunk_sizes << ", segment_num:" << segment_num_;
 
-  // Ring ReduceScatter.
   MS_LOG(DEBUG) << "Start Ring ReduceScatter.";
-  MS_EXCEPTION_IF_NULL(abs_node_);
-  for (size_t i = 0; i < rank_size_ - 1; i++) {
-    // Step 1: Async send data to next rank.
-    size_t send_chunk_index = (rank_id_ - i + rank_size_) % rank_size_;
-    float *send_chunk = output_buff + chunk_offset[send_chunk_index];
-    auto send_req_id = abs_node_->CollectiveSendAsync(ps::core::NodeRole::WORKER, send_to_rank, send_chunk,
-                                                      chunk_sizes[send_chunk_index] * sizeof(float));
-    // Step 2: Async receive data to next rank and wait until it's done.
-    size_t rec_chunk_index = (rank_id_ - i - 1 + rank_size_) % rank_size_;
-    float *rec_chunk = output_buff + chunk_offset[rec_chunk_index];
-    MS_LOG(DEBUG) << "Ring ReduceScatter send_to_rank:" << send_to_rank << ", rec_from_rank:" << rec_from_rank
-                  << ", send data_num:" << chunk_sizes[send_chunk_index]
-                  << ", rec data_num:" << chunk_sizes[rec_chunk_index] << ", iteration:" << i;
+  if (!RingPass(output_buff, layout, (pos + ring_size - 1) % ring_size, true, wire_type)) {
+    return false;
+  }
+  MS_LOG(DEBUG) << "End Ring ReduceScatter.";
+
+  if (wire_type == CompressionType::kFp16 || wire_type == CompressionType::kBf16) {
+    // The other ranks only get the chunk reduced here in 16 bits, so it is rounded the same way on this rank.
+    float *own_chunk = output_buff + layout.chunk_offsets[pos];
+    std::vector<uint16_t> rounded(layout.chunk_sizes[pos]);
+    Float32ToHalf(own_chunk, rounded.size(), rounded.data(), wire_type == CompressionType::kBf16);
+    HalfToFloat32(rounded.data(), rounded.size(), own_chunk, wire_type == CompressionType::kBf16);
+  }
 
+  MS_LOG(DEBUG) << "Start Ring AllGather.";
+  if (!RingPass(output_buff, layout, pos, false, wire_type)) {
+    return false;
+  }
+  MS_LOG(DEBUG) << "End Ring AllGather.";
+  return true;
+}
+
+bool AllReduceLauncher::RingAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                                      CompressionType wire_type) const {
+  MS_EXCEPTION_IF_CHECK_FAIL((rank_size_ != 0), "The rank size is zero.");
+  std::vector<uint32_t> ranks(rank_size_);
+  std::iota(ranks.begin(), ranks.end(), 0);
+  return RingAllReduce(input_data, output_data, data_size, ranks, rank_id_, wire_type);
+}
+
+bool AllReduceLauncher::CompressedAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                                            GradientCompressor *compressor) const {
+  MS_EXCEPTION_IF_NULL(compressor);
+  MS_EXCEPTION_IF_CHECK_FAIL((rank_size_ != 0), "The rank size is zero.");
+  size_t data_num = data_size / sizeof(float);
+  std::vector<std::vector<uint8_t>> payloads(rank_size_);
+  if (!compressor->Compress(input_data, reinterpret_cast<const float *>(input_data), data_num,
+                            &payloads[rank_id_])) {
+    return false;
+  }
+
+  // The payloads differ in size, so each of them goes around the ring as a whole.
+  uint32_t send_to_rank = SizeToUint((rank_id_ + 1) % rank_size_);
+  uint32_t rec_from_rank = SizeToUint((rank_id_ + rank_size_ - 1) % rank_size_);
+  for (size_t i = 0; i + 1 < rank_size_; i++) {
+    const auto &send_payload = payloads[(rank_id_ + rank_size_ - i) % rank_size_];
+    auto send_req_id = SendAsync(send_to_rank, send_payload.data(), send_payload.size());
     std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
-    auto rec_req_id = abs_node_->CollectiveReceiveAsync(ps::core::NodeRole::WORKER, rec_from_rank, &rec_ptr);
-    if (!abs_node_->CollectiveWait(rec_req_id, kWaitTimeout)) {
-      MS_LOG(ERROR) << "Ring ReduceScatter wait receiving [" << rec_req_id.first << "," << rec_req_id.second
-                    << "] failed.";
+    if (!Receive(rec_from_rank, &rec_ptr)) {
+      MS_LOG(ERROR) << "CompressedAllReduce wait receiving from rank " << rec_from_rank << " failed.";
       return false;
     }
-    // Step 3: Reduce the data, so we can overlap the time cost of send.
     MS_EXCEPTION_IF_NULL(rec_ptr);
-    const auto *tmp_data = reinterpret_cast<float *>(rec_ptr->data());
-    for (size_t j = 0; j < chunk_sizes[rec_chunk_index]; j++) {
-      rec_chunk[j] += tmp_data[j];
+    payloads[(rank_id_ + rank_size_ - i - 1) % rank_size_].assign(rec_ptr->begin(), rec_ptr->end());
+    if (!WaitSend(send_req_id)) {
+      MS_LOG(ERROR) << "CompressedAllReduce wait sending " << send_req_id << " failed.";
+      return false;
     }
-    // Step 4: Wait until send is done.
-    if (!abs_node_->Wait(send_req_id, kWaitTimeout)) {
-      MS_LOG(ERROR) << "Ring ReduceScatter wait sending " << send_req_id << " failed.";
+  }
+
+  // Every rank sums the payloads in the order of the ranks, so that they all get the same result.
+  auto *output_buff = reinterpret_cast<float *>(output_data);
+  std::fill(output_buff, output_buff + data_num, 0.0f);
+  for (const auto &payload : payloads) {
+    if (!compressor->DecompressAdd(payload.data(), payload.size(), output_buff, data_num)) {
       return false;
     }
   }
-  MS_LOG(DEBUG) << "End Ring ReduceScatter.";
+  return true;
+}
 
-  // Ring AllGather.
-  MS_LOG(DEBUG) << "Start Ring AllGather.";
-  for (size_t i = 0; i < rank_size_ - 1; i++) {
-    size_t send_chunk_index = (rank_id_ - i + 1 + rank_size_) % rank_size_;
-    float *send_chunk = output_buff + chunk_offset[send_chunk_index];
-    auto send_req_id = abs_node_->CollectiveSendAsync(ps::core::NodeRole::WORKER, send_to_rank, send_chunk,
-                                                      chunk_sizes[send_chunk_index] * sizeof(float));
-    size_t rec_chunk_index = (rank_id_ - i + rank_size_) % rank_size_;
-    float *rec_chunk = output_buff + chunk_offset[rec_chunk_index];
-    MS_LOG(DEBUG) << "Ring AllGather send_to_rank:" << send_to_rank << ", rec_from_rank:" << rec_from_rank
-                  << ", send data_num:" << chunk_sizes[send_chunk_index]
-                  << ", rec data_num:" << chunk_sizes[rec_chunk_index] << ", iteration:" << i;
+bool AllReduceLauncher::HierarchicalAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                                              CompressionType wire_type) const {
+  MS_EXCEPTION_IF_NULL(shm_segment_);
+  const auto *input_buff = reinterpret_cast<const float *>(input_data);
+  auto *output_buff = reinterpret_cast<float *>(output_data);
+  size_t local_rank = shm_segment_->local_rank();
+  size_t local_size = shm_segment_->local_size();
+  float *local_slot = shm_segment_->slot(local_rank);
+  float *reduced_slot = shm_segment_->slot(0);
+  size_t leader_pos = LongToSize(std::distance(
+    leader_ranks_.begin(), std::find(leader_ranks_.begin(), leader_ranks_.end(), SizeToUint(rank_id_))));
 
-    std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
-    auto rec_req_id = abs_node_->CollectiveReceiveAsync(ps::core::NodeRole::WORKER, rec_from_rank, &rec_ptr);
-    if (!abs_node_->CollectiveWait(rec_req_id, kWaitTimeout)) {
-      MS_LOG(ERROR) << "Ring AllGather wait receiving " << rec_req_id << " failed.";
+  size_t data_num = data_size / sizeof(float);
+  size_t round_num = shm_segment_->slot_size() / sizeof(float);
+  for (size_t offset = 0; offset < data_num; offset += round_num) {
+    size_t num = std::min(round_num, data_num - offset);
+    int memcpy_ret = memcpy_s(local_slot, shm_segment_->slot_size(), input_buff + offset, num * sizeof(float));
+    if (memcpy_ret != EOK) {
+      MS_LOG(ERROR) << "HierarchicalAllReduce memcpy_s input_data error, errorno(" << memcpy_ret << ")";
       return false;
     }
-    MS_EXCEPTION_IF_NULL(rec_ptr);
-    memcpy_ret = memcpy_s(rec_chunk, chunk_sizes[rec_chunk_index] * sizeof(float), rec_ptr->data(), rec_ptr->size());
-    if (memcpy_ret != 0) {
-      MS_LOG(ERROR) << "Ring AllGather memcpy_s received data error, errorno(" << memcpy_ret << ")";
+    if (!shm_segment_->Barrier(kWaitTimeout)) {
+      return false;
+    }
+
+    // Every local rank sums its share of all the slots into the slot of the first local rank.
+    size_t begin = num * local_rank / local_size;
+    size_t end = num * (local_rank + 1) / local_size;
+    for (size_t i = 1; i < local_size; ++i) {
+      AddFloats(reduced_slot + begin, shm_segment_->slot(i) + begin, end - begin);
+    }
+    if (!shm_segment_->Barrier(kWaitTimeout)) {
       return false;
     }
-    if (!abs_node_->Wait(send_req_id, kWaitTimeout)) {
-      MS_LOG(ERROR) << "RingAllReduce wait sending " << send_req_id << " failed.";
+
+    if (local_rank == 0 && leader_ranks_.size() > 1 &&
+        !RingAllReduce(reduced_slot, reduced_slot, num * sizeof(float), leader_ranks_, leader_pos, wire_type)) {
+      return false;
+    }
+    if (!shm_segment_->Barrier(kWaitTimeout)) {
+      return false;
+    }
+
+    memcpy_ret = memcpy_s(output_buff + offset, (data_num - offset) * sizeof(float), reduced_slot, num * sizeof(float));
+    if (memcpy_ret != EOK) {
+      MS_LOG(ERROR) << "HierarchicalAllReduce memcpy_s output_data error, errorno(" << memcpy_ret << ")";
+      return false;
+    }
+    // The slot of the first local rank is overwritten by the next round.
+    if (!shm_segment_->Barrier(kWaitTimeout)) {
       return false;
     }
   }
-  MS_LOG(DEBUG) << "End Ring AllGather.";
   return true;
 }
 
@@ -190,14 +556,12 @@ bool AllReduceLauncher::ReduceBroadcastAllReduce(const void *input_data, void *c
   float *output_buff = reinterpret_cast<float *>(output_data);
   // Reduce data to rank 0 process.
   MS_LOG(DEBUG) << "Start Reduce to rank 0 process.";
-  MS_EXCEPTION_IF_NULL(abs_node_);
   if (rank_id_ == 0) {
     for (uint32_t i = 1; i < rank_size_; i++) {
       std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
       MS_LOG(DEBUG) << "Reduce rank 0 receive from rank " << i;
-      auto rec_req_id = abs_node_->CollectiveReceiveAsync(ps::core::NodeRole::WORKER, i, &rec_ptr);
-      if (!abs_node_->CollectiveWait(rec_req_id, kWaitTimeout)) {
-        MS_LOG(ERROR) << "Reduce wait receiving " << rec_req_id << " failed.";
+      if (!Receive(i, &rec_ptr)) {
+        MS_LOG(ERROR) << "Reduce wait receiving from rank " << i << " failed.";
         return false;
       }
       MS_EXCEPTION_IF_NULL(rec_ptr);
@@ -208,9 +572,8 @@ bool AllReduceLauncher::ReduceBroadcastAllReduce(const void *input_data, void *c
     }
   } else {
     MS_LOG(DEBUG) << "Reduce send data to rank 0 process.";
-    auto send_req_id =
-      abs_node_->CollectiveSendAsync(ps::core::NodeRole::WORKER, 0, input_data, data_num * sizeof(float));
-    if (!abs_node_->Wait(send_req_id, kWaitTimeout)) {
+    auto send_req_id = SendAsync(0, input_data, data_num * sizeof(float));
+    if (!WaitSend(send_req_id)) {
       MS_LOG(ERROR) << "Reduce wait sending " << send_req_id << " failed.";
       return false;
     }
@@ -222,9 +585,8 @@ bool AllReduceLauncher::ReduceBroadcastAllReduce(const void *input_data, void *c
   if (rank_id_ == 0) {
     for (uint32_t i = 1; i < rank_size_; i++) {
       MS_LOG(DEBUG) << "Broadcast data to process " << i;
-      auto send_req_id =
-        abs_node_->CollectiveSendAsync(ps::core::NodeRole::WORKER, i, output_buff, data_num * sizeof(float));
-      if (!abs_node_->Wait(send_req_id, kWaitTimeout)) {
+      auto send_req_id = SendAsync(i, output_buff, data_num * sizeof(float));
+      if (!WaitSend(send_req_id)) {
         MS_LOG(ERROR) << "Broadcast wait sending " << send_req_id << " failed.";
         return false;
       }
@@ -232,9 +594,8 @@ bool AllReduceLauncher::ReduceBroadcastAllReduce(const void *input_data, void *c
   } else {
     MS_LOG(DEBUG) << "Broadcast receive from rank 0.";
     std::shared_ptr<std::vector<unsigned char>> rec_ptr = nullptr;
-    auto rec_req_id = abs_node_->CollectiveReceiveAsync(ps::core::NodeRole::WORKER, 0, &rec_ptr);
-    if (!abs_node_->CollectiveWait(rec_req_id, kWaitTimeout)) {
-      MS_LOG(ERROR) << "Broadcast wait receiving " << rec_req_id << " failed.";
+    if (!Receive(0, &rec_ptr)) {
+      MS_LOG(ERROR) << "Broadcast wait receiving from rank 0 failed.";
       return false;
     }
     MS_EXCEPTION_IF_NULL(rec_ptr);
@@ -19,8 +19,11 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "distributed/cluster/cluster_context.h"
 #include "plugin/device/cpu/hal/hardware/ms_collective_node.h"
+#include "plugin/device/cpu/hal/hardware/ms_collective_shm.h"
+#include "plugin/device/cpu/hal/hardware/ms_collective_compressor.h"
 
 namespace mindspore {
 namespace device {
@@ -30,23 +33,71 @@ class AllReduceLauncher {
   AllReduceLauncher(const AllReduceLauncher &) = delete;
   AllReduceLauncher &operator=(const AllReduceLauncher &) = delete;
   AllReduceLauncher() = default;
-  ~AllReduceLauncher() = default;
+  virtual ~AllReduceLauncher() = default;
 
   bool Initialize();
   bool Finalize();
 
-  bool Execute(const void *input_data, void *const output_data, size_t data_size) const;
+  // The gradients are compressed if the compressor is not nullptr: fp16 and bf16 are the types sent on the ring, while
+  // the top-k and 1-bit payloads are gathered by every rank and summed locally.
+  bool Execute(const void *input_data, void *const output_data, size_t data_size,
+               GradientCompressor *compressor = nullptr) const;
+
+  // Sum the float32 input of every rank and scatter the result, rank i gets the i-th block of output_size bytes.
+  bool ReduceScatter(const void *input_data, void *const output_data, size_t output_size) const;
+
+  // Send the i-th block of block_size bytes of the input to rank i, the block received from rank i is written to the
+  // i-th block of the output.
+  bool AllToAll(const void *input_data, void *const output_data, size_t block_size) const;
 
   const std::shared_ptr<ps::core::CollectiveNode> &collective_node() const;
 
  private:
+  // The ring formed by a subset of the ranks, and the float32 chunks the buffer is split into, one for each rank.
+  struct RingLayout {
+    std::vector<uint32_t> ranks;
+    size_t pos;
+    std::vector<size_t> chunk_sizes;
+    std::vector<size_t> chunk_offsets;
+  };
+
   size_t rank_id_{0};
   size_t rank_size_{0};
   std::string node_role_{distributed::kEnvRoleOfWorker};
   std::shared_ptr<ps::core::CollectiveNode> abs_node_{nullptr};
 
-  bool RingAllReduce(const void *input_data, void *const output_data, size_t data_size) const;
+  // The number of floats sent in one message, chunks larger than it are pipelined segment by segment.
+  size_t segment_num_{0};
+
+  // The ranks on this host reduce through shared memory, then the first rank of each host runs the ring among hosts.
+  bool hierarchical_{false};
+  std::vector<uint32_t> local_ranks_;
+  std::vector<uint32_t> leader_ranks_;
+  std::unique_ptr<ShmCollectiveSegment> shm_segment_{nullptr};
+
+  // The messages between the workers, which go through the collective node.
+  virtual uint64_t SendAsync(uint32_t rank, const void *data, size_t size) const;
+  virtual bool WaitSend(uint64_t request_id) const;
+  virtual bool Receive(uint32_t rank, std::shared_ptr<std::vector<unsigned char>> *output) const;
+
+  bool InitHierarchy(const std::shared_ptr<distributed::cluster::topology::ComputeGraphNode> &cgn);
+  bool InitShmSegment();
+
+  RingLayout MakeRingLayout(const std::vector<uint32_t> &ranks, size_t pos, size_t data_num) const;
+  // Step i sends the chunk first_send_chunk - i to the next rank and receives the chunk before it from the previous
+  // rank, which is added to the buffer if reduce is true and copied to it otherwise. The segments are cast to fp16 or
+  // bf16 on the wire if wire_type is one of them.
+  bool RingPass(float *buff, const RingLayout &layout, size_t first_send_chunk, bool reduce,
+                CompressionType wire_type = CompressionType::kNone) const;
+  bool RingAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                     const std::vector<uint32_t> &ranks, size_t pos, CompressionType wire_type) const;
+  bool RingAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                     CompressionType wire_type = CompressionType::kNone) const;
   bool ReduceBroadcastAllReduce(const void *input_data, void *const output_data, size_t data_size) const;
+  bool HierarchicalAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                             CompressionType wire_type) const;
+  bool CompressedAllReduce(const void *input_data, void *const output_data, size_t data_size,
+                           GradientCompressor *compressor) const;
 };
 }  // namespace cpu
 }  // namespace device
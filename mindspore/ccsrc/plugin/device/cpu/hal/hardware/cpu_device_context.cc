@@ -25,6 +25,7 @@
 #endif
 #include "plugin/factory/ms_factory.h"
 #include "plugin/device/cpu/kernel/cpu_kernel.h"
+#include "plugin/device/cpu/kernel/mkldnn/mkl_primitive_cache.h"
 #include "kernel/kernel_build_info.h"
 #include "plugin/device/cpu/hal/device/kernel_select_cpu.h"
 #include "utils/trace_base.h"
@@ -241,6 +242,30 @@ void SetKernelInfoBeforeCreateKernel(const std::vector<CNodePtr> &nodes) {
     }
   }
 }
+
+// The kernels of the same op and data types share the block size searched for the parallel launch.
+std::string GetParallelSearchKey(const CNodePtr &node, const std::string &kernel_name) {
+  std::string key = kernel_name;
+  if (common::AnfAlgo::GetInputTensorNum(node) > 0) {
+    key += "_" + TypeIdLabel(AnfAlgo::GetInputDeviceDataType(node, 0));
+  }
+  if (common::AnfAlgo::GetOutputTensorNum(node) > 0) {
+    key += "_" + TypeIdLabel(AnfAlgo::GetOutputDeviceDataType(node, 0));
+  }
+  return key;
+}
+
+// The inputs fed by the weights, which only change when the host or the ops updating them write them.
+std::vector<bool> GetWeightInputs(const CNodePtr &node) {
+  size_t input_num = common::AnfAlgo::GetInputTensorNum(node);
+  std::vector<bool> weight_inputs(input_num, false);
+  for (size_t i = 0; i < input_num; ++i) {
+    auto input = common::AnfAlgo::VisitKernelWithReturnType(common::AnfAlgo::GetInputNode(node, i), 0, true).first;
+    MS_EXCEPTION_IF_NULL(input);
+    weight_inputs[i] = input->isa<Parameter>() && common::AnfAlgo::IsParameterWeight(input->cast<ParameterPtr>());
+  }
+  return weight_inputs;
+}
 }  // namespace
 
 void CPUKernelExecutor::SetOperatorInfo(const KernelGraphPtr &graph) const {
@@ -314,6 +339,8 @@ void CPUKernelExecutor::CreateKernel(const std::vector<CNodePtr> &nodes) const {
     if (cpu_kernel == nullptr) {
       MS_LOG(EXCEPTION) << "Build cpu operator[" << node->fullname_with_scope() << "] failed";
     }
+    cpu_kernel->parallel_search_info_.kernel_key = GetParallelSearchKey(node, kernel_name);
+    cpu_kernel->set_weight_inputs(GetWeightInputs(node));
 
     // This branch would be removed When KernelMode rectification is complete
     auto discard_cpu_kernel_mod = std::dynamic_pointer_cast<kernel::DeprecatedNativeCpuKernelMod>(cpu_kernel);
@@ -395,12 +422,14 @@ bool CPUKernelExecutor::LaunchKernel(const CNodePtr &kernel, const std::vector<A
   if (profiler_inst->GetEnableFlag()) {
     MS_LOG(DEBUG) << "Begin launch kernel: " << kernel->fullname_with_scope();
     auto ret = LaunchKernelWithProfiling(kernel, inputs, workspace, outputs);
+    kernel::MKLWeightVersion::GetInstance().UpdateWrittenBy(kernel, inputs, outputs);
     MS_LOG(DEBUG) << "End launch kernel: " << kernel->fullname_with_scope();
     return ret;
   }
 #endif
   MS_LOG(DEBUG) << "Begin launch kernel: " << kernel->fullname_with_scope();
   auto ret = DoLaunchKernel(kernel_mod, inputs, workspace, outputs);
+  kernel::MKLWeightVersion::GetInstance().UpdateWrittenBy(kernel, inputs, outputs);
   MS_LOG(DEBUG) << "End launch kernel: " << kernel->fullname_with_scope();
   return ret;
 }
@@ -16,6 +16,7 @@
 
 #include "plugin/device/cpu/hal/hardware/ms_collective_comm_lib.h"
 
+#include "abstract/utils.h"
 #include "distributed/constants.h"
 #include "runtime/collective/collective_communication_lib.h"
 #include "plugin/device/cpu/hal/hardware/allreduce_impl.h"
@@ -193,7 +194,23 @@ bool MsCollectiveCommLib::QueryUniqueID(const std::string &group_name, size_t ro
 }
 
 bool MsCollectiveCommLib::AllReduce(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
-                                    CollectiveOpReduceType reduce_op, const std::string &group_name, void *) {
+                                    CollectiveOpReduceType reduce_op, const std::string &, void *) {
+  return AllReduceImpl(send_buff, recv_buff, send_count, data_type, reduce_op, nullptr);
+}
+
+bool MsCollectiveCommLib::AllReduceGradient(const void *send_buff, void *recv_buff, size_t send_count,
+                                            TypeId data_type, CollectiveOpReduceType reduce_op,
+                                            const std::string &group_name) {
+  GradientCompressor *compressor = nullptr;
+  auto group = std::dynamic_pointer_cast<MsCommunicationGroup>(GetGroup(group_name));
+  if (group != nullptr) {
+    compressor = group->compressor();
+  }
+  return AllReduceImpl(send_buff, recv_buff, send_count, data_type, reduce_op, compressor);
+}
+
+bool MsCollectiveCommLib::AllReduceImpl(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                                        CollectiveOpReduceType reduce_op, GradientCompressor *compressor) {
   CHECK_IF_NULL(send_buff);
   CHECK_IF_NULL(recv_buff);
   CHECK_IF_NULL(launcher_);
@@ -203,10 +220,40 @@ bool MsCollectiveCommLib::AllReduce(const void *send_buff, void *recv_buff, size
   if (reduce_op != CollectiveOpReduceType::Reduce_Sum) {
     MS_LOG(EXCEPTION) << "AllReduce only support reduce sum.";
   }
-  bool ret = launcher_->Execute(send_buff, recv_buff, send_count);
+  bool ret = launcher_->Execute(send_buff, recv_buff, send_count, compressor);
   return ret;
 }
 
+bool MsCollectiveCommLib::ReduceScatter(const void *send_buff, void *recv_buff, size_t recv_count, TypeId data_type,
+                                        CollectiveOpReduceType reduce_op, const std::string &group_name, void *) {
+  CHECK_IF_NULL(send_buff);
+  CHECK_IF_NULL(recv_buff);
+  CHECK_IF_NULL(launcher_);
+  if (data_type != TypeId::kNumberTypeFloat32) {
+    MS_LOG(EXCEPTION) << "ReduceScatter only support float32.";
+  }
+  if (reduce_op != CollectiveOpReduceType::Reduce_Sum) {
+    MS_LOG(EXCEPTION) << "ReduceScatter only support reduce sum.";
+  }
+  if (group_name != kMCCLGlobalGroupName) {
+    MS_LOG(ERROR) << "ReduceScatter only support the group " << kMCCLGlobalGroupName << ", but got " << group_name;
+    return false;
+  }
+  return launcher_->ReduceScatter(send_buff, recv_buff, recv_count * sizeof(float));
+}
+
+bool MsCollectiveCommLib::AllToAll(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                                   const std::string &group_name) {
+  CHECK_IF_NULL(send_buff);
+  CHECK_IF_NULL(recv_buff);
+  CHECK_IF_NULL(launcher_);
+  if (group_name != kMCCLGlobalGroupName) {
+    MS_LOG(ERROR) << "AllToAll only support the group " << kMCCLGlobalGroupName << ", but got " << group_name;
+    return false;
+  }
+  return launcher_->AllToAll(send_buff, recv_buff, send_count * abstract::TypeIdSize(data_type));
+}
+
 bool MsCollectiveCommLib::AllGather(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
                                     const std::string &, void *) {
   CHECK_IF_NULL(send_buff);
@@ -65,13 +65,21 @@ class MsCollectiveCommLib : public CollectiveCommunicationLib {
   bool AllReduce(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
                  CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream = nullptr) override;
 
+  // The AllReduce of gradients, which compresses them if the compression of the group is set by
+  // MS_DEV_CPU_GRADIENT_COMPRESSION. The other AllReduce never compresses the data.
+  bool AllReduceGradient(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                         CollectiveOpReduceType reduce_op, const std::string &group_name);
+
   bool Broadcast(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type, uint32_t root_rank,
                  const std::string &group_name, void *stream = nullptr) override;
 
   bool ReduceScatter(const void *send_buff, void *recv_buff, size_t recv_count, TypeId data_type,
-                     CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream = nullptr) override {
-    return true;
-  }
+                     CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream = nullptr) override;
+
+  // Send send_count elements to every rank and receive as many from each of them, the blocks in both buffers are
+  // ordered by rank id.
+  bool AllToAll(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                const std::string &group_name);
 
  private:
   MsCollectiveCommLib();
@@ -83,6 +91,9 @@ class MsCollectiveCommLib : public CollectiveCommunicationLib {
   // Query unique id from scheduler.
   bool QueryUniqueID(const std::string &group_name, size_t root_info_size, void *root_info) const;
 
+  bool AllReduceImpl(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                     CollectiveOpReduceType reduce_op, GradientCompressor *compressor);
+
   std::shared_ptr<ps::core::CollectiveNode> node_;
 
   // This compute graph node is maintained by the clusster context and used for metadata synchronization.
@@ -0,0 +1,300 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/device/cpu/hal/hardware/ms_collective_compressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+constexpr float kDefaultTopKRatio = 0.01f;
+constexpr size_t kBitsPerByte = 8;
+
+std::vector<std::string> Split(const std::string &str, char delimiter) {
+  std::vector<std::string> fields;
+  std::stringstream ss(str);
+  std::string field;
+  while (std::getline(ss, field, delimiter)) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+inline uint32_t FloatToBits(float value) {
+  uint32_t bits;
+  (void)memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline float BitsToFloat(uint32_t bits) {
+  float value;
+  (void)memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// The conversions of the FP16 library by Marat Dukhan, which only use float arithmetic and selects.
+inline uint16_t FloatToFp16(float value) {
+  const float scale_to_inf = BitsToFloat(0x77800000);   // 2^112
+  const float scale_to_zero = BitsToFloat(0x08800000);  // 2^-110
+  float base = (std::fabs(value) * scale_to_inf) * scale_to_zero;
+  const uint32_t w = FloatToBits(value);
+  const uint32_t shl1_w = w + w;
+  const uint32_t sign = w & 0x80000000;
+  uint32_t bias = shl1_w & 0xFF000000;
+  bias = bias < 0x71000000 ? 0x71000000 : bias;
+  base = BitsToFloat((bias >> 1) + 0x07800000) + base;
+  const uint32_t bits = FloatToBits(base);
+  const uint32_t exp_bits = (bits >> 13) & 0x00007C00;
+  const uint32_t mantissa_bits = bits & 0x00000FFF;
+  const uint32_t nonsign = exp_bits + mantissa_bits;
+  return static_cast<uint16_t>((sign >> 16) | (shl1_w > 0xFF000000 ? 0x7E00 : nonsign));
+}
+
+inline float Fp16ToFloat(uint16_t value) {
+  const uint32_t w = static_cast<uint32_t>(value) << 16;
+  const uint32_t sign = w & 0x80000000;
+  const uint32_t two_w = w + w;
+  const uint32_t exp_offset = 0xE0u << 23;
+  const float exp_scale = BitsToFloat(0x07800000);  // 2^-112
+  const float normalized = BitsToFloat((two_w >> 4) + exp_offset) * exp_scale;
+  const uint32_t magic_mask = 126u << 23;
+  const float magic_bias = 0.5f;
+  const float denormalized = BitsToFloat((two_w >> 17) | magic_mask) - magic_bias;
+  const uint32_t denormalized_cutoff = 1u << 27;
+  return BitsToFloat(sign | (two_w < denormalized_cutoff ? FloatToBits(denormalized) : FloatToBits(normalized)));
+}
+
+inline uint16_t FloatToBf16(float value) {
+  const uint32_t bits = FloatToBits(value);
+  const uint32_t rounded = (bits + 0x7FFF + ((bits >> 16) & 1)) >> 16;
+  // NaN must not be rounded to infinity.
+  return static_cast<uint16_t>((bits & 0x7FFFFFFF) > 0x7F800000 ? ((bits >> 16) | 0x40) : rounded);
+}
+
+inline float Bf16ToFloat(uint16_t value) { return BitsToFloat(static_cast<uint32_t>(value) << 16); }
+}  // namespace
+
+CompressionConfig ParseCompressionConfig(const std::string &config, const std::string &group_name) {
+  static const std::map<std::string, CompressionType> kCompressionTypes = {{"fp16", CompressionType::kFp16},
+                                                                          {"bf16", CompressionType::kBf16},
+                                                                          {"topk", CompressionType::kTopK},
+                                                                          {"onebit", CompressionType::kOneBit}};
+  CompressionConfig result;
+  for (const auto &entry : Split(config, ';')) {
+    auto fields = Split(entry, ':');
+    if (fields.size() < 2 || fields[0] != group_name) {
+      continue;
+    }
+    auto iter = kCompressionTypes.find(fields[1]);
+    if (iter == kCompressionTypes.end()) {
+      MS_LOG(EXCEPTION) << "Unknown gradient compression " << fields[1] << " of the group " << group_name
+                        << ", it should be one of fp16, bf16, topk and onebit.";
+    }
+    result.type = iter->second;
+    result.param = result.type == CompressionType::kTopK ? kDefaultTopKRatio : 0;
+    if (fields.size() > 2) {
+      result.param = std::strtof(fields[2].c_str(), nullptr);
+    }
+    if (result.type == CompressionType::kTopK && (result.param <= 0 || result.param > 1)) {
+      MS_LOG(EXCEPTION) << "The top-k ratio of the group " << group_name << " should be in (0, 1], but got "
+                        << result.param;
+    }
+    if (result.type == CompressionType::kOneBit && (result.param < 0 || result.param >= 1)) {
+      MS_LOG(EXCEPTION) << "The 1-bit momentum of the group " << group_name << " should be in [0, 1), but got "
+                        << result.param;
+    }
+  }
+  return result;
+}
+
+void Float32ToHalf(const float *input, size_t num, uint16_t *output, bool bf16) {
+  if (bf16) {
+    for (size_t i = 0; i < num; ++i) {
+      output[i] = FloatToBf16(input[i]);
+    }
+  } else {
+    for (size_t i = 0; i < num; ++i) {
+      output[i] = FloatToFp16(input[i]);
+    }
+  }
+}
+
+void HalfToFloat32(const uint16_t *input, size_t num, float *output, bool bf16) {
+  if (bf16) {
+    for (size_t i = 0; i < num; ++i) {
+      output[i] = Bf16ToFloat(input[i]);
+    }
+  } else {
+    for (size_t i = 0; i < num; ++i) {
+      output[i] = Fp16ToFloat(input[i]);
+    }
+  }
+}
+
+GradientCompressor::Residual *GradientCompressor::GetResidual(const void *key, size_t num) {
+  auto residual_key = std::make_pair(key, num);
+  auto iter = residuals_.find(residual_key);
+  if (iter != residuals_.end()) {
+    lru_.splice(lru_.begin(), lru_, iter->second.lru_iter);
+    return &iter->second;
+  }
+  if (residuals_.size() >= max_residual_num_) {
+    MS_LOG(DEBUG) << "Drop the least recently used gradient residual of " << lru_.back().second << " elements.";
+    (void)residuals_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  lru_.push_front(residual_key);
+  auto &residual = residuals_[residual_key];
+  residual.lru_iter = lru_.begin();
+  return &residual;
+}
+
+void GradientCompressor::ClearResiduals() {
+  residuals_.clear();
+  lru_.clear();
+}
+
+bool GradientCompressor::Compress(const void *key, const float *data, size_t num, std::vector<uint8_t> *payload) {
+  if (!sparse() || data == nullptr || payload == nullptr || num > std::numeric_limits<uint32_t>::max()) {
+    MS_LOG(ERROR) << "Failed to compress the gradient of " << num << " elements.";
+    return false;
+  }
+  auto &residual = *GetResidual(key, num);
+  if (residual.error.size() != num) {
+    residual.error.assign(num, 0);
+  }
+  float *corrected = residual.error.data();
+  if (config_.type == CompressionType::kOneBit && config_.param > 0) {
+    // Momentum correction: the momentum is accumulated locally, and its part which is not sent is fed back.
+    if (residual.momentum.size() != num) {
+      residual.momentum.assign(num, 0);
+    }
+    float *momentum = residual.momentum.data();
+    const float beta = config_.param;
+    for (size_t i = 0; i < num; ++i) {
+      momentum[i] = beta * momentum[i] + data[i];
+      corrected[i] += momentum[i];
+    }
+  } else {
+    for (size_t i = 0; i < num; ++i) {
+      corrected[i] += data[i];
+    }
+  }
+
+  if (config_.type == CompressionType::kTopK) {
+    CompressTopK(corrected, num, payload);
+  } else {
+    CompressOneBit(corrected, num, payload);
+  }
+  return true;
+}
+
+// The payload is the number k, the k indices in ascending order and then their values.
+void GradientCompressor::CompressTopK(float *corrected, size_t num, std::vector<uint8_t> *payload) const {
+  size_t k = std::min(num, std::max(size_t(1), static_cast<size_t>(std::ceil(config_.param * num))));
+  std::vector<uint32_t> indices(num);
+  std::iota(indices.begin(), indices.end(), 0);
+  if (k < num) {
+    std::nth_element(indices.begin(), indices.begin() + k, indices.end(), [corrected](uint32_t a, uint32_t b) {
+      return std::fabs(corrected[a]) > std::fabs(corrected[b]);
+    });
+  }
+  std::sort(indices.begin(), indices.begin() + k);
+
+  payload->resize(sizeof(uint32_t) + k * (sizeof(uint32_t) + sizeof(float)));
+  auto *count = reinterpret_cast<uint32_t *>(payload->data());
+  auto *sent_indices = count + 1;
+  auto *sent_values = reinterpret_cast<float *>(sent_indices + k);
+  *count = static_cast<uint32_t>(k);
+  for (size_t i = 0; i < k; ++i) {
+    sent_indices[i] = indices[i];
+    sent_values[i] = corrected[indices[i]];
+    // What is sent leaves the residual.
+    corrected[indices[i]] = 0;
+  }
+}
+
+// The payload is the scale, which is the mean of the absolute values, followed by the signs packed 8 in a byte.
+void GradientCompressor::CompressOneBit(float *corrected, size_t num, std::vector<uint8_t> *payload) const {
+  double abs_sum = 0;
+  for (size_t i = 0; i < num; ++i) {
+    abs_sum += std::fabs(corrected[i]);
+  }
+  const float scale = num == 0 ? 0 : static_cast<float>(abs_sum / num);
+  size_t byte_num = (num + kBitsPerByte - 1) / kBitsPerByte;
+  payload->assign(sizeof(float) + byte_num, 0);
+  (void)memcpy(payload->data(), &scale, sizeof(float));
+  uint8_t *signs = payload->data() + sizeof(float);
+  for (size_t i = 0; i < num; ++i) {
+    uint8_t positive = corrected[i] >= 0 ? 1 : 0;
+    signs[i / kBitsPerByte] |= static_cast<uint8_t>(positive << (i % kBitsPerByte));
+    corrected[i] -= positive ? scale : -scale;
+  }
+}
+
+bool GradientCompressor::DecompressAdd(const uint8_t *payload, size_t payload_size, float *output, size_t num) const {
+  if (payload == nullptr || output == nullptr) {
+    return false;
+  }
+  if (config_.type == CompressionType::kTopK) {
+    if (payload_size < sizeof(uint32_t)) {
+      MS_LOG(ERROR) << "The top-k payload of " << payload_size << " bytes is too short.";
+      return false;
+    }
+    uint32_t k;
+    (void)memcpy(&k, payload, sizeof(uint32_t));
+    if (payload_size != sizeof(uint32_t) + k * (sizeof(uint32_t) + sizeof(float))) {
+      MS_LOG(ERROR) << "The top-k payload of " << payload_size << " bytes does not match its " << k << " elements.";
+      return false;
+    }
+    const auto *indices = reinterpret_cast<const uint32_t *>(payload + sizeof(uint32_t));
+    const auto *values = reinterpret_cast<const float *>(indices + k);
+    for (size_t i = 0; i < k; ++i) {
+      if (indices[i] >= num) {
+        MS_LOG(ERROR) << "The top-k index " << indices[i] << " is out of range " << num;
+        return false;
+      }
+      output[indices[i]] += values[i];
+    }
+    return true;
+  }
+  if (config_.type == CompressionType::kOneBit) {
+    if (payload_size != sizeof(float) + (num + kBitsPerByte - 1) / kBitsPerByte) {
+      MS_LOG(ERROR) << "The 1-bit payload of " << payload_size << " bytes does not match " << num << " elements.";
+      return false;
+    }
+    float scale;
+    (void)memcpy(&scale, payload, sizeof(float));
+    const uint8_t *signs = payload + sizeof(float);
+    for (size_t i = 0; i < num; ++i) {
+      int positive = (signs[i / kBitsPerByte] >> (i % kBitsPerByte)) & 1;
+      output[i] += scale * static_cast<float>(2 * positive - 1);
+    }
+    return true;
+  }
+  return false;
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_COMPRESSOR_H_
+#define MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_COMPRESSOR_H_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+enum class CompressionType { kNone = 0, kFp16, kBf16, kTopK, kOneBit };
+
+// The compression of the gradients exchanged by AllReduce. The param is the ratio of the elements sent for top-k, and
+// the momentum of the correction for 1-bit, which is plain error feedback when it is zero.
+struct CompressionConfig {
+  CompressionType type{CompressionType::kNone};
+  float param{0};
+};
+
+// Parse the compression of the group from a config like "group_a:topk:0.01;group_b:fp16". The types are fp16, bf16,
+// topk and onebit.
+BACKEND_EXPORT CompressionConfig ParseCompressionConfig(const std::string &config, const std::string &group_name);
+
+// Convert between float32 and the 16 bits floating point types sent on the wire, with rounding to nearest even. The
+// loops have no branches, so that the compiler vectorizes them.
+BACKEND_EXPORT void Float32ToHalf(const float *input, size_t num, uint16_t *output, bool bf16);
+BACKEND_EXPORT void HalfToFloat32(const uint16_t *input, size_t num, float *output, bool bf16);
+
+// The default number of the gradient residuals kept by a compressor.
+constexpr size_t kDefaultMaxResidualNum = 1024;
+
+// GradientCompressor turns a gradient into a payload of top-k or 1-bit compression. The part of the gradient lost by
+// the compression is kept as a residual and added to the gradient of the next step, which is looked up by the address
+// and size of the buffer, since a gradient keeps its buffer across the steps. At most `max_residual_num` residuals are
+// kept, the least recently used one is dropped for a new gradient, e.g. when the buffers of the gradients change.
+class BACKEND_EXPORT GradientCompressor {
+ public:
+  explicit GradientCompressor(const CompressionConfig &config, size_t max_residual_num = kDefaultMaxResidualNum)
+      : config_(config), max_residual_num_(max_residual_num == 0 ? 1 : max_residual_num) {}
+  ~GradientCompressor() = default;
+
+  CompressionType type() const { return config_.type; }
+  bool sparse() const { return config_.type == CompressionType::kTopK || config_.type == CompressionType::kOneBit; }
+
+  bool Compress(const void *key, const float *data, size_t num, std::vector<uint8_t> *payload);
+  // Add the gradient carried by the payload to output.
+  bool DecompressAdd(const uint8_t *payload, size_t payload_size, float *output, size_t num) const;
+
+  // Drop all the residuals, e.g. when the gradient buffers are freed.
+  void ClearResiduals();
+  size_t residual_num() const { return residuals_.size(); }
+
+ private:
+  using ResidualKey = std::pair<const void *, size_t>;
+  struct Residual {
+    std::vector<float> error;
+    std::vector<float> momentum;
+    // The position of the key in the least recently used list.
+    std::list<ResidualKey>::iterator lru_iter;
+  };
+
+  // Get the residual of the gradient and mark it most recently used, the residual is created if absent.
+  Residual *GetResidual(const void *key, size_t num);
+
+  void CompressTopK(float *corrected, size_t num, std::vector<uint8_t> *payload) const;
+  void CompressOneBit(float *corrected, size_t num, std::vector<uint8_t> *payload) const;
+
+  CompressionConfig config_;
+  size_t max_residual_num_;
+  std::map<ResidualKey, Residual> residuals_;
+  // The keys of the residuals, the most recently used first.
+  std::list<ResidualKey> lru_;
+};
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_COMPRESSOR_H_
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/device/cpu/hal/hardware/ms_collective_shm.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <new>
+#include <thread>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+// The header is kept in its own cache line, so that spinning on the barrier does not slow down the copies to slot 0.
+constexpr size_t kShmHeaderSize = 64;
+// The number of spins before the waiting rank yields and checks the timeout.
+constexpr size_t kBarrierSpinNum = 1024;
+}  // namespace
+
+ShmCollectiveSegment::~ShmCollectiveSegment() {
+  Unlink();
+  if (addr_ != nullptr) {
+    (void)munmap(addr_, SegmentSize());
+    addr_ = nullptr;
+    header_ = nullptr;
+  }
+}
+
+bool ShmCollectiveSegment::Create(const std::string &name) {
+  // Remove the segment left by a previous job which was killed before unlinking it.
+  (void)shm_unlink(name.c_str());
+  if (!Map(name, true)) {
+    return false;
+  }
+  header_ = new (addr_) Header();
+  header_->arrived.store(0, std::memory_order_relaxed);
+  header_->generation.store(0, std::memory_order_release);
+  unlinked_ = false;
+  return true;
+}
+
+bool ShmCollectiveSegment::Attach(const std::string &name) {
+  if (!Map(name, false)) {
+    return false;
+  }
+  header_ = reinterpret_cast<Header *>(addr_);
+  return true;
+}
+
+bool ShmCollectiveSegment::Map(const std::string &name, bool create) {
+  int flags = create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR;
+  int fd = shm_open(name.c_str(), flags, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG(ERROR) << "Failed to open the shared memory " << name << ", errno: " << errno;
+    return false;
+  }
+  size_t size = SegmentSize();
+  if (create && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    MS_LOG(ERROR) << "Failed to resize the shared memory " << name << " to " << size << " bytes, errno: " << errno;
+    (void)close(fd);
+    (void)shm_unlink(name.c_str());
+    return false;
+  }
+  struct stat fd_stat = {};
+  if (fstat(fd, &fd_stat) != 0 || static_cast<size_t>(fd_stat.st_size) != size) {
+    MS_LOG(ERROR) << "The size of the shared memory " << name << " is not " << size << " bytes.";
+    (void)close(fd);
+    return false;
+  }
+  addr_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  (void)close(fd);
+  if (addr_ == MAP_FAILED) {
+    MS_LOG(ERROR) << "Failed to map the shared memory " << name << ", errno: " << errno;
+    addr_ = nullptr;
+    return false;
+  }
+  name_ = name;
+  return true;
+}
+
+void ShmCollectiveSegment::Unlink() {
+  if (!unlinked_) {
+    (void)shm_unlink(name_.c_str());
+    unlinked_ = true;
+  }
+}
+
+bool ShmCollectiveSegment::Barrier(uint32_t timeout) const {
+  if (header_ == nullptr) {
+    return false;
+  }
+  uint64_t generation = header_->generation.load(std::memory_order_acquire);
+  if (header_->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == local_size_) {
+    // The last rank resets the counter before releasing the others, so they can enter the next barrier right away.
+    header_->arrived.store(0, std::memory_order_relaxed);
+    (void)header_->generation.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t spin = 0;
+  while (header_->generation.load(std::memory_order_acquire) == generation) {
+    if (++spin < kBarrierSpinNum) {
+      continue;
+    }
+    spin = 0;
+    std::this_thread::yield();
+    if (std::chrono::steady_clock::now() - start > std::chrono::seconds(timeout)) {
+      MS_LOG(ERROR) << "Local rank " << local_rank_ << " timed out waiting for the other ranks on the shared memory "
+                    << name_;
+      return false;
+    }
+  }
+  return true;
+}
+
+float *ShmCollectiveSegment::slot(size_t local_rank) const {
+  if (addr_ == nullptr || local_rank >= local_size_) {
+    return nullptr;
+  }
+  return reinterpret_cast<float *>(static_cast<uint8_t *>(addr_) + kShmHeaderSize + local_rank * slot_size_);
+}
+
+size_t ShmCollectiveSegment::SegmentSize() const { return kShmHeaderSize + local_size_ * slot_size_; }
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
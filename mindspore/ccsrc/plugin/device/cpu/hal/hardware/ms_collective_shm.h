@@ -0,0 +1,72 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_SHM_H_
+#define MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_SHM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+// The POSIX shared memory segment through which the ranks on the same host exchange data for the hierarchical
+// collectives. Every local rank owns one slot of slot_size bytes, and the ranks synchronize with a barrier kept in the
+// header of the segment.
+class ShmCollectiveSegment {
+ public:
+  ShmCollectiveSegment(size_t local_rank, size_t local_size, size_t slot_size)
+      : local_rank_(local_rank), local_size_(local_size), slot_size_(slot_size) {}
+  ~ShmCollectiveSegment();
+
+  // The first rank of the host creates the segment, the others attach to it once the name has been sent to them.
+  bool Create(const std::string &name);
+  bool Attach(const std::string &name);
+
+  // Remove the name of the segment. The memory is released when the last rank unmaps it.
+  void Unlink();
+
+  // Wait until every local rank has reached the barrier, returns false if a rank does not come within timeout seconds.
+  bool Barrier(uint32_t timeout) const;
+
+  float *slot(size_t local_rank) const;
+  size_t slot_size() const { return slot_size_; }
+  size_t local_rank() const { return local_rank_; }
+  size_t local_size() const { return local_size_; }
+
+ private:
+  struct Header {
+    std::atomic<uint64_t> arrived;
+    std::atomic<uint64_t> generation;
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "The barrier in shared memory needs lock free atomics.");
+
+  bool Map(const std::string &name, bool create);
+  size_t SegmentSize() const;
+
+  size_t local_rank_;
+  size_t local_size_;
+  size_t slot_size_;
+  std::string name_;
+  bool unlinked_{true};
+  void *addr_{nullptr};
+  Header *header_{nullptr};
+};
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_SHM_H_
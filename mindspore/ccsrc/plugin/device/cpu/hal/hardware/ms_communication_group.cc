@@ -15,10 +15,31 @@
  */
 
 #include "plugin/device/cpu/hal/hardware/ms_communication_group.h"
+#include "utils/ms_utils.h"
 
 namespace mindspore {
 namespace device {
 namespace cpu {
+MsCommunicationGroup::MsCommunicationGroup(const std::string &name, const std::vector<uint32_t> &group_ranks,
+                                           uint32_t global_rank, uint32_t local_group_rank, uint32_t local_group_size)
+    : CommunicationGroup(name, group_ranks, global_rank, local_group_rank, local_group_size),
+      root_info_(kMSRootInfo + name_) {
+  auto compression = common::GetEnv(kEnvGradientCompression);
+  if (!compression.empty()) {
+    set_compression(ParseCompressionConfig(compression, name_));
+  }
+}
+
+void MsCommunicationGroup::set_compression(const CompressionConfig &config) {
+  if (config.type == CompressionType::kNone) {
+    compressor_ = nullptr;
+    return;
+  }
+  MS_LOG(INFO) << "The gradients reduced in the group " << name_ << " are compressed with type "
+               << static_cast<int>(config.type) << ", param " << config.param;
+  compressor_ = std::make_unique<GradientCompressor>(config);
+}
+
 void *MsCommunicationGroup::GenerateRootInfo(size_t *root_info_size) {
   *root_info_size = root_info_.size();
   return const_cast<char *>(root_info_.c_str());
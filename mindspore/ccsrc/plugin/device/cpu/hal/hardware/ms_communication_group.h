@@ -21,18 +21,19 @@
 #include <vector>
 #include <memory>
 #include "runtime/collective/communication_group.h"
+#include "plugin/device/cpu/hal/hardware/ms_collective_compressor.h"
 
 namespace mindspore {
 namespace device {
 namespace cpu {
 constexpr char kMSRootInfo[] = "MS_CLUSTER_ROOT";
+// The gradient compression of the groups, like "mccl_world_group:topk:0.01;group_a:fp16".
+constexpr char kEnvGradientCompression[] = "MS_DEV_CPU_GRADIENT_COMPRESSION";
 
 class MsCommunicationGroup : public CommunicationGroup {
  public:
   explicit MsCommunicationGroup(const std::string &name, const std::vector<uint32_t> &group_ranks, uint32_t global_rank,
-                                uint32_t local_group_rank, uint32_t local_group_size)
-      : CommunicationGroup(name, group_ranks, global_rank, local_group_rank, local_group_size),
-        root_info_(kMSRootInfo + name_) {}
+                                uint32_t local_group_rank, uint32_t local_group_size);
 
   ~MsCommunicationGroup() override = default;
 
@@ -40,8 +41,13 @@ class MsCommunicationGroup : public CommunicationGroup {
   bool Finalize() override { return true; }
   void *GenerateRootInfo(size_t *root_info_size) override;
 
+  // The compressor of the gradients reduced in this group, nullptr if they are sent as they are.
+  GradientCompressor *compressor() const { return compressor_.get(); }
+  void set_compression(const CompressionConfig &config);
+
  private:
   std::string root_info_;
+  std::unique_ptr<GradientCompressor> compressor_{nullptr};
 };
 using MsCommunicationGroupPtr = std::shared_ptr<MsCommunicationGroup>;
 }  // namespace cpu
@@ -53,6 +53,9 @@ void AllReduceCPUKernelMod::InitKernel(const CNodePtr &kernel_node) {
   if (reduce_op != kSupportedReduceOp) {
     MS_LOG(EXCEPTION) << kernel_name_ << " only support reduce sum on CPU, but got " << reduce_op;
   }
+  // The gradient AllReduce is marked by the gradient reducer, the other AllReduce is never compressed.
+  gradient_reduce_ = common::AnfAlgo::HasNodeAttr(kAttrGradientReduce, kernel_node) &&
+                     common::AnfAlgo::GetNodeAttr<bool>(kernel_node, kAttrGradientReduce);
 #else
   MS_LOG(EXCEPTION) << "The CPU kernel allreduce is only supported on linux platform.";
 #endif
@@ -75,8 +78,11 @@ bool AllReduceCPUKernelMod::Launch(const std::vector<kernel::AddressPtr> &inputs
   for (size_t i = 0; i < inputs.size(); ++i) {
     data_size += inputs[i]->size;
   }
-  bool ret = MsCollectiveCommLib::GetInstance().AllReduce(inputs[0]->addr, outputs[0]->addr, data_size,
-                                                          kNumberTypeFloat32, Reduce_Sum, kMCCLGlobalGroupName);
+  auto &comm_lib = MsCollectiveCommLib::GetInstance();
+  bool ret = gradient_reduce_ ? comm_lib.AllReduceGradient(inputs[0]->addr, outputs[0]->addr, data_size,
+                                                           kNumberTypeFloat32, Reduce_Sum, kMCCLGlobalGroupName)
+                              : comm_lib.AllReduce(inputs[0]->addr, outputs[0]->addr, data_size, kNumberTypeFloat32,
+                                                   Reduce_Sum, kMCCLGlobalGroupName);
   if (!ret) {
     MS_LOG(ERROR) << "AllReduceCPUKernelMod launch failed.";
   }
@@ -36,6 +36,10 @@ class AllReduceCPUKernelMod : public DeprecatedNativeCpuKernelMod {
               const std::vector<AddressPtr> &outputs) override;
 
   std::vector<KernelAttr> GetOpSupport() override;
+
+ private:
+  // Whether this AllReduce reduces the gradients, which are compressed if the compression of the group is set.
+  bool gradient_reduce_{false};
 };
 }  // namespace kernel
 }  // namespace mindspore
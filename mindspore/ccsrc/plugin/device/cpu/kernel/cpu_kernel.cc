@@ -26,6 +26,7 @@
 #include "utils/profile.h"
 #include "runtime/graph_scheduler/actor/actor_common.h"
 #include "kernel/common_utils.h"
+#include "kernel/parallel_search_cache.h"
 
 namespace mindspore {
 namespace kernel {
@@ -333,8 +334,21 @@ void ParallelLaunchAutoSearch(const CTask &task, size_t count, Content content,
     }
     parallel_search_info->max_pow = max_pow_current + 1;
     parallel_search_info->kernel_thread_num_set = true;
+    if (!parallel_search_info->kernel_key.empty()) {
+      parallel_search_info->cache_key =
+        ParallelSearchCache::MakeKey(parallel_search_info->kernel_key, count, kernel_thread_num);
+    }
   }
   const size_t AVG_COUNT = 5;
+  // Take the result searched by the other kernels of the same key, or in the former jobs.
+  size_t cached_pow = 0;
+  if (parallel_search_info->search_count == 0 && !parallel_search_info->cache_key.empty() &&
+      ParallelSearchCache::GetInstance().Get(parallel_search_info->cache_key, &cached_pow) &&
+      cached_pow < parallel_search_info->max_pow) {
+    parallel_search_info->best_pow = cached_pow;
+    parallel_search_info->best_block_size = static_cast<float>(count) / std::pow(2.0f, cached_pow);
+    parallel_search_info->search_count = AVG_COUNT * parallel_search_info->max_pow;
+  }
   size_t current_pow = parallel_search_info->search_count / AVG_COUNT;
   if (current_pow < parallel_search_info->max_pow) {
     if (parallel_search_info->search_count % AVG_COUNT == 0) {
@@ -355,6 +369,10 @@ void ParallelLaunchAutoSearch(const CTask &task, size_t count, Content content,
       } else if (current_pow - parallel_search_info->best_pow >= 2) {
         parallel_search_info->search_count = AVG_COUNT * parallel_search_info->max_pow;
       }
+      if (parallel_search_info->search_count >= AVG_COUNT * parallel_search_info->max_pow &&
+          !parallel_search_info->cache_key.empty()) {
+        ParallelSearchCache::GetInstance().Put(parallel_search_info->cache_key, parallel_search_info->best_pow);
+      }
     }
   } else {
     ParallelLaunch(task, count, parallel_search_info->best_block_size, content, pool);
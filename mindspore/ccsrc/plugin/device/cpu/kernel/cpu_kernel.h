@@ -132,6 +132,9 @@ struct ParallelSearchInfo {
   size_t search_count{0};
   bool kernel_thread_num_set{false};
   size_t max_pow{6};
+  // The op name and data types of the kernel. If it is set, the result is shared through ParallelSearchCache.
+  std::string kernel_key;
+  std::string cache_key;
 };
 
 class BACKEND_EXPORT NativeCpuKernelMod : public CpuKernelMod {
@@ -161,10 +164,16 @@ class BACKEND_EXPORT NativeCpuKernelMod : public CpuKernelMod {
   virtual std::vector<KernelAttr> GetOpSupport() { return {}; }
   enum KernelModType GetKernelModType() const override { return KernelModType::NativeCpuKernelMod; }
 
+  // Must be called before Init. The inputs fed by the weights keep their contents until the weights are updated.
+  void set_weight_inputs(const std::vector<bool> &weight_inputs) { weight_inputs_ = weight_inputs; }
+
   ParallelSearchInfo parallel_search_info_;
 
  protected:
+  bool IsWeightInput(size_t index) const { return index < weight_inputs_.size() && weight_inputs_[index]; }
+
   ThreadPool *pool_{nullptr};
+  std::vector<bool> weight_inputs_;
 
  private:
   std::vector<KernelAttr> GetAllSupportedList(const std::string &kernel_name);
@@ -108,6 +108,10 @@ bool MatMulCpuKernelMod::Init(const BaseOperatorPtr &base_operator, const std::v
   }
 
   func_obj_ = support_list_map[kernel_type_][index].second();
+  auto mkl_func = std::dynamic_pointer_cast<MatMulCpuKernelFunc>(func_obj_);
+  if (mkl_func != nullptr) {
+    mkl_func->set_weight_inputs(weight_inputs_);
+  }
   func_obj_->InitFunc(base_operator, inputs, outputs);
   return true;
 }
@@ -61,6 +61,10 @@ void ConvCpuKernelMod::InitKernel(const CNodePtr &kernel_node) {
   const dnnl::memory::desc src_desc = GetDefaultMemDesc(src_shape);
   const dnnl::memory::desc weights_desc = GetDefaultMemDesc(weight_shape);
   const dnnl::memory::desc dst_desc = GetDefaultMemDesc(dst_shape);
+  // The weights of parameters are packed once into the layout chosen by the primitive.
+  const bool const_weights = IsWeightInput(1);
+  const dnnl::memory::desc prim_weights_desc =
+    const_weights ? formatted_md(weight_shape, dnnl::memory::format_tag::any) : weights_desc;
   const auto stride_attr = src_dim == SHAPE_4D ? STRIDE : STRIDES;
   const auto dilation_attr = src_dim == SHAPE_4D ? DILATION : DILATIONS;
   const auto pad_mode = common::AnfAlgo::GetNodeAttr<std::string>(kernel_node, PAD_MODE);
@@ -84,13 +88,26 @@ void ConvCpuKernelMod::InitKernel(const CNodePtr &kernel_node) {
   PaddingInfo padding_info{pad_mode, kernel_size, strides, dilation, &padding_l, &padding_r};
   GetPadding(kernel_node, src_shape, padding_info);
 
-  const auto desc = CreateDesc<dnnl::convolution_forward::desc>(
-    dnnl::prop_kind::forward_training, dnnl::algorithm::convolution_auto, src_desc, weights_desc, dst_desc, strides,
-    dilates, padding_l, padding_r);
-  const auto prim_desc = CreateDesc<dnnl::convolution_forward::primitive_desc>(desc, engine_);
-  primitive_ = CreatePrimitive<dnnl::convolution_forward>(prim_desc);
+  PrimitiveKey key("convolution_forward");
+  (void)key.Add(src_desc).Add(prim_weights_desc).Add(dst_desc).Add(strides).Add(dilates).Add(padding_l);
+  (void)key.Add(padding_r);
+  dnnl::convolution_forward::primitive_desc prim_desc;
+  primitive_ = CreateCachedPrimitive<dnnl::convolution_forward>(
+    key,
+    [&]() {
+      const auto desc = CreateDesc<dnnl::convolution_forward::desc>(
+        dnnl::prop_kind::forward_training, dnnl::algorithm::convolution_auto, src_desc, prim_weights_desc, dst_desc,
+        strides, dilates, padding_l, padding_r);
+      return CreateDesc<dnnl::convolution_forward::primitive_desc>(desc, engine_);
+    },
+    &prim_desc);
+  const auto packed_weights_desc = prim_desc.weights_desc();
+  pack_weights_ = const_weights && packed_weights_desc != weights_desc;
+  if (pack_weights_) {
+    packed_weights_.Init(weights_desc, packed_weights_desc, true, engine_);
+  }
   AddArgument(DNNL_ARG_SRC, src_desc);
-  AddArgument(DNNL_ARG_WEIGHTS, weights_desc);
+  AddArgument(DNNL_ARG_WEIGHTS, pack_weights_ ? packed_weights_desc : weights_desc);
   AddArgument(DNNL_ARG_DST, dst_desc);
 }
 
@@ -99,7 +116,7 @@ bool ConvCpuKernelMod::Launch(const std::vector<kernel::AddressPtr> &inputs, con
   CHECK_KERNEL_INPUTS_NUM(inputs.size(), kConvInputsNum, kernel_name_);
   CHECK_KERNEL_OUTPUTS_NUM(outputs.size(), kConvOutputsNum, kernel_name_);
   SetArgumentHandle(DNNL_ARG_SRC, inputs[0]->addr);
-  SetArgumentHandle(DNNL_ARG_WEIGHTS, inputs[1]->addr);
+  SetArgumentHandle(DNNL_ARG_WEIGHTS, pack_weights_ ? packed_weights_.Pack(inputs[1]->addr, stream_) : inputs[1]->addr);
   SetArgumentHandle(DNNL_ARG_DST, outputs[0]->addr);
   ExecutePrimitive();
   return true;
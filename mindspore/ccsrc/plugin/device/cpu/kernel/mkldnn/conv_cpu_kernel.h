@@ -32,6 +32,10 @@ class ConvCpuKernelMod : public DeprecatedMKLCpuKernelMod {
 
   bool Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
               const std::vector<AddressPtr> &outputs) override;
+
+ private:
+  bool pack_weights_{false};
+  PackedWeights packed_weights_;
 };
 }  // namespace kernel
 }  // namespace mindspore
@@ -137,11 +137,18 @@ int LstmCpuKernelMod::Resize(const BaseOperatorPtr &base_operator, const std::ve
   }
   auto weights_desc = formatted_md(weights_dims_, tag::any);
   auto weights_h_desc = formatted_md(weights_h_dims_, tag::any);
-  auto desc =
-    CreatePrimitive<dnnl::lstm_forward::desc>(prop_kind, direction, src_desc, src_h_desc, src_c_desc, weights_desc,
-                                              weights_h_desc, bias_desc, dst_desc, dst_h_desc, dst_c_desc);
-  prim_desc_ = CreateDesc<dnnl::lstm_forward::primitive_desc>(*desc, eng);
-  primitive_ = CreatePrimitive<dnnl::lstm_forward>(prim_desc_);
+  PrimitiveKey key("lstm_forward");
+  (void)key.Add(prop_kind).Add(direction).Add(src_desc).Add(src_h_desc).Add(src_c_desc).Add(weights_desc);
+  (void)key.Add(weights_h_desc).Add(bias_desc).Add(dst_desc).Add(dst_h_desc).Add(dst_c_desc);
+  primitive_ = CreateCachedPrimitive<dnnl::lstm_forward>(
+    key,
+    [&]() {
+      auto desc =
+        CreatePrimitive<dnnl::lstm_forward::desc>(prop_kind, direction, src_desc, src_h_desc, src_c_desc, weights_desc,
+                                                  weights_h_desc, bias_desc, dst_desc, dst_h_desc, dst_c_desc);
+      return CreateDesc<dnnl::lstm_forward::primitive_desc>(*desc, eng);
+    },
+    &prim_desc_);
   if (is_training_) {
     auto wksp_desc = GetWorkspaceDesc(prim_desc_);
     reserve_size_ = GetSize(wksp_desc);
@@ -164,10 +171,10 @@ int LstmCpuKernelMod::Resize(const BaseOperatorPtr &base_operator, const std::ve
 
   auto weights_dims_desc = CreateDesc<dnnl::memory::desc>(weights_dims_, dt::f32, tag::ldgoi);
   auto weights_h_dims_desc = CreateDesc<dnnl::memory::desc>(weights_h_dims_, dt::f32, tag::ldgoi);
-  user_weights_memory_ = CreateDesc<dnnl::memory>(weights_dims_desc, eng);
-  user_weights_h_memory_ = CreateDesc<dnnl::memory>(weights_h_dims_desc, eng);
-  weights_memory_ = CreateDesc<dnnl::memory>(weights_layer, eng);
-  weights_h_memory_ = CreateDesc<dnnl::memory>(weights_iter, eng);
+  // The weights of parameters are packed once, the others are packed on every launch.
+  const bool const_weights = IsWeightInput(kInputWeightIndex);
+  packed_weights_.Init(weights_dims_desc, weights_layer, const_weights, engine_);
+  packed_weights_h_.Init(weights_h_dims_desc, weights_iter, const_weights, engine_);
   bias_memory_ = CreateDesc<dnnl::memory>(bias_desc_, eng);
 
   InitOutputSize(outputs);
@@ -176,10 +183,9 @@ int LstmCpuKernelMod::Resize(const BaseOperatorPtr &base_operator, const std::ve
 
 bool LstmCpuKernelMod::Launch(const std::vector<kernel::AddressPtr> &inputs, const std::vector<kernel::AddressPtr> &,
                               const std::vector<kernel::AddressPtr> &outputs) {
-  SetDataHandle(user_weights_memory_, inputs[kInputWeightIndex]->addr);
-  SetDataHandle(user_weights_h_memory_, reinterpret_cast<float *>(inputs[kInputWeightIndex]->addr) + weight_size_);
-  Reorder(&user_weights_memory_, &weights_memory_);
-  Reorder(&user_weights_h_memory_, &weights_h_memory_);
+  auto weights = packed_weights_.Pack(inputs[kInputWeightIndex]->addr, stream_);
+  auto weights_h =
+    packed_weights_h_.Pack(inputs[kInputWeightIndex]->addr, stream_, IntToSize(weight_size_) * sizeof(float));
   if (has_bias_) {
     SetDataHandle(bias_memory_,
                   reinterpret_cast<float *>(inputs[kInputWeightIndex]->addr) + weight_size_ + weight_h_size_);
@@ -193,8 +199,8 @@ bool LstmCpuKernelMod::Launch(const std::vector<kernel::AddressPtr> &inputs, con
   SetArgumentHandle(DNNL_ARG_SRC_LAYER, inputs[0]->addr);
   SetArgumentHandle(DNNL_ARG_SRC_ITER, inputs[1]->addr);
   SetArgumentHandle(DNNL_ARG_SRC_ITER_C, inputs[kInputCIndex]->addr);
-  SetArgumentHandle(DNNL_ARG_WEIGHTS_LAYER, GetDataHandle(weights_memory_));
-  SetArgumentHandle(DNNL_ARG_WEIGHTS_ITER, GetDataHandle(weights_h_memory_));
+  SetArgumentHandle(DNNL_ARG_WEIGHTS_LAYER, weights);
+  SetArgumentHandle(DNNL_ARG_WEIGHTS_ITER, weights_h);
   SetArgumentHandle(DNNL_ARG_BIAS, GetDataHandle(bias_memory_));
   SetArgumentHandle(DNNL_ARG_DST_LAYER, outputs[0]->addr);
   SetArgumentHandle(DNNL_ARG_DST_ITER, outputs[1]->addr);
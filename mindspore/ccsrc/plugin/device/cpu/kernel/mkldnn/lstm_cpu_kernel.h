@@ -76,10 +76,8 @@ class LstmCpuKernelMod : public MKLCpuKernelMod {
   dnnl::memory::dims bias_dims_;
   dnnl::lstm_forward::primitive_desc prim_desc_;
   dnnl::memory::desc bias_desc_;
-  dnnl::memory user_weights_memory_;
-  dnnl::memory user_weights_h_memory_;
-  dnnl::memory weights_memory_;
-  dnnl::memory weights_h_memory_;
+  PackedWeights packed_weights_;
+  PackedWeights packed_weights_h_;
   dnnl::memory bias_memory_;
 };
 }  // namespace kernel
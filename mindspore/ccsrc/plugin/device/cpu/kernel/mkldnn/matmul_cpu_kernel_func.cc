@@ -90,12 +90,27 @@ int MatMulCpuKernelFunc::Resize(const BaseOperatorPtr &base_operator, const std:
   auto src_md = CreateDesc<dnnl::memory::desc>(src_dims, dnnl::memory::data_type::f32, a_strides);
   auto weights_md = CreateDesc<dnnl::memory::desc>(weights_dims, dnnl::memory::data_type::f32, b_strides);
   auto dst_md = CreateDesc<dnnl::memory::desc>(dst_dims, dnnl::memory::data_type::f32, o_strides);
-  auto matmul_desc = CreateDesc<dnnl::matmul::desc>(src_md, weights_md, dst_md);
-  auto prim_desc = CreateDesc<dnnl::matmul::primitive_desc>(matmul_desc, engine_);
-  primitive_ = CreatePrimitive<dnnl::matmul>(prim_desc);
+  // The weights of parameters are packed once into the layout chosen by the primitive.
+  const bool const_weights = IsWeightInput(kIndex1);
+  auto prim_weights_md = const_weights ? formatted_md(weights_dims, dnnl::memory::format_tag::any) : weights_md;
+  PrimitiveKey key("matmul");
+  (void)key.Add(src_md).Add(prim_weights_md).Add(dst_md);
+  dnnl::matmul::primitive_desc prim_desc;
+  primitive_ = CreateCachedPrimitive<dnnl::matmul>(
+    key,
+    [&]() {
+      auto matmul_desc = CreateDesc<dnnl::matmul::desc>(src_md, prim_weights_md, dst_md);
+      return CreateDesc<dnnl::matmul::primitive_desc>(matmul_desc, engine_);
+    },
+    &prim_desc);
+  auto packed_weights_md = prim_desc.weights_desc();
+  pack_weights_ = const_weights && packed_weights_md != weights_md;
+  if (pack_weights_) {
+    packed_weights_.Init(weights_md, packed_weights_md, true, engine_);
+  }
 
   AddArgument(DNNL_ARG_SRC, src_md);
-  AddArgument(DNNL_ARG_WEIGHTS, weights_md);
+  AddArgument(DNNL_ARG_WEIGHTS, pack_weights_ ? packed_weights_md : weights_md);
   AddArgument(DNNL_ARG_DST, dst_md);
 
   return KRET_OK;
@@ -111,7 +126,7 @@ bool MatMulCpuKernelFunc::RunFunc(const std::vector<kernel::AddressPtr> &inputs,
   auto output = reinterpret_cast<float *>(outputs[0]->addr);
 
   SetArgumentHandle(DNNL_ARG_SRC, input_a);
-  SetArgumentHandle(DNNL_ARG_WEIGHTS, input_b);
+  SetArgumentHandle(DNNL_ARG_WEIGHTS, pack_weights_ ? packed_weights_.Pack(input_b, stream_) : input_b);
   SetArgumentHandle(DNNL_ARG_DST, output);
   ExecutePrimitive();
   return true;
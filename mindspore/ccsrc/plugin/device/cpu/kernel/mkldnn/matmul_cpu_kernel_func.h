@@ -39,6 +39,8 @@ class MatMulCpuKernelFunc : public CpuKernelFunc, private MKLCpuKernelMod {
   bool RunFunc(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
                const std::vector<AddressPtr> &outputs) override;
 
+  using MKLCpuKernelMod::set_weight_inputs;
+
  private:
   bool Init(const BaseOperatorPtr &base_operator, const std::vector<KernelTensorPtr> &inputs,
             const std::vector<KernelTensorPtr> &outputs) override {
@@ -52,6 +54,8 @@ class MatMulCpuKernelFunc : public CpuKernelFunc, private MKLCpuKernelMod {
 
   bool trans_a_{false};
   bool trans_b_{false};
+  bool pack_weights_{false};
+  PackedWeights packed_weights_;
 };
 }  // namespace kernel
 }  // namespace mindspore
@@ -25,6 +25,7 @@
 #include <utility>
 #include "dnnl.hpp"
 #include "plugin/device/cpu/kernel/cpu_kernel.h"
+#include "plugin/device/cpu/kernel/mkldnn/mkl_primitive_cache.h"
 #include "plugin/factory/ms_factory.h"
 #ifdef USE_MS_THREADPOOL_FOR_DNNL
 #include "dnnl_threadpool.hpp"
@@ -49,6 +50,29 @@ auto CreatePrimitive(Args &&... args) {
   return prim;
 }
 
+// Take the primitive of the key from the cache, or create it from the primitive descriptor made by create_prim_desc.
+// Either way prim_desc is set to the descriptor of the primitive.
+template <class T, class CreatePrimDesc>
+std::shared_ptr<dnnl::primitive> CreateCachedPrimitive(const PrimitiveKey &key, const CreatePrimDesc &create_prim_desc,
+                                                       typename T::primitive_desc *prim_desc) {
+  MS_EXCEPTION_IF_NULL(prim_desc);
+  auto &cache = MKLPrimitiveCache::GetInstance();
+  auto primitive = cache.Get(key.str());
+  if (primitive != nullptr) {
+    MS_LOG(DEBUG) << "Reuse the cached primitive of " << demangle(typeid(T).name());
+    dnnl_primitive_desc_t c_prim_desc = nullptr;
+    if (dnnl_primitive_desc_clone(&c_prim_desc, primitive->get_primitive_desc()) != dnnl_success) {
+      MS_LOG(EXCEPTION) << "Failed to clone the primitive descriptor of " << demangle(typeid(T).name());
+    }
+    *prim_desc = typename T::primitive_desc(c_prim_desc);
+    return primitive;
+  }
+  *prim_desc = create_prim_desc();
+  primitive = CreatePrimitive<T>(*prim_desc);
+  cache.Put(key.str(), primitive);
+  return primitive;
+}
+
 template <class T>
 auto GetWorkspaceDesc(const T &prim_desc) {
   MS_LOG(DEBUG) << "begin to invoke " << demangle(typeid(T).name()) << "::workspace_desc()";
@@ -175,7 +199,7 @@ struct PaddingInfo {
 class DeprecatedMKLCpuKernelMod : public DeprecatedNativeCpuKernelMod {
  public:
 #ifdef USE_MS_THREADPOOL_FOR_DNNL
-  DeprecatedMKLCpuKernelMod() : engine_(dnnl::engine::kind::cpu, 0) {
+  DeprecatedMKLCpuKernelMod() : engine_(MKLPrimitiveCache::GetInstance().engine()) {
     auto thread_pool = GetActorMgrInnerThreadPool();
     mkl_threadpool_ = std::make_shared<mkl_threadpool>(thread_pool);
     MS_LOG(DEBUG) << "begin to invoke dnnl::threadpool_interop::make_stream";
@@ -183,7 +207,7 @@ class DeprecatedMKLCpuKernelMod : public DeprecatedNativeCpuKernelMod {
     MS_LOG(DEBUG) << "end to invoke dnnl::threadpool_interop::make_stream";
   }
 #else
-  DeprecatedMKLCpuKernelMod() : engine_(dnnl::engine::kind::cpu, 0), stream_(engine_) {}
+  DeprecatedMKLCpuKernelMod() : engine_(MKLPrimitiveCache::GetInstance().engine()), stream_(engine_) {}
 #endif
   ~DeprecatedMKLCpuKernelMod() override = default;
 
@@ -221,7 +245,7 @@ class DeprecatedMKLCpuKernelMod : public DeprecatedNativeCpuKernelMod {
 class MKLCpuKernelMod : public NativeCpuKernelMod {
  public:
 #ifdef USE_MS_THREADPOOL_FOR_DNNL
-  MKLCpuKernelMod() : engine_(dnnl::engine::kind::cpu, 0) {
+  MKLCpuKernelMod() : engine_(MKLPrimitiveCache::GetInstance().engine()) {
     auto thread_pool = pool_ == nullptr ? GetActorMgrInnerThreadPool() : pool_;
     mkl_threadpool_ = std::make_shared<mkl_threadpool>(thread_pool);
     MS_LOG(DEBUG) << "begin to invoke dnnl::threadpool_interop::make_stream";
@@ -229,7 +253,7 @@ class MKLCpuKernelMod : public NativeCpuKernelMod {
     MS_LOG(DEBUG) << "end to invoke dnnl::threadpool_interop::make_stream";
   }
 #else
-  MKLCpuKernelMod() : engine_(dnnl::engine::kind::cpu, 0), stream_(engine_) {}
+  MKLCpuKernelMod() : engine_(MKLPrimitiveCache::GetInstance().engine()), stream_(engine_) {}
 #endif
   ~MKLCpuKernelMod() override = default;
 
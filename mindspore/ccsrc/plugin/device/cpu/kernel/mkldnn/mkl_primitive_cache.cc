@@ -0,0 +1,190 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/device/cpu/kernel/mkldnn/mkl_primitive_cache.h"
+
+#include <cstdlib>
+#include "include/common/utils/anfalgo.h"
+#include "runtime/device/kernel_info.h"
+#include "utils/convert_utils_base.h"
+#include "utils/flags.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+// The number of primitives kept in the cache, set to 0 to disable the cache.
+constexpr char kPrimitiveCacheCapacityEnv[] = "MS_DEV_DNNL_PRIMITIVE_CACHE_CAPACITY";
+constexpr size_t kDefaultPrimitiveCacheCapacity = 1024;
+}  // namespace
+
+PrimitiveKey &PrimitiveKey::Add(const dnnl::memory::desc &desc) {
+  const auto &data = desc.data;
+  (void)key_.append("|md:").append(std::to_string(data.data_type)).append(":");
+  (void)key_.append(std::to_string(data.format_kind)).append(":").append(std::to_string(data.offset0));
+  for (int i = 0; i < data.ndims; ++i) {
+    (void)key_.append(",").append(std::to_string(data.dims[i]));
+  }
+  if (data.format_kind == dnnl_blocked) {
+    const auto &blocking = data.format_desc.blocking;
+    for (int i = 0; i < data.ndims; ++i) {
+      (void)key_.append(",s").append(std::to_string(blocking.strides[i]));
+    }
+    for (int i = 0; i < blocking.inner_nblks; ++i) {
+      (void)key_.append(",b").append(std::to_string(blocking.inner_idxs[i]));
+      (void)key_.append("x").append(std::to_string(blocking.inner_blks[i]));
+    }
+  }
+  return *this;
+}
+
+PrimitiveKey &PrimitiveKey::Add(const dnnl::memory::dims &dims) {
+  (void)key_.append("|");
+  for (auto dim : dims) {
+    (void)key_.append(std::to_string(dim)).append(",");
+  }
+  return *this;
+}
+
+MKLPrimitiveCache::MKLPrimitiveCache()
+    : engine_(dnnl::engine::kind::cpu, 0), capacity_(kDefaultPrimitiveCacheCapacity) {
+  auto capacity_env = common::GetEnv(kPrimitiveCacheCapacityEnv);
+  if (!capacity_env.empty()) {
+    auto capacity = std::strtol(capacity_env.c_str(), nullptr, 0);
+    if (capacity >= 0) {
+      capacity_ = LongToSize(capacity);
+    }
+  }
+  MS_LOG(INFO) << "The capacity of the dnnl primitive cache is " << capacity_;
+}
+
+std::shared_ptr<dnnl::primitive> MKLPrimitiveCache::Get(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = index_.find(key);
+  if (iter == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, iter->second);
+  return iter->second->second;
+}
+
+void MKLPrimitiveCache::Put(const std::string &key, const std::shared_ptr<dnnl::primitive> &primitive) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capacity_ == 0) {
+    return;
+  }
+  auto iter = index_.find(key);
+  if (iter != index_.end()) {
+    // Another kernel has created the same primitive in the meantime.
+    iter->second->second = primitive;
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return;
+  }
+  if (entries_.size() >= capacity_) {
+    (void)index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, primitive);
+  index_[key] = entries_.begin();
+}
+
+void MKLPrimitiveCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  entries_.clear();
+}
+
+size_t MKLPrimitiveCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+uint64_t MKLWeightVersion::Get(const void *addr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = versions_.find(addr);
+  if (iter != versions_.end()) {
+    return iter->second;
+  }
+  return versions_[addr] = ++last_version_;
+}
+
+void MKLWeightVersion::Update(const void *addr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = versions_.find(addr);
+  if (iter != versions_.end()) {
+    iter->second = ++last_version_;
+  }
+}
+
+void MKLWeightVersion::UpdateWrittenBy(const CNodePtr &kernel, const std::vector<AddressPtr> &inputs,
+                                       const std::vector<AddressPtr> &outputs) {
+  MS_EXCEPTION_IF_NULL(kernel);
+  auto prim = common::AnfAlgo::GetCNodePrimitive(kernel);
+  if (prim != nullptr && GetPrimitiveFlag(prim, GRAPH_FLAG_SIDE_EFFECT_MEM)) {
+    for (const auto &input : inputs) {
+      if (input != nullptr) {
+        Update(input->addr);
+      }
+    }
+    return;
+  }
+  auto kernel_info = dynamic_cast<device::KernelInfo *>(kernel->kernel_info());
+  if (kernel_info == nullptr) {
+    return;
+  }
+  for (const auto &ref : kernel_info->out_in_ref_map()) {
+    if (ref.first < outputs.size() && outputs[ref.first] != nullptr) {
+      Update(outputs[ref.first]->addr);
+    }
+  }
+}
+
+void MKLWeightVersion::Remove(const void *addr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  (void)versions_.erase(addr);
+}
+
+size_t MKLWeightVersion::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return versions_.size();
+}
+
+void PackedWeights::Init(const dnnl::memory::desc &user_desc, const dnnl::memory::desc &packed_desc, bool is_const,
+                         const dnnl::engine &engine) {
+  user_memory_ = dnnl::memory(user_desc, engine, nullptr);
+  packed_memory_ = dnnl::memory(packed_desc, engine);
+  is_const_ = is_const;
+  addr_ = nullptr;
+  version_ = 0;
+}
+
+void *PackedWeights::Pack(void *weight_addr, const dnnl::stream &stream, size_t offset) {
+  MS_EXCEPTION_IF_NULL(weight_addr);
+  if (is_const_) {
+    // Take the version before packing, so that an update during the packing is not missed.
+    auto version = MKLWeightVersion::GetInstance().Get(weight_addr);
+    if (weight_addr == addr_ && version == version_) {
+      return packed_memory_.get_data_handle();
+    }
+    addr_ = weight_addr;
+    version_ = version;
+  }
+  user_memory_.set_data_handle(static_cast<uint8_t *>(weight_addr) + offset);
+  dnnl::reorder(user_memory_, packed_memory_).execute(stream, user_memory_, packed_memory_);
+  return packed_memory_.get_data_handle();
+}
+}  // namespace kernel
+}  // namespace mindspore
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_KERNEL_MKLDNN_MKL_PRIMITIVE_CACHE_H_
+#define MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_KERNEL_MKLDNN_MKL_PRIMITIVE_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "dnnl.hpp"
+#include "ir/anf.h"
+#include "kernel/kernel.h"
+#include "utils/hash_map.h"
+#include "utils/ms_utils.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace kernel {
+// The key of a primitive in the cache, which is made of the kind of the primitive and everything its descriptor is
+// created from.
+class BACKEND_EXPORT PrimitiveKey {
+ public:
+  explicit PrimitiveKey(const std::string &kind) : key_(kind) {}
+  ~PrimitiveKey() = default;
+
+  PrimitiveKey &Add(const dnnl::memory::desc &desc);
+  PrimitiveKey &Add(const dnnl::memory::dims &dims);
+  template <typename T>
+  PrimitiveKey &Add(T value) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Only integers and enums can be added.");
+    (void)key_.append("|").append(std::to_string(static_cast<int64_t>(value)));
+    return *this;
+  }
+
+  const std::string &str() const { return key_; }
+
+ private:
+  std::string key_;
+};
+
+// The primitives created by the mkldnn kernels, shared by the kernels with the same key and evicted in LRU order. In
+// dynamic shape and PyNative mode the kernels are resized or created again and again on a few shapes, which would
+// otherwise create their primitives from scratch every time.
+class BACKEND_EXPORT MKLPrimitiveCache {
+ public:
+  static MKLPrimitiveCache &GetInstance() noexcept {
+    static MKLPrimitiveCache instance;
+    return instance;
+  }
+
+  // All the kernels create their primitives on this engine, so that they can run the primitives of each other.
+  const dnnl::engine &engine() const { return engine_; }
+
+  std::shared_ptr<dnnl::primitive> Get(const std::string &key);
+  void Put(const std::string &key, const std::shared_ptr<dnnl::primitive> &primitive);
+  void Clear();
+  size_t size() const;
+  size_t capacity() const { return capacity_; }
+
+ private:
+  MKLPrimitiveCache();
+  ~MKLPrimitiveCache() = default;
+  DISABLE_COPY_AND_ASSIGN(MKLPrimitiveCache);
+
+  using Entry = std::pair<std::string, std::shared_ptr<dnnl::primitive>>;
+
+  dnnl::engine engine_;
+  size_t capacity_;
+  // The most recently used entries are at the front.
+  std::list<Entry> entries_;
+  mindspore::HashMap<std::string, std::list<Entry>::iterator> index_;
+  mutable std::mutex mutex_;
+};
+
+// The versions of the weights prepacked by the kernels, looked up by the address of the weight. The version changes
+// whenever the weight is written by the host or by the ops updating it, then the kernels pack the weight again. The
+// version of an address is dropped when its memory is freed, so that a weight allocated at the same address later
+// gets a new version, and the versions are only kept for the live weights.
+class BACKEND_EXPORT MKLWeightVersion {
+ public:
+  static MKLWeightVersion &GetInstance() noexcept {
+    static MKLWeightVersion instance;
+    return instance;
+  }
+
+  uint64_t Get(const void *addr);
+  // Only the addresses of the packed weights are tracked, the others are ignored.
+  void Update(const void *addr);
+  // Update the versions of the memory the kernel writes in place, which are the inputs of the ops with the side effect
+  // on memory, such as the optimizers and Assign, and the inputs referred by the outputs.
+  void UpdateWrittenBy(const CNodePtr &kernel, const std::vector<AddressPtr> &inputs,
+                       const std::vector<AddressPtr> &outputs);
+  void Remove(const void *addr);
+  size_t size();
+
+ private:
+  MKLWeightVersion() = default;
+  ~MKLWeightVersion() = default;
+  DISABLE_COPY_AND_ASSIGN(MKLWeightVersion);
+
+  uint64_t last_version_{0};
+  mindspore::HashMap<const void *, uint64_t> versions_;
+  std::mutex mutex_;
+};
+
+// The weights reordered into the layout chosen by the primitive. The weights fed by parameters are packed once and
+// kept across the launches until the parameters are updated, the others are packed on every launch.
+class BACKEND_EXPORT PackedWeights {
+ public:
+  PackedWeights() = default;
+  ~PackedWeights() = default;
+
+  void Init(const dnnl::memory::desc &user_desc, const dnnl::memory::desc &packed_desc, bool is_const,
+            const dnnl::engine &engine);
+  // Returns the packed weights of the weight at weight_addr, whose user data begins offset bytes after it.
+  void *Pack(void *weight_addr, const dnnl::stream &stream, size_t offset = 0);
+
+ private:
+  dnnl::memory user_memory_;
+  dnnl::memory packed_memory_;
+  bool is_const_{false};
+  const void *addr_{nullptr};
+  uint64_t version_{0};
+};
+}  // namespace kernel
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_KERNEL_MKLDNN_MKL_PRIMITIVE_CACHE_H_
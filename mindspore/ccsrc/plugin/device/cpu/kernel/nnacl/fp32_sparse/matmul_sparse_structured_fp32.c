@@ -0,0 +1,167 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/fp32_sparse/matmul_sparse_structured_fp32.h"
+#include "nnacl/matmul_sparse_structured_fp32_simd.h"
+
+static inline float SparseWeightAt(const float *weight, int deep, int col, bool b_transpose, int k, int c) {
+  return b_transpose ? weight[c * deep + k] : weight[k * col + c];
+}
+
+static inline float SparseActFp32(float value, ActType act_type) {
+  if (act_type == ActType_Relu || act_type == ActType_Relu6) {
+    value = MSMAX(value, 0.0f);
+  }
+  if (act_type == ActType_Relu6) {
+    value = MSMIN(value, 6.0f);
+  }
+  return value;
+}
+
+int SparseBlockCount(const float *weight, int deep, int col, bool b_transpose, int *block_offset) {
+  int tile_num = UP_DIV(col, SPARSE_BLOCK_TILE);
+  block_offset[0] = 0;
+  for (int t = 0; t < tile_num; ++t) {
+    int col_end = MSMIN(col, (t + 1) * SPARSE_BLOCK_TILE);
+    int block_num = 0;
+    for (int k = 0; k < deep; ++k) {
+      for (int c = t * SPARSE_BLOCK_TILE; c < col_end; ++c) {
+        if (SparseWeightAt(weight, deep, col, b_transpose, k, c) != 0.0f) {
+          block_num++;
+          break;
+        }
+      }
+    }
+    block_offset[t + 1] = block_offset[t] + block_num;
+  }
+  return block_offset[tile_num];
+}
+
+void SparseBlockPack(const float *weight, int deep, int col, bool b_transpose, const int *block_offset,
+                     int *deep_index, float *data) {
+  int tile_num = UP_DIV(col, SPARSE_BLOCK_TILE);
+  for (int t = 0; t < tile_num; ++t) {
+    int col_end = MSMIN(col, (t + 1) * SPARSE_BLOCK_TILE);
+    int b = block_offset[t];
+    for (int k = 0; k < deep && b < block_offset[t + 1]; ++k) {
+      bool non_zero = false;
+      for (int c = t * SPARSE_BLOCK_TILE; c < col_end; ++c) {
+        non_zero = non_zero || SparseWeightAt(weight, deep, col, b_transpose, k, c) != 0.0f;
+      }
+      if (!non_zero) {
+        continue;
+      }
+      deep_index[b] = k;
+      float *dst = data + b * SPARSE_BLOCK_TILE;
+      for (int i = 0; i < SPARSE_BLOCK_TILE; ++i) {
+        int c = t * SPARSE_BLOCK_TILE + i;
+        dst[i] = c < col_end ? SparseWeightAt(weight, deep, col, b_transpose, k, c) : 0.0f;
+      }
+      b++;
+    }
+  }
+}
+
+void SparseBlockMatmulFp32(const float *a, const float *data, const int *deep_index, const int *block_offset,
+                           const float *bias, float *c, int row, int deep, int col, int start_tile, int end_tile,
+                           ActType act_type) {
+  for (int r = 0; r < row; ++r) {
+    const float *src = a + r * deep;
+    float *dst = c + r * col;
+    int tile_index = start_tile;
+    SIMD_RUN_NO_SCALAR(SparseBlockMatmulRow, tile_index, src, data, deep_index, block_offset, bias, dst, col,
+                       act_type, end_tile);
+    for (; tile_index < end_tile; ++tile_index) {
+      int col_end = MSMIN(col, (tile_index + 1) * SPARSE_BLOCK_TILE);
+      for (int j = tile_index * SPARSE_BLOCK_TILE; j < col_end; ++j) {
+        dst[j] = bias[j];
+      }
+      for (int b = block_offset[tile_index]; b < block_offset[tile_index + 1]; ++b) {
+        float left = src[deep_index[b]];
+        const float *right = data + b * SPARSE_BLOCK_TILE - tile_index * SPARSE_BLOCK_TILE;
+        for (int j = tile_index * SPARSE_BLOCK_TILE; j < col_end; ++j) {
+          dst[j] += left * right[j];
+        }
+      }
+      for (int j = tile_index * SPARSE_BLOCK_TILE; j < col_end; ++j) {
+        dst[j] = SparseActFp32(dst[j], act_type);
+      }
+    }
+  }
+}
+
+bool SparseNMCheck(const float *weight, int deep, int col, bool b_transpose, int n, int m) {
+  if (n <= 0 || m <= n || m > SPARSE_NM_MAX_M) {
+    return false;
+  }
+  for (int c = 0; c < col; ++c) {
+    for (int g = 0; g < deep; g += m) {
+      int non_zero = 0;
+      for (int k = g; k < MSMIN(deep, g + m); ++k) {
+        non_zero += SparseWeightAt(weight, deep, col, b_transpose, k, c) != 0.0f ? 1 : 0;
+      }
+      if (non_zero > n) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void SparseNMPack(const float *weight, int deep, int col, bool b_transpose, int n, int m, float *data,
+                  uint8_t *offset) {
+  int group_num = UP_DIV(deep, m);
+  for (int c = 0; c < col; ++c) {
+    for (int g = 0; g < group_num; ++g) {
+      float *dst = data + (c * group_num + g) * n;
+      uint8_t *dst_offset = offset + (c * group_num + g) * n;
+      int s = 0;
+      for (int k = g * m; k < MSMIN(deep, (g + 1) * m) && s < n; ++k) {
+        float value = SparseWeightAt(weight, deep, col, b_transpose, k, c);
+        if (value != 0.0f) {
+          dst[s] = value;
+          dst_offset[s] = (uint8_t)(k - g * m);
+          s++;
+        }
+      }
+      for (; s < n; ++s) {
+        dst[s] = 0.0f;
+        dst_offset[s] = 0;
+      }
+    }
+  }
+}
+
+void SparseNMMatmulFp32(const float *a_t, const float *data, const uint8_t *offset, const float *bias, float *c,
+                        int row, int deep, int col, int n, int m, int start_col, int end_col, ActType act_type) {
+  int group_num = UP_DIV(deep, m);
+  for (int j = start_col; j < end_col; ++j) {
+    const float *col_data = data + j * group_num * n;
+    const uint8_t *col_offset = offset + j * group_num * n;
+    float col_bias = bias == NULL ? 0.0f : bias[j];
+    int row_index = 0;
+    SIMD_RUN_NO_SCALAR(SparseNMMatmulCol, row_index, a_t, col_data, col_offset, col_bias, c + j, row, group_num, n,
+                       m, col, act_type);
+    for (; row_index < row; ++row_index) {
+      float acc = col_bias;
+      for (int i = 0; i < group_num * n; ++i) {
+        int k = (i / n) * m + col_offset[i];
+        acc += a_t[k * row + row_index] * col_data[i];
+      }
+      c[row_index * col + j] = SparseActFp32(acc, act_type);
+    }
+  }
+}
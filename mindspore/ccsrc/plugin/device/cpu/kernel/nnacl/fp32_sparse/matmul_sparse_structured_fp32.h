@@ -0,0 +1,53 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_NNACL_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+#define MINDSPORE_NNACL_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nnacl/op_base.h"
+
+// 16x1 block sparse: a block is 16 adjacent output channels of one input channel, only non-zero blocks are stored.
+#define SPARSE_BLOCK_TILE C16NUM
+// N:M sparse: at most n of every m adjacent input channels of one output channel are non-zero, m <= 255.
+#define SPARSE_NM_MAX_M 255
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// weight is deep x col, or col x deep when b_transpose, which is the layout of FullConnection.
+// block_offset has UP_DIV(col, 16) + 1 items, returns the number of non-zero blocks.
+int SparseBlockCount(const float *weight, int deep, int col, bool b_transpose, int *block_offset);
+// deep_index has one item and data has 16 floats for every non-zero block, the last tile is padded with zero.
+void SparseBlockPack(const float *weight, int deep, int col, bool b_transpose, const int *block_offset,
+                     int *deep_index, float *data);
+// a is row x deep, c is row x col, bias is padded to UP_ROUND(col, 16), computes column tiles [start_tile, end_tile).
+void SparseBlockMatmulFp32(const float *a, const float *data, const int *deep_index, const int *block_offset,
+                           const float *bias, float *c, int row, int deep, int col, int start_tile, int end_tile,
+                           ActType act_type);
+
+bool SparseNMCheck(const float *weight, int deep, int col, bool b_transpose, int n, int m);
+// data and offset have UP_DIV(deep, m) * n items for every output channel, unused slots are zero.
+void SparseNMPack(const float *weight, int deep, int col, bool b_transpose, int n, int m, float *data,
+                  uint8_t *offset);
+// a_t is the transposed input in deep x row, c is row x col, computes output channels [start_col, end_col).
+void SparseNMMatmulFp32(const float *a_t, const float *data, const uint8_t *offset, const float *bias, float *c,
+                        int row, int deep, int col, int n, int m, int start_col, int end_col, ActType act_type);
+#ifdef __cplusplus
+}
+#endif
+#endif  // MINDSPORE_NNACL_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
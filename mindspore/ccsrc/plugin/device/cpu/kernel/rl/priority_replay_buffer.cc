@@ -16,8 +16,8 @@
 
 #include "plugin/device/cpu/kernel/rl/priority_replay_buffer.h"
 
+#include <cmath>
 #include <vector>
-#include <tuple>
 #include <memory>
 #include <algorithm>
 #include "kernel/kernel.h"
@@ -25,6 +25,9 @@
 namespace mindspore {
 namespace kernel {
 constexpr float kMinPriority = 1e-7;
+// The buffer is split into shards of at least kMinShardCapacity transitions, the small buffers keep a single shard.
+constexpr size_t kMinShardCapacity = 1 << 16;
+constexpr size_t kMaxShardNum = 16;
 
 PriorityTree::PriorityTree(size_t capacity, const PriorityItem &init_value)
     : SegmentTree<PriorityItem>(capacity, init_value) {}
@@ -48,73 +51,221 @@ size_t PriorityTree::GetPrefixSumIdx(float prefix_sum) const {
   return idx - capacity_;
 }
 
+void PriorityTree::GetPrefixSumIdx(float *prefix_sums, size_t num, size_t *indices) const {
+  MS_EXCEPTION_IF_NULL(prefix_sums);
+  MS_EXCEPTION_IF_NULL(indices);
+  const PriorityItem *nodes = buffer_.data();
+  for (size_t i = 0; i < num; i++) {
+    indices[i] = kRootIndex;
+  }
+  for (size_t level_capacity = 1; level_capacity < capacity_; level_capacity *= kNumSubnodes) {
+    for (size_t i = 0; i < num; i++) {
+      size_t left = kNumSubnodes * indices[i];
+      float left_priority = nodes[left].sum_priority;
+      bool right = prefix_sums[i] > left_priority;
+      prefix_sums[i] -= right ? left_priority : 0.0f;
+      indices[i] = left + static_cast<size_t>(right);
+    }
+  }
+  for (size_t i = 0; i < num; i++) {
+    indices[i] -= capacity_;
+  }
+}
+
 PriorityReplayBuffer::PriorityReplayBuffer(uint32_t seed, float alpha, size_t capacity,
                                            const std::vector<size_t> &schema)
     : alpha_(alpha), capacity_(capacity), max_priority_(1.0), schema_(schema) {
+  MS_EXCEPTION_IF_ZERO("capacity", capacity);
   random_engine_.seed(seed);
-  fifo_replay_buffer_ = std::make_unique<FIFOReplayBuffer>(capacity, schema);
-  priority_tree_ = std::make_unique<PriorityTree>(capacity);
+  size_t shard_num = std::min(kMaxShardNum, std::max(size_t(1), capacity / kMinShardCapacity));
+  shard_capacity_ = (capacity + shard_num - 1) / shard_num;
+  for (size_t i = 0; i < shard_num; i++) {
+    auto shard = std::make_unique<Shard>();
+    size_t shard_capacity = std::min(shard_capacity_, capacity - i * shard_capacity_);
+    shard->fifo_replay_buffer = std::make_unique<FIFOReplayBuffer>(shard_capacity, schema);
+    shard->priority_tree = std::make_unique<PriorityTree>(shard_capacity);
+    (void)shards_.emplace_back(std::move(shard));
+  }
 }
 
 bool PriorityReplayBuffer::Push(const std::vector<AddressPtr> &items) {
-  (void)fifo_replay_buffer_->Push(items);
-  auto idx = fifo_replay_buffer_->head();
-
+  auto &shard = shards_[push_count_.fetch_add(1, std::memory_order_relaxed) % shards_.size()];
   // Set max priority for the newest item.
-  float priority = static_cast<float>(pow(max_priority_, alpha_));
-  priority_tree_->Insert(idx, {priority, priority});
+  float priority = static_cast<float>(pow(max_priority_.load(std::memory_order_relaxed), alpha_));
+
+  std::lock_guard<std::mutex> lock(shard->mutex);
+  (void)shard->fifo_replay_buffer->Push(items);
+  auto idx = shard->fifo_replay_buffer->head();
+  shard->priority_tree->Insert(idx, {priority, priority});
   return true;
 }
 
+void PriorityReplayBuffer::UpdateMaxPriority(float priority) {
+  float max_priority = max_priority_.load(std::memory_order_relaxed);
+  while (priority > max_priority &&
+         !max_priority_.compare_exchange_weak(max_priority, priority, std::memory_order_relaxed)) {
+  }
+}
+
 bool PriorityReplayBuffer::UpdatePriorities(const std::vector<size_t> &indices, const std::vector<float> &priorities) {
   if (indices.size() != priorities.size()) {
     return false;
   }
 
+  // Group the updates by the shards, so that every shard is locked only once.
+  std::vector<std::vector<size_t>> shard_updates(shards_.size());
   for (size_t i = 0; i < indices.size(); i++) {
-    float priority = static_cast<float>(pow(priorities[i], alpha_));
-    if (priority <= 0.0f) {
-      MS_LOG(WARNING) << "The priority is " << priority << ". It may lead to converge issue.";
-      priority = kMinPriority;
+    if (indices[i] >= capacity_) {
+      MS_LOG(EXCEPTION) << "Index " << indices[i] << " out of range " << capacity_;
     }
-    priority_tree_->Insert(indices[i], {priority, priority});
+    (void)shard_updates[indices[i] / shard_capacity_].emplace_back(i);
+  }
 
-    // Record max priority of transitions
-    max_priority_ = std::max(max_priority_, priorities[i]);
+  for (size_t shard_id = 0; shard_id < shards_.size(); shard_id++) {
+    if (shard_updates[shard_id].empty()) {
+      continue;
+    }
+    auto &shard = shards_[shard_id];
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto i : shard_updates[shard_id]) {
+      float priority = static_cast<float>(pow(priorities[i], alpha_));
+      if (priority <= 0.0f) {
+        MS_LOG(WARNING) << "The priority is " << priority << ". It may lead to converge issue.";
+        priority = kMinPriority;
+      }
+      shard->priority_tree->Insert(indices[i] - shard_id * shard_capacity_, {priority, priority});
+    }
   }
 
+  // Record max priority of transitions
+  for (auto priority : priorities) {
+    UpdateMaxPriority(priority);
+  }
   return true;
 }
 
-std::tuple<std::vector<size_t>, std::vector<float>, std::vector<std::vector<AddressPtr>>> PriorityReplayBuffer::Sample(
-  size_t batch_size, float beta) {
+size_t PriorityReplayBuffer::size() {
+  size_t size = 0;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    size += shard->fifo_replay_buffer->size();
+  }
+  return size;
+}
+
+bool PriorityReplayBuffer::Sample(size_t batch_size, float beta, size_t *indices, float *weights,
+                                  const std::vector<AddressPtr> &transition) {
   MS_EXCEPTION_IF_ZERO("batch size", batch_size);
-  const PriorityItem &root = priority_tree_->Root();
-  float sum_priority = root.sum_priority;
-  float min_priority = root.min_priority;
-  size_t size = fifo_replay_buffer_->size();
+  MS_EXCEPTION_IF_NULL(indices);
+  MS_EXCEPTION_IF_NULL(weights);
+  if (transition.size() != schema_.size()) {
+    MS_LOG(EXCEPTION) << "Transition element num error. Expect " << schema_.size() << " , but got "
+                      << transition.size();
+  }
+  for (size_t i = 0; i < schema_.size(); i++) {
+    MS_EXCEPTION_IF_NULL(transition[i]);
+    if (transition[i]->size < schema_[i] * batch_size) {
+      MS_LOG(EXCEPTION) << "The output size " << transition[i]->size << " is less than " << schema_[i] * batch_size;
+    }
+  }
+
+  // Take a snapshot of the shards, the stratified masses are spread over the priorities of all the shards.
+  std::vector<float> shard_sums(shards_.size());
+  float sum_priority = 0.0f;
+  float min_priority = std::numeric_limits<float>::max();
+  size_t size = 0;
+  for (size_t shard_id = 0; shard_id < shards_.size(); shard_id++) {
+    auto &shard = shards_[shard_id];
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    const PriorityItem &root = shard->priority_tree->Root();
+    shard_sums[shard_id] = root.sum_priority;
+    sum_priority += root.sum_priority;
+    min_priority = std::min(min_priority, root.min_priority);
+    size += shard->fifo_replay_buffer->size();
+  }
+  if (size == 0) {
+    MS_LOG(EXCEPTION) << "Can not sample from an empty priority replay buffer.";
+  }
+
   float max_weight = Weight(min_priority, sum_priority, size, beta);
-  float segment_len = root.sum_priority / batch_size;
+  if (max_weight <= 0.0f) {
+    MS_LOG(WARNING) << "The max priority is " << max_weight << ". It may leads to converge issue.";
+    max_weight = kMinPriority;
+  }
 
-  std::vector<size_t> indices;
-  std::vector<float> weights;
-  std::vector<std::vector<AddressPtr>> items;
-  for (size_t i = 0; i < batch_size; i++) {
-    float mass = (dist_(random_engine_) + i) * segment_len;
-    size_t idx = priority_tree_->GetPrefixSumIdx(mass);
+  float segment_len = sum_priority / batch_size;
+  std::vector<float> masses(batch_size);
+  {
+    std::lock_guard<std::mutex> lock(random_mutex_);
+    for (size_t i = 0; i < batch_size; i++) {
+      masses[i] = (dist_(random_engine_) + i) * segment_len;
+    }
+  }
 
-    (void)indices.emplace_back(idx);
-    float priority = priority_tree_->GetByIndex(idx).sum_priority;
+  // The masses are ascending, so the masses of a shard are contiguous.
+  size_t last_shard = 0;
+  for (size_t shard_id = 0; shard_id < shards_.size(); shard_id++) {
+    if (shard_sums[shard_id] > 0.0f) {
+      last_shard = shard_id;
+    }
+  }
+  size_t start = 0;
+  float shard_offset = 0.0f;
+  for (size_t shard_id = 0; shard_id <= last_shard && start < batch_size; shard_id++) {
+    if (shard_sums[shard_id] <= 0.0f) {
+      continue;
+    }
+    float shard_end = shard_offset + shard_sums[shard_id];
+    size_t end = start;
+    while (end < batch_size && (shard_id == last_shard || masses[end] <= shard_end)) {
+      masses[end] -= shard_offset;
+      end++;
+    }
+    if (end > start) {
+      SampleShard(shard_id, shard_sums[shard_id], sum_priority, size, beta, max_weight, start, end, masses.data(),
+                  indices, weights, transition);
+    }
+    start = end;
+    shard_offset = shard_end;
+  }
+  return true;
+}
 
-    if (max_weight <= 0.0f) {
-      MS_LOG(WARNING) << "The max priority is " << max_weight << ". It may leads to converge issue.";
-      max_weight = kMinPriority;
+void PriorityReplayBuffer::SampleShard(size_t shard_id, float snapshot_sum, float sum_priority, size_t size,
+                                       float beta, float max_weight, size_t start, size_t end, float *masses,
+                                       size_t *indices, float *weights, const std::vector<AddressPtr> &transition) {
+  auto &shard = shards_[shard_id];
+  std::lock_guard<std::mutex> lock(shard->mutex);
+  const auto &tree = shard->priority_tree;
+  const auto &fifo = shard->fifo_replay_buffer;
+  // The shard may be pushed or updated since the snapshot, rescale the masses to its current priorities.
+  float shard_sum = tree->Root().sum_priority;
+  if (shard_sum != snapshot_sum && snapshot_sum > 0.0f) {
+    float scale = shard_sum / snapshot_sum;
+    for (size_t i = start; i < end; i++) {
+      masses[i] *= scale;
     }
-    (void)weights.emplace_back(Weight(priority, sum_priority, size, beta) / max_weight);
-    (void)items.emplace_back(fifo_replay_buffer_->GetItem(idx));
   }
+  tree->GetPrefixSumIdx(masses + start, end - start, indices + start);
 
-  return std::forward_as_tuple(indices, weights, items);
+  size_t shard_size = fifo->size();
+  const auto &buffer = fifo->GetAll();
+  for (size_t i = start; i < end; i++) {
+    // The rounding of the float sums may lead the search to the empty leaves at the end.
+    size_t idx = std::min(indices[i], shard_size - 1);
+    float priority = tree->GetByIndex(idx).sum_priority;
+    weights[i] = Weight(priority, sum_priority, size, beta) / max_weight;
+    indices[i] = shard_id * shard_capacity_ + idx;
+    for (size_t item = 0; item < schema_.size(); item++) {
+      size_t dst_offset = schema_[item] * i;
+      auto ret = memcpy_s(static_cast<uint8_t *>(transition[item]->addr) + dst_offset,
+                          transition[item]->size - dst_offset,
+                          static_cast<uint8_t *>(buffer[item]->addr) + schema_[item] * idx, schema_[item]);
+      if (ret != EOK) {
+        MS_LOG(EXCEPTION) << "memcpy_s() failed. Error code: " << ret;
+      }
+    }
+  }
 }
 
 inline float PriorityReplayBuffer::Weight(float priority, float sum_priority, size_t size, float beta) const {
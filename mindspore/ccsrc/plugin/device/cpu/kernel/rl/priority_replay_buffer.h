@@ -17,10 +17,11 @@
 #ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_PRIORITY_REPLAY_BUFFER_H_
 #define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_PRIORITY_REPLAY_BUFFER_H_
 
+#include <atomic>
 #include <vector>
-#include <tuple>
 #include <memory>
 #include <limits>
+#include <mutex>
 #include <random>
 #include "kernel/kernel.h"
 #include "utils/log_adapter.h"
@@ -48,12 +49,19 @@ class PriorityTree : public SegmentTree<PriorityItem> {
 
   // Find the minimal index greater than prefix_sum.
   size_t GetPrefixSumIdx(float prefix_sum) const;
+
+  // Find the indices of a batch of prefix sums, the prefix sums are consumed. The batch descends the tree one level at
+  // a time with a branch free loop, so the loads of the different prefix sums overlap and the loop can be vectorized.
+  void GetPrefixSumIdx(float *prefix_sums, size_t num, size_t *indices) const;
 };
 
 // PriorityReplayBuffer is experience container used in Deep Q-Networks.
 // The algorithm is proposed in `Prioritized Experience Replay <https://arxiv.org/abs/1511.05952>`.
 // Same as the normal replay buffer, it lets the reinforcement learning agents remember and reuse experiences from the
 // past. Besides, it replays important transitions more frequently and improve sample effciency.
+// A large buffer is split into shards which are guarded by their own locks, so that the actors pushing transitions and
+// the learner sampling and updating priorities run concurrently. The transitions are pushed to the shards in turn, and
+// the index of a transition is the offset of its shard plus its index in the shard.
 class PriorityReplayBuffer {
  public:
   // Construct a fixed-length priority replay buffer.
@@ -62,24 +70,43 @@ class PriorityReplayBuffer {
   // Push an experience transition to the buffer which will be given the highest priority.
   bool Push(const std::vector<AddressPtr> &items);
 
-  // Sample a batch transitions with indices and bias correction weights.
-  std::tuple<std::vector<size_t>, std::vector<float>, std::vector<std::vector<AddressPtr>>> Sample(size_t batch_size,
-                                                                                                   float beta);
+  // Sample a batch transitions with indices and bias correction weights. The transitions are copied to the buffers of
+  // transition, one for each item of the schema, while the shards are locked.
+  bool Sample(size_t batch_size, float beta, size_t *indices, float *weights,
+              const std::vector<AddressPtr> &transition);
 
   // Update experience transitions priorities.
   bool UpdatePriorities(const std::vector<size_t> &indices, const std::vector<float> &priorities);
 
+  // Return the valid transitions number.
+  size_t size();
+
+  size_t shard_num() const { return shards_.size(); }
+
  private:
+  struct Shard {
+    std::mutex mutex;
+    std::unique_ptr<FIFOReplayBuffer> fifo_replay_buffer;
+    std::unique_ptr<PriorityTree> priority_tree;
+  };
+
   inline float Weight(float priority, float sum_priority, size_t size, float beta) const;
+  void UpdateMaxPriority(float priority);
+  // Sample the masses in [start, end) which fall into the shard, their prefix sums are relative to the shard.
+  void SampleShard(size_t shard_id, float snapshot_sum, float sum_priority, size_t size, float beta, float max_weight,
+                   size_t start, size_t end, float *masses, size_t *indices, float *weights,
+                   const std::vector<AddressPtr> &transition);
 
   float alpha_;
   size_t capacity_;
-  float max_priority_;
+  size_t shard_capacity_;
+  std::atomic<float> max_priority_;
+  std::atomic<size_t> push_count_{0};
   std::vector<size_t> schema_;
+  std::mutex random_mutex_;
   std::default_random_engine random_engine_;
   std::uniform_real_distribution<float> dist_{0, 1};
-  std::unique_ptr<FIFOReplayBuffer> fifo_replay_buffer_;
-  std::unique_ptr<PriorityTree> priority_tree_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 }  // namespace kernel
 }  // namespace mindspore
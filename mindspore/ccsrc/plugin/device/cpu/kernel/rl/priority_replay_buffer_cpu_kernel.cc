@@ -101,32 +101,19 @@ void PriorityReplayBufferSampleCpuKernel::InitKernel(const CNodePtr &kernel_node
 
 bool PriorityReplayBufferSampleCpuKernel::Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &,
                                                  const std::vector<AddressPtr> &outputs) {
-  std::vector<size_t> indices;
-  std::vector<float> weights;
-  std::vector<std::vector<AddressPtr>> samples;
-
-  auto beta = reinterpret_cast<float *>(inputs[0]->addr);
-  std::tie(indices, weights, samples) = prioriory_replay_buffer_->Sample(batch_size_, beta[0]);
-
   MS_EXCEPTION_IF_CHECK_FAIL(outputs.size() == schema_.size() + kTransitionIndex,
                              "The dtype and shapes must be the same.");
-  MS_EXCEPTION_IF_CHECK_FAIL(memcpy_s(outputs[kIndicesIndex]->addr, outputs[kIndicesIndex]->size, indices.data(),
-                                      batch_size_ * sizeof(int64_t)) == EOK,
-                             "memcpy_s() failed.");
-  MS_EXCEPTION_IF_CHECK_FAIL(memcpy_s(outputs[kInWeightsIndex]->addr, outputs[kInWeightsIndex]->size, weights.data(),
-                                      batch_size_ * sizeof(float)) == EOK,
-                             "memcpy_s() failed.");
+  MS_EXCEPTION_IF_CHECK_FAIL(outputs[kIndicesIndex]->size >= batch_size_ * sizeof(int64_t),
+                             "The indices output is too small.");
+  MS_EXCEPTION_IF_CHECK_FAIL(outputs[kInWeightsIndex]->size >= batch_size_ * sizeof(float),
+                             "The weights output is too small.");
+  static_assert(sizeof(size_t) == sizeof(int64_t), "The indices are written to the int64 output.");
 
-  for (size_t transition_index = 0; transition_index < samples.size(); transition_index++) {
-    const std::vector<AddressPtr> &transition = samples[transition_index];
-    for (size_t item_index = 0; item_index < schema_.size(); item_index++) {
-      void *offset = reinterpret_cast<uint8_t *>(outputs[item_index + kTransitionIndex]->addr) +
-                     schema_[item_index] * transition_index;
-      MS_EXCEPTION_IF_CHECK_FAIL(memcpy_s(offset, outputs[item_index + kTransitionIndex]->size,
-                                          transition[item_index]->addr, transition[item_index]->size) == EOK,
-                                 "memcpy_s() failed.");
-    }
-  }
+  auto beta = reinterpret_cast<float *>(inputs[0]->addr);
+  auto indices = reinterpret_cast<size_t *>(outputs[kIndicesIndex]->addr);
+  auto weights = reinterpret_cast<float *>(outputs[kInWeightsIndex]->addr);
+  std::vector<AddressPtr> transition(outputs.begin() + kTransitionIndex, outputs.end());
+  (void)prioriory_replay_buffer_->Sample(batch_size_, beta[0], indices, weights, transition);
 
   return true;
 }
@@ -56,6 +56,7 @@ void ComputeFtrl(MultiThreadComputeParams<T> *input_params, size_t start, size_t
   const auto unique_sparse_grad = input_params->sparse_grad_;
   const auto var_first_dim_size = input_params->var_first_dim_size_;
   const auto var_outer_dim_size = input_params->var_outer_dim_size_;
+  const bool sqrt_lr_power = std::fabs(lr_power + kPowToSqrtValue) <= std::numeric_limits<float>::epsilon();
   for (size_t i = start; i < end; ++i) {
     T index = unique_sparse_grad.indices_[i];
     if (index < 0 || LongToSize(index) >= var_first_dim_size) {
@@ -64,18 +65,27 @@ void ComputeFtrl(MultiThreadComputeParams<T> *input_params, size_t start, size_t
     }
     size_t start_index = var_outer_dim_size * static_cast<size_t>(index);
     size_t end_index = start_index + var_outer_dim_size;
+    // The branch of lr_power is taken out of the loop over the row, so that the common sqrt case can be vectorized.
+    if (sqrt_lr_power) {
+      for (size_t j = start_index, k = var_outer_dim_size * i; j < end_index; ++j, ++k) {
+        auto summed_grad = unique_sparse_grad.value_[k];
+        auto accum_new = accum[j] + summed_grad * summed_grad;
+        float y = std::sqrt(accum_new);
+        linear[j] += summed_grad;
+        linear[j] -= ((y - std::sqrt(accum[j])) / lr) * var[j];
+        accum[j] = accum_new;
+        auto x = Sign(linear[j]) * l1 - linear[j];
+        y = y / lr + l2_plus;
+        var[j] = std::fabs(linear[j]) > l1 ? x / y : 0;
+      }
+      continue;
+    }
     for (size_t j = start_index, k = var_outer_dim_size * i; j < end_index; ++j, ++k) {
       auto summed_grad = unique_sparse_grad.value_[k];
       auto accum_new = accum[j] + summed_grad * summed_grad;
-      float y;
+      float y = std::pow(accum_new, -lr_power);
       linear[j] += summed_grad;
-      if (std::fabs(lr_power + kPowToSqrtValue) <= std::numeric_limits<float>::epsilon()) {
-        y = std::sqrt(accum_new);
-        linear[j] -= ((y - std::sqrt(accum[j])) / lr) * var[j];
-      } else {
-        y = std::pow(accum_new, -lr_power);
-        linear[j] -= ((y - std::pow(accum[j], -lr_power)) / lr) * var[j];
-      }
+      linear[j] -= ((y - std::pow(accum[j], -lr_power)) / lr) * var[j];
       accum[j] = accum_new;
       auto x = Sign(linear[j]) * l1 - linear[j];
       y = y / lr + l2_plus;
@@ -267,7 +277,6 @@ bool FusedSparseFtrlCpuKernelMod::LaunchKernel(const std::vector<kernel::Address
   param.output_grad_ = &unique_sparse_grad;
   param.max_index_ = var_first_dim_size_;
   param.value_stride_ = var_outer_dim_size_;
-  BucketReduceSparseGradient(param);
 
   MultiThreadComputeParams<T> input_params;
   input_params.var_ = var;
@@ -277,10 +286,9 @@ bool FusedSparseFtrlCpuKernelMod::LaunchKernel(const std::vector<kernel::Address
   input_params.l1_ = l1_;
   input_params.l2_ = l2_;
   input_params.lr_power_ = lr_power_;
-  input_params.sparse_grad_ = unique_sparse_grad;
   input_params.var_first_dim_size_ = var_first_dim_size_;
   input_params.var_outer_dim_size_ = var_outer_dim_size_;
-  MultiThreadCompute<T>(ComputeFtrl<T>, &input_params, unique_sparse_grad.indices_size_);
+  BucketReduceAndApplySparseGradient<T>(param, ComputeFtrl<T>, input_params);
   return true;
 }
 
@@ -20,6 +20,7 @@
 #include <utility>
 #include "kernel/common_utils.h"
 #include "plugin/device/cpu/hal/device/cpu_device_address.h"
+#include "plugin/device/cpu/kernel/nnacl/fp32/adam_fp32.h"
 #include "ops/fused_sparse_lazy_adam.h"
 
 namespace mindspore {
@@ -63,18 +64,10 @@ void ComputeLazyAdam(MultiThreadComputeParams<T> *input_params, size_t start, si
       MS_LOG(EXCEPTION) << "For '" << kKernelName << "', each element in 'indices' must be in range [0, "
                         << SizeToLong(var_first_dim_size) << "), but got " << index;
     }
+    // The row is updated by the vectorized adam of nnacl.
     size_t start_index = var_outer_dim_size * static_cast<size_t>(index);
-    size_t end_index = start_index + var_outer_dim_size;
-    for (size_t j = start_index, k = var_outer_dim_size * i; j < end_index; ++j, ++k) {
-      auto summed_grad = unique_sparse_grad.value_[k];
-      m[j] = beta1 * m[j] + (1 - beta1) * summed_grad;
-      v[j] = beta2 * v[j] + (1 - beta2) * summed_grad * summed_grad;
-      if (use_nesterov) {
-        var[j] -= lr * (m[j] * beta1 + (1 - beta1) * summed_grad) / (std::sqrt(v[j]) + epsilon);
-      } else {
-        var[j] -= lr * m[j] / (std::sqrt(v[j]) + epsilon);
-      }
-    }
+    (void)AdamFp32(var + start_index, m + start_index, v + start_index, lr, beta1, beta2, epsilon,
+                   unique_sparse_grad.value_ + var_outer_dim_size * i, 0, var_outer_dim_size, use_nesterov);
   }
 }
 }  // namespace
@@ -264,7 +257,6 @@ bool SparseApplyLazyAdamCpuKernelMod::LaunchKernel(const std::vector<kernel::Add
   param.output_grad_ = &unique_sparse_grad;
   param.max_index_ = var_first_dim_size_;
   param.value_stride_ = var_outer_dim_size_;
-  BucketReduceSparseGradient(param);
 
   lr = lr * std::sqrt(1 - beta2_power) / (1 - beta1_power);
   MultiThreadComputeParams<T> input_params;
@@ -276,10 +268,9 @@ bool SparseApplyLazyAdamCpuKernelMod::LaunchKernel(const std::vector<kernel::Add
   input_params.beta2_ = beta2;
   input_params.epsilon_ = epsilon;
   input_params.use_nesterov_ = use_nesterov_;
-  input_params.sparse_grad_ = unique_sparse_grad;
   input_params.var_first_dim_size_ = var_first_dim_size_;
   input_params.var_outer_dim_size_ = var_outer_dim_size_;
-  MultiThreadCompute<T>(ComputeLazyAdam<T>, &input_params, unique_sparse_grad.indices_size_);
+  BucketReduceAndApplySparseGradient<T>(param, ComputeLazyAdam<T>, input_params);
   return true;
 }
 
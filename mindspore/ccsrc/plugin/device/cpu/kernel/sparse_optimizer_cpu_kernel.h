@@ -19,7 +19,7 @@
 
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <cstdint>
 #include <algorithm>
 #include <utility>
 #include "plugin/device/cpu/kernel/cpu_kernel.h"
@@ -118,6 +118,62 @@ class SparseOptimizerCpuKernelMod : public NativeCpuKernelMod {
     MS_LOG(DEBUG) << "End";
   }
 
+  // Reduce the sparse gradient and apply `func` to the reduced rows in one parallel launch. The indices are divided
+  // into buckets by value, so each row is reduced and updated by one thread only, without merging the buckets. The
+  // output grad of `param` is used as the bucket buffer, its content is undefined after the call.
+  template <typename T>
+  static void BucketReduceAndApplySparseGradient(const ReduceSparseGradientParam<T> &param,
+                                                 const MultiThreadComputeFunc<T> &func,
+                                                 const MultiThreadComputeParams<T> &compute_params) {
+    MS_LOG(DEBUG) << "Start";
+    MS_EXCEPTION_IF_NULL(param.input_grad_);
+    MS_EXCEPTION_IF_NULL(param.workspace_grad_);
+    MS_EXCEPTION_IF_NULL(param.workspace_grad_->value_);
+    MS_EXCEPTION_IF_NULL(param.workspace_grad_->indices_);
+    if (param.input_grad_->indices_size_ == 0) {
+      return;
+    }
+    size_t thread_num = common::ThreadPool::GetInstance().GetSyncRunThreadNum();
+    if (param.input_grad_->indices_size_ < thread_num) {
+      thread_num = param.input_grad_->indices_size_;
+    }
+    MultiThreadReduceSparseGradientParam<T> multi_thread_param(
+      {param.input_grad_, param.workspace_grad_, param.output_grad_, param.max_index_, param.value_stride_, thread_num,
+       param.use_sort_reduce_});
+    std::vector<std::shared_ptr<SparseGradient<T>>> segments;
+    std::vector<std::shared_ptr<std::vector<size_t>>> segment_bucket_sizes;
+    SplitAndCalculateSegmentBucketSize(multi_thread_param, &segments, &segment_bucket_sizes);
+
+    std::vector<std::shared_ptr<BucketSparseGradient<T>>> buckets;
+    GatherSegmentIndicesToOutputBucket(multi_thread_param, segments, segment_bucket_sizes, &buckets);
+
+    std::vector<std::shared_ptr<SparseGradient<T>>> reduced_buckets;
+    std::vector<common::Task> tasks;
+    tasks.reserve(buckets.size());
+    size_t current_indices_offset = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      (void)reduced_buckets.emplace_back(std::make_shared<SparseGradient<T>>());
+      reduced_buckets[i]->value_ = param.workspace_grad_->value_ + current_indices_offset * param.value_stride_;
+      reduced_buckets[i]->indices_ = param.workspace_grad_->indices_ + current_indices_offset;
+      reduced_buckets[i]->indices_size_ = buckets[i]->indices_size_;
+      auto task = [&multi_thread_param, &buckets, &reduced_buckets, &func, &compute_params, i]() {
+        if (multi_thread_param.use_sort_reduce_) {
+          SortAndReduceBucketSparseGradient<T>(multi_thread_param, buckets[i], reduced_buckets[i]);
+        } else {
+          ReduceBucketSparseGradient<T>(multi_thread_param, buckets[i], reduced_buckets[i]);
+        }
+        auto bucket_params = compute_params;
+        bucket_params.sparse_grad_ = *reduced_buckets[i];
+        func(&bucket_params, 0, reduced_buckets[i]->indices_size_);
+        return common::SUCCESS;
+      };
+      (void)tasks.emplace_back(task);
+      current_indices_offset += buckets[i]->indices_size_;
+    }
+    ParallelLaunch(tasks);
+    MS_LOG(DEBUG) << "End";
+  }
+
  protected:
   template <typename T>
   void MultiThreadCompute(const MultiThreadComputeFunc<T> &func, MultiThreadComputeParams<T> *params,
@@ -140,6 +196,19 @@ class SparseOptimizerCpuKernelMod : public NativeCpuKernelMod {
   }
 
  private:
+  // The hash table of indices is kept at most half full.
+  static constexpr size_t kHashTableLoadFactorInverse = 2;
+
+  // The indices of a bucket are congruent modulo the bucket number, so they are mixed by the multiplicative hash
+  // before taking the low bits.
+  template <typename T>
+  static size_t HashIndex(T index) {
+    constexpr uint64_t kGoldenRatio = 0x9E3779B97F4A7C15ULL;
+    constexpr uint64_t kShiftBits = 32;
+    uint64_t hash = static_cast<uint64_t>(index) * kGoldenRatio;
+    return static_cast<size_t>(hash ^ (hash >> kShiftBits));
+  }
+
   template <typename T>
   static void CalculateEachBucketSize(const std::shared_ptr<SparseGradient<T>> &sparse_grad, size_t max_index,
                                       std::vector<size_t> *each_bucket_size) {
@@ -346,18 +415,29 @@ class SparseOptimizerCpuKernelMod : public NativeCpuKernelMod {
     MS_EXCEPTION_IF_NULL(reduced_bucket->value_);
     MS_EXCEPTION_IF_NULL(reduced_bucket->indices_);
 
+    // The unique indices are found by an open addressing hash table with linear probing, whose slots record the
+    // positions of the unique indices in the reduced bucket. The unique indices keep the order of first appearance.
+    size_t capacity = 1;
+    while (capacity < bucket->indices_size_ * kHashTableLoadFactorInverse) {
+      capacity <<= 1;
+    }
+    const size_t mask = capacity - 1;
+    std::vector<size_t> slots(capacity, SIZE_MAX);
+
     float *global_value = param.input_grad_->value_;
-    std::unordered_map<T, size_t> index_map;
     size_t unique_indices_size = 0;
     size_t max_length = reduced_bucket->indices_size_ * param.value_stride_;
     for (size_t i = 0; i < bucket->indices_size_; ++i) {
       T index = bucket->indices_[i];
       T global_index = bucket->global_indices_[i];
-      auto iter = index_map.find(index);
-      if (iter == index_map.end()) {
+      size_t pos = HashIndex(index) & mask;
+      while (slots[pos] != SIZE_MAX && reduced_bucket->indices_[slots[pos]] != index) {
+        pos = (pos + 1) & mask;
+      }
+      if (slots[pos] == SIZE_MAX) {
+        slots[pos] = unique_indices_size;
         reduced_bucket->indices_[unique_indices_size] = index;
         size_t start_index = unique_indices_size * param.value_stride_;
-        index_map[index] = start_index;
         auto ret_code =
           memcpy_s(reduced_bucket->value_ + start_index, (max_length - start_index) * sizeof(float),
                    global_value + global_index * param.value_stride_, param.value_stride_ * sizeof(float));
@@ -366,10 +446,10 @@ class SparseOptimizerCpuKernelMod : public NativeCpuKernelMod {
         }
         unique_indices_size++;
       } else {
-        size_t start_index = iter->second;
-        size_t end_index = start_index + param.value_stride_;
-        for (size_t j = start_index, k = global_index * param.value_stride_; j < end_index; ++j, ++k) {
-          reduced_bucket->value_[j] += global_value[k];
+        float *reduced_value = reduced_bucket->value_ + slots[pos] * param.value_stride_;
+        const float *value = global_value + global_index * param.value_stride_;
+        for (size_t j = 0; j < param.value_stride_; ++j) {
+          reduced_value[j] += value[j];
         }
       }
     }
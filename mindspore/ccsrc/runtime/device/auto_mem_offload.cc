@@ -78,6 +78,15 @@ void *AutoMemoryOffload::Get(const void *key, void *stream, const HashSet<const
   if (stream == nullptr) {
     return nullptr;
   }
+  if (file_store_ != nullptr && file_store_->Contains(key)) {
+    const auto mem_size = GetMemSize(key);
+    auto device_ptr = Malloc(key, mem_size, stream, pinned_memory);
+    if (device_ptr == nullptr) {
+      return nullptr;
+    }
+    SwapInFromFile(key, device_ptr, mem_size, stream);
+    return device_ptr;
+  }
   void *host_ptr = nullptr;
   bool from_init = false;
   GetHostPtr(key, &host_ptr, &from_init);
@@ -92,8 +101,7 @@ void *AutoMemoryOffload::Get(const void *key, void *stream, const HashSet<const
   MS_EXCEPTION_IF_NULL(mem_handler_);
   mem_handler_->SwapIn(host_ptr, device_ptr, mem_size, stream);
   if (!from_init) {
-    (void)swap_host_ptr_.erase(key);
-    mem_handler_->FreeHost(host_ptr);
+    FreeSwapHostPtr(key, host_ptr, mem_size);
   }
   mem_result_[key] = device_ptr;
   return device_ptr;
@@ -207,6 +215,9 @@ void AutoMemoryOffload::SwapOut(const void *key, void *stream) {
   bool from_init = false;
   const auto mem_size = GetMemSize(key);
   if (iter == mem_result_.end()) {
+    if (file_store_ != nullptr && file_store_->Contains(key)) {
+      return;
+    }
     GetHostPtr(key, &host_ptr, &from_init);
     if (host_ptr == nullptr) {
       MS_LOG(EXCEPTION) << "Can not find device ptr for key " << key;
@@ -214,6 +225,9 @@ void AutoMemoryOffload::SwapOut(const void *key, void *stream) {
     return;
   }
   const auto device_ptr = iter->second;
+  if (SwapOutToFile(key, device_ptr, mem_size, stream)) {
+    return;
+  }
   GetOrMallocHostPtr(key, mem_size, &host_ptr, &from_init);
   MS_EXCEPTION_IF_NULL(host_ptr);
   auto updated_iter = from_init ? updated_device_mem_.find(key) : updated_device_mem_.end();
@@ -232,18 +246,61 @@ void *AutoMemoryOffload::SwapIn(const void *key, void *stream) {
   if (iter == mem_result_.end()) {
     MS_LOG(EXCEPTION) << "Can not find device ptr for key " << key;
   }
+  if (file_store_ != nullptr && file_store_->Contains(key)) {
+    SwapInFromFile(key, iter->second, mem_size, stream);
+    return iter->second;
+  }
   bool from_init = true;
   void *host_ptr = nullptr;
   GetHostPtr(key, &host_ptr, &from_init);
   MS_EXCEPTION_IF_NULL(host_ptr);
   mem_handler_->SwapIn(host_ptr, iter->second, mem_size, stream);
   if (!from_init) {
-    mem_handler_->FreeHost(host_ptr);
-    (void)swap_host_ptr_.erase(key);
+    FreeSwapHostPtr(key, host_ptr, mem_size);
   }
   return iter->second;
 }
 
+void AutoMemoryOffload::Prefetch(const void *key) {
+  if (file_store_ != nullptr) {
+    file_store_->Prefetch(key);
+  }
+}
+
+void AutoMemoryOffload::ReleaseSwappedOutMem(const void *key) {
+  if (file_store_ != nullptr) {
+    file_store_->Remove(key);
+  }
+  auto iter = swap_host_ptr_.find(key);
+  if (iter != swap_host_ptr_.end()) {
+    FreeSwapHostPtr(key, iter->second, GetMemSize(key));
+  }
+}
+
+bool AutoMemoryOffload::SwapOutToFile(const void *key, const void *device_ptr, size_t mem_size, void *stream) {
+  if (file_store_ == nullptr || init_from_host_keys_.count(key) != 0 || swap_host_ptr_.count(key) != 0) {
+    return false;
+  }
+  // The memory reserved here is allocated by the swap out to the host memory.
+  if (file_store_->ReserveHostMem(mem_size)) {
+    return false;
+  }
+  MS_EXCEPTION_IF_NULL(mem_handler_);
+  // The swap out waits for the stream, so the buffer holds the data when it is written.
+  auto buffer = file_store_->AllocBuffer(mem_size);
+  mem_handler_->SwapOut(device_ptr, buffer, mem_size, stream);
+  file_store_->AsyncWrite(key, buffer, mem_size);
+  return true;
+}
+
+void AutoMemoryOffload::SwapInFromFile(const void *key, void *device_ptr, size_t mem_size, void *stream) {
+  MS_EXCEPTION_IF_NULL(mem_handler_);
+  auto host_ptr = file_store_->Load(key);
+  MS_EXCEPTION_IF_NULL(host_ptr);
+  mem_handler_->SwapIn(host_ptr, device_ptr, mem_size, stream);
+  file_store_->Release(key);
+}
+
 size_t AutoMemoryOffload::GetMemSize(const void *key) {
   const auto &iter = mem_size_.find(key);
   if (iter == mem_size_.end()) {
@@ -262,6 +319,17 @@ void AutoMemoryOffload::GetOrMallocHostPtr(const void *key, size_t mem_size, voi
   *host_ptr = mem_handler_->MallocHost(mem_size);
   *from_init = false;
   swap_host_ptr_[key] = *host_ptr;
+  host_swap_size_ += mem_size;
+}
+
+void AutoMemoryOffload::FreeSwapHostPtr(const void *key, void *host_ptr, size_t mem_size) {
+  MS_EXCEPTION_IF_NULL(mem_handler_);
+  mem_handler_->FreeHost(host_ptr);
+  (void)swap_host_ptr_.erase(key);
+  host_swap_size_ -= mem_size;
+  if (file_store_ != nullptr) {
+    file_store_->ReleaseHostMem(mem_size);
+  }
 }
 
 void AutoMemoryOffload::GetHostPtr(const void *key, void **host_ptr, bool *from_init) {
@@ -295,6 +363,14 @@ void AutoMemoryOffload::Clear() {
     }
   }
   swap_host_ptr_.clear();
+  if (file_store_ != nullptr) {
+    file_store_->ReleaseHostMem(host_swap_size_);
+    // The store is shared with the other graphs, so only the files of the keys here are removed.
+    for (const auto &item : mem_size_) {
+      file_store_->Remove(item.first);
+    }
+  }
+  host_swap_size_ = 0;
   init_host_ptr_.clear();
   init_from_host_keys_.clear();
 }
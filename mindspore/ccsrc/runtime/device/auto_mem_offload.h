@@ -24,6 +24,7 @@
 #include <shared_mutex>
 
 #include "runtime/device/memory_manager.h"
+#include "runtime/device/file_offload.h"
 #include "common/mem_reuse/mem_dynamic_allocator.h"
 #include "utils/hash_map.h"
 #include "utils/hash_set.h"
@@ -70,7 +71,8 @@ class MemHandler {
 
 class BACKEND_EXPORT AutoMemoryOffload {
  public:
-  explicit AutoMemoryOffload(std::shared_ptr<MemHandler> mem_handler) : mem_handler_(std::move(mem_handler)) {}
+  explicit AutoMemoryOffload(std::shared_ptr<MemHandler> mem_handler)
+      : mem_handler_(std::move(mem_handler)), file_store_(FileOffloadStore::GetInstance()) {}
   ~AutoMemoryOffload() = default;
   void *Get(const void *key, void *stream = nullptr, const HashSet<const void *> &pinned_memory = {});
   void *Malloc(const void *key, size_t mem_size, void *stream, const HashSet<const void *> &pinned_memory);
@@ -84,11 +86,18 @@ class BACKEND_EXPORT AutoMemoryOffload {
   void SwapOut(const void *key, void *stream);
   // Return the device ptr where the data is copied to
   void *SwapIn(const void *key, void *stream);
+  // Start loading the data of key from the offload file, so it is in the host memory when it is swapped in.
+  void Prefetch(const void *key);
+  // Drop the swapped out data of key in the host memory or the offload file, which is not swapped in once key is freed.
+  void ReleaseSwappedOutMem(const void *key);
 
  private:
   size_t GetMemSize(const void *key);
   void GetHostPtr(const void *key, void **host_ptr, bool *from_init);
   void GetOrMallocHostPtr(const void *key, size_t mem_size, void **host_ptr, bool *from_init);
+  void FreeSwapHostPtr(const void *key, void *host_ptr, size_t mem_size);
+  bool SwapOutToFile(const void *key, const void *device_ptr, size_t mem_size, void *stream);
+  void SwapInFromFile(const void *key, void *device_ptr, size_t mem_size, void *stream);
   template <typename MallocInfo>
   bool TryAllocMemory(
     const MallocInfo &info, size_t total_size, void *stream, const HashSet<const void *> &pinned_memory,
@@ -102,6 +111,10 @@ class BACKEND_EXPORT AutoMemoryOffload {
   HashSet<const void *> continuous_mem_key_;
   HashMap<const void *, void *> init_host_ptr_;
   HashMap<const void *, void *> swap_host_ptr_;
+  // The swapped out memory beyond the host memory limit of the store goes to the files, the store is shared by all the
+  // graphs of the process.
+  std::shared_ptr<FileOffloadStore> file_store_;
+  size_t host_swap_size_{0};
 };
 
 class BACKEND_EXPORT MindRTAutoOffloadAdapter {
@@ -0,0 +1,466 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/device/file_offload.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+#include "utils/file_utils.h"
+#include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
+#include "utils/convert_utils_base.h"
+
+namespace mindspore {
+namespace device {
+namespace {
+constexpr auto kOffloadFilePathEnv = "MS_DEV_OFFLOAD_FILE_PATH";
+constexpr auto kOffloadIoThreadsEnv = "MS_DEV_OFFLOAD_IO_THREADS";
+constexpr auto kOffloadHostMemLimitEnv = "MS_DEV_OFFLOAD_HOST_MEM_LIMIT";
+// The alignment required by direct I/O, which is the logical block size of most NVMe disks.
+constexpr size_t kDirectIoAlignSize = 4096;
+constexpr size_t kDefaultIoThreadNum = 4;
+constexpr size_t kMBToByte = 1 << 20;
+// The total size of the free buffers kept for reuse, the buffers freed beyond it are returned to the system.
+constexpr size_t kMaxFreeBufferSize = 256 * kMBToByte;
+
+size_t AlignSize(size_t size) { return (size + kDirectIoAlignSize - 1) / kDirectIoAlignSize * kDirectIoAlignSize; }
+
+size_t GetEnvNumber(const std::string &name, size_t default_value) {
+  auto value = common::GetEnv(name);
+  if (value.empty()) {
+    return default_value;
+  }
+  auto number = std::strtol(value.c_str(), nullptr, 10);
+  if (number < 0) {
+    MS_LOG(WARNING) << "The " << name << " should not be negative, but got " << value;
+    return default_value;
+  }
+  return LongToSize(number);
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+bool WriteFile(int fd, const uint8_t *buffer, size_t size, size_t offset) {
+  size_t done = 0;
+  while (done < size) {
+    auto ret = pwrite(fd, buffer + done, size - done, static_cast<off_t>(offset + done));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      MS_LOG(ERROR) << "Failed to write " << size << " bytes to the offload file, errno: " << errno;
+      return false;
+    }
+    done += static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+bool ReadFile(int fd, uint8_t *buffer, size_t size, size_t offset) {
+  size_t done = 0;
+  while (done < size) {
+    auto ret = pread(fd, buffer + done, size - done, static_cast<off_t>(offset + done));
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      MS_LOG(ERROR) << "Failed to read " << size << " bytes from the offload file, errno: " << errno;
+      return false;
+    }
+    done += static_cast<size_t>(ret);
+  }
+  return true;
+}
+#endif
+}  // namespace
+
+FileOffloadStore::FileOffloadStore(const std::string &path, size_t io_thread_num, size_t host_mem_limit)
+    : host_mem_limit_(host_mem_limit) {
+  auto real_path = FileUtils::CreateNotExistDirs(path, true);
+  if (!real_path.has_value()) {
+    MS_LOG(EXCEPTION) << "Failed to create the offload directory " << path;
+  }
+  path_ = real_path.value();
+#if !defined(_WIN32) && !defined(_WIN64)
+  fd_ = OpenFile();
+#endif
+  io_thread_num = std::max(io_thread_num, size_t(1));
+  for (size_t i = 0; i < io_thread_num; ++i) {
+    (void)workers_.emplace_back(&FileOffloadStore::WorkerLoop, this);
+  }
+}
+
+FileOffloadStore::~FileOffloadStore() {
+  Clear();
+  {
+    std::lock_guard<std::mutex> lock(task_mutex_);
+    stop_ = true;
+  }
+  task_cv_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  FreeBuffers();
+#if !defined(_WIN32) && !defined(_WIN64)
+  (void)close(fd_);
+#endif
+}
+
+std::shared_ptr<FileOffloadStore> FileOffloadStore::GetInstance() {
+  static const std::shared_ptr<FileOffloadStore> instance = CreateFromEnv();
+  return instance;
+}
+
+std::shared_ptr<FileOffloadStore> FileOffloadStore::CreateFromEnv() {
+  auto path = common::GetEnv(kOffloadFilePathEnv);
+  if (path.empty()) {
+    return nullptr;
+  }
+#if defined(_WIN32) || defined(_WIN64)
+  MS_LOG(WARNING) << "Offloading memory to files is not supported on Windows, " << kOffloadFilePathEnv
+                  << " is ignored.";
+  return nullptr;
+#else
+  auto io_thread_num = GetEnvNumber(kOffloadIoThreadsEnv, kDefaultIoThreadNum);
+  auto host_mem_limit = GetEnvNumber(kOffloadHostMemLimitEnv, 0) * kMBToByte;
+  MS_LOG(INFO) << "Offload memory to the directory " << path << " with " << io_thread_num
+               << " I/O threads, the host memory limit of the offloaded memory is " << host_mem_limit << " bytes.";
+  return std::make_shared<FileOffloadStore>(path, io_thread_num, host_mem_limit);
+#endif
+}
+
+bool FileOffloadStore::ReserveHostMem(size_t size) {
+  auto used_size = host_mem_size_.load();
+  do {
+    if (used_size + size > host_mem_limit_) {
+      return false;
+    }
+  } while (!host_mem_size_.compare_exchange_weak(used_size, used_size + size));
+  return true;
+}
+
+void FileOffloadStore::ReleaseHostMem(size_t size) { (void)host_mem_size_.fetch_sub(size); }
+
+void *FileOffloadStore::AllocBuffer(size_t size) {
+  size_t aligned_size = AlignSize(size);
+  {
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    auto iter = free_buffers_.find(aligned_size);
+    if (iter != free_buffers_.end() && !iter->second.empty()) {
+      auto buffer = iter->second.back();
+      iter->second.pop_back();
+      free_buffer_size_ -= aligned_size;
+      return buffer;
+    }
+  }
+  void *buffer = nullptr;
+#if defined(_WIN32) || defined(_WIN64)
+  buffer = malloc(aligned_size);
+#else
+  if (posix_memalign(&buffer, kDirectIoAlignSize, aligned_size) != 0) {
+    buffer = nullptr;
+  }
+#endif
+  if (buffer == nullptr) {
+    MS_LOG(EXCEPTION) << "Failed to allocate the offload buffer of " << aligned_size << " bytes.";
+  }
+  return buffer;
+}
+
+void FileOffloadStore::FreeBuffer(void *buffer, size_t size) {
+  if (buffer == nullptr) {
+    return;
+  }
+  size_t aligned_size = AlignSize(size);
+  {
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    if (free_buffer_size_ + aligned_size <= kMaxFreeBufferSize) {
+      free_buffers_[aligned_size].push_back(buffer);
+      free_buffer_size_ += aligned_size;
+      return;
+    }
+  }
+  free(buffer);
+}
+
+void FileOffloadStore::FreeBuffers() {
+  std::lock_guard<std::mutex> lock(buffer_mutex_);
+  for (auto &buffers : free_buffers_) {
+    for (auto buffer : buffers.second) {
+      free(buffer);
+    }
+  }
+  free_buffers_.clear();
+  free_buffer_size_ = 0;
+}
+
+std::shared_ptr<FileOffloadStore::FileEntry> FileOffloadStore::FindEntry(const void *key) const {
+  std::lock_guard<std::mutex> lock(entry_mutex_);
+  auto iter = entries_.find(key);
+  return iter == entries_.end() ? nullptr : iter->second;
+}
+
+int FileOffloadStore::OpenFile() {
+#if defined(_WIN32) || defined(_WIN64)
+  MS_LOG(EXCEPTION) << "Offloading memory to files is not supported on Windows.";
+#else
+  auto file_name = path_ + "/ms_offload_" + std::to_string(getpid());
+  int flags = O_RDWR | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+  int fd = open(file_name.c_str(), flags | O_DIRECT, S_IRUSR | S_IWUSR);
+  if (fd < 0 && errno == EINVAL) {
+    MS_LOG(INFO) << "The file system of " << path_ << " does not support direct I/O, use buffered I/O instead.";
+    fd = open(file_name.c_str(), flags, S_IRUSR | S_IWUSR);
+  }
+#else
+  int fd = open(file_name.c_str(), flags, S_IRUSR | S_IWUSR);
+#endif
+  if (fd < 0) {
+    MS_LOG(EXCEPTION) << "Failed to open the offload file " << file_name << ", errno: " << errno;
+  }
+  // The file is removed once it is closed, even if the process is killed.
+  (void)unlink(file_name.c_str());
+  return fd;
+#endif
+}
+
+size_t FileOffloadStore::AllocExtent(size_t size) {
+  std::lock_guard<std::mutex> lock(extent_mutex_);
+  // The best fit, so the large extents are left for the large tensors.
+  auto best = free_extents_.end();
+  for (auto iter = free_extents_.begin(); iter != free_extents_.end(); ++iter) {
+    if (iter->second >= size && (best == free_extents_.end() || iter->second < best->second)) {
+      best = iter;
+    }
+  }
+  if (best == free_extents_.end()) {
+    auto offset = file_size_;
+    file_size_ += size;
+    return offset;
+  }
+  auto offset = best->first;
+  auto remain = best->second - size;
+  (void)free_extents_.erase(best);
+  if (remain > 0) {
+    free_extents_[offset + size] = remain;
+  }
+  return offset;
+}
+
+void FileOffloadStore::FreeExtent(size_t offset, size_t size) {
+  std::lock_guard<std::mutex> lock(extent_mutex_);
+  auto next = free_extents_.lower_bound(offset);
+  if (next != free_extents_.end() && offset + size == next->first) {
+    size += next->second;
+    next = free_extents_.erase(next);
+  }
+  if (next != free_extents_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      size += prev->second;
+      (void)free_extents_.erase(prev);
+    }
+  }
+  if (offset + size < file_size_) {
+    free_extents_[offset] = size;
+    return;
+  }
+  // Give the disk space at the end of the file back.
+  file_size_ = offset;
+#if !defined(_WIN32) && !defined(_WIN64)
+  if (ftruncate(fd_, static_cast<off_t>(file_size_)) != 0) {
+    MS_LOG(INFO) << "Failed to truncate the offload file to " << file_size_ << " bytes, errno: " << errno;
+  }
+#endif
+}
+
+template <typename T>
+std::shared_future<T> FileOffloadStore::Submit(std::function<T()> &&task) {
+  auto packaged_task = std::make_shared<std::packaged_task<T()>>(std::move(task));
+  auto future = packaged_task->get_future().share();
+  {
+    std::lock_guard<std::mutex> lock(task_mutex_);
+    tasks_.emplace([packaged_task]() { (*packaged_task)(); });
+  }
+  task_cv_.notify_one();
+  return future;
+}
+
+void FileOffloadStore::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(task_mutex_);
+      task_cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+void FileOffloadStore::WaitAndFreeRead(FileEntry *entry) {
+  if (entry->read.valid()) {
+    FreeBuffer(entry->read.get(), entry->size);
+    entry->read = std::shared_future<void *>();
+  }
+}
+
+void FileOffloadStore::AsyncWrite(const void *key, void *buffer, size_t size) {
+  MS_EXCEPTION_IF_NULL(buffer);
+  std::shared_ptr<FileEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(entry_mutex_);
+    auto &item = entries_[key];
+    if (item == nullptr) {
+      item = std::make_shared<FileEntry>();
+    }
+    entry = item;
+  }
+  // The previous transfers of the key must be finished before its extent is overwritten.
+  WaitAndFreeRead(entry.get());
+  if (entry->write.valid()) {
+    (void)entry->write.get();
+  }
+  if (entry->capacity < AlignSize(size)) {
+    if (entry->capacity > 0) {
+      FreeExtent(entry->offset, entry->capacity);
+    }
+    entry->capacity = AlignSize(size);
+    entry->offset = AllocExtent(entry->capacity);
+  }
+  entry->size = size;
+  entry->stored = true;
+#if defined(_WIN32) || defined(_WIN64)
+  entry->write = Submit<bool>([]() { return false; });
+#else
+  size_t offset = entry->offset;
+  entry->write = Submit<bool>([this, buffer, size, offset]() {
+    bool ret = WriteFile(fd_, static_cast<uint8_t *>(buffer), AlignSize(size), offset);
+    FreeBuffer(buffer, size);
+    return ret;
+  });
+#endif
+}
+
+void FileOffloadStore::Prefetch(const void *key) {
+  auto entry = FindEntry(key);
+  if (entry == nullptr || !entry->stored || entry->read.valid()) {
+    return;
+  }
+#if defined(_WIN32) || defined(_WIN64)
+  entry->read = Submit<void *>([]() -> void * { return nullptr; });
+#else
+  size_t size = entry->size;
+  size_t offset = entry->offset;
+  // The tasks are taken in order, so the write of the key is running or finished when the read starts.
+  auto write = entry->write;
+  entry->read = Submit<void *>([this, size, offset, write]() -> void * {
+    if (write.valid() && !write.get()) {
+      return nullptr;
+    }
+    auto buffer = AllocBuffer(size);
+    if (!ReadFile(fd_, static_cast<uint8_t *>(buffer), AlignSize(size), offset)) {
+      FreeBuffer(buffer, size);
+      return nullptr;
+    }
+    return buffer;
+  });
+#endif
+}
+
+void *FileOffloadStore::Load(const void *key) {
+  auto entry = FindEntry(key);
+  if (entry == nullptr || !entry->stored) {
+    return nullptr;
+  }
+  Prefetch(key);
+  auto buffer = entry->read.get();
+  if (buffer == nullptr) {
+    MS_LOG(EXCEPTION) << "Failed to load the offloaded memory of " << entry->size << " bytes for key " << key;
+  }
+  return buffer;
+}
+
+void FileOffloadStore::Release(const void *key) {
+  auto entry = FindEntry(key);
+  if (entry == nullptr) {
+    return;
+  }
+  WaitAndFreeRead(entry.get());
+  entry->stored = false;
+}
+
+void FileOffloadStore::Remove(const void *key) {
+  std::shared_ptr<FileEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(entry_mutex_);
+    auto iter = entries_.find(key);
+    if (iter == entries_.end()) {
+      return;
+    }
+    entry = iter->second;
+    (void)entries_.erase(iter);
+  }
+  // The task runs after the transfers of the key, which are queued before it.
+  (void)Submit<bool>([this, entry]() {
+    if (entry->write.valid()) {
+      (void)entry->write.get();
+    }
+    WaitAndFreeRead(entry.get());
+    if (entry->capacity > 0) {
+      FreeExtent(entry->offset, entry->capacity);
+    }
+    return true;
+  });
+}
+
+bool FileOffloadStore::Contains(const void *key) const {
+  auto entry = FindEntry(key);
+  return entry != nullptr && entry->stored;
+}
+
+void FileOffloadStore::Clear() {
+  HashMap<const void *, std::shared_ptr<FileEntry>> entries;
+  {
+    std::lock_guard<std::mutex> lock(entry_mutex_);
+    entries.swap(entries_);
+  }
+  for (auto &item : entries) {
+    auto &entry = item.second;
+    WaitAndFreeRead(entry.get());
+    if (entry->write.valid()) {
+      (void)entry->write.get();
+    }
+    if (entry->capacity > 0) {
+      FreeExtent(entry->offset, entry->capacity);
+    }
+  }
+  FreeBuffers();
+}
+}  // namespace device
+}  // namespace mindspore
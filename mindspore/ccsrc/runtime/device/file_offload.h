@@ -0,0 +1,130 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_DEVICE_FILE_OFFLOAD_H_
+#define MINDSPORE_CCSRC_RUNTIME_DEVICE_FILE_OFFLOAD_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/hash_map.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace device {
+// FileOffloadStore is the tier of the offloaded memory beyond the host memory, such as the files on NVMe disks. The
+// data of all the keys is kept in one file of the process, in which every key takes an extent of blocks which is reused
+// by the following writes of the key and by other keys once the key is removed. The file is written and read by the
+// I/O threads, so the transfers overlap the computation. It is opened with direct I/O when the file system supports it,
+// so the transfers bypass the page cache, which requires the buffers, sizes and offsets aligned to the block size. One
+// store is shared by all the graphs of the process, so they share the I/O threads and the host memory limit. It is
+// driven by the swap events of the MemScheduler of the KernelRuntime, so it is only used by the device runtimes running
+// graphs with memory offload, the CPU runtime does not offload its memory.
+class BACKEND_EXPORT FileOffloadStore {
+ public:
+  FileOffloadStore(const std::string &path, size_t io_thread_num, size_t host_mem_limit);
+  ~FileOffloadStore();
+
+  // Get the store of the process in the directory set by MS_DEV_OFFLOAD_FILE_PATH, returns nullptr when it is not set.
+  static std::shared_ptr<FileOffloadStore> GetInstance();
+
+  // Allocate an aligned buffer of at least size bytes, which can be passed to AsyncWrite.
+  void *AllocBuffer(size_t size);
+  void FreeBuffer(void *buffer, size_t size);
+
+  // Write the data of key to its file in the background. The store takes the buffer, which is freed once written.
+  void AsyncWrite(const void *key, void *buffer, size_t size);
+
+  // Start reading the data of key in the background, does nothing if the key is not stored or already being read.
+  void Prefetch(const void *key);
+
+  // Wait until the data of key is read and return the buffer holding it, returns nullptr if the key is not stored.
+  void *Load(const void *key);
+
+  // Drop the data of key, including the buffer returned by Load. The extent is kept for the next write of the key.
+  void Release(const void *key);
+
+  // Drop the data and the extent of key, the extent is reused by other keys once the transfers of key finish.
+  void Remove(const void *key);
+
+  bool Contains(const void *key) const;
+
+  // Wait for all the transfers and drop all the keys, the file is truncated once their extents are free.
+  void Clear();
+
+  // The swapped out memory of all the users of the store is kept in the host memory up to the host memory limit, the
+  // rest is written to the files. Returns false if the memory of size does not fit in the limit any more.
+  bool ReserveHostMem(size_t size);
+  void ReleaseHostMem(size_t size);
+  size_t host_mem_limit() const { return host_mem_limit_; }
+
+ private:
+  struct FileEntry {
+    size_t offset{0};
+    // The aligned size of the extent of the key in the file, 0 if there is no extent.
+    size_t capacity{0};
+    size_t size{0};
+    bool stored{false};
+    std::shared_future<bool> write;
+    std::shared_future<void *> read;
+  };
+
+  static std::shared_ptr<FileOffloadStore> CreateFromEnv();
+  std::shared_ptr<FileEntry> FindEntry(const void *key) const;
+  int OpenFile();
+  size_t AllocExtent(size_t size);
+  void FreeExtent(size_t offset, size_t size);
+  void FreeBuffers();
+  void WaitAndFreeRead(FileEntry *entry);
+  template <typename T>
+  std::shared_future<T> Submit(std::function<T()> &&task);
+  void WorkerLoop();
+
+  std::string path_;
+  size_t host_mem_limit_;
+  std::atomic<size_t> host_mem_size_{0};
+  // The entries of different keys are used by the graphs on different threads, the entry of one key by one thread.
+  mutable std::mutex entry_mutex_;
+  HashMap<const void *, std::shared_ptr<FileEntry>> entries_;
+
+  int fd_{-1};
+  // The free extents of the file by offset, the adjacent ones are merged.
+  std::mutex extent_mutex_;
+  std::map<size_t, size_t> free_extents_;
+  size_t file_size_{0};
+
+  // The aligned buffers are cached by size up to a total size, since the same tensors are offloaded in every step.
+  std::mutex buffer_mutex_;
+  std::map<size_t, std::vector<void *>> free_buffers_;
+  size_t free_buffer_size_{0};
+
+  std::mutex task_mutex_;
+  std::condition_variable task_cv_;
+  std::queue<std::function<void()>> tasks_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_DEVICE_FILE_OFFLOAD_H_
@@ -33,6 +33,8 @@ constexpr float kMaxMemReuseFactor = 1.0;
 constexpr float kMinMemReuseFactor = 0.5;
 constexpr float kRetryFactor = 0.1;
 constexpr size_t kMockTimes = 5;
+// The number of the following steps whose swapped in memory is loaded from the offload files in advance.
+constexpr size_t kPrefetchStepNum = 2;
 
 double GetCurrentTime() {
 #ifdef _MSC_VER
@@ -223,11 +225,36 @@ bool MemScheduler::PostCompute(void *stream) {
       auto_mem_offload_->SwapOut(event->key, stream);
     }
     auto_mem_offload_->Free(event->key);
+    if (event->type == kFree && optimized_) {
+      auto_mem_offload_->ReleaseSwappedOutMem(event->key);
+    }
+  }
+  if (optimized_) {
+    PrefetchSwapInMem();
   }
   ++current_step_;
   return true;
 }
 
+void MemScheduler::PrefetchSwapInMem() {
+  MS_EXCEPTION_IF_NULL(strategy_);
+  MS_EXCEPTION_IF_NULL(auto_mem_offload_);
+  if (total_step_ == 0) {
+    return;
+  }
+  // The loads are queued after the writes of this step, and the swap event schedule tells which memory the next steps
+  // read, so the files are read while the kernels in between run.
+  for (size_t i = 1; i <= kPrefetchStepNum && i < total_step_; ++i) {
+    const auto &events = strategy_->GetPreComputeEvents((current_step_ + i) % total_step_);
+    for (const auto &event : events) {
+      MS_EXCEPTION_IF_NULL(event);
+      if (event->type == kSwapIn || event->type == kGet) {
+        auto_mem_offload_->Prefetch(event->key);
+      }
+    }
+  }
+}
+
 void MemScheduler::OptMemUsage(float mem_used_factor) {
   MS_EXCEPTION_IF_NULL(mem_handler_);
   MS_EXCEPTION_IF_NULL(auto_mem_offload_);
@@ -95,6 +95,8 @@ class MemScheduler {
 
   bool PreComputeGet(const MemEventPtr<const void *> &event, void *stream);
 
+  void PrefetchSwapInMem();
+
   const HashSet<const void *> &GetNoReuseKeys() const { return step_keys_[current_step_]; }
 
   void *Malloc(const MemEventPtr<const void *> &event, void *stream);
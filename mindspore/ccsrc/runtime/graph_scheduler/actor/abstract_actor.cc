@@ -154,6 +154,11 @@ void AbstractActor::InitOutputData() {
       SET_FLAG(output_data_flag, kOutputDataFlagToFusion);
     }
 
+    // Add the linearized flag.
+    if (TEST_FLAG(data_arrow->flag_, kOutputDataFlagLinearized)) {
+      SET_FLAG(output_data_flag, kOutputDataFlagLinearized);
+    }
+
     // Add the output data.
     (void)output_data_.emplace_back(std::make_pair(std::move(data), output_data_flag));
   }
@@ -169,10 +174,20 @@ void AbstractActor::SendOutput(OpContext<DeviceTensor> *const context) {
     SET_OPCONTEXT_FAIL_RET_WITH_ERROR((*context), "The size of output data arrows is not equal to the output data.");
   }
 
+  if ((output_data_actors_.size() != output_data_.size()) ||
+      (output_control_actors_.size() != output_control_arrows_.size())) {
+    FetchOutputActors();
+  }
   size_t output_data_arrow_index = 0;
   for (auto &output_data : output_data_) {
     MS_EXCEPTION_IF_NULL(output_data.first);
+    // The destination in the same linearized actor reads the device tensor directly.
+    if (TEST_FLAG(output_data.second, kOutputDataFlagLinearized)) {
+      ++output_data_arrow_index;
+      continue;
+    }
     auto &to_op_id = output_data.first->op_id_;
+    auto to_actor_handle = output_data_actors_[output_data_arrow_index];
     auto &output_data_arrow = output_data_arrows_[output_data_arrow_index];
     UpdateOutputData(output_data.first.get(), output_data_arrow, output_data_nodes_[output_data_arrow_index], context);
     // The index of output data will be modified the real actor input index in the fusion actor, so need recovery the
@@ -187,6 +202,9 @@ void AbstractActor::SendOutput(OpContext<DeviceTensor> *const context) {
         const auto &to_actor = FetchSubActorInFusionActor(to_op_id.Name());
         ActorDispatcher::SendSync(to_actor, &AbstractActor::RunBatchOpData, &batch_output_data_[to_op_id.Name()],
                                   context);
+      } else if (to_actor_handle != nullptr) {
+        ActorDispatcher::Send(to_actor_handle, &AbstractActor::RunBatchOpData, &batch_output_data_[to_op_id.Name()],
+                              context);
       } else {
         ActorDispatcher::Send(to_op_id, &AbstractActor::RunBatchOpData, &batch_output_data_[to_op_id.Name()], context);
       }
@@ -198,6 +216,8 @@ void AbstractActor::SendOutput(OpContext<DeviceTensor> *const context) {
       if (TEST_FLAG(output_data.second, kOutputDataFlagBetweenFusion)) {
         const auto &to_actor = FetchSubActorInFusionActor(to_op_id.Name());
         ActorDispatcher::SendSync(to_actor, &OpActor::RunOpData, to_stack_data_.back().get(), context);
+      } else if (to_actor_handle != nullptr) {
+        ActorDispatcher::Send(to_actor_handle, &OpActor::RunOpData, to_stack_data_.back().get(), context);
       } else {
         ActorDispatcher::Send(to_op_id, &OpActor::RunOpData, to_stack_data_.back().get(), context);
       }
@@ -206,6 +226,8 @@ void AbstractActor::SendOutput(OpContext<DeviceTensor> *const context) {
       if (TEST_FLAG(output_data.second, kOutputDataFlagBetweenFusion)) {
         const auto &to_actor = FetchSubActorInFusionActor(to_op_id.Name());
         ActorDispatcher::SendSync(to_actor, &OpActor::RunOpData, output_data.first.get(), context);
+      } else if (to_actor_handle != nullptr) {
+        ActorDispatcher::Send(to_actor_handle, &OpActor::RunOpData, output_data.first.get(), context);
       } else {
         ActorDispatcher::Send(to_op_id, &OpActor::RunOpData, output_data.first.get(), context);
       }
@@ -216,11 +238,17 @@ void AbstractActor::SendOutput(OpContext<DeviceTensor> *const context) {
   // 2.Send output control.
   if (output_control_arrows_.size() > 0) {
     auto from_aid = const_cast<AID *>(&GetAID());
-    for (auto &output_control : output_control_arrows_) {
+    for (size_t i = 0; i < output_control_arrows_.size(); ++i) {
+      const auto &output_control = output_control_arrows_[i];
       MS_EXCEPTION_IF_NULL(output_control);
+      if (TEST_FLAG(output_control->flag_, kOutputDataFlagLinearized)) {
+        continue;
+      }
       if (TEST_FLAG(output_control->flag_, kOutputDataFlagBetweenFusion)) {
         const auto &to_actor = FetchSubActorInFusionActor(output_control->to_op_id_.Name());
         ActorDispatcher::SendSync(to_actor, &OpActor::RunOpControl, from_aid, context);
+      } else if (output_control_actors_[i] != nullptr) {
+        ActorDispatcher::Send(output_control_actors_[i], &OpActor::RunOpControl, from_aid, context);
       } else {
         ActorDispatcher::Send(output_control->to_op_id_, &OpActor::RunOpControl, from_aid, context);
       }
@@ -237,6 +265,25 @@ void AbstractActor::SendOutput(OpContext<DeviceTensor> *const context) {
   }
 }
 
+void AbstractActor::FetchOutputActors() {
+  auto actor_manager = ActorMgr::GetActorMgrRef();
+  MS_EXCEPTION_IF_NULL(actor_manager);
+  auto fetch_actor = [&actor_manager](const AID &aid) {
+    return dynamic_cast<OpActor<DeviceTensor> *>(actor_manager->GetActor(aid).get());
+  };
+
+  output_data_actors_.clear();
+  for (const auto &output_data : output_data_) {
+    MS_EXCEPTION_IF_NULL(output_data.first);
+    (void)output_data_actors_.emplace_back(fetch_actor(output_data.first->op_id_));
+  }
+  output_control_actors_.clear();
+  for (const auto &output_control : output_control_arrows_) {
+    MS_EXCEPTION_IF_NULL(output_control);
+    (void)output_control_actors_.emplace_back(fetch_actor(output_control->to_op_id_));
+  }
+}
+
 AbstractActor *AbstractActor::FetchSubActorInFusionActor(const std::string &sub_actor_name) const {
   if (parent_fusion_actor_ == nullptr) {
     return nullptr;
@@ -46,6 +46,9 @@ constexpr size_t kOutputDataFlagLastBatch = 4;
 constexpr size_t kOutputDataFlagBetweenFusion = 8;
 // Indicates that the output data destination is the fusion actor, and needs to use the fusion output index.
 constexpr size_t kOutputDataFlagToFusion = 16;
+// Indicates that the output data destination runs in the same linearized actor, the destination device tensor is bound
+// before running and no data is sent.
+constexpr size_t kOutputDataFlagLinearized = 32;
 
 // The abstract common attributes of actors. The actor inheritance relationship:  OpActor --> AbstractActor -->
 // MemoryAwareActor --> DebugAwareActor --> KernelActor/DataSourceActor/CopyActor/LoopCountActor/OutputActor.
@@ -101,6 +104,7 @@ class AbstractActor : public OpActor<DeviceTensor> {
   friend class GraphScheduler;
   friend class ControlNodeScheduler;
   friend class SchedulerHelper;
+  friend class LinearizedActor;
 
   // Check whether satisfy the actor running condition.
   virtual bool CheckRunningCondition(const OpContext<DeviceTensor> *context) const;
@@ -122,6 +126,8 @@ class AbstractActor : public OpActor<DeviceTensor> {
 
   // Fetch the sub actor in the fusion actor by the name.
   AbstractActor *FetchSubActorInFusionActor(const std::string &sub_actor_name) const;
+  // Fetch the receivers of the output data and the output controls, which are sent to through their handles.
+  void FetchOutputActors();
 
   KernelTransformType type_;
 
@@ -135,6 +141,10 @@ class AbstractActor : public OpActor<DeviceTensor> {
   std::vector<AnfNodePtr> output_data_nodes_;
   // The second of pair indicates the output data falg. See constant prefixed with kOutputDataFalg for details.
   std::vector<std::pair<OpDataUniquePtr<DeviceTensor>, size_t>> output_data_;
+  // The receivers of output_data_ and output_control_arrows_ one by one, which are fetched on the first sending since
+  // they may be spawned after this actor. The receivers not found are null and sent to by the name.
+  std::vector<OpActor<DeviceTensor> *> output_data_actors_;
+  std::vector<OpActor<DeviceTensor> *> output_control_actors_;
   // Record the fusion output index for output data arrow.
   mindspore::HashMap<DataArrow *, size_t> data_arrow_to_fusion_actor_indexs_;
   // Used to send batch data in the message which RunBatchOpData needs, the key is the actor name of destination actor.
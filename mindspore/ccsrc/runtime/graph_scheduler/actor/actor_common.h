@@ -70,6 +70,7 @@ const char kEntranceActorNameSuffix[] = "_EntranceActor";
 const char kExitActorNameSuffix[] = "_ExitActor";
 const char kStackActorNameSuffix[] = "_StackActor";
 const char kFusionActorNameSuffix[] = "_FusionActor";
+const char kLinearizedActorNameSuffix[] = "_LinearizedActor";
 const char kMemoryAllocActorNameSuffix[] = "_MemoryAllocActor";
 const char kMemoryFreeActorNameSuffix[] = "_MemoryFreeActor";
 const char kCopyActorNameSignFromStore[] = "_device_tensor_store:";
@@ -188,6 +189,18 @@ class ActorDispatcher {
     }
   }
 
+  // Send to the actor through its handle, which skips the lookup by name. The actor must stay spawned while sending.
+  template <typename T, typename... Args0, typename... Args1>
+  static void Send(OpActor<DeviceTensor> *to_actor, void (T::*method)(Args0...), Args1 &&... args) {
+    MS_EXCEPTION_IF_NULL(to_actor);
+    if (is_multi_thread_execution_) {
+      Async(static_cast<const ActorBase *>(to_actor), method, std::forward<Args1>(args)...);
+    } else {
+      T *actor = static_cast<T *>(to_actor);
+      (actor->*method)(std::forward<Args1>(args)...);
+    }
+  }
+
   template <typename T, typename Arg0, typename Arg1>
   static void SendSync(const AID &aid, void (T::*method)(Arg0), Arg1 &&arg) {
     auto actor_manager = ActorMgr::GetActorMgrRef();
@@ -38,6 +38,7 @@
 #include "runtime/graph_scheduler/actor/output_actor.h"
 #include "runtime/graph_scheduler/actor/copy_actor.h"
 #include "runtime/graph_scheduler/actor/fusion/fusion_actor.h"
+#include "runtime/graph_scheduler/actor/fusion/linearized_actor.h"
 #include "runtime/graph_scheduler/actor/control_flow/switch_actor.h"
 #include "runtime/graph_scheduler/actor/control_flow/gather_actor.h"
 #include "runtime/graph_scheduler/actor/control_flow/entrance_actor.h"
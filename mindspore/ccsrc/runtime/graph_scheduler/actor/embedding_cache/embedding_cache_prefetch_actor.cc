@@ -16,11 +16,17 @@
 
 #include "runtime/graph_scheduler/actor/embedding_cache/embedding_cache_prefetch_actor.h"
 #include <limits>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <sstream>
 #include "backend/common/optimizer/dynamic_shape/dynamic_shape_helper.h"
 #include "kernel/common_utils.h"
 #include "runtime/graph_scheduler/actor/rpc/rpc_actor.h"
 #include "proto/topology.pb.h"
 #include "distributed/constants.h"
+#include "include/common/utils/utils.h"
+#include "include/common/thread_pool.h"
 
 namespace mindspore {
 namespace runtime {
@@ -40,6 +46,26 @@ constexpr size_t kMaxThreadNum = 16;
 // Maximum number of feature ids processed per thread.
 constexpr size_t kMaxIdsPerThread = 10000;
 
+// The number of batch ids whose cache miss analysis can run ahead of their cache update.
+constexpr char kPrefetchDepthEnv[] = "MS_DEV_EMBEDDING_CACHE_PREFETCH_DEPTH";
+constexpr size_t kDefaultPrefetchDepth = 2;
+constexpr size_t kMaxPrefetchDepth = 8;
+
+// The policy to shard the embedding table rows over servers, "range" or "hash".
+constexpr char kShardingPolicyEnv[] = "MS_DEV_EMBEDDING_CACHE_SHARDING";
+// The number of hot ids pinned in the local host cache, 0 disables the hot id pinning.
+constexpr char kHotIdNumEnv[] = "MS_DEV_EMBEDDING_CACHE_HOT_ID_NUM";
+// The number of batches between two selections of the hot ids, the hot embeddings are reconciled to remote at each
+// selection.
+constexpr size_t kHotIdRefreshInterval = 100;
+// The hot ids take at most 1/kHotIdCacheRatio of the local host cache, the rest is left for the batch ids in flight.
+constexpr size_t kHotIdCacheRatio = 4;
+
+// The names of prefetch stages used in the latency report, in the order of PrefetchStage.
+const char *const kPrefetchStageNames[] = {"CheckCacheHit",    "ParseCacheMiss",   "WaitSwapBuffer",
+                                           "PushHostToRemote", "SwapDeviceToHost", "PullRemoteToHost",
+                                           "SwapHostToDevice"};
+
 namespace {
 ParameterPtr NewParameter(const KernelGraphPtr &graph, TypePtr type, const ShapeVector &shape) {
   MS_EXCEPTION_IF_NULL(graph);
@@ -245,6 +271,17 @@ void EmbeddingCachePrefetchActor::Initialize() {
   const double sigma = 0.01;
   rnd_gen_->Initialize(mean, sigma);
 
+  // Create the swap buffers for pipelining the cache miss analysis and the cache update.
+  prefetch_depth_ = kDefaultPrefetchDepth;
+  auto prefetch_depth_env = common::GetEnv(kPrefetchDepthEnv);
+  if (!prefetch_depth_env.empty()) {
+    auto prefetch_depth = std::strtol(prefetch_depth_env.c_str(), nullptr, 0);
+    prefetch_depth_ = prefetch_depth > 0 ? LongToSize(prefetch_depth) : 1;
+  }
+  prefetch_depth_ = std::min(prefetch_depth_, kMaxPrefetchDepth);
+  swap_buffers_.resize(prefetch_depth_);
+  MS_LOG(INFO) << "The embedding cache prefetch depth is " << prefetch_depth_;
+
   // Get embedding cache table info.
   hash_tables_ = embedding_cache_table_manager.hash_tables_;
   local_host_cache_size_ = embedding_cache_table_manager.host_cache_size_;
@@ -258,6 +295,21 @@ void EmbeddingCachePrefetchActor::Initialize() {
 
   // Get the id range of each server's embedding table slice.
   GetRemoteEmbeddingSliceBound();
+  for (const auto &cache_op : distributed::kEmbeddingCacheOps) {
+    remote_request_ids_num_[cache_op] = std::vector<size_t>(server_num_, 0);
+  }
+
+  auto hot_id_num_env = common::GetEnv(kHotIdNumEnv);
+  if (!hot_id_num_env.empty()) {
+    auto hot_id_num = std::strtol(hot_id_num_env.c_str(), nullptr, 0);
+    if (hot_id_num > 0) {
+      auto max_hot_id_num = local_host_cache_size_ / kHotIdCacheRatio;
+      hot_id_tracker_ = std::make_unique<distributed::HotIdTracker>(std::min(LongToSize(hot_id_num), max_hot_id_num),
+                                                                    kHotIdRefreshInterval);
+      MS_LOG(INFO) << "Pin at most " << std::min(LongToSize(hot_id_num), max_hot_id_num)
+                   << " hot ids in the local host cache.";
+    }
+  }
 
   BuildEmbeddingCacheLookupKernel();
   BuildEmbeddingCacheUpdateKernel();
@@ -282,7 +334,16 @@ void EmbeddingCachePrefetchActor::Finalize() {
   }
   SyncEmbeddingTable();
 
-  running_ = false;
+  {
+    std::lock_guard<std::mutex> locker(update_mutex_);
+    running_ = false;
+  }
+  update_cond_.notify_all();
+  if (update_thread_.joinable()) {
+    update_thread_.join();
+  }
+  PrintStageCost();
+  PrintRemoteRequests();
   (void)FinalizeRemote();
 
   PsDataPrefetch::GetInstance().NotifyFinalize();
@@ -485,6 +546,10 @@ void EmbeddingCachePrefetchActor::IncreaseGraphStep(const std::string &channel_n
     MS_LOG(EXCEPTION) << "TryWakeChannel failed, channel name: " << channel_name;
   }
   data_parser_.notify_one();
+
+  // The batch ids of this step are handed over to the graph before their cache update finishes, so the graph can't
+  // run until the device cache is ready.
+  WaitCacheUpdate();
 }
 
 void EmbeddingCachePrefetchActor::Run() {
@@ -508,10 +573,19 @@ void EmbeddingCachePrefetchActor::Run() {
   // Wait data channel ready.
   WaitDataChannelInit();
 
+  // The cache update runs in another thread to overlap with the cache miss analysis of the next batch ids.
+  if (prefetch_depth_ > 1 && running_) {
+    update_thread_ = std::thread(&EmbeddingCachePrefetchActor::UpdateCacheLoop, this);
+  }
+
   MS_LOG(INFO) << "Begin prefetching cache.";
   while (running_) {
     if (!PrefetchCache()) {
-      running_ = false;
+      {
+        std::lock_guard<std::mutex> locker(update_mutex_);
+        running_ = false;
+      }
+      update_cond_.notify_all();
       // If prefetch cache failed, need to finalize data prefetch thread which is executing
       // PsDataPrefetch::PrefetchData(), so as to the minddata can release resource normally.
       PsDataPrefetch::GetInstance().NotifyFinalize();
@@ -520,6 +594,142 @@ void EmbeddingCachePrefetchActor::Run() {
   MS_LOG(INFO) << "End prefetching cache.";
 }
 
+void EmbeddingCachePrefetchActor::UpdateCacheLoop() {
+  MS_EXCEPTION_IF_NULL(device_context_);
+  MS_EXCEPTION_IF_NULL(device_context_->device_res_manager_);
+  if (!device_context_->device_res_manager_->BindDeviceToCurrentThread()) {
+    MS_LOG(ERROR) << "Failed to bind device to cache update thread.";
+    {
+      std::lock_guard<std::mutex> locker(update_mutex_);
+      running_ = false;
+    }
+    update_cond_.notify_all();
+    PsDataPrefetch::GetInstance().NotifyFinalize();
+    return;
+  }
+
+  MS_LOG(INFO) << "Begin updating cache.";
+  while (true) {
+    {
+      std::unique_lock<std::mutex> locker(update_mutex_);
+      update_cond_.wait(locker, [this] { return committed_step_ > updated_step_ || !running_; });
+      if (!running_) {
+        break;
+      }
+    }
+    if (!UpdateOldestCache()) {
+      {
+        std::lock_guard<std::mutex> locker(update_mutex_);
+        running_ = false;
+      }
+      update_cond_.notify_all();
+      PsDataPrefetch::GetInstance().NotifyFinalize();
+      break;
+    }
+  }
+  MS_LOG(INFO) << "End updating cache.";
+}
+
+bool EmbeddingCachePrefetchActor::UpdateOldestCache() {
+  size_t step = 0;
+  {
+    std::lock_guard<std::mutex> locker(update_mutex_);
+    step = updated_step_;
+  }
+  // Only the cache update stage modifies the updated step, so the swap buffer can be read without the lock.
+  const auto &swap_info = swap_buffers_[step % prefetch_depth_];
+  RETURN_IF_FALSE_WITH_LOG(UpdateCache(swap_info), "Update local cache failed.");
+  {
+    std::lock_guard<std::mutex> locker(update_mutex_);
+    ++updated_step_;
+  }
+  update_cond_.notify_all();
+  return true;
+}
+
+bool EmbeddingCachePrefetchActor::CommitCacheSwapInfo() {
+  auto start_usec = GetCurrentUSec();
+  CacheSwapInfo *swap_info = nullptr;
+  {
+    std::unique_lock<std::mutex> locker(update_mutex_);
+    update_cond_.wait(locker, [this] { return committed_step_ - updated_step_ < prefetch_depth_ || !running_; });
+    if (!running_) {
+      MS_LOG(INFO) << "The cache update stage is stopped.";
+      return false;
+    }
+    swap_info = &swap_buffers_[committed_step_ % prefetch_depth_];
+  }
+  RecordStageCost(PrefetchStage::kWaitSwapBuffer, start_usec);
+
+  MS_ERROR_IF_NULL(embedding_device_cache_);
+  MS_ERROR_IF_NULL(embedding_host_cache_);
+  swap_info->data_step_ = data_step_;
+  swap_info->statistics_info_ = statistics_info_;
+  auto copy_indices = [](const std::unique_ptr<int[]> &indices, size_t size, std::vector<int> *buffer) {
+    buffer->assign(indices.get(), indices.get() + size);
+  };
+  copy_indices(embedding_device_cache_->device_to_host_index, statistics_info_.device_to_host_size_,
+               &swap_info->device_cache_device_to_host_index_);
+  copy_indices(embedding_host_cache_->device_to_host_index, statistics_info_.device_to_host_size_,
+               &swap_info->host_cache_device_to_host_index_);
+  copy_indices(embedding_device_cache_->host_to_device_index, statistics_info_.host_to_device_size_,
+               &swap_info->device_cache_host_to_device_index_);
+  copy_indices(embedding_host_cache_->host_to_device_index, statistics_info_.host_to_device_size_,
+               &swap_info->host_cache_host_to_device_index_);
+  copy_indices(embedding_host_cache_->host_to_server_ids, statistics_info_.host_to_server_size_,
+               &swap_info->host_to_server_ids_);
+  copy_indices(embedding_host_cache_->host_to_server_index, statistics_info_.host_to_server_size_,
+               &swap_info->host_to_server_index_);
+  copy_indices(embedding_host_cache_->server_to_host_ids, statistics_info_.server_to_host_size_,
+               &swap_info->server_to_host_ids_);
+  copy_indices(embedding_host_cache_->server_to_host_index, statistics_info_.server_to_host_size_,
+               &swap_info->server_to_host_index_);
+  copy_indices(embedding_host_cache_->new_id_index, statistics_info_.new_id_size_, &swap_info->new_id_index_);
+  CollectHotIds(swap_info);
+
+  {
+    std::lock_guard<std::mutex> locker(update_mutex_);
+    ++committed_step_;
+  }
+  update_cond_.notify_all();
+  return true;
+}
+
+void EmbeddingCachePrefetchActor::WaitCacheUpdate() {
+  std::unique_lock<std::mutex> locker(update_mutex_);
+  update_cond_.wait(locker, [this] { return updated_step_ >= graph_step_ || !running_; });
+  if (!running_) {
+    std::string error_info =
+      !error_info_.empty() ? error_info_ : "Embedding cache prefetch actor is finalized abnormally.";
+    MS_LOG(EXCEPTION) << error_info;
+  }
+}
+
+void EmbeddingCachePrefetchActor::WaitAllCacheUpdates() {
+  std::unique_lock<std::mutex> locker(update_mutex_);
+  update_cond_.wait(locker, [this] { return updated_step_ >= committed_step_ || !running_; });
+}
+
+void EmbeddingCachePrefetchActor::RecordStageCost(PrefetchStage stage, uint64_t start_usec) {
+  auto index = static_cast<size_t>(stage);
+  auto cost = GetCurrentUSec() - start_usec;
+  stage_cost_usec_[index] += cost;
+  ++stage_count_[index];
+  MS_LOG(DEBUG) << "[PROF]" << kPrefetchStageNames[index] << " costs " << cost << " usec.";
+}
+
+void EmbeddingCachePrefetchActor::PrintStageCost() const {
+  for (size_t i = 0; i < static_cast<size_t>(PrefetchStage::kStageNum); ++i) {
+    uint64_t count = stage_count_[i];
+    uint64_t total = stage_cost_usec_[i];
+    if (count == 0) {
+      continue;
+    }
+    MS_LOG(INFO) << "[PROF]Embedding cache prefetch stage " << kPrefetchStageNames[i] << " called " << count
+                 << " times, costs " << total << " usec, average " << (total / count) << " usec.";
+  }
+}
+
 bool EmbeddingCachePrefetchActor::PrefetchCache() {
   // 1. Acquire batch ids
   void *data = nullptr;
@@ -548,7 +758,8 @@ bool EmbeddingCachePrefetchActor::PrefetchCache() {
     return false;
   }
 
-  // 2. Count cache miss ids.
+  // 2. Count cache miss ids, the hot ids are pinned before the cache miss analysis evicts any id.
+  PinHotIds(batch_ids, batch_ids_num);
   RETURN_IF_FALSE_WITH_LOG(CountCacheMissIds(batch_ids, batch_ids_num, hash_index.get()),
                            "Count cache miss ids failed.");
 
@@ -557,8 +768,12 @@ bool EmbeddingCachePrefetchActor::PrefetchCache() {
     return false;
   }
 
-  // 3. If the device cache does not reach 100% hit rate, the cache needs to be updated.
-  RETURN_IF_FALSE_WITH_LOG(UpdateCache(), "Update local cache failed.");
+  // 3. If the device cache does not reach 100% hit rate, the cache needs to be updated. The cache update runs in the
+  // cache update thread if the prefetch depth is greater than 1, and the graph waits for it in IncreaseGraphStep.
+  RETURN_IF_FALSE_WITH_LOG(CommitCacheSwapInfo(), "Commit cache swap info failed.");
+  if (prefetch_depth_ == 1) {
+    RETURN_IF_FALSE(UpdateOldestCache());
+  }
 
   // 4. Replace the batch_ids by hash index for GetNext operator to get hash index as input.
   size_t dest_len = data_size;
@@ -605,13 +820,16 @@ bool EmbeddingCachePrefetchActor::CountCacheMissIds(const int *batch_ids, const
   }
 
   // 1. Analyze the hit/miss info of the local host cache and device cache.
+  auto start_usec = GetCurrentUSec();
   RETURN_IF_FALSE_WITH_LOG(
     CheckCacheHitOrOutRange(batch_ids, batch_ids_num, hash_index, in_device.get(), out_range.get()),
     "Check cache hit or out range failed.");
   RETURN_IF_FALSE_WITH_LOG(ResetEmbeddingHashMap(), "Reset embedding hash map failed.");
+  RecordStageCost(PrefetchStage::kCheckCacheHit, start_usec);
 
   // 2.calculate the swapping and mapping(feature id to cache index) information of the missing feature id that needs to
   // be inserted into the cache.
+  start_usec = GetCurrentUSec();
   for (size_t i = 0; i < batch_ids_num; i++) {
     if (in_device[i] || out_range[i]) {
       continue;
@@ -632,6 +850,7 @@ bool EmbeddingCachePrefetchActor::CountCacheMissIds(const int *batch_ids, const
                                "Parse local host cache data(swap device cache to local host) failed.");
     }
   }
+  RecordStageCost(PrefetchStage::kParseCacheMiss, start_usec);
   return true;
 }
 
@@ -879,29 +1098,60 @@ bool EmbeddingCachePrefetchActor::WaitGraphRun() {
   return true;
 }
 
-bool EmbeddingCachePrefetchActor::UpdateCache() {
+bool EmbeddingCachePrefetchActor::UpdateCache(const CacheSwapInfo &swap_info) {
+  MS_LOG(DEBUG) << "Update cache for data step: " << swap_info.data_step_;
   for (const auto &item : hash_tables_) {
     auto hash_info = item.second;
-    RETURN_IF_FALSE_WITH_LOG(PushCacheFromLocalHostToRemote(hash_info), "Push cache from local host to remote failed.");
-    RETURN_IF_FALSE_WITH_LOG(PushCacheFromDeviceToLocalHost(hash_info), "Push cache from device to local host failed.");
-    RETURN_IF_FALSE_WITH_LOG(InitLocalCacheForNewIds(hash_info),
-                             "Initialize the local cache values using random generator.");
-    RETURN_IF_FALSE_WITH_LOG(PullCacheFromRemoteToLocalHost(hash_info), "Pull cache from remote to local host failed.");
-    RETURN_IF_FALSE_WITH_LOG(PullCacheFromLocalHostToDevice(hash_info), "Pull cache from local host to device failed.");
+    // The evicted embeddings must be read out before the local host cache rows are reused.
+    auto start_usec = GetCurrentUSec();
+    RETURN_IF_FALSE_WITH_LOG(PushCacheFromLocalHostToRemote(hash_info, swap_info),
+                             "Push cache from local host to remote failed.");
+    RecordStageCost(PrefetchStage::kPushHostToRemote, start_usec);
+
+    // The embeddings pulled from remote and swapped out from device are inserted into the different local host cache
+    // rows, so the remote pulling overlaps with the device to host swapping on the common thread pool.
+    bool pull_success = false;
+    bool swap_success = false;
+    std::vector<common::Task> tasks;
+    tasks.emplace_back([this, &hash_info, &swap_info, &pull_success]() {
+      auto pull_start_usec = GetCurrentUSec();
+      pull_success = PullCacheFromRemoteToLocalHost(hash_info, swap_info);
+      RecordStageCost(PrefetchStage::kPullRemoteToHost, pull_start_usec);
+      return common::SUCCESS;
+    });
+    tasks.emplace_back([this, &hash_info, &swap_info, &swap_success]() {
+      auto swap_start_usec = GetCurrentUSec();
+      // The device cache is looked up on the thread of the pool, which needs to be bound to the device first.
+      swap_success = device_context_ != nullptr && device_context_->device_res_manager_ != nullptr &&
+                     device_context_->device_res_manager_->BindDeviceToCurrentThread() &&
+                     PushCacheFromDeviceToLocalHost(hash_info, swap_info) &&
+                     InitLocalCacheForNewIds(hash_info, swap_info);
+      RecordStageCost(PrefetchStage::kSwapDeviceToHost, swap_start_usec);
+      return common::SUCCESS;
+    });
+    (void)common::ThreadPool::GetInstance().SyncRun(tasks);
+    RETURN_IF_FALSE_WITH_LOG(swap_success, "Push cache from device to local host or initialize new ids failed.");
+    RETURN_IF_FALSE_WITH_LOG(pull_success, "Pull cache from remote to local host failed.");
+    RETURN_IF_FALSE_WITH_LOG(ReconcileHotIds(hash_info, swap_info), "Reconcile hot ids to remote failed.");
+
+    start_usec = GetCurrentUSec();
+    RETURN_IF_FALSE_WITH_LOG(PullCacheFromLocalHostToDevice(hash_info, swap_info),
+                             "Pull cache from local host to device failed.");
+    RecordStageCost(PrefetchStage::kSwapHostToDevice, start_usec);
   }
   return true;
 }
 
-bool EmbeddingCachePrefetchActor::PushCacheFromLocalHostToRemote(const HashTableInfo &hash_info) {
-  auto swap_indices_size = statistics_info_.host_to_server_size_;
+bool EmbeddingCachePrefetchActor::PushCacheFromLocalHostToRemote(const HashTableInfo &hash_info,
+                                                                 const CacheSwapInfo &swap_info) {
+  auto swap_indices_size = swap_info.statistics_info_.host_to_server_size_;
   if (swap_indices_size == 0) {
     return true;
   }
 
-  MS_ERROR_IF_NULL(embedding_host_cache_);
-  auto host_to_server_ids = embedding_host_cache_->host_to_server_ids.get();
+  auto host_to_server_ids = swap_info.host_to_server_ids_.data();
   MS_ERROR_IF_NULL(host_to_server_ids);
-  auto host_to_server_index = embedding_host_cache_->host_to_server_index.get();
+  auto host_to_server_index = swap_info.host_to_server_index_.data();
   MS_ERROR_IF_NULL(host_to_server_index);
 
   std::vector<float> swap_out_data;
@@ -918,17 +1168,77 @@ bool EmbeddingCachePrefetchActor::PushCacheFromLocalHostToRemote(const HashTable
   return true;
 }
 
-bool EmbeddingCachePrefetchActor::PushCacheFromDeviceToLocalHost(const HashTableInfo &hash_info) {
-  auto swap_indices_size = statistics_info_.device_to_host_size_;
+bool EmbeddingCachePrefetchActor::ReconcileHotIds(const HashTableInfo &hash_info, const CacheSwapInfo &swap_info) {
+  auto hot_id_num = swap_info.hot_ids_.size();
+  if (hot_id_num == 0) {
+    return true;
+  }
+
+  std::vector<float> hot_embeddings;
+  auto embedding_size = hash_info.embedding_size;
+  hot_embeddings.resize(hot_id_num * embedding_size);
+  auto host_hash_table_addr = reinterpret_cast<float *>(hash_info.host_address.get());
+
+  RETURN_IF_FALSE_WITH_LOG(LookupLocalHostCache(embedding_size, hot_id_num, host_hash_table_addr,
+                                                swap_info.hot_id_index_.data(), hot_embeddings.data()),
+                           "Lookup local host cache failed.");
+  RETURN_IF_FALSE_WITH_LOG(PushEmbeddingsToRemote(hash_info.param_key_, swap_info.hot_ids_.data(), hot_id_num,
+                                                  hot_embeddings.data(), hot_embeddings.size() * sizeof(float)),
+                           "Push embeddings to remote failed.");
+  return true;
+}
+
+void EmbeddingCachePrefetchActor::PinHotIds(const int *batch_ids, size_t batch_ids_num) {
+  if (hot_id_tracker_ == nullptr) {
+    return;
+  }
+  hot_ids_refreshed_ = hot_id_tracker_->Record(batch_ids, batch_ids_num, local_embedding_slice_bounds_.first,
+                                               local_embedding_slice_bounds_.second);
+
+  // The hot ids marked by current data step are not expired until the graph finishes this step, so they are not
+  // swapped out to remote even though they are absent from some batches.
+  MS_EXCEPTION_IF_NULL(embedding_host_cache_);
+  const auto &host_hash_map = embedding_host_cache_->host_hash_map_;
+  MS_EXCEPTION_IF_NULL(host_hash_map);
+  const auto &hash_id_to_index = host_hash_map->hash_id_to_index();
+  for (int id : hot_id_tracker_->hot_ids()) {
+    const auto &iter = hash_id_to_index.find(id);
+    if (iter != hash_id_to_index.end()) {
+      host_hash_map->set_hash_step(iter->second, data_step_);
+    }
+  }
+}
+
+void EmbeddingCachePrefetchActor::CollectHotIds(CacheSwapInfo *swap_info) {
+  MS_EXCEPTION_IF_NULL(swap_info);
+  swap_info->hot_ids_.clear();
+  swap_info->hot_id_index_.clear();
+  if (hot_id_tracker_ == nullptr || !hot_ids_refreshed_) {
+    return;
+  }
+
+  // The device hash map has been updated by the cache miss analysis of this batch, so the hot ids swapped out of device
+  // by this batch are reconciled after their device copies are pushed to the local host cache.
+  MS_EXCEPTION_IF_NULL(embedding_host_cache_);
+  MS_EXCEPTION_IF_NULL(embedding_host_cache_->host_hash_map_);
+  MS_EXCEPTION_IF_NULL(embedding_device_cache_);
+  MS_EXCEPTION_IF_NULL(embedding_device_cache_->device_hash_map_);
+  hot_id_tracker_->CollectHostResidentIds(*embedding_host_cache_->host_hash_map_,
+                                          *embedding_device_cache_->device_hash_map_, &swap_info->hot_ids_,
+                                          &swap_info->hot_id_index_);
+}
+
+bool EmbeddingCachePrefetchActor::PushCacheFromDeviceToLocalHost(const HashTableInfo &hash_info,
+                                                                 const CacheSwapInfo &swap_info) {
+  auto swap_indices_size = swap_info.statistics_info_.device_to_host_size_;
   if (swap_indices_size == 0) {
     return true;
   }
 
   MS_ERROR_IF_NULL(embedding_device_cache_);
-  MS_ERROR_IF_NULL(embedding_host_cache_);
 
-  auto device_cache_device_to_host_index = embedding_device_cache_->device_to_host_index.get();
-  auto host_cache_device_to_host_index = embedding_host_cache_->device_to_host_index.get();
+  auto device_cache_device_to_host_index = swap_info.device_cache_device_to_host_index_.data();
+  auto host_cache_device_to_host_index = swap_info.host_cache_device_to_host_index_.data();
   MS_ERROR_IF_NULL(device_cache_device_to_host_index);
   MS_ERROR_IF_NULL(host_cache_device_to_host_index);
   auto hash_table_addr = reinterpret_cast<float *>(hash_info.device_address.addr);
@@ -962,16 +1272,16 @@ bool EmbeddingCachePrefetchActor::PushCacheFromDeviceToLocalHost(const HashTable
   return true;
 }
 
-bool EmbeddingCachePrefetchActor::PullCacheFromRemoteToLocalHost(const HashTableInfo &hash_info) {
-  auto swap_indices_size = statistics_info_.server_to_host_size_;
+bool EmbeddingCachePrefetchActor::PullCacheFromRemoteToLocalHost(const HashTableInfo &hash_info,
+                                                                 const CacheSwapInfo &swap_info) {
+  auto swap_indices_size = swap_info.statistics_info_.server_to_host_size_;
   if (swap_indices_size == 0) {
     return true;
   }
 
-  MS_ERROR_IF_NULL(embedding_host_cache_);
-  auto server_to_host_ids = embedding_host_cache_->server_to_host_ids.get();
+  auto server_to_host_ids = swap_info.server_to_host_ids_.data();
   MS_ERROR_IF_NULL(server_to_host_ids);
-  auto server_to_host_index = embedding_host_cache_->server_to_host_index.get();
+  auto server_to_host_index = swap_info.server_to_host_index_.data();
   MS_ERROR_IF_NULL(server_to_host_index);
 
   auto host_hash_table_addr = reinterpret_cast<float *>(hash_info.host_address.get());
@@ -988,17 +1298,17 @@ bool EmbeddingCachePrefetchActor::PullCacheFromRemoteToLocalHost(const HashTable
   return true;
 }
 
-bool EmbeddingCachePrefetchActor::PullCacheFromLocalHostToDevice(const HashTableInfo &hash_info) {
-  auto swap_indices_size = statistics_info_.host_to_device_size_;
+bool EmbeddingCachePrefetchActor::PullCacheFromLocalHostToDevice(const HashTableInfo &hash_info,
+                                                                 const CacheSwapInfo &swap_info) {
+  auto swap_indices_size = swap_info.statistics_info_.host_to_device_size_;
   if (swap_indices_size == 0) {
     return true;
   }
 
   MS_ERROR_IF_NULL(embedding_device_cache_);
-  MS_ERROR_IF_NULL(embedding_host_cache_);
 
-  auto host_cache_host_to_device_index = embedding_host_cache_->host_to_device_index.get();
-  auto device_cache_host_to_device_index = embedding_device_cache_->host_to_device_index.get();
+  auto host_cache_host_to_device_index = swap_info.host_cache_host_to_device_index_.data();
+  auto device_cache_host_to_device_index = swap_info.device_cache_host_to_device_index_.data();
   MS_ERROR_IF_NULL(host_cache_host_to_device_index);
   MS_ERROR_IF_NULL(device_cache_host_to_device_index);
 
@@ -1032,14 +1342,14 @@ bool EmbeddingCachePrefetchActor::PullCacheFromLocalHostToDevice(const HashTable
   return true;
 }
 
-bool EmbeddingCachePrefetchActor::InitLocalCacheForNewIds(const HashTableInfo &hash_info) {
-  auto new_id_size = statistics_info_.new_id_size_;
+bool EmbeddingCachePrefetchActor::InitLocalCacheForNewIds(const HashTableInfo &hash_info,
+                                                          const CacheSwapInfo &swap_info) {
+  auto new_id_size = swap_info.statistics_info_.new_id_size_;
   if (new_id_size == 0) {
     return true;
   }
 
-  MS_ERROR_IF_NULL(embedding_host_cache_);
-  auto new_id_index = embedding_host_cache_->new_id_index.get();
+  auto new_id_index = swap_info.new_id_index_.data();
   MS_ERROR_IF_NULL(new_id_index);
 
   // Compute the feature values size needed to be initialized.
@@ -1199,17 +1509,28 @@ bool EmbeddingCachePrefetchActor::PullEembeddingsFromRemote(int32_t param_key, c
   std::vector<std::vector<int>> slice_ids_list(server_num_);
   // 1. Partition ids by remote embedding slice bound and get unique ids.
   RETURN_IF_FALSE_WITH_LOG(PartitionIds(ids, ids_num, &slice_ids_list), "Partition ids failed.");
+  RecordRemoteRequests(distributed::kLookupEmbeddingCache, slice_ids_list);
 
   size_t embedding_dim = outputs->size() / ids_num;
+  std::vector<std::vector<int>> slice_keys_list(server_num_);
   for (size_t i = 0; i < server_num_; i++) {
     auto &slice_ids = slice_ids_list[i];
     if (slice_ids.empty()) {
       continue;
     }
 
-    // 2. Send unique ids to remote to do embedding lookup.
+    // 2. Send unique ids to remote to do embedding lookup. The remote lookup subtracts the slice offset from the keys,
+    // so the keys are the rows in the server's embedding table slice plus the offset.
+    auto &slice_keys = slice_keys_list[i];
+    int offset = SizeToInt(remote_embedding_slice_bounds_[i].first);
+    (void)std::transform(slice_ids.begin(), slice_ids.end(), std::back_inserter(slice_keys), [this, offset](int id) {
+      size_t server_rank_id = 0;
+      int row = 0;
+      (void)remote_sharding_->Locate(id, &server_rank_id, &row);
+      return row + offset;
+    });
     RETURN_IF_FALSE_WITH_LOG(SendToRemote(distributed::kLookupEmbeddingCache, param_key, i, embedding_dim,
-                                          slice_ids.data(), slice_ids.size() * sizeof(int), nullptr, 0, false, false),
+                                          slice_keys.data(), slice_keys.size() * sizeof(int), nullptr, 0, false, false),
                              "Send ids to server failed.");
   }
 
@@ -1255,6 +1576,7 @@ bool EmbeddingCachePrefetchActor::PushEmbeddingsToRemote(int32_t param_key, cons
   RETURN_IF_FALSE_WITH_LOG(
     PartitionIdsAndEmbeddings(ids, ids_num, embeddings, embeddings_len, &slice_ids_list, &slice_embeddings_list),
     "Partition ids and embeddings failed.");
+  RecordRemoteRequests(distributed::kUpdateEmbeddingCache, slice_ids_list);
 
   size_t embedding_dim = (embeddings_len / ids_num) / sizeof(float);
   for (size_t i = 0; i < server_num_; i++) {
@@ -1279,24 +1601,42 @@ void EmbeddingCachePrefetchActor::GetRemoteEmbeddingSliceBound() {
   if (server_num_ == 0) {
     MS_LOG(EXCEPTION) << "The server num is 0";
   }
-  size_t average_slice_size = vocab_size_ / server_num_;
-  std::vector<size_t> remote_embedding_slice_sizes = std::vector<size_t>(server_num_, average_slice_size);
-  size_t rest_vocab_size = vocab_size_ % server_num_;
-  for (size_t i = 0; i < rest_vocab_size; i++) {
-    remote_embedding_slice_sizes[i] += 1;
+  auto sharding_policy = common::GetEnv(kShardingPolicyEnv) == "hash" ? distributed::RemoteShardingPolicy::kHash
+                                                                       : distributed::RemoteShardingPolicy::kRange;
+  remote_sharding_ = std::make_unique<distributed::RemoteEmbeddingSharding>(vocab_size_, server_num_, sharding_policy);
+  remote_embedding_slice_bounds_ = remote_sharding_->slice_bounds();
+  MS_LOG(INFO) << "The embedding table is sharded over " << server_num_ << " servers by "
+               << (sharding_policy == distributed::RemoteShardingPolicy::kHash ? "id hash." : "id range.");
+}
+
+void EmbeddingCachePrefetchActor::RecordRemoteRequests(const std::string &cache_operation,
+                                                       const std::vector<std::vector<int>> &slice_ids_list) {
+  auto iter = remote_request_ids_num_.find(cache_operation);
+  if (iter == remote_request_ids_num_.end()) {
+    return;
+  }
+  auto &request_ids_num = iter->second;
+  for (size_t i = 0; i < slice_ids_list.size() && i < request_ids_num.size(); ++i) {
+    request_ids_num[i] += slice_ids_list[i].size();
   }
+}
 
-  size_t begin;
-  size_t end;
-  for (size_t i = 0; i < server_num_; i++) {
-    if (i == 0) {
-      begin = 0;
-      end = remote_embedding_slice_sizes[0] - 1;
-    } else {
-      begin = remote_embedding_slice_bounds_[i - 1].second + 1;
-      end = begin + remote_embedding_slice_sizes[i] - 1;
+void EmbeddingCachePrefetchActor::PrintRemoteRequests() const {
+  for (const auto &item : remote_request_ids_num_) {
+    const auto &request_ids_num = item.second;
+    auto total = std::accumulate(request_ids_num.begin(), request_ids_num.end(), size_t(0));
+    if (total == 0) {
+      continue;
     }
-    (void)remote_embedding_slice_bounds_.emplace_back(begin, end);
+    std::ostringstream oss;
+    for (size_t i = 0; i < request_ids_num.size(); ++i) {
+      oss << (i == 0 ? "" : ", ") << "server " << i << ": " << request_ids_num[i];
+    }
+    // The imbalance is the ratio of the maximum load to the average load, 1 means the load is balanced.
+    auto max_ids_num = *std::max_element(request_ids_num.begin(), request_ids_num.end());
+    auto imbalance = static_cast<double>(max_ids_num) * request_ids_num.size() / total;
+    MS_LOG(INFO) << "[PROF]Embedding cache " << item.first << " requests ids number of " << oss.str()
+                 << ", imbalance " << imbalance << ".";
   }
 }
 
@@ -1305,17 +1645,17 @@ bool EmbeddingCachePrefetchActor::PartitionIds(const int *ids, size_t ids_num,
   MS_ERROR_IF_NULL(ids);
   MS_ERROR_IF_NULL(slice_ids_list);
 
-  for (size_t i = 0; i < slice_ids_list->size(); i++) {
-    int begin = SizeToInt(remote_embedding_slice_bounds_[i].first);
-    int end = SizeToInt(remote_embedding_slice_bounds_[i].second);
-
-    mindspore::HashSet<int> unique_ids;
-    (void)std::for_each(ids, ids + ids_num, [&](int id) {
-      if (id >= begin && id <= end) {
-        (void)unique_ids.insert(id);
-      }
-    });
+  std::vector<mindspore::HashSet<int>> unique_ids_list(slice_ids_list->size());
+  size_t server_rank_id = 0;
+  int row = 0;
+  for (size_t i = 0; i < ids_num; i++) {
+    if (remote_sharding_->Locate(ids[i], &server_rank_id, &row) && server_rank_id < unique_ids_list.size()) {
+      (void)unique_ids_list[server_rank_id].insert(ids[i]);
+    }
+  }
 
+  for (size_t i = 0; i < slice_ids_list->size(); i++) {
+    const auto &unique_ids = unique_ids_list[i];
     std::vector<int> &slice_ids = slice_ids_list->at(i);
     (void)std::for_each(unique_ids.begin(), unique_ids.end(), [&](int id) { slice_ids.push_back(id); });
   }
@@ -1339,21 +1679,16 @@ bool EmbeddingCachePrefetchActor::PartitionIdsAndEmbeddings(const int *ids, size
 
   size_t embedding_dim = (embeddings_len / ids_num) / sizeof(float);
   size_t partition_num = slice_ids_list->size();
-  for (size_t i = 0; i < partition_num; i++) {
-    int begin = SizeToInt(remote_embedding_slice_bounds_[i].first);
-    int end = SizeToInt(remote_embedding_slice_bounds_[i].second);
-
-    std::vector<int> &slice_ids = slice_ids_list->at(i);
-    std::vector<float> &slice_embeddings = slice_embeddings_list->at(i);
-    // Ids range offset for multi server.
-    int offset = SizeToInt(remote_embedding_slice_bounds_.at(i).first);
-    for (size_t j = 0; j < ids_num; j++) {
-      if (ids[j] >= begin && ids[j] <= end) {
-        slice_ids.push_back(ids[j] - offset);
-        (void)slice_embeddings.insert(slice_embeddings.end(), embeddings + (j * embedding_dim),
-                                      embeddings + (j * embedding_dim) + embedding_dim);
-      }
+  size_t server_rank_id = 0;
+  int row = 0;
+  for (size_t j = 0; j < ids_num; j++) {
+    if (!remote_sharding_->Locate(ids[j], &server_rank_id, &row) || server_rank_id >= partition_num) {
+      continue;
     }
+    slice_ids_list->at(server_rank_id).push_back(row);
+    std::vector<float> &slice_embeddings = slice_embeddings_list->at(server_rank_id);
+    (void)slice_embeddings.insert(slice_embeddings.end(), embeddings + (j * embedding_dim),
+                                  embeddings + (j * embedding_dim) + embedding_dim);
   }
   return true;
 }
@@ -1489,6 +1824,8 @@ void EmbeddingCachePrefetchActor::SyncEmbeddingTable() {
   if (!initialized_) {
     return;
   }
+  // The embeddings of the committed batch ids must be in the cache before syncing.
+  WaitAllCacheUpdates();
   if (!SyncHostEmbeddingTable()) {
     MS_LOG(ERROR) << "SyncHostEmbeddingTable failed.";
   }
@@ -24,6 +24,9 @@
 #include <vector>
 #include <utility>
 #include <random>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 
 #include "runtime/graph_scheduler/actor/actor_common.h"
 #include "ir/anf.h"
@@ -71,6 +74,43 @@ using DataType = float;
 using Generator = random::Philox;
 using Distribution = random::NormalDistribution<double>;
 
+// The stages of cache prefetching for a batch ids, the cache miss analysis stages run on the prefetch actor thread and
+// the cache update stages run on the cache update thread.
+enum class PrefetchStage : size_t {
+  kCheckCacheHit = 0,
+  kParseCacheMiss,
+  kWaitSwapBuffer,
+  kPushHostToRemote,
+  kSwapDeviceToHost,
+  kPullRemoteToHost,
+  kSwapHostToDevice,
+  kStageNum
+};
+
+// The swap information of one batch ids produced by the cache miss analysis and consumed by the cache update. A swap
+// buffer is reused only after the cache update of the batch which uses it finishes.
+struct CacheSwapInfo {
+  size_t data_step_{0};
+  EmbeddingCacheStatisticsInfo statistics_info_;
+  // The device cache indices and the local host cache indices of the embeddings swapped from device to local host.
+  std::vector<int> device_cache_device_to_host_index_;
+  std::vector<int> host_cache_device_to_host_index_;
+  // The device cache indices and the local host cache indices of the embeddings swapped from local host to device.
+  std::vector<int> device_cache_host_to_device_index_;
+  std::vector<int> host_cache_host_to_device_index_;
+  // The ids and local host cache indices of the embeddings pushed to remote.
+  std::vector<int> host_to_server_ids_;
+  std::vector<int> host_to_server_index_;
+  // The ids and local host cache indices of the embeddings pulled from remote.
+  std::vector<int> server_to_host_ids_;
+  std::vector<int> server_to_host_index_;
+  // The local host cache indices of the new ids which are initialized by the random generator.
+  std::vector<int> new_id_index_;
+  // The ids and local host cache indices of the hot embeddings reconciled to remote, empty in most steps.
+  std::vector<int> hot_ids_;
+  std::vector<int> hot_id_index_;
+};
+
 // The EmbeddingCachePrefetchActor is used to cache large embedding table scenarios. The cache level is: Device
 // Cache->Local Host Cache->Remote Cache. This Actor is used to perform Local and Device Cache hit analysis and cache
 // prefetching (the feature weights corresponding to the ids of subsequent batches are assigned in advance Prefetching
@@ -140,19 +180,44 @@ class EmbeddingCachePrefetchActor : public ActorBase {
   // When the device cache does not reach 100% hit, the cache needs to be updated, which involves cache insertion and
   // deletion. That is, push the non-hotspot embeddings on the local side to the remote, and pull the missing embeddings
   // on the local side from the remote.
-  bool UpdateCache();
+  bool UpdateCache(const CacheSwapInfo &swap_info);
+
+  // Copy the swap information of current batch ids to a free swap buffer and hand it over to the cache update stage,
+  // wait for a free swap buffer if the cache update falls behind by the prefetch depth.
+  bool CommitCacheSwapInfo();
+  // Thread execution function of the cache update stage when the prefetch depth is greater than 1.
+  void UpdateCacheLoop();
+  // Update the cache by the swap buffer of the oldest batch ids whose cache is not updated yet.
+  bool UpdateOldestCache();
+  // Wait the cache update of the batch ids used by current graph step finish.
+  void WaitCacheUpdate();
+  // Wait all the committed cache updates finish.
+  void WaitAllCacheUpdates();
+
+  // Record and print the latency of prefetch stages.
+  void RecordStageCost(PrefetchStage stage, uint64_t start_usec);
+  void PrintStageCost() const;
 
   // Push non-hotspot embeddings on local host cache to remote.
-  bool PushCacheFromLocalHostToRemote(const HashTableInfo &hash_info);
+  bool PushCacheFromLocalHostToRemote(const HashTableInfo &hash_info, const CacheSwapInfo &swap_info);
   // Push non-hotspot embeddings on device cache to local host cache.
-  bool PushCacheFromDeviceToLocalHost(const HashTableInfo &hash_info);
+  bool PushCacheFromDeviceToLocalHost(const HashTableInfo &hash_info, const CacheSwapInfo &swap_info);
   // Pull missing embeddings on local cache from remote.
-  bool PullCacheFromRemoteToLocalHost(const HashTableInfo &hash_info);
+  bool PullCacheFromRemoteToLocalHost(const HashTableInfo &hash_info, const CacheSwapInfo &swap_info);
   // Pull missing embeddings on device cache from local host.
-  bool PullCacheFromLocalHostToDevice(const HashTableInfo &hash_info);
+  bool PullCacheFromLocalHostToDevice(const HashTableInfo &hash_info, const CacheSwapInfo &swap_info);
+
+  // Push the hot embeddings pinned in the local host cache to remote, so that the remote copy does not fall behind.
+  bool ReconcileHotIds(const HashTableInfo &hash_info, const CacheSwapInfo &swap_info);
+
+  // Count the batch ids and keep the hot ids resident in the local host cache by refreshing their steps.
+  void PinHotIds(const int *batch_ids, size_t batch_ids_num);
+  // Collect the hot ids whose latest embeddings are in the local host cache, which excludes the hot ids resident in the
+  // device cache, to reconcile them in the cache update stage.
+  void CollectHotIds(CacheSwapInfo *swap_info);
 
   // Initialize local cache values using the random number generator.
-  bool InitLocalCacheForNewIds(const HashTableInfo &hash_info);
+  bool InitLocalCacheForNewIds(const HashTableInfo &hash_info, const CacheSwapInfo &swap_info);
 
   // Insert weights into the local host embedding cache.
   bool InsertLocalHostCache(size_t embedding_size, size_t insert_indices_size, const int *insert_indices,
@@ -172,13 +237,17 @@ class EmbeddingCachePrefetchActor : public ActorBase {
 
   // Get the id range of each server's embedding table slice.
   void GetRemoteEmbeddingSliceBound();
+  // Record and print the number of ids requested from each server, which shows the load imbalance of servers.
+  void RecordRemoteRequests(const std::string &cache_operation, const std::vector<std::vector<int>> &slice_ids_list);
+  void PrintRemoteRequests() const;
 
   // In a multi-server scenario, the embeddings need to be segmented, and each server saves the embeddings of
   // different feature id ranges. Therefore, when the local side performs the push or pull embeddings operation, the
   // embeddings and ids need to be divided, and then communicate with the corresponding remote: Partition ids by
-  // remote embedding slice bound and get unique ids.
+  // remote embedding slice bound and get unique ids. The ids of each slice are the origin ids.
   bool PartitionIds(const int *ids, size_t ids_num, std::vector<std::vector<int>> *slice_ids_list);
-  // Partition ids end embeddings by remote embedding slice bound.
+  // Partition ids end embeddings by remote embedding slice bound. The ids of each slice are the rows in the server's
+  // embedding table slice.
   bool PartitionIdsAndEmbeddings(const int *ids, size_t ids_num, const float *embeddings, size_t embeddings_len,
                                  std::vector<std::vector<int>> *slice_ids_list,
                                  std::vector<std::vector<float>> *slice_embeddings_list);
@@ -304,6 +373,15 @@ class EmbeddingCachePrefetchActor : public ActorBase {
 
   // Total server number of cluster.
   size_t server_num_{0};
+  // Map the ids to the servers and the rows in the embedding table slices of the servers.
+  std::unique_ptr<distributed::RemoteEmbeddingSharding> remote_sharding_;
+  // The number of ids requested from each server by cache operation name, only accessed by the cache update stage.
+  std::map<std::string, std::vector<size_t>> remote_request_ids_num_;
+
+  // Track the hot ids which are pinned in the local host cache, nullptr if the hot id pinning is disabled.
+  std::unique_ptr<distributed::HotIdTracker> hot_id_tracker_;
+  // Whether the hot ids are reselected by current batch ids, the reselected hot ids are reconciled to remote.
+  bool hot_ids_refreshed_{false};
 
   // The flag which indicates whether this actor is running to prefetch cache.
   std::atomic_bool running_{false};
@@ -353,6 +431,25 @@ class EmbeddingCachePrefetchActor : public ActorBase {
 
   // The feature ids that have been initialized already.
   std::set<int> initialized_ids_;
+
+  // The number of batch ids whose cache miss analysis can run ahead of their cache update, 1 means the cache update
+  // runs on the prefetch actor thread right after the analysis.
+  size_t prefetch_depth_{1};
+  // The swap buffers used in turn by the batch ids, the size is prefetch_depth_.
+  std::vector<CacheSwapInfo> swap_buffers_;
+  // The number of batch ids whose swap information is committed to the cache update stage.
+  size_t committed_step_{0};
+  // The number of batch ids whose cache update finishes.
+  size_t updated_step_{0};
+  // The mutex and condition variable to synchronize the cache miss analysis, the cache update and the graph running.
+  std::mutex update_mutex_;
+  std::condition_variable update_cond_;
+  // The thread runs the cache update stage.
+  std::thread update_thread_;
+
+  // The accumulated latency in microseconds and counts of each prefetch stage.
+  std::atomic<uint64_t> stage_cost_usec_[static_cast<size_t>(PrefetchStage::kStageNum)]{};
+  std::atomic<uint64_t> stage_count_[static_cast<size_t>(PrefetchStage::kStageNum)]{};
 };
 
 // RpcOperator is used to do rpc with other processes in distributed execution.
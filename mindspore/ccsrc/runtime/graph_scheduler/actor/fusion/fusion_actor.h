@@ -46,7 +46,7 @@ class FusionActor : public AbstractActor {
     return real_input_controls_;
   }
 
- private:
+ protected:
   friend class SchedulerHelper;
 
   // std::pair<actor, input_index> used to find the mapping between fusion actor inputs and real actors inputs.
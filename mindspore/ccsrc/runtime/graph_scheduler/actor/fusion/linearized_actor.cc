@@ -0,0 +1,87 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/graph_scheduler/actor/fusion/linearized_actor.h"
+
+namespace mindspore {
+namespace runtime {
+void LinearizedActor::RunOpData(OpData<DeviceTensor> *const input_data, OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(input_data);
+  MS_EXCEPTION_IF_NULL(context);
+  MS_LOG(DEBUG) << "Actor(" << GetAID().Name() << ") receive the input op data.";
+
+  if (IntToSize(input_data->index_) >= real_input_data_.size()) {
+    SET_OPCONTEXT_FAIL_RET_WITH_ERROR((*context), "The input index is out of range.");
+  }
+  // Update the input data using the real input info, and the real actor is triggered by the launch schedule.
+  auto &real_input_data = real_input_data_[IntToSize(input_data->index_)];
+  MS_EXCEPTION_IF_NULL(real_input_data.first);
+  input_data->index_ = SizeToInt(real_input_data.second);
+  (void)real_input_data.first->input_op_datas_[context->sequential_num_].emplace_back(input_data);
+
+  AbstractActor::RunOpData(input_data, context);
+}
+
+void LinearizedActor::RunOpControl(AID *const input_control, OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(input_control);
+  MS_EXCEPTION_IF_NULL(context);
+  MS_LOG(DEBUG) << "Actor(" << GetAID().Name() << ") receive the input op control: " << input_control->Name();
+  AbstractActor::RunOpControl(input_control, context);
+}
+
+void LinearizedActor::Run(OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(context);
+  // The output device tensors of kernel actor can't be changed after initialization, so only need bind once.
+  if (!is_bound_) {
+    BindInternalInputs(context);
+    if (IsRunningFailed(context)) {
+      return;
+    }
+    is_bound_ = true;
+  }
+
+  for (auto &kernel_actor : launch_schedule_) {
+    MS_EXCEPTION_IF_NULL(kernel_actor);
+    kernel_actor->Run(context);
+    if (IsRunningFailed(context)) {
+      return;
+    }
+  }
+
+  EraseInput(context);
+}
+
+void LinearizedActor::BindInternalInputs(OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(context);
+  for (auto &internal_input : internal_inputs_) {
+    MS_EXCEPTION_IF_NULL(internal_input.from_actor_);
+    MS_EXCEPTION_IF_NULL(internal_input.to_actor_);
+    auto &output_device_tensors = internal_input.from_actor_->output_device_tensors_;
+    auto to_actor = internal_input.to_actor_;
+    if ((internal_input.from_output_index_ >= output_device_tensors.size()) ||
+        (internal_input.to_input_index_ >= to_actor->input_device_tensors_.size()) ||
+        (internal_input.to_input_index_ >= to_actor->memory_free_list_.size())) {
+      std::string error_info = GetAID().Name() + " binds the input of " + to_actor->GetAID().Name() + " from " +
+                               internal_input.from_actor_->GetAID().Name() + " out of range.";
+      SET_OPCONTEXT_FAIL_RET_WITH_ERROR((*context), error_info);
+    }
+    auto device_tensor = output_device_tensors[internal_input.from_output_index_];
+    to_actor->input_device_tensors_[internal_input.to_input_index_] = device_tensor;
+    to_actor->memory_free_list_[internal_input.to_input_index_] = device_tensor;
+  }
+}
+}  // namespace runtime
+}  // namespace mindspore
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_LINEARIZED_ACTOR_H_
+#define MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_LINEARIZED_ACTOR_H_
+
+#include <vector>
+#include <string>
+#include <memory>
+#include "runtime/graph_scheduler/actor/fusion/fusion_actor.h"
+#include "runtime/graph_scheduler/actor/kernel_actor.h"
+
+namespace mindspore {
+namespace runtime {
+// The linearized actor runs the kernel actors of a static graph in a launch schedule which is computed ahead of time,
+// instead of triggering each kernel actor by the messages. The inputs between the kernel actors are bound to the output
+// device tensors directly, and only the inputs from outside are received by messages.
+class LinearizedActor : public FusionActor {
+ public:
+  explicit LinearizedActor(const std::string &name) : FusionActor(name) {}
+  ~LinearizedActor() override = default;
+
+  // The actor run when receive the input data.
+  void RunOpData(OpData<DeviceTensor> *const input_data, OpContext<DeviceTensor> *const context) override;
+  // The actor run when receive the input control.
+  void RunOpControl(AID *const input_control, OpContext<DeviceTensor> *const context) override;
+
+  const std::vector<KernelActor *> &launch_schedule() const { return launch_schedule_; }
+
+ protected:
+  void Run(OpContext<DeviceTensor> *const context) override;
+
+ private:
+  friend class SchedulerHelper;
+
+  // The input of kernel actor which comes from the output of another kernel actor in the launch schedule.
+  struct InternalInput {
+    KernelActor *from_actor_;
+    size_t from_output_index_;
+    KernelActor *to_actor_;
+    size_t to_input_index_;
+  };
+
+  // Bind the output device tensors to the inputs of kernel actors before launching.
+  void BindInternalInputs(OpContext<DeviceTensor> *const context);
+
+  // The kernel actors in the topological order.
+  std::vector<KernelActor *> launch_schedule_;
+  std::vector<InternalInput> internal_inputs_;
+  bool is_bound_{false};
+};
+
+using LinearizedActorPtr = std::shared_ptr<LinearizedActor>;
+}  // namespace runtime
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_LINEARIZED_ACTOR_H_
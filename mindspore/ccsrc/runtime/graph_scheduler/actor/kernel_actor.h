@@ -128,6 +128,7 @@ class KernelActor : public DebugAwareActor {
   friend class GraphScheduler;
   friend class ControlNodeScheduler;
   friend class SchedulerHelper;
+  friend class LinearizedActor;
 #ifdef ENABLE_RPC_ACTOR
   friend class RpcNodeScheduler;
 #endif
@@ -31,6 +31,7 @@
 #include "utils/ms_context.h"
 #include "ir/tensor.h"
 #include "kernel/common_utils.h"
+#include "kernel/kernel_select_cache.h"
 #include "profiler/device/profiling.h"
 #include "backend/common/optimizer/helper.h"
 #include "base/base_ref_utils.h"
@@ -484,6 +485,8 @@ GraphId GraphCompiler::CompileGraphImpl(const KernelGraphPtr &graph, const Devic
   MS_EXCEPTION_IF_NULL(device_context->kernel_executor_);
   // Execute optimization pass.
   device_context->kernel_executor_->OptimizeGraph(graph);
+  // Keep the kernel selections of the graph for the next job when the compile cache is enabled.
+  (void)kernel::KernelSelectCache::GetInstance().Save();
 
   // Generate 'KernelMod' for all kernels and set 'KernelMod' into kernel,
   // 'KernelMod' is real executive object of kernel.
@@ -25,6 +25,7 @@
 #include "runtime/graph_scheduler/optimizer/invalid_data_arrow_elimination.h"
 #include "runtime/graph_scheduler/optimizer/batch_data_arrow_fusion.h"
 #include "runtime/graph_scheduler/optimizer/multi_actor_fusion.h"
+#include "runtime/graph_scheduler/optimizer/kernel_actor_linearization.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "mindrt/src/actor/actormgr.h"
 #include "mindrt/include/async/async.h"
@@ -80,6 +81,8 @@ using distributed::recovery::RecoveryContext;
 namespace {
 constexpr char kNumaEnableEnv[] = "MS_ENABLE_NUMA";
 constexpr char kNumaEnableEnv2[] = "DATASET_ENABLE_NUMA";
+// Launch the kernels of the static graph in the precomputed order instead of the actor messages.
+constexpr char kLinearizedExecutionEnv[] = "MS_DEV_LINEARIZED_EXECUTION";
 
 // For the transform state synchronization.
 constexpr char kTransformFinishPrefix[] = "TRANSFORM_FINISH_";
@@ -842,6 +845,9 @@ void GraphScheduler::Optimize(const ActorSetPtr &actor_set) const {
     optimizer->AddPass(std::make_shared<MemoryActorInsert>());
   }
   optimizer->AddPass(std::make_shared<InvalidDataArrowElimination>());
+  if (common::GetEnv(kLinearizedExecutionEnv) == "1") {
+    optimizer->AddPass(std::make_shared<KernelActorLinearization>());
+  }
   if (!ms_context->get_param<bool>(MS_CTX_ENABLE_MEM_OFFLOAD)) {
     optimizer->AddPass(std::make_shared<MultiActorFusion>());
   }
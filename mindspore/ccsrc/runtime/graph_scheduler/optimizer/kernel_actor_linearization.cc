@@ -0,0 +1,67 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/graph_scheduler/optimizer/kernel_actor_linearization.h"
+#include <algorithm>
+#include "runtime/graph_scheduler/scheduler_helper.h"
+
+namespace mindspore {
+namespace runtime {
+void KernelActorLinearization::Process(ActorSet *const actor_set, AbstractActor *const) {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  if (!SupportLinearization(actor_set)) {
+    return;
+  }
+
+  auto linearized_actor = SchedulerHelper::BuildLinearizedActor(actor_set->kernel_actors_);
+  if (linearized_actor == nullptr) {
+    return;
+  }
+  MS_LOG(INFO) << "Actor set(" << actor_set->name_ << ") is linearized to " << linearized_actor->GetAID().Name()
+               << " with kernel actors num: " << linearized_actor->launch_schedule().size();
+  (void)actor_set->fusion_actors_.emplace_back(linearized_actor);
+}
+
+bool KernelActorLinearization::SupportLinearization(const ActorSet *actor_set) const {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  // The control flow, the memory actors and the actors running on other devices keep the actor network.
+  if ((actor_set->kernel_actors_.size() <= 1) || (actor_set->control_actors_ != nullptr) ||
+      (!actor_set->custom_actors_.empty()) || (!actor_set->super_kernel_actors_.empty()) ||
+      (!actor_set->memory_actors_.empty()) || (!actor_set->copy_actors_.empty()) ||
+      (!actor_set->fusion_actors_.empty()) || (!actor_set->swap_actors_.empty())) {
+    return false;
+  }
+#ifdef ENABLE_RPC_ACTOR
+  if (actor_set->rpc_actors_ != nullptr) {
+    return false;
+  }
+#endif
+  // The kernel actors are launched in the linearized actor synchronously.
+  if (!ActorDispatcher::is_memory_allocation_sync()) {
+    return false;
+  }
+
+  return std::all_of(actor_set->kernel_actors_.begin(), actor_set->kernel_actors_.end(),
+                     [](const KernelActorPtr &kernel_actor) {
+                       MS_EXCEPTION_IF_NULL(kernel_actor);
+                       return (kernel_actor->type() == KernelTransformType::kKernelActor) &&
+                              (kernel_actor->device_contexts().size() == 1) &&
+                              (kernel_actor->device_contexts()[0] != nullptr) &&
+                              (kernel_actor->device_contexts()[0]->GetDeviceType() == device::DeviceType::kCPU);
+                     });
+}
+}  // namespace runtime
+}  // namespace mindspore
@@ -0,0 +1,41 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_OPTIMIZER_KERNEL_ACTOR_LINEARIZATION_H_
+#define MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_OPTIMIZER_KERNEL_ACTOR_LINEARIZATION_H_
+
+#include <memory>
+#include "runtime/graph_scheduler/optimizer/optimizer.h"
+
+namespace mindspore {
+namespace runtime {
+// Compile the kernel actors of the static graph without control flow to a linearized actor, which launches the kernels
+// in the precomputed topological order instead of triggering each kernel actor by the messages.
+class KernelActorLinearization : public ActorPass {
+ public:
+  KernelActorLinearization() : ActorPass("kernel_actor_linearization", false) {}
+  ~KernelActorLinearization() override = default;
+
+ protected:
+  void Process(ActorSet *const actor_set, AbstractActor *const actor) override;
+
+ private:
+  bool SupportLinearization(const ActorSet *actor_set) const;
+};
+}  // namespace runtime
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_OPTIMIZER_KERNEL_ACTOR_LINEARIZATION_H_
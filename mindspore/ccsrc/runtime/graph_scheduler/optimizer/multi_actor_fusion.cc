@@ -39,7 +39,8 @@ constexpr size_t kActorFusionMaxNum = 1000;
 
 void MultiActorFusion::Process(ActorSet *const actor_set, AbstractActor *const) {
   MS_EXCEPTION_IF_NULL(actor_set);
-  if (!actor_set->custom_actors_.empty()) {
+  // The actor set which has been linearized no need fusion.
+  if ((!actor_set->custom_actors_.empty()) || (!actor_set->fusion_actors_.empty())) {
     return;
   }
 
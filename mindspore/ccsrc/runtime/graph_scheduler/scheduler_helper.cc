@@ -15,6 +15,7 @@
  */
 
 #include "runtime/graph_scheduler/scheduler_helper.h"
+#include <queue>
 #include "runtime/graph_scheduler/actor/actor_dump.h"
 #include "backend/common/session/anf_runtime_algorithm.h"
 #include "include/common/utils/anfalgo.h"
@@ -503,6 +504,102 @@ void SchedulerHelper::AddArrowForFusionActor(FusionActor *fusion_actor) {
   }
 }
 
+LinearizedActorPtr SchedulerHelper::BuildLinearizedActor(const std::vector<KernelActorPtr> &kernel_actors) {
+  if (kernel_actors.size() <= 1) {
+    return nullptr;
+  }
+
+  mindspore::HashMap<std::string, size_t> actor_positions;
+  for (size_t i = 0; i < kernel_actors.size(); ++i) {
+    const auto &kernel_actor = kernel_actors[i];
+    MS_EXCEPTION_IF_NULL(kernel_actor);
+    if ((kernel_actor->strategy_ != GraphExecutionStrategy::kPipeline) || kernel_actor->is_dynamic_shape_ ||
+        (kernel_actor->somas_info_ != nullptr) || (kernel_actor->parent_fusion_actor_ != nullptr)) {
+      MS_LOG(INFO) << "The kernel actor can't be linearized: " << kernel_actor->GetAID().Name();
+      return nullptr;
+    }
+    actor_positions[kernel_actor->GetAID().Name()] = i;
+  }
+
+  // Sort the kernel actors topologically by the data and control arrows, in the execution order for the same level.
+  std::vector<size_t> in_degrees(kernel_actors.size(), 0);
+  std::vector<std::vector<size_t>> successors(kernel_actors.size());
+  auto add_edge = [&actor_positions, &in_degrees, &successors](size_t from_position, const std::string &to_name) {
+    const auto &iter = actor_positions.find(to_name);
+    if (iter == actor_positions.end()) {
+      return;
+    }
+    (void)successors[from_position].emplace_back(iter->second);
+    ++in_degrees[iter->second];
+  };
+  for (size_t i = 0; i < kernel_actors.size(); ++i) {
+    for (auto &data_arrow : kernel_actors[i]->output_data_arrows_) {
+      MS_EXCEPTION_IF_NULL(data_arrow);
+      add_edge(i, data_arrow->to_op_id_.Name());
+    }
+    for (auto &control_arrow : kernel_actors[i]->output_control_arrows_) {
+      MS_EXCEPTION_IF_NULL(control_arrow);
+      add_edge(i, control_arrow->to_op_id_.Name());
+    }
+  }
+  std::queue<size_t> ready_positions;
+  for (size_t i = 0; i < kernel_actors.size(); ++i) {
+    if (in_degrees[i] == 0) {
+      ready_positions.push(i);
+    }
+  }
+  std::vector<KernelActor *> launch_schedule;
+  while (!ready_positions.empty()) {
+    auto position = ready_positions.front();
+    ready_positions.pop();
+    (void)launch_schedule.emplace_back(kernel_actors[position].get());
+    for (auto successor : successors[position]) {
+      if (--in_degrees[successor] == 0) {
+        ready_positions.push(successor);
+      }
+    }
+  }
+  if (launch_schedule.size() != kernel_actors.size()) {
+    MS_LOG(INFO) << "The kernel actors have the circular dependency and can't be linearized.";
+    return nullptr;
+  }
+
+  std::string linearized_actor_name = std::to_string(++fusion_actor_index_) + kLinearizedActorNameSuffix;
+  auto linearized_actor = std::make_shared<LinearizedActor>(linearized_actor_name);
+  for (auto &kernel_actor : kernel_actors) {
+    kernel_actor->parent_fusion_actor_ = linearized_actor.get();
+    linearized_actor->sub_actors_[kernel_actor->GetAID().Name()] = kernel_actor;
+  }
+  AddArrowForFusionActor(linearized_actor.get());
+
+  // The internal arrows are replaced by the launch schedule and the bound device tensors.
+  for (auto &kernel_actor : kernel_actors) {
+    for (auto &input_data_arrow_aid : kernel_actor->input_data_arrow_aids_) {
+      const auto &iter = actor_positions.find(input_data_arrow_aid.first.Name());
+      if (iter == actor_positions.end()) {
+        continue;
+      }
+      auto input_data_arrow = input_data_arrow_aid.second;
+      MS_EXCEPTION_IF_NULL(input_data_arrow);
+      SET_FLAG(input_data_arrow->flag_, kOutputDataFlagLinearized);
+      (void)linearized_actor->internal_inputs_.emplace_back(LinearizedActor::InternalInput{
+        kernel_actors[iter->second].get(), IntToSize(input_data_arrow->from_output_index_), kernel_actor.get(),
+        IntToSize(input_data_arrow->to_input_index_)});
+      --kernel_actor->input_datas_num_;
+    }
+    for (auto &input_control_arrow_aid : kernel_actor->input_control_arrow_aids_) {
+      if (actor_positions.count(input_control_arrow_aid.first.Name()) > 0) {
+        MS_EXCEPTION_IF_NULL(input_control_arrow_aid.second);
+        SET_FLAG(input_control_arrow_aid.second->flag_, kOutputDataFlagLinearized);
+      }
+    }
+    // The input controls from outside are received by the linearized actor.
+    kernel_actor->input_controls_num_ = 0;
+  }
+  linearized_actor->launch_schedule_ = std::move(launch_schedule);
+  return linearized_actor;
+}
+
 void SchedulerHelper::AddMemorySign(AbstractActor *const from_actor, AbstractActor *const to_actor) {
   MS_EXCEPTION_IF_NULL(from_actor);
   MS_EXCEPTION_IF_NULL(to_actor);
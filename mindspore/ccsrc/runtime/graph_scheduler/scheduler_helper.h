@@ -79,6 +79,8 @@ class SchedulerHelper {
   static bool CheckDependency(const std::vector<AbstractActorPtr> &output_actors);
   static FusionActorPtr BuildFusionActor(const std::vector<AbstractActorPtr> &actors);
   static void AddArrowForFusionActor(FusionActor *fusion_actor);
+  // Compile the kernel actors to the launch schedule of linearized actor, return nullptr if they can't be linearized.
+  static LinearizedActorPtr BuildLinearizedActor(const std::vector<KernelActorPtr> &kernel_actors);
 
   // The interface of integration of dynamic and static memory.
   static void AddMemorySign(AbstractActor *const from_actor, AbstractActor *const to_actor);
@@ -15,17 +15,58 @@
  */
 
 #include "runtime/pynative/op_executor.h"
+#include <algorithm>
+#include "pybind11/pybind11.h"
 #if !defined(_WIN32) && !defined(_WIN64) && !defined(__APPLE__)
 #include "include/common/utils/signal_util.h"
 #endif
 
 namespace mindspore::runtime {
+namespace {
+constexpr size_t kRunQueueCapacity = 1024;
+// The number of polls before a thread parks, the next task or the end of the tasks usually comes within microseconds.
+constexpr size_t kSpinNum = 256;
+
+template <typename Pred>
+bool SpinUntil(const Pred &pred) {
+  for (size_t i = 0; i < kSpinNum; ++i) {
+    if (pred()) {
+      return true;
+    }
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+// The worker may take the GIL to run a task, so a thread holding the GIL must release it before blocking on the worker.
+class GilReleaseIfHeld {
+ public:
+  GilReleaseIfHeld() {
+    if (Py_IsInitialized() != 0 && PyGILState_Check() != 0) {
+      release_ = std::make_unique<pybind11::gil_scoped_release>();
+    }
+  }
+  ~GilReleaseIfHeld() = default;
+
+ private:
+  std::unique_ptr<pybind11::gil_scoped_release> release_;
+};
+
+void UpdateMax(std::atomic<size_t> *max_value, size_t value) {
+  auto current = max_value->load();
+  while (current < value && !max_value->compare_exchange_weak(current, value)) {
+  }
+}
+}  // namespace
+
 OpExecutor &OpExecutor::GetInstance() {
   static OpExecutor instance;
   return instance;
 }
 
-OpExecutor::OpExecutor() { worker_ = std::make_shared<std::thread>(&OpExecutor::WorkerLoop, this); }
+OpExecutor::OpExecutor() : op_run_tasks_(kRunQueueCapacity) {
+  worker_ = std::make_shared<std::thread>(&OpExecutor::WorkerLoop, this);
+}
 
 OpExecutor::~OpExecutor() { WorkerJoin(); }
 
@@ -51,8 +92,8 @@ void OpExecutor::Reset() {
 
 void OpExecutor::ClearResources() {
   MS_LOG(DEBUG) << "Start clear tasks";
-  std::lock_guard<std::mutex> lock(task_mutex_);
   ClearRunOpTasks();
+  std::lock_guard<std::mutex> lock(task_mutex_);
 
   // Set the build task failed, and no need to run op_run_tasks.
   for (auto &build_task : op_build_tasks_) {
@@ -73,8 +114,14 @@ void OpExecutor::WaitForBuild() {
 
 void OpExecutor::WaitForRun() {
   MS_LOG(DEBUG) << "Start";
-  std::unique_lock<std::mutex> lock(task_mutex_);
-  task_cond_var_.wait(lock, [this]() { return op_run_tasks_.empty(); });
+  auto all_finished = [this]() { return pending_run_task_num_.load() == 0; };
+  if (!SpinUntil(all_finished)) {
+    std::unique_lock<std::mutex> lock(task_mutex_);
+    (void)parked_waiter_num_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wait_cond_var_.wait(lock, all_finished);
+    (void)parked_waiter_num_.fetch_sub(1);
+  }
   MsException::Instance().CheckException();
   MS_LOG(DEBUG) << "All task finish";
 }
@@ -87,13 +134,69 @@ void OpExecutor::Wait() {
 void OpExecutor::PushOpBuildTask(const std::shared_ptr<OpBuildTask> &op_build_task) {
   std::lock_guard<std::mutex> lock(task_mutex_);
   op_build_tasks_.push_back(op_build_task);
+  UpdateMax(&max_build_queue_depth_, op_build_tasks_.size());
 }
 
 void OpExecutor::PushOpRunTask(const std::shared_ptr<OpTask> &op_run_task) {
-  std::lock_guard<std::mutex> lock(task_mutex_);
-  op_run_tasks_.push(op_run_task);
-  (void)actor_in_queue_.insert(op_run_task->context()->graph_id());
-  task_cond_var_.notify_all();
+  MS_EXCEPTION_IF_NULL(op_run_task);
+  {
+    std::lock_guard<std::mutex> lock(actor_mutex_);
+    (void)actor_in_queue_.insert(op_run_task->context()->graph_id());
+  }
+  UpdateMax(&max_run_queue_depth_, pending_run_task_num_.fetch_add(1) + 1);
+  EnqueueRunTask({op_run_task, epoch_.load()});
+}
+
+void OpExecutor::EnqueueRunTask(QueuedOpTask &&queued_task) {
+  // The queue is full, wait for the worker to take some tasks.
+  if (!SpinUntil([this, &queued_task]() { return op_run_tasks_.Push(std::move(queued_task)); })) {
+    GilReleaseIfHeld gil_release;
+    std::unique_lock<std::mutex> lock(task_mutex_);
+    producer_parked_.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    space_cond_var_.wait(lock, [this, &queued_task]() { return op_run_tasks_.Push(std::move(queued_task)); });
+    producer_parked_.store(false);
+  }
+  // Pairs with the fence of the worker, so either the worker sees the task before parking, or it is notified.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (worker_parked_.load()) {
+    { std::lock_guard<std::mutex> lock(task_mutex_); }
+    task_cond_var_.notify_one();
+  }
+}
+
+OpExecutor::QueuedOpTask OpExecutor::DequeueRunTask() {
+  QueuedOpTask queued_task;
+  if (!SpinUntil([this, &queued_task]() { return op_run_tasks_.Pop(&queued_task); })) {
+    std::unique_lock<std::mutex> lock(task_mutex_);
+    worker_parked_.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    task_cond_var_.wait(lock, [this, &queued_task]() { return op_run_tasks_.Pop(&queued_task); });
+    worker_parked_.store(false);
+  }
+  // Pairs with the fence of the producer, so either the producer sees the free slot before parking, or it is notified.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (producer_parked_.load()) {
+    { std::lock_guard<std::mutex> lock(task_mutex_); }
+    space_cond_var_.notify_one();
+  }
+  return queued_task;
+}
+
+void OpExecutor::FinishRunTask(const std::shared_ptr<OpTask> &task) {
+  {
+    std::lock_guard<std::mutex> lock(actor_mutex_);
+    (void)actor_in_queue_.erase(task->context()->graph_id());
+  }
+  if (pending_run_task_num_.fetch_sub(1) != 1) {
+    return;
+  }
+  MS_LOG(DEBUG) << "Task queue empty";
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parked_waiter_num_.load() > 0) {
+    { std::lock_guard<std::mutex> lock(task_mutex_); }
+    wait_cond_var_.notify_all();
+  }
 }
 
 void OpExecutor::ClearOpBuildTasks() {
@@ -110,10 +213,7 @@ bool OpExecutor::BuildQueueEmpty() {
   return op_build_tasks_.empty();
 }
 
-bool OpExecutor::RunQueueEmpty() {
-  std::lock_guard<std::mutex> lock(task_mutex_);
-  return op_run_tasks_.empty();
-}
+bool OpExecutor::RunQueueEmpty() { return pending_run_task_num_.load() == 0; }
 
 bool OpExecutor::BuildQueueFull() {
   std::lock_guard<std::mutex> lock(task_mutex_);
@@ -121,17 +221,15 @@ bool OpExecutor::BuildQueueFull() {
 }
 
 bool OpExecutor::ActorInQueue(GraphId graph_id) {
-  std::lock_guard<std::mutex> lock(task_mutex_);
+  std::lock_guard<std::mutex> lock(actor_mutex_);
   auto iter = actor_in_queue_.find(graph_id);
   return iter != actor_in_queue_.end();
 }
 
 void OpExecutor::ClearRunOpTasks() {
-  actor_in_queue_.clear();
-  std::queue<std::shared_ptr<OpTask>> empty;
-  // No need to worry about ExitOpTask.
-  // ClearRunOpTasks is executed before ~OpExecutor
-  std::swap(op_run_tasks_, empty);
+  // Only the worker pops the queue, so the tasks queued so far are dropped by the worker when it reaches them.
+  // No need to worry about ExitOpTask, it is always executed.
+  (void)epoch_.fetch_add(1);
 }
 
 void OpExecutor::WorkerLoop() {
@@ -144,41 +242,25 @@ void OpExecutor::WorkerLoop() {
 #endif
 
   while (true) {
-    std::shared_ptr<OpTask> task;
-    {
-      MS_LOG(DEBUG) << "Wait task in queue";
-      std::unique_lock<std::mutex> lock(task_mutex_);
-      task_cond_var_.wait(lock, [this]() { return !op_run_tasks_.empty(); });
-      task = op_run_tasks_.front();
-    }
-
+    MS_LOG(DEBUG) << "Wait task in queue";
+    auto queued_task = DequeueRunTask();
+    const auto &task = queued_task.task;
     MS_LOG(DEBUG) << "Get task";
     MS_EXCEPTION_IF_NULL(task);
     if (task->task_type() == kExitTask) {
       MS_LOG(DEBUG) << "Thread exit";
       return;
     }
-    try {
-      task->Run();
-      std::unique_lock<std::mutex> lock(task_mutex_);
-      if (!op_run_tasks_.empty()) {
-        op_run_tasks_.pop();
-        (void)actor_in_queue_.erase(task->context()->graph_id());
-      }
-
-      if (op_run_tasks_.empty()) {
-        MS_LOG(DEBUG) << "Task queue empty";
-        task_cond_var_.notify_all();
-      }
-    } catch (const std::exception &e) {
-      MS_LOG(ERROR) << "Run lazy task failed, error message:" << e.what();
-      {
-        std::unique_lock<std::mutex> lock(task_mutex_);
+    if (queued_task.epoch == epoch_.load()) {
+      try {
+        task->Run();
+      } catch (const std::exception &e) {
+        MS_LOG(ERROR) << "Run lazy task failed, error message:" << e.what();
         ClearRunOpTasks();
         MsException::Instance().SetException();
-        task_cond_var_.notify_all();
       }
     }
+    FinishRunTask(task);
   }
 }
 
@@ -186,15 +268,11 @@ void OpExecutor::WorkerJoin() {
   try {
     // Avoid worker thread join itself which will cause deadlock
     if (worker_->joinable() && worker_->get_id() != std::this_thread::get_id()) {
-      {
-        std::lock_guard<std::mutex> lock(task_mutex_);
-        auto task = std::make_shared<ExitOpTask>();
-        op_run_tasks_.push(task);
-        task_cond_var_.notify_all();
-        MS_LOG(DEBUG) << "Push exit task and notify all";
-      }
+      EnqueueRunTask({std::make_shared<ExitOpTask>(), epoch_.load()});
+      MS_LOG(DEBUG) << "Push exit task and notify all";
       worker_->join();
-      MS_LOG(DEBUG) << "Worker join finish";
+      MS_LOG(INFO) << "Worker join finish, the max depth of the build queue is " << max_build_queue_depth_.load()
+                   << ", the max depth of the run queue is " << max_run_queue_depth_.load();
     }
   } catch (const std::exception &e) {
     MS_LOG(ERROR) << "WorkerJoin failed: " << e.what();
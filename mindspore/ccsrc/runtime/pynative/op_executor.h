@@ -19,7 +19,7 @@
 
 #include <vector>
 #include <memory>
-#include <queue>
+#include <atomic>
 #include <map>
 #include <string>
 #include <set>
@@ -30,9 +30,15 @@
 #include "runtime/hardware/device_context.h"
 #include "runtime/graph_scheduler/graph_scheduler.h"
 #include "runtime/pynative/op_task.h"
+#include "runtime/pynative/spsc_queue.h"
 #include "include/backend/visible.h"
 
 namespace mindspore::runtime {
+// OpExecutor runs the ops of PyNative asynchronously in two stages. The ops are inferred by the forward executor on the
+// Python thread before they get here. The build tasks are gathered on the Python thread and compiled in batches by the
+// registered callback, since the kernels are compiled in parallel and some compilers need the GIL. The run tasks wait
+// for their builds and are launched by one worker thread, which takes them from a lock free ring filled by the Python
+// thread. The depths of both stages are kept for tuning the batch size and the ring capacity.
 class BACKEND_EXPORT OpExecutor {
  public:
   static OpExecutor &GetInstance();
@@ -75,27 +81,56 @@ class BACKEND_EXPORT OpExecutor {
   // Thread join before the process exit.
   void WorkerJoin();
 
+  // The max number of the build tasks which were waiting for a batch build at the same time.
+  size_t max_build_queue_depth() const { return max_build_queue_depth_.load(); }
+  // The max number of the run tasks which were waiting in the queue at the same time.
+  size_t max_run_queue_depth() const { return max_run_queue_depth_.load(); }
+
  private:
   OpExecutor();
   ~OpExecutor();
   DISABLE_COPY_AND_ASSIGN(OpExecutor);
 
+  // The run task and the epoch in which it was pushed. The tasks of the former epochs are dropped by the worker.
+  struct QueuedOpTask {
+    std::shared_ptr<OpTask> task;
+    uint64_t epoch{0};
+  };
+
   void WaitForBuild();
   void WaitForRun();
   void WorkerLoop();
   void ClearRunOpTasks();
   void ClearResources();
+  // Called by the Python thread, which is the only producer of the run queue.
+  void EnqueueRunTask(QueuedOpTask &&queued_task);
+  // Called by the worker thread, which is the only consumer of the run queue.
+  QueuedOpTask DequeueRunTask();
+  void FinishRunTask(const std::shared_ptr<OpTask> &task);
 
   std::vector<std::shared_ptr<OpBuildTask>> op_build_tasks_;
-  std::queue<std::shared_ptr<OpTask>> op_run_tasks_;
+  SpscQueue<QueuedOpTask> op_run_tasks_;
+  // The number of the run tasks pushed but not finished.
+  std::atomic<size_t> pending_run_task_num_{0};
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<size_t> max_build_queue_depth_{0};
+  std::atomic<size_t> max_run_queue_depth_{0};
   std::set<GraphId> actor_in_queue_;
+  std::mutex actor_mutex_;
   std::function<void()> batch_build_callback_{nullptr};
   inline static size_t kMaxQueueSize = 20;
   bool executing_{false};
   bool registered_{false};
   std::shared_ptr<std::thread> worker_;
+  // The worker, the producer waiting for a free slot and the threads waiting for the tasks spin for a while, and then
+  // park on the condition variables. Any number of threads may wait for the tasks at the same time.
+  std::atomic<bool> worker_parked_{false};
+  std::atomic<bool> producer_parked_{false};
+  std::atomic<size_t> parked_waiter_num_{0};
   std::mutex task_mutex_;
   std::condition_variable task_cond_var_;
+  std::condition_variable space_cond_var_;
+  std::condition_variable wait_cond_var_;
 };
 }  // namespace mindspore::runtime
 #endif  // MINDSPORE_MINDSPORE_CCSRC_RUNTIME_PYNATIVE_OP_EXECUTOR_H_
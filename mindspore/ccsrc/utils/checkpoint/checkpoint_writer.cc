@@ -0,0 +1,387 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "include/common/utils/checkpoint/checkpoint_writer.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <nlohmann/json.hpp>
+#include "include/common/thread_pool.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace checkpoint {
+namespace {
+// The size of each write call, large enough to keep the disk busy and small enough not to stall other io for long.
+constexpr size_t kWriteChunkSize = 64 << 20;
+constexpr uint32_t kManifestVersion = 1;
+constexpr char kTmpSuffix[] = ".tmp";
+
+bool PWriteAll(int fd, const uint8_t *data, size_t size, uint64_t offset) {
+  while (size > 0) {
+    auto ret = pwrite(fd, data, std::min(size, kWriteChunkSize), static_cast<off_t>(offset));
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += ret;
+    size -= static_cast<size_t>(ret);
+    offset += static_cast<uint64_t>(ret);
+  }
+  return true;
+}
+
+bool WriteAll(int fd, const char *data, size_t size) {
+  while (size > 0) {
+    auto ret = write(fd, data, std::min(size, kWriteChunkSize));
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += ret;
+    size -= static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+// Split the items into at most part_num contiguous parts of about the same bytes.
+std::vector<std::pair<size_t, size_t>> SplitByBytes(const std::vector<uint64_t> &bytes, size_t part_num) {
+  uint64_t total = 0;
+  for (auto size : bytes) {
+    total += size;
+  }
+  std::vector<std::pair<size_t, size_t>> parts;
+  size_t begin = 0;
+  uint64_t accumulated = 0;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    accumulated += bytes[i];
+    // The boundary of the next part, rounded up so that the last part is never empty.
+    uint64_t boundary = (total * (parts.size() + 1) + part_num - 1) / part_num;
+    if ((parts.size() + 1 < part_num && accumulated >= boundary) || i + 1 == bytes.size()) {
+      parts.emplace_back(begin, i + 1);
+      begin = i + 1;
+    }
+  }
+  return parts;
+}
+}  // namespace
+
+CheckpointWriter::CheckpointWriter(const std::string &directory, size_t shard_num)
+    : directory_(directory), shard_num_(std::max(shard_num, size_t(1))) {
+  struct stat dir_stat = {};
+  if (stat(directory_.c_str(), &dir_stat) != 0 || !S_ISDIR(dir_stat.st_mode)) {
+    MS_LOG(EXCEPTION) << "The checkpoint directory " << directory_ << " does not exist.";
+  }
+}
+
+CheckpointWriter::~CheckpointWriter() {
+  if (!Wait()) {
+    MS_LOG(ERROR) << "The last checkpoint in " << directory_ << " failed to save.";
+  }
+}
+
+bool CheckpointWriter::Wait() {
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  return success_;
+}
+
+void CheckpointWriter::Save(const std::string &prefix, const std::vector<std::string> &names,
+                            const std::vector<tensor::TensorPtr> &tensors, bool incremental) {
+  if (names.size() != tensors.size()) {
+    MS_LOG(EXCEPTION) << "The number of names " << names.size() << " is not equal to the number of tensors "
+                      << tensors.size();
+  }
+  if (prefix.empty() || prefix.find('/') != std::string::npos) {
+    MS_LOG(EXCEPTION) << "Invalid checkpoint prefix: " << prefix;
+  }
+  // The snapshot buffer is still being written by the previous save.
+  if (!Wait()) {
+    MS_LOG(WARNING) << "The previous checkpoint in " << directory_ << " failed to save, the unchanged tensors of this "
+                    << "checkpoint still refer to the last checkpoint saved successfully.";
+  }
+
+  std::vector<SnapshotItem> items(tensors.size());
+  uint64_t snapshot_size = 0;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto &tensor = tensors[i];
+    MS_EXCEPTION_IF_NULL(tensor);
+    // Copy the data from device to host if the tensor lives on the device.
+    tensor->data_sync();
+    auto &entry = items[i].entry;
+    entry.name = names[i];
+    entry.type = tensor->data_type();
+    entry.shape = tensor->shape();
+    entry.nbytes = tensor->Size();
+    items[i].snapshot_offset = snapshot_size;
+    snapshot_size = AlignTensorFileOffset(snapshot_size + entry.nbytes);
+  }
+  ReserveSnapshot(snapshot_size);
+
+  // Copy the tensors into the snapshot in parallel, every task copies about the same bytes.
+  std::vector<uint64_t> bytes(items.size());
+  (void)std::transform(items.begin(), items.end(), bytes.begin(),
+                       [](const SnapshotItem &item) { return item.entry.nbytes; });
+  auto &thread_pool = common::ThreadPool::GetInstance();
+  std::vector<common::Task> tasks;
+  for (const auto &part : SplitByBytes(bytes, thread_pool.GetSyncRunThreadNum())) {
+    (void)tasks.emplace_back([this, &items, &tensors, part]() {
+      for (size_t i = part.first; i < part.second; ++i) {
+        if (items[i].entry.nbytes > 0) {
+          (void)memcpy(snapshot_.get() + items[i].snapshot_offset, tensors[i]->data_c(), items[i].entry.nbytes);
+        }
+      }
+      return common::SUCCESS;
+    });
+  }
+  if (!thread_pool.SyncRun(tasks)) {
+    MS_LOG(EXCEPTION) << "Failed to take the snapshot of checkpoint " << prefix;
+  }
+
+  success_ = true;
+  writer_ = std::thread(&CheckpointWriter::WriteCheckpoint, this, prefix, std::move(items), incremental);
+}
+
+void CheckpointWriter::ReserveSnapshot(size_t size) {
+  if (size <= snapshot_size_ && snapshot_ != nullptr) {
+    return;
+  }
+  void *buffer = nullptr;
+  size_t reserved = std::max(size, size_t(kTensorFileAlignment));
+  if (posix_memalign(&buffer, kTensorFileAlignment, reserved) != 0 || buffer == nullptr) {
+    MS_LOG(EXCEPTION) << "Failed to allocate " << reserved << " bytes for the checkpoint snapshot.";
+  }
+  snapshot_.reset(static_cast<uint8_t *>(buffer));
+  snapshot_size_ = reserved;
+}
+
+void CheckpointWriter::HashSnapshot(std::vector<SnapshotItem> *items) const {
+  std::vector<uint64_t> bytes(items->size());
+  (void)std::transform(items->begin(), items->end(), bytes.begin(),
+                       [](const SnapshotItem &item) { return item.entry.nbytes; });
+  std::vector<std::thread> threads;
+  for (const auto &part : SplitByBytes(bytes, shard_num_)) {
+    threads.emplace_back([this, items, part]() {
+      for (size_t i = part.first; i < part.second; ++i) {
+        auto &entry = (*items)[i].entry;
+        entry.hash = TensorFileHash(snapshot_.get() + (*items)[i].snapshot_offset, entry.nbytes);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+void CheckpointWriter::WriteCheckpoint(const std::string &prefix, std::vector<SnapshotItem> items, bool incremental) {
+  // An exception escaping the background thread would terminate the process, so it only fails this checkpoint.
+  try {
+    WriteCheckpointFiles(prefix, &items, incremental);
+  } catch (const std::exception &e) {
+    MS_LOG(ERROR) << "Failed to save the checkpoint " << prefix << " in " << directory_ << ": " << e.what();
+    success_ = false;
+  }
+}
+
+std::string CheckpointWriter::NewShardPrefix(const std::string &prefix) {
+  // Skip the sequence numbers used by the files in the directory, which may be left by another writer.
+  while (true) {
+    std::string shard_prefix = prefix + "_" + std::to_string(save_seq_++) + "_";
+    bool used = false;
+    for (size_t shard = 0; shard < shard_num_ && !used; ++shard) {
+      used = access((directory_ + "/" + shard_prefix + std::to_string(shard) + kTensorFileSuffix).c_str(), F_OK) == 0;
+    }
+    if (!used) {
+      return shard_prefix;
+    }
+  }
+}
+
+void CheckpointWriter::WriteCheckpointFiles(const std::string &prefix, std::vector<SnapshotItem> *items_ptr,
+                                            bool incremental) {
+  auto &items = *items_ptr;
+  HashSnapshot(&items);
+
+  // Only the changed tensors are written, the others keep the file of the last checkpoint.
+  std::vector<SnapshotItem *> changed;
+  for (auto &item : items) {
+    const auto &entry = item.entry;
+    auto iter = saved_tensors_.find(entry.name);
+    if (incremental && iter != saved_tensors_.end() && iter->second.hash == entry.hash &&
+        iter->second.type == entry.type && iter->second.shape == entry.shape) {
+      item.file_name = iter->second.file_name;
+    } else {
+      changed.push_back(&item);
+    }
+  }
+
+  std::vector<uint64_t> bytes(changed.size());
+  (void)std::transform(changed.begin(), changed.end(), bytes.begin(),
+                       [](const SnapshotItem *item) { return item->entry.nbytes; });
+  auto parts = SplitByBytes(bytes, shard_num_);
+  std::string shard_prefix = parts.empty() ? "" : NewShardPrefix(prefix);
+  std::vector<std::thread> threads;
+  std::vector<char> results(parts.size(), 0);
+  for (size_t shard = 0; shard < parts.size(); ++shard) {
+    std::string file_name = shard_prefix + std::to_string(shard) + kTensorFileSuffix;
+    std::vector<SnapshotItem *> shard_items(changed.begin() + parts[shard].first,
+                                            changed.begin() + parts[shard].second);
+    for (auto item : shard_items) {
+      item->file_name = file_name;
+    }
+    threads.emplace_back([this, file_name, shard_items, &results, shard]() {
+      results[shard] = WriteTensorFile(file_name, shard_items) ? 1 : 0;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // The renamed tensor files are made durable before the manifest referring to them.
+  if (std::any_of(results.begin(), results.end(), [](char result) { return result == 0; }) || !SyncDirectory() ||
+      !WriteManifest(prefix, items) || !SyncDirectory()) {
+    MS_LOG(ERROR) << "Failed to save the checkpoint " << prefix << " in " << directory_;
+    success_ = false;
+    return;
+  }
+
+  for (const auto &item : items) {
+    saved_tensors_[item.entry.name] = {item.entry.type, item.entry.shape, item.entry.hash, item.file_name};
+  }
+  MS_LOG(INFO) << "The checkpoint " << prefix << " has been saved, " << changed.size() << " of " << items.size()
+               << " tensors are written into " << parts.size() << " files.";
+}
+
+// The tensors are laid out in the file as in the snapshot, so each run of consecutive tensors is written by one call.
+bool CheckpointWriter::WriteTensorFile(const std::string &file_name, const std::vector<SnapshotItem *> &items) const {
+  std::string path = directory_ + "/" + file_name;
+  std::string tmp_path = path + kTmpSuffix;
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG(ERROR) << "Failed to create the tensor file " << tmp_path << ", errno: " << errno;
+    return false;
+  }
+
+  std::vector<TensorFileEntry> entries;
+  uint64_t file_offset = kTensorFileAlignment;
+  bool success = true;
+  for (size_t begin = 0; begin < items.size() && success;) {
+    size_t end = begin + 1;
+    while (end < items.size()) {
+      const auto *last = items[end - 1];
+      if (items[end]->snapshot_offset != AlignTensorFileOffset(last->snapshot_offset + last->entry.nbytes)) {
+        break;
+      }
+      ++end;
+    }
+    uint64_t run_offset = file_offset;
+    for (size_t i = begin; i < end; ++i) {
+      entries.push_back(items[i]->entry);
+      entries.back().offset = file_offset;
+      file_offset = AlignTensorFileOffset(file_offset + items[i]->entry.nbytes);
+    }
+    uint64_t run_size = items[end - 1]->snapshot_offset + items[end - 1]->entry.nbytes - items[begin]->snapshot_offset;
+    success = PWriteAll(fd, snapshot_.get() + items[begin]->snapshot_offset, run_size, run_offset);
+    begin = end;
+  }
+
+  std::string index = EncodeTensorFileIndex(entries);
+  auto header = MakeTensorFileHeader(static_cast<uint32_t>(entries.size()), file_offset, index.size());
+  success = success && PWriteAll(fd, reinterpret_cast<const uint8_t *>(index.data()), index.size(), file_offset) &&
+            PWriteAll(fd, reinterpret_cast<const uint8_t *>(&header), sizeof(header), 0) && fsync(fd) == 0;
+  if (close(fd) != 0 || !success) {
+    MS_LOG(ERROR) << "Failed to write the tensor file " << tmp_path << ", errno: " << errno;
+    (void)unlink(tmp_path.c_str());
+    return false;
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    MS_LOG(ERROR) << "Failed to rename the tensor file " << tmp_path << " to " << path << ", errno: " << errno;
+    (void)unlink(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool CheckpointWriter::WriteManifest(const std::string &prefix, const std::vector<SnapshotItem> &items) const {
+  nlohmann::json tensors = nlohmann::json::array();
+  for (const auto &item : items) {
+    nlohmann::json tensor;
+    tensor["name"] = item.entry.name;
+    tensor["file"] = item.file_name;
+    tensors.push_back(tensor);
+  }
+  nlohmann::json manifest;
+  manifest["version"] = kManifestVersion;
+  manifest["tensors"] = tensors;
+
+  std::string content;
+  try {
+    content = manifest.dump();
+  } catch (const nlohmann::json::exception &e) {
+    // The names which are not valid UTF-8 can not be dumped.
+    MS_LOG(ERROR) << "Failed to dump the manifest of checkpoint " << prefix << ": " << e.what();
+    return false;
+  }
+
+  // The manifest is written last and replaced atomically, so it never refers to an incomplete tensor file.
+  std::string path = directory_ + "/" + prefix + kManifestSuffix;
+  std::string tmp_path = path + kTmpSuffix;
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG(ERROR) << "Failed to create the manifest " << tmp_path << ", errno: " << errno;
+    return false;
+  }
+  bool success = WriteAll(fd, content.data(), content.size()) && fsync(fd) == 0;
+  if (close(fd) != 0 || !success) {
+    MS_LOG(ERROR) << "Failed to write the manifest " << tmp_path << ", errno: " << errno;
+    (void)unlink(tmp_path.c_str());
+    return false;
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    MS_LOG(ERROR) << "Failed to rename the manifest " << tmp_path << " to " << path << ", errno: " << errno;
+    (void)unlink(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+// The renames are only durable once the directory itself is synced.
+bool CheckpointWriter::SyncDirectory() const {
+  int fd = open(directory_.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    MS_LOG(ERROR) << "Failed to open the checkpoint directory " << directory_ << ", errno: " << errno;
+    return false;
+  }
+  bool success = fsync(fd) == 0;
+  if (close(fd) != 0 || !success) {
+    MS_LOG(ERROR) << "Failed to sync the checkpoint directory " << directory_ << ", errno: " << errno;
+    return false;
+  }
+  return true;
+}
+}  // namespace checkpoint
+}  // namespace mindspore
@@ -34,6 +34,7 @@
 #include "utils/ms_utils_secure.h"
 #include "utils/shape_utils.h"
 #include "utils/ordered_set.h"
+#include "utils/tensor_file.h"
 
 namespace mindspore {
 namespace tensor {
@@ -553,6 +554,43 @@ class TensorSubDataImpl : public TensorSubData {
   }
 };
 
+// TensorMappedDataImpl refers to the data of a file mapped in memory.
+template <typename T>
+class TensorMappedDataImpl : public TensorData {
+ public:
+  TensorMappedDataImpl(const ShapeVector &shape, const std::shared_ptr<MappedFile> &file, size_t offset)
+      : ndim_(shape.size()), data_size_(SizeOf(shape)), file_(file), offset_(offset) {}
+
+  ~TensorMappedDataImpl() override = default;
+
+  ssize_t size() const override { return static_cast<ssize_t>(data_size_); }
+
+  ssize_t itemsize() const override { return static_cast<ssize_t>(sizeof(T)); }
+
+  ssize_t nbytes() const override { return size() * itemsize(); }
+
+  ssize_t ndim() const override { return static_cast<ssize_t>(ndim_); }
+
+  bool is_sub_data() const override { return false; }
+
+  bool has_sub_data() const override { return false; }
+
+  void *data() override { return file_->data() + offset_; }
+
+  const void *const_data() const override { return file_->data() + offset_; }
+
+  std::string ToString(TypeId type, const ShapeVector &shape, bool use_comma) const override {
+    TensorStringifier<T> stringifier{static_cast<const T *>(const_data()), data_size_, ndim_};
+    return stringifier.ToString(type, shape, use_comma);
+  }
+
+ private:
+  size_t ndim_{0};
+  size_t data_size_{0};
+  std::shared_ptr<MappedFile> file_;
+  size_t offset_{0};
+};
+
 template <template <class> class ImplClass = TensorDataImpl, typename... Args>
 TensorDataPtr MakeTensorData(TypeId data_type, Args &&... args) {
   switch (data_type) {
@@ -609,6 +647,22 @@ TensorDataPtr MakeTensorSubData(const TensorPtr &owner, size_t offset, const Ten
   return sub_data;
 }
 
+TensorDataPtr MakeMappedTensorData(TypeId data_type, const ShapeVector &shape, const std::shared_ptr<MappedFile> &file,
+                                   size_t offset) {
+  MS_EXCEPTION_IF_NULL(file);
+  auto data = MakeTensorData<TensorMappedDataImpl>(data_type, shape, file, offset);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  auto nbytes = static_cast<size_t>(data->nbytes());
+  if (offset > file->size() || nbytes > file->size() - offset || offset % static_cast<size_t>(data->itemsize()) != 0) {
+    MS_LOG(ERROR) << "The tensor data of " << nbytes << " bytes at offset " << offset
+                  << " is out of the mapped file of " << file->size() << " bytes or not aligned.";
+    return nullptr;
+  }
+  return data;
+}
+
 Tensor::Tensor(const Tensor &tensor)
     : MetaTensor(tensor),
       init_flag_(tensor.init_flag_),
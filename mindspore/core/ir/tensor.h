@@ -40,6 +40,7 @@
 // mindspore namespace is the top level namespace of MindSpore project.
 // Other namespace should be a sub namespace of mindspore namespace in the ME project.
 namespace mindspore {
+class MappedFile;
 // brief mindspore::tensor namespace
 enum TensorSyncStatus {
   kNoNeedSync,
@@ -139,6 +140,18 @@ class MS_CORE_API TensorData {
 
 using TensorDataPtr = std::shared_ptr<TensorData>;
 
+/// \brief Make the tensor data which refers to the data of a mapped file instead of owning a copy. The pages are read
+/// from the file when they are touched for the first time, and a write to the data only changes a private copy of the
+/// written pages.
+///
+/// \param[in] data_type The type of tensor data.
+/// \param[in] shape The shape of tensor data.
+/// \param[in] file The mapped file, which is kept mapped while the tensor data is alive.
+/// \param[in] offset The offset of the tensor data in file, which should be aligned to the size of data type.
+/// \return The tensor data, or nullptr if the data is out of the file or not aligned.
+MS_CORE_API TensorDataPtr MakeMappedTensorData(TypeId data_type, const ShapeVector &shape,
+                                               const std::shared_ptr<MappedFile> &file, size_t offset);
+
 class WaitEvent : public ExceptionListener {
  public:
   ~WaitEvent() = default;
@@ -484,8 +484,13 @@ bool MSANFModelParser::BuildParameterForFuncGraph(const ParameterPtr &node,
   if (parameter_proto.has_raw_data()) {
     node->set_default_param(tensor);
   } else if (parameter_proto.has_external_data()) {
-    auto ret = GetTensorDataFromExternal(parameter_proto, tensor);
-    if (!ret) {
+    auto mapped_tensor = GetMappedTensorFromExternal(parameter_proto, tensor);
+    if (mapped_tensor != nullptr) {
+      tensor = mapped_tensor;
+      tensor->set_param_info(param_info);
+      // The graphs loaded incrementally reuse the tensor of the parameter, which must be the one holding the data.
+      load_tensor_map_[parameter_proto.name()] = tensor;
+    } else if (!GetTensorDataFromExternal(parameter_proto, tensor)) {
       return false;
     }
     node->set_default_param(tensor);
@@ -498,6 +503,36 @@ bool MSANFModelParser::BuildParameterForFuncGraph(const ParameterPtr &node,
   return true;
 }
 
+tensor::TensorPtr MSANFModelParser::GetMappedTensorFromExternal(const mind_ir::TensorProto &tensor_proto,
+                                                                const tensor::TensorPtr &tensor_info) {
+  // The encrypted data has to be decrypted into memory, so only the plain data file is mapped.
+  if (mindir_dec_key_ != nullptr || tensor_info->data().nbytes() == 0) {
+    return nullptr;
+  }
+  const auto &location = tensor_proto.external_data().location();
+  auto it = mapped_files_.find(location);
+  if (it == mapped_files_.end()) {
+    auto file = MappedFile::Open(mindir_path_ + "/" + location);
+    constexpr Byte is_little_endian = 1;
+    constexpr int byte_order_index = 0;
+    // A file of the other byte order is left to GetTensorDataFromExternal, which reports the error.
+    if (file != nullptr && ((file->data()[byte_order_index] == is_little_endian) ^ little_endian())) {
+      file = nullptr;
+    }
+    it = mapped_files_.emplace(location, file).first;
+  }
+  if (it->second == nullptr ||
+      tensor_proto.external_data().length() != static_cast<int64_t>(tensor_info->data().nbytes())) {
+    return nullptr;
+  }
+  auto data = tensor::MakeMappedTensorData(tensor_info->data_type(), tensor_info->shape(), it->second,
+                                           LongToSize(tensor_proto.external_data().offset()));
+  if (data == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<tensor::Tensor>(tensor_info->data_type(), tensor_info->shape(), data);
+}
+
 bool MSANFModelParser::GetTensorDataFromExternal(const mind_ir::TensorProto &tensor_proto,
                                                  const tensor::TensorPtr &tensor_info) {
   if (!tensor_proto.has_external_data()) {
@@ -24,8 +24,10 @@
 #include "utils/hash_map.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "ir/func_graph.h"
+#include "ir/tensor.h"
 #include "proto/mind_ir.pb.h"
 #include "utils/crypto.h"
+#include "utils/tensor_file.h"
 
 namespace mindspore {
 using int32 = int32_t;
@@ -95,6 +97,9 @@ class MSANFModelParser {
   bool BuildParameterForFuncGraph(const ParameterPtr &node, const mind_ir::TensorProto &parameter_proto);
   bool SetValueForTopGraphParameter(const FuncGraphPtr &topGraph, const std::map<std::string, ValuePtr> &weights);
   bool GetTensorDataFromExternal(const mind_ir::TensorProto &tensor_proto, const tensor::TensorPtr &tensor_info);
+  // Make a tensor referring to the mapped external data file, returns nullptr if the data can not be mapped.
+  tensor::TensorPtr GetMappedTensorFromExternal(const mind_ir::TensorProto &tensor_proto,
+                                                const tensor::TensorPtr &tensor_info);
   bool BuildInputForFuncGraph(const ParameterPtr &node, const mind_ir::ValueInfoProto &value_proto);
   abstract::AbstractTensorPtr GetAbsTensorFromTensorProto(const mind_ir::TensorProto &tensor_proto);
   CNodePtr BuildCNodeForFuncGraph(const FuncGraphPtr &outputFuncGraph, const mind_ir::NodeProto &node_proto);
@@ -143,6 +148,8 @@ class MSANFModelParser {
   std::string mindir_dec_mode_;
   bool little_endian_ = common::IsLittleByteOrder();
   std::map<std::string, std::unique_ptr<Byte[]>> tenor_data_;
+  // The mapped external data files, nullptr if the file can not be mapped.
+  std::map<std::string, MappedFilePtr> mapped_files_;
   static std::map<std::string, tensor::TensorPtr> load_tensor_map_;
 };
 }  // namespace mindspore
@@ -26,6 +26,7 @@
 #include "actor/actormgr.h"
 #include "async/apply.h"
 #include "async/future.h"
+#include "async/message_pool.h"
 
 namespace mindspore {
 using MessageHandler = std::function<void(ActorBase *)>;
@@ -158,6 +159,27 @@ void Async(const AID &aid, const std::shared_ptr<ActorMgr> &mgr, void (T::*metho
   Async(aid, mgr, method, std::move(tuple));
 }
 
+// Direct handle variants: the message skips the AID copies and the name lookup, and is taken from the MessagePool of
+// the sending thread. Only for local actors, which must stay spawned while the handle is in use.
+template <typename T, typename... Args0, typename... Args1>
+void Async(const ActorBase *to, void (T::*method)(Args0...), std::tuple<Args1...> &&tuple) {
+  auto handler = [method, tuple](ActorBase *actor) {
+    MINDRT_ASSERT(actor != nullptr);
+    T *t = static_cast<T *>(actor);
+    MINDRT_ASSERT(t != nullptr);
+    Apply(t, method, tuple);
+  };
+  auto msg = std::unique_ptr<MessageBase>(new (std::nothrow) LocalMessageAsync<decltype(handler)>(std::move(handler)));
+  MINDRT_OOM_EXIT(msg);
+  (void)ActorMgr::SendLocal(to, std::move(msg));
+}
+
+template <typename T, typename... Args0, typename... Args1>
+void Async(const ActorBase *to, void (T::*method)(Args0...), Args1 &&... args) {
+  auto tuple = std::make_tuple(std::forward<Args1>(args)...);
+  Async(to, method, std::move(tuple));
+}
+
 // return future
 template <typename R, typename T>
 Future<R> Async(const AID &aid, Future<R> (T::*method)()) {
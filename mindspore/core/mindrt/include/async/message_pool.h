@@ -0,0 +1,62 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_MINDRT_INCLUDE_ASYNC_MESSAGE_POOL_H
+#define MINDSPORE_CORE_MINDRT_INCLUDE_ASYNC_MESSAGE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "utils/macros.h"
+#include "actor/msg.h"
+
+namespace mindspore {
+// Per-thread free lists of fixed size slots for local async messages. A slot released on another thread than the one
+// which allocated it simply joins the free list of the releasing thread, so no lock is taken on either side.
+class MS_CORE_API MessagePool {
+ public:
+  // a MessageBase plus a handler capturing a member function pointer and a few arguments fits in one slot.
+  static constexpr size_t kSlotSize = 384;
+  // slots beyond this number are returned to the system when released.
+  static constexpr size_t kMaxCachedSlots = 1024;
+
+  static void *Alloc(size_t size) noexcept;
+  static void Free(void *ptr, size_t size) noexcept;
+  // number of slots cached by the calling thread.
+  static size_t CachedSlots() noexcept;
+};
+
+// Async message keeping its handler inline instead of in a std::function, allocated from the MessagePool when the
+// handler is small enough and from the heap otherwise.
+template <typename F>
+class LocalMessageAsync : public MessageBase {
+ public:
+  explicit LocalMessageAsync(F &&f) : MessageBase("Async", Type::KASYNC), handler_(std::move(f)) {}
+  ~LocalMessageAsync() override = default;
+  void Run(ActorBase *actor) override { handler_(actor); }
+
+  static void *operator new(size_t size, const std::nothrow_t &) noexcept { return MessagePool::Alloc(size); }
+  static void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    MessagePool::Free(ptr, sizeof(LocalMessageAsync));
+  }
+  static void operator delete(void *ptr, size_t size) noexcept { MessagePool::Free(ptr, size); }
+
+ private:
+  F handler_;
+};
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CORE_MINDRT_INCLUDE_ASYNC_MESSAGE_POOL_H
@@ -191,7 +191,7 @@ ActorReference ActorMgr::GetActor(const AID &id) {
   }
 }
 
-int ActorMgr::EnqueueMessage(const mindspore::ActorReference actor, std::unique_ptr<mindspore::MessageBase> msg) {
+int ActorMgr::EnqueueMessage(const mindspore::ActorReference &actor, std::unique_ptr<mindspore::MessageBase> msg) {
   return actor->EnqueMessage(std::move(msg));
 }
 
@@ -208,7 +208,8 @@ int ActorMgr::Send(const AID &to, std::unique_ptr<MessageBase> msg, bool remoteL
   if (IsLocalAddres(to)) {
     auto actor = GetActor(to);
     if (actor != nullptr) {
-      if (to.GetProtocol() == MINDRT_UDP && msg->GetType() == MessageBase::Type::KMSG) {
+      // GetProtocol parses the url, so it is left to the string messages which may need it.
+      if (msg->GetType() == MessageBase::Type::KMSG && to.GetProtocol() == MINDRT_UDP) {
         msg->type = MessageBase::Type::KUDP;
       }
       return EnqueueMessage(actor, std::move(msg));
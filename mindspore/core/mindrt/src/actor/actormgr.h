@@ -27,6 +27,7 @@
 #include <shared_mutex>
 #endif
 #include "actor/actor.h"
+#include "actor/errcode.h"
 #include "thread/actor_threadpool.h"
 #include "thread/hqueue.h"
 
@@ -62,6 +63,14 @@ class MS_CORE_API ActorMgr {
   void AddUrl(const std::string &protocol, const std::string &url);
   void AddIOMgr(const std::string &protocol, const std::shared_ptr<IOMgr> &ioMgr);
   int Send(const AID &to, std::unique_ptr<MessageBase> msg, bool remoteLink = false, bool isExactNotRemote = false);
+  // Enqueues msg to a local actor through a handle cached by the sender, skipping the name lookup. The actor must stay
+  // spawned while the handle is in use.
+  static inline int SendLocal(const ActorBase *actor, std::unique_ptr<MessageBase> msg) {
+    if (actor == nullptr || actor->mailbox == nullptr) {
+      return ACTOR_NOT_FIND;
+    }
+    return actor->EnqueMessage(std::move(msg));
+  }
   AID Spawn(const ActorReference &actor, bool shareThread = true);
   void Terminate(const AID &id);
   void TerminateAll();
@@ -79,7 +88,7 @@ class MS_CORE_API ActorMgr {
       return false;
     }
   }
-  int EnqueueMessage(const ActorReference actor, std::unique_ptr<MessageBase> msg);
+  int EnqueueMessage(const ActorReference &actor, std::unique_ptr<MessageBase> msg);
   // in order to avoid being initialized many times
   std::atomic_bool initialized_{false};
 
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "async/message_pool.h"
+
+namespace mindspore {
+namespace {
+struct FreeSlot {
+  FreeSlot *next;
+};
+
+// kept trivially destructible, so that messages released during thread exit can still reach them.
+thread_local FreeSlot *free_slots = nullptr;
+thread_local size_t free_slot_num = 0;
+thread_local bool pool_released = false;
+
+struct SlotCacheGuard {
+  SlotCacheGuard() = default;
+  ~SlotCacheGuard() {
+    while (free_slots != nullptr) {
+      auto slot = free_slots;
+      free_slots = slot->next;
+      ::operator delete(slot);
+    }
+    free_slot_num = 0;
+    pool_released = true;
+  }
+  void Touch() {}
+};
+thread_local SlotCacheGuard slot_cache_guard;
+}  // namespace
+
+void *MessagePool::Alloc(size_t size) noexcept {
+  if (size > kSlotSize) {
+    return ::operator new(size, std::nothrow);
+  }
+  if (free_slots != nullptr) {
+    auto slot = free_slots;
+    free_slots = slot->next;
+    --free_slot_num;
+    return slot;
+  }
+  return ::operator new(kSlotSize, std::nothrow);
+}
+
+void MessagePool::Free(void *ptr, size_t size) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (size > kSlotSize || pool_released || free_slot_num >= kMaxCachedSlots) {
+    ::operator delete(ptr);
+    return;
+  }
+  // registers the guard of this thread before the first slot is cached.
+  slot_cache_guard.Touch();
+  auto slot = static_cast<FreeSlot *>(ptr);
+  slot->next = free_slots;
+  free_slots = slot;
+  ++free_slot_num;
+}
+
+size_t MessagePool::CachedSlots() noexcept { return free_slot_num; }
+}  // namespace mindspore
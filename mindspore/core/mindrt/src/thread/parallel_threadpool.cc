@@ -153,9 +153,11 @@ bool ParallelThreadPool::RunParallel() {
 }
 
 int ParallelThreadPool::ParallelLaunch(const Func &func, Content content, int task_num) {
+  Func stat_func;
+  const Func &run_func = StatisticsFunc(func, &stat_func);
   // if single thread, run master thread
   if (task_num <= 1) {
-    return SyncRunFunc(func, content, 0, task_num);
+    return SyncRunFunc(run_func, content, 0, task_num);
   }
 
   // distribute task to the KernelThread and the idle ActorThread,
@@ -180,13 +182,13 @@ int ParallelThreadPool::ParallelLaunch(const Func &func, Content content, int ta
       }
     }
     if (task_index >= max_task_num) {
-      return SyncRunFunc(func, content, 0, task_num);
+      return SyncRunFunc(run_func, content, 0, task_num);
     }
   }
 
   ParallelTask *p_task = &tasks_[task_index];
   p_task->valid.store(false);
-  p_task->func = func;
+  p_task->func = run_func;
   p_task->content = content;
   p_task->finished = 1;
   p_task->distributor = {1, task_num};
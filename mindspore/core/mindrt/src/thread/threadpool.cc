@@ -18,10 +18,14 @@
 #include <unistd.h>
 #endif
 #include "thread/threadpool.h"
+#include <chrono>
 #include "thread/core_affinity.h"
 
 namespace mindspore {
 std::mutex ThreadPool::create_thread_pool_muntex_;
+std::atomic_bool ThreadPool::statistics_enabled_{false};
+std::atomic<uint64_t> ThreadPool::statistics_busy_ns_{0};
+std::atomic<uint64_t> ThreadPool::statistics_split_num_{0};
 
 Worker::~Worker() {
   {
@@ -253,16 +257,42 @@ int ThreadPool::TaskQueuesInit(size_t thread_num) {
   return THREAD_OK;
 }
 
+void ThreadPool::EnableStatistics(bool enable) { statistics_enabled_.store(enable, std::memory_order_relaxed); }
+
+ThreadPoolStatistics ThreadPool::GetStatistics() {
+  ThreadPoolStatistics statistics;
+  statistics.busy_ns = statistics_busy_ns_.load(std::memory_order_relaxed);
+  statistics.split_num = statistics_split_num_.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+const Func &ThreadPool::StatisticsFunc(const Func &func, Func *stat_func) {
+  if (!statistics_enabled_.load(std::memory_order_relaxed)) {
+    return func;
+  }
+  *stat_func = [&func](void *content, int task_id, float lhs_scale, float rhs_scale) {
+    auto start = std::chrono::steady_clock::now();
+    int ret = func(content, task_id, lhs_scale, rhs_scale);
+    auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    (void)statistics_busy_ns_.fetch_add(static_cast<uint64_t>(cost.count()), std::memory_order_relaxed);
+    (void)statistics_split_num_.fetch_add(1, std::memory_order_relaxed);
+    return ret;
+  };
+  return *stat_func;
+}
+
 int ThreadPool::ParallelLaunch(const Func &func, Content content, int task_num) {
+  Func stat_func;
+  const Func &run_func = StatisticsFunc(func, &stat_func);
   // if single thread, run master thread
   if (task_num <= 1) {
-    return SyncRunFunc(func, content, 0, task_num);
+    return SyncRunFunc(run_func, content, 0, task_num);
   }
 
   // distribute task to the KernelThread and the idle ActorThread,
   // if the task num is greater than the KernelThread num
   THREAD_DEBUG("launch: %d", task_num);
-  Task task = {func, content};
+  Task task = {run_func, content};
   std::vector<TaskSplit> task_list;
   for (int i = 0; i < task_num; ++i) {
     (void)task_list.emplace_back(TaskSplit{&task, i});
@@ -68,6 +68,12 @@ typedef struct Task {
   std::atomic_int status{THREAD_OK};  // return status, RET_OK
 } Task;
 
+// statistics of the task splits run by all thread pools of the process
+typedef struct ThreadPoolStatistics {
+  uint64_t busy_ns{0};  // wall time spent in task splits, summed over threads
+  uint64_t split_num{0};
+} ThreadPoolStatistics;
+
 typedef struct TaskSplit {
   TaskSplit(Task *task, int task_id) : task_(task), task_id_(task_id) {}
   Task *task_;
@@ -166,6 +172,10 @@ class MS_CORE_API ThreadPool {
 
   virtual int ParallelLaunch(const Func &func, Content content, int task_num);
 
+  // statistics are only collected after being enabled by profiling tools, as timing every task split is not free.
+  static void EnableStatistics(bool enable);
+  static ThreadPoolStatistics GetStatistics();
+
   void DisableOccupiedActorThread() { occupied_actor_thread_ = false; }
   void SetActorThreadNum(size_t actor_thread_num) { actor_thread_num_ = actor_thread_num; }
   void SetKernelThreadNum(size_t kernel_thread_num) { kernel_thread_num_ = kernel_thread_num; }
@@ -225,6 +235,8 @@ class MS_CORE_API ThreadPool {
 
   Worker *CurrentWorker(size_t *index) const;
   Worker *CurrentWorker() const;
+  // returns func itself if statistics are disabled, otherwise a timing wrapper of func stored in stat_func.
+  static const Func &StatisticsFunc(const Func &func, Func *stat_func);
 
   std::mutex pool_mutex_;
   std::vector<Worker *> workers_;
@@ -238,6 +250,9 @@ class MS_CORE_API ThreadPool {
   int min_spin_count_{kMinSpinCount};
   float server_cpu_frequence = -1.0f;  // Unit : GHz
   static std::mutex create_thread_pool_muntex_;
+  static std::atomic_bool statistics_enabled_;
+  static std::atomic<uint64_t> statistics_busy_ns_;
+  static std::atomic<uint64_t> statistics_split_num_;
 };
 }  // namespace mindspore
 #endif  // MINDSPORE_CORE_MINDRT_RUNTIME_THREADPOOL_H_
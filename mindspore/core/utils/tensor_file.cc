@@ -0,0 +1,358 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/tensor_file.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <utility>
+#include "ir/tensor.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace {
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+constexpr size_t kHashLaneNum = 4;
+constexpr size_t kHashStripeSize = kHashLaneNum * sizeof(uint64_t);
+// The upper limit of the rank of a tensor, used to reject a corrupted index.
+constexpr uint32_t kMaxTensorRank = 64;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+inline uint64_t Load64(const uint8_t *data) {
+  uint64_t value;
+  (void)memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+  acc += input * kPrime2;
+  acc = RotateLeft(acc, 31);
+  return acc * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t lane) {
+  acc ^= Round(0, lane);
+  return acc * kPrime1 + kPrime4;
+}
+
+template <typename T>
+void Append(std::string *buffer, const T &value) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+bool Read(const char *data, size_t size, size_t *offset, T *value) {
+  if (size - *offset < sizeof(T)) {
+    return false;
+  }
+  (void)memcpy(value, data + *offset, sizeof(T));
+  *offset += sizeof(T);
+  return true;
+}
+}  // namespace
+
+// The structure of XXH64, four independent lanes are accumulated so that the multiplications are pipelined.
+uint64_t TensorFileHash(const void *data, size_t size) {
+  const auto *input = static_cast<const uint8_t *>(data);
+  const uint8_t *end = input + size;
+  uint64_t hash;
+  if (size >= kHashStripeSize) {
+    uint64_t lanes[kHashLaneNum] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+    const uint8_t *limit = end - kHashStripeSize;
+    do {
+      for (size_t i = 0; i < kHashLaneNum; ++i) {
+        lanes[i] = Round(lanes[i], Load64(input + i * sizeof(uint64_t)));
+      }
+      input += kHashStripeSize;
+    } while (input <= limit);
+    hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+    for (size_t i = 0; i < kHashLaneNum; ++i) {
+      hash = MergeRound(hash, lanes[i]);
+    }
+  } else {
+    hash = kPrime5;
+  }
+  hash += static_cast<uint64_t>(size);
+  while (input + sizeof(uint64_t) <= end) {
+    hash ^= Round(0, Load64(input));
+    hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+    input += sizeof(uint64_t);
+  }
+  while (input < end) {
+    hash ^= static_cast<uint64_t>(*input) * kPrime5;
+    hash = RotateLeft(hash, 11) * kPrime1;
+    ++input;
+  }
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+TensorFileHeader MakeTensorFileHeader(uint32_t tensor_num, uint64_t index_offset, uint64_t index_size) {
+  TensorFileHeader header{};
+  (void)memcpy(header.magic, kTensorFileMagic, sizeof(header.magic));
+  header.version = kTensorFileVersion;
+  header.tensor_num = tensor_num;
+  header.index_offset = index_offset;
+  header.index_size = index_size;
+  header.alignment = kTensorFileAlignment;
+  return header;
+}
+
+bool CheckTensorFileHeader(const TensorFileHeader &header, uint64_t file_size) {
+  if (memcmp(header.magic, kTensorFileMagic, sizeof(header.magic)) != 0) {
+    MS_LOG(ERROR) << "The magic number of the tensor file is invalid.";
+    return false;
+  }
+  if (header.version != kTensorFileVersion || header.alignment != kTensorFileAlignment) {
+    MS_LOG(ERROR) << "Unsupported tensor file of version " << header.version << " and alignment " << header.alignment;
+    return false;
+  }
+  if (header.index_offset < kTensorFileAlignment || header.index_offset > file_size ||
+      header.index_size > file_size - header.index_offset) {
+    MS_LOG(ERROR) << "The index [" << header.index_offset << ", +" << header.index_size
+                  << ") is out of the tensor file of " << file_size << " bytes.";
+    return false;
+  }
+  return true;
+}
+
+// Every entry is encoded as: name length(uint32) | name | type(int32) | rank(uint32) | dims(int64 * rank) |
+// offset(uint64) | nbytes(uint64) | hash(uint64).
+std::string EncodeTensorFileIndex(const std::vector<TensorFileEntry> &entries) {
+  std::string buffer;
+  for (const auto &entry : entries) {
+    Append(&buffer, static_cast<uint32_t>(entry.name.size()));
+    buffer.append(entry.name);
+    Append(&buffer, static_cast<int32_t>(entry.type));
+    Append(&buffer, static_cast<uint32_t>(entry.shape.size()));
+    for (auto dim : entry.shape) {
+      Append(&buffer, static_cast<int64_t>(dim));
+    }
+    Append(&buffer, entry.offset);
+    Append(&buffer, entry.nbytes);
+    Append(&buffer, entry.hash);
+  }
+  return buffer;
+}
+
+bool DecodeTensorFileIndex(const char *data, size_t size, uint32_t tensor_num, std::vector<TensorFileEntry> *entries) {
+  MS_EXCEPTION_IF_NULL(entries);
+  entries->clear();
+  size_t offset = 0;
+  for (uint32_t i = 0; i < tensor_num; ++i) {
+    TensorFileEntry entry;
+    uint32_t name_size = 0;
+    if (!Read(data, size, &offset, &name_size) || size - offset < name_size) {
+      return false;
+    }
+    entry.name.assign(data + offset, name_size);
+    offset += name_size;
+    int32_t type = 0;
+    uint32_t rank = 0;
+    if (!Read(data, size, &offset, &type) || !Read(data, size, &offset, &rank) || rank > kMaxTensorRank) {
+      return false;
+    }
+    entry.type = static_cast<TypeId>(type);
+    for (uint32_t j = 0; j < rank; ++j) {
+      int64_t dim = 0;
+      if (!Read(data, size, &offset, &dim)) {
+        return false;
+      }
+      entry.shape.push_back(dim);
+    }
+    if (!Read(data, size, &offset, &entry.offset) || !Read(data, size, &offset, &entry.nbytes) ||
+        !Read(data, size, &offset, &entry.hash)) {
+      return false;
+    }
+    entries->push_back(std::move(entry));
+  }
+  return offset == size;
+}
+
+bool ReadTensorFileIndex(const std::string &file_name, std::vector<TensorFileEntry> *entries) {
+  std::ifstream ifs(file_name, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!ifs.good()) {
+    MS_LOG(ERROR) << "Failed to open the tensor file " << file_name;
+    return false;
+  }
+  auto file_size = static_cast<uint64_t>(ifs.tellg());
+  TensorFileHeader header{};
+  if (file_size < kTensorFileAlignment || !ifs.seekg(0).read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    MS_LOG(ERROR) << "Failed to read the header of the tensor file " << file_name;
+    return false;
+  }
+  if (!CheckTensorFileHeader(header, file_size)) {
+    MS_LOG(ERROR) << "Invalid tensor file " << file_name;
+    return false;
+  }
+  std::string index(header.index_size, '\0');
+  if (!ifs.seekg(static_cast<std::streamoff>(header.index_offset)).read(&index[0], index.size())) {
+    MS_LOG(ERROR) << "Failed to read the index of the tensor file " << file_name;
+    return false;
+  }
+  if (!DecodeTensorFileIndex(index.data(), index.size(), header.tensor_num, entries)) {
+    MS_LOG(ERROR) << "The index of the tensor file " << file_name << " is corrupted.";
+    return false;
+  }
+  for (const auto &entry : *entries) {
+    if (entry.offset % kTensorFileAlignment != 0 || entry.offset > header.index_offset ||
+        entry.nbytes > header.index_offset - entry.offset) {
+      MS_LOG(ERROR) << "The data of tensor " << entry.name << " is out of the data region of the tensor file "
+                    << file_name;
+      return false;
+    }
+  }
+  return true;
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (data_ != nullptr) {
+    (void)munmap(data_, size_);
+  }
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string &file_name) {
+#ifdef _WIN32
+  return nullptr;
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    MS_LOG(WARNING) << "Failed to open the file " << file_name << ", errno: " << errno;
+    return nullptr;
+  }
+  struct stat fd_stat = {};
+  if (fstat(fd, &fd_stat) != 0 || fd_stat.st_size <= 0) {
+    MS_LOG(WARNING) << "Failed to get the size of the file " << file_name << ", errno: " << errno;
+    (void)close(fd);
+    return nullptr;
+  }
+  auto size = static_cast<size_t>(fd_stat.st_size);
+  // The mapping is private and writable, so the tensors referring to it can be updated in place, as copy on write.
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  (void)close(fd);
+  if (data == MAP_FAILED) {
+    MS_LOG(WARNING) << "Failed to map the file " << file_name << ", errno: " << errno;
+    return nullptr;
+  }
+  return std::shared_ptr<MappedFile>(new MappedFile(file_name, static_cast<uint8_t *>(data), size));
+#endif
+}
+
+namespace {
+bool VerifyTensorFile(const MappedFilePtr &file, const std::vector<TensorFileEntry> &entries) {
+  size_t thread_num = std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()), entries.size());
+  std::atomic<size_t> next_entry{0};
+  std::atomic<bool> success{true};
+  auto verify = [&]() {
+    for (size_t i = next_entry++; i < entries.size() && success; i = next_entry++) {
+      const auto &entry = entries[i];
+      if (TensorFileHash(file->data() + entry.offset, entry.nbytes) != entry.hash) {
+        MS_LOG(ERROR) << "The data of tensor " << entry.name << " in the tensor file " << file->file_name()
+                      << " is corrupted.";
+        success = false;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_num; ++i) {
+    threads.emplace_back(verify);
+  }
+  verify();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return success;
+}
+
+bool ReadTensorFileData(const std::string &file_name, bool verify, const std::vector<TensorFileEntry> &entries,
+                        std::vector<std::pair<std::string, tensor::TensorPtr>> *tensors) {
+  std::ifstream ifs(file_name, std::ios::in | std::ios::binary);
+  if (!ifs.good()) {
+    MS_LOG(ERROR) << "Failed to open the tensor file " << file_name;
+    return false;
+  }
+  for (const auto &entry : entries) {
+    auto tensor = std::make_shared<tensor::Tensor>(entry.type, entry.shape);
+    if (static_cast<uint64_t>(tensor->data().nbytes()) != entry.nbytes) {
+      MS_LOG(ERROR) << "The size of tensor " << entry.name << " in the tensor file " << file_name
+                    << " does not match its shape.";
+      return false;
+    }
+    if (!ifs.seekg(static_cast<std::streamoff>(entry.offset))
+           .read(static_cast<char *>(tensor->data_c()), static_cast<std::streamsize>(entry.nbytes))) {
+      MS_LOG(ERROR) << "Failed to read the data of tensor " << entry.name << " from the tensor file " << file_name;
+      return false;
+    }
+    if (verify && TensorFileHash(tensor->data_c(), entry.nbytes) != entry.hash) {
+      MS_LOG(ERROR) << "The data of tensor " << entry.name << " in the tensor file " << file_name << " is corrupted.";
+      return false;
+    }
+    (void)tensors->emplace_back(entry.name, tensor);
+  }
+  return true;
+}
+}  // namespace
+
+bool LoadTensorFile(const std::string &file_name, bool verify,
+                    std::vector<std::pair<std::string, tensor::TensorPtr>> *tensors) {
+  MS_EXCEPTION_IF_NULL(tensors);
+  tensors->clear();
+  std::vector<TensorFileEntry> entries;
+  if (!ReadTensorFileIndex(file_name, &entries)) {
+    return false;
+  }
+  auto file = MappedFile::Open(file_name);
+  if (file == nullptr) {
+    MS_LOG(INFO) << "The tensor file " << file_name << " can not be mapped, read it instead.";
+    return ReadTensorFileData(file_name, verify, entries, tensors);
+  }
+  if (verify && !VerifyTensorFile(file, entries)) {
+    return false;
+  }
+  for (const auto &entry : entries) {
+    auto data = tensor::MakeMappedTensorData(entry.type, entry.shape, file, entry.offset);
+    if (data == nullptr || static_cast<uint64_t>(data->nbytes()) != entry.nbytes) {
+      MS_LOG(ERROR) << "The data of tensor " << entry.name << " in the tensor file " << file_name
+                    << " does not match its shape.";
+      tensors->clear();
+      return false;
+    }
+    (void)tensors->emplace_back(entry.name, std::make_shared<tensor::Tensor>(entry.type, entry.shape, data));
+  }
+  return true;
+}
+}  // namespace mindspore
@@ -0,0 +1,111 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_UTILS_TENSOR_FILE_H_
+#define MINDSPORE_CORE_UTILS_TENSOR_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "mindapi/base/shape_vector.h"
+#include "mindapi/base/type_id.h"
+#include "utils/macros.h"
+
+namespace mindspore {
+// The flat tensor file holds raw tensor data which can be written with large sequential writes and mapped into memory
+// without parsing. The layout is:
+//   header   : kTensorFileAlignment bytes, see TensorFileHeader.
+//   data     : the data of every tensor, starting at an offset aligned to kTensorFileAlignment.
+//   index    : the entries of all the tensors, which is written after the data.
+constexpr char kTensorFileMagic[] = "MSTENSOR";
+constexpr uint32_t kTensorFileVersion = 1;
+constexpr uint64_t kTensorFileAlignment = 4096;
+
+struct TensorFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t tensor_num;
+  uint64_t index_offset;
+  uint64_t index_size;
+  uint64_t alignment;
+};
+
+struct TensorFileEntry {
+  std::string name;
+  TypeId type{kTypeUnknown};
+  ShapeVector shape;
+  // The offset of the data in file, aligned to kTensorFileAlignment.
+  uint64_t offset{0};
+  uint64_t nbytes{0};
+  // The TensorFileHash of the data, used to verify the data and to find the unchanged tensors of a checkpoint.
+  uint64_t hash{0};
+};
+
+inline uint64_t AlignTensorFileOffset(uint64_t offset) {
+  return (offset + kTensorFileAlignment - 1) / kTensorFileAlignment * kTensorFileAlignment;
+}
+
+// A 64 bits non-cryptographic hash which processes 32 bytes in each round, so that hashing the data is much faster
+// than reading it from disk.
+MS_CORE_API uint64_t TensorFileHash(const void *data, size_t size);
+
+MS_CORE_API TensorFileHeader MakeTensorFileHeader(uint32_t tensor_num, uint64_t index_offset, uint64_t index_size);
+MS_CORE_API bool CheckTensorFileHeader(const TensorFileHeader &header, uint64_t file_size);
+
+MS_CORE_API std::string EncodeTensorFileIndex(const std::vector<TensorFileEntry> &entries);
+MS_CORE_API bool DecodeTensorFileIndex(const char *data, size_t size, uint32_t tensor_num,
+                                       std::vector<TensorFileEntry> *entries);
+
+// Read the header and the index of a tensor file, returns false if the file is not a valid tensor file.
+MS_CORE_API bool ReadTensorFileIndex(const std::string &file_name, std::vector<TensorFileEntry> *entries);
+
+namespace tensor {
+class Tensor;
+using TensorPtr = std::shared_ptr<Tensor>;
+}  // namespace tensor
+
+// MappedFile maps a whole file into memory privately. The pages are read from the file when they are touched, and the
+// written pages are copied, so the file is never changed through the mapping.
+class MS_CORE_API MappedFile {
+ public:
+  ~MappedFile();
+
+  // Returns nullptr if the file can not be mapped, in which case the caller should read the file instead.
+  static std::shared_ptr<MappedFile> Open(const std::string &file_name);
+
+  uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+  const std::string &file_name() const { return file_name_; }
+
+ private:
+  MappedFile(const std::string &file_name, uint8_t *data, size_t size)
+      : file_name_(file_name), data_(data), size_(size) {}
+
+  std::string file_name_;
+  uint8_t *data_;
+  size_t size_;
+};
+using MappedFilePtr = std::shared_ptr<MappedFile>;
+
+// Load the tensors of a tensor file in the order of its index. The tensors refer to the mapped file instead of copies
+// of the data when the file can be mapped, so only the data which is used is read. If verify is true, the data of all
+// the tensors is hashed in parallel and compared with the index.
+MS_CORE_API bool LoadTensorFile(const std::string &file_name, bool verify,
+                                std::vector<std::pair<std::string, tensor::TensorPtr>> *tensors);
+}  // namespace mindspore
+#endif  // MINDSPORE_CORE_UTILS_TENSOR_FILE_H_
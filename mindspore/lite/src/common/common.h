@@ -61,6 +61,7 @@ static const char *const kMSCacheSerializePath = "serialize_path";
 // weight path
 static const char *const kWeight = "weight";
 static const char *const kWeightPath = "weight_path";
+static const char *const kPackedWeightCachePath = "packed_weight_cache_path";
 
 static const char *const kIsOptimized = "isOptimized";
 // gpu context
@@ -68,6 +69,12 @@ static const char *const kGPUContext = "gpu_context";
 static const char *const kInputShape = "input_shape";
 static const char *const kDynamicDims = "dynamic_dims";
 static const char *const kOptimizeDims = "opt_dims";
+// kernel autotune
+static const char *const kAutoTune = "autotune";
+static const char *const kAutoTuneEnable = "enable";
+static const char *const kAutoTuneDbPath = "tuning_db_path";
+static const char *const kAutoTuneWarmUpLoops = "warm_up_loops";
+static const char *const kAutoTuneLoops = "loops";
 }  // namespace lite
 }  // namespace mindspore
 
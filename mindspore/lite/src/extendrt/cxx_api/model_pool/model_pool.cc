@@ -134,6 +134,19 @@ Status DistinguishPhysicalAndLogical(std::vector<int> *physical_list, std::vecto
   }
   return kSuccess;
 }
+
+std::string GetPackWeightCachePath(const ModelPoolConfig &model_pool_config) {
+  if (model_pool_config.empty() || model_pool_config.front() == nullptr) {
+    return "";
+  }
+  auto &config_info = model_pool_config.front()->config_info;
+  auto weight_iter = config_info.find(lite::kWeight);
+  if (weight_iter == config_info.end()) {
+    return "";
+  }
+  auto path_iter = weight_iter->second.find(lite::kPackedWeightCachePath);
+  return path_iter == weight_iter->second.end() ? "" : path_iter->second;
+}
 }  // namespace
 
 int ModelPool::GetDefaultThreadNum(int worker_num) {
@@ -844,6 +857,10 @@ Status ModelPool::CreateWorkers(const char *graph_buf, size_t size, const ModelP
   }
   bool create_worker_success = true;
   MS_LOG(INFO) << "Strategy: " << strategy << " | worker num: " << model_pool_info_[strategy].all_workers_num_;
+  auto pack_weight_cache_path = GetPackWeightCachePath(model_pool_config);
+  if (!pack_weight_cache_path.empty()) {
+    lite::PackWeightManager::GetInstance()->SetPackWeightCachePath(pack_weight_cache_path);
+  }
   for (size_t i = 0; i < model_pool_info_[strategy].all_workers_num_; i++) {
     model_pool_config[i]->strategy = strategy;
     int numa_node_id = model_pool_config[i]->numa_id;
@@ -892,6 +909,10 @@ Status ModelPool::CreateWorkers(const char *graph_buf, size_t size, const ModelP
       return kLiteError;
     }
   }
+  // all workers have packed their weights, later processes can map them instead of repacking.
+  if (!pack_weight_cache_path.empty() && lite::PackWeightManager::GetInstance()->StorePackWeightCache() != kSuccess) {
+    MS_LOG(WARNING) << "Store packed weight cache to " << pack_weight_cache_path << " failed.";
+  }
   // init model pool input and output
   if (model_worker != nullptr) {
     auto inputs = model_worker->GetInputs();
@@ -28,6 +28,9 @@
 #include "nnacl/base/conv_common_base.h"
 #include "schema/model_generated.h"
 #include "include/errorcode.h"
+#include "src/common/common.h"
+#include "src/common/utils.h"
+#include "src/litert/pack_weight_manager.h"
 #if defined(ENABLE_ARM) || (defined(ENABLE_SSE) && !defined(ENABLE_AVX))
 #include "src/litert/kernel/cpu/fp32/convolution_depthwise_3x3_fp32.h"
 #endif
@@ -233,64 +236,227 @@ bool ConvolutionDelegateCPUKernel::CheckAvxUseSWConv(const ConvParameter *conv_p
   return false;
 }
 
-kernel::LiteKernel *ConvolutionDelegateCPUKernel::CreateConv1x1MatmulKernel() {
-  auto conv_param = reinterpret_cast<ConvParameter *>(op_parameter_);
-
-  matmul_param_ = reinterpret_cast<MatMulParameter *>(malloc(sizeof(MatMulParameter)));
-  if (matmul_param_ == nullptr) {
+kernel::LiteKernel *ConvolutionDelegateCPUKernel::CreateConv1x1MatmulKernel(const ConvParameter *conv_param) {
+  auto matmul_param = reinterpret_cast<MatMulParameter *>(malloc(sizeof(MatMulParameter)));
+  if (matmul_param == nullptr) {
     MS_LOG(WARNING) << "Memory allocation failed, Create Conv1x1 Matmul Kernel failed.";
     return nullptr;
   }
-
-  MS_CHECK_INT_MUL_NOT_OVERFLOW(conv_param->output_h_, conv_param->output_w_, nullptr);
-  matmul_param_->row_ = conv_param->output_h_ * conv_param->output_w_;
-  matmul_param_->col_ = conv_param->output_channel_;
-  matmul_param_->deep_ = conv_param->input_channel_;
-  matmul_param_->batch = conv_param->input_batch_;
-  matmul_param_->op_parameter_ = conv_param->op_parameter_;
-  matmul_param_->act_type_ = conv_param->act_type_;
-  matmul_param_->a_transpose_ = false;
-  matmul_param_->b_transpose_ = true;
-  matmul_param_->a_const_ = input_const_;
-  matmul_param_->b_const_ = weight_const_;
+  if (INT_MUL_OVERFLOW(conv_param->output_h_, conv_param->output_w_)) {
+    free(matmul_param);
+    return nullptr;
+  }
+  matmul_param->row_ = conv_param->output_h_ * conv_param->output_w_;
+  matmul_param->col_ = conv_param->output_channel_;
+  matmul_param->deep_ = conv_param->input_channel_;
+  matmul_param->batch = conv_param->input_batch_;
+  matmul_param->op_parameter_ = conv_param->op_parameter_;
+  matmul_param->act_type_ = conv_param->act_type_;
+  matmul_param->a_transpose_ = false;
+  matmul_param->b_transpose_ = true;
+  matmul_param->a_const_ = input_const_;
+  matmul_param->b_const_ = weight_const_;
   auto kernel = new (std::nothrow) kernel::ConvolutionSW1x1CPUKernel(
-    reinterpret_cast<OpParameter *>(matmul_param_), in_tensors_, out_tensors_,
+    reinterpret_cast<OpParameter *>(matmul_param), in_tensors_, out_tensors_,
     static_cast<const lite::InnerContext *>(this->ms_context_), origin_weight_, origin_bias_);
+  if (kernel == nullptr) {
+    free(matmul_param);
+  }
   return kernel;
 }
 
-kernel::LiteKernel *ConvolutionDelegateCPUKernel::CpuConvFp32NHWCKernelSelect() {
-  kernel::LiteKernel *kernel = nullptr;
-  auto conv_param = reinterpret_cast<ConvParameter *>(op_parameter_);
-
-  int out_unit;
-  if (CheckIfUseWinograd(&out_unit, conv_param)) {
-    kernel = CreateConvolutionWinogradCPUKernel(op_parameter_, in_tensors_, out_tensors_,
-                                                static_cast<const lite::InnerContext *>(this->ms_context_), out_unit,
-                                                origin_weight_, origin_bias_);
+std::vector<int> ConvolutionDelegateCPUKernel::GetCandidateAlgorithms(ConvParameter *conv_param, int *out_unit) {
+  std::vector<int> candidates;
+  if (CheckIfUseWinograd(out_unit, conv_param)) {
+    candidates.push_back(kConvAlgoWinograd);
+  }
+#ifdef ENABLE_AVX
+  if (CheckAvxUseSW1x1Conv(conv_param)) {
+    candidates.push_back(kConvAlgoSW1x1);
   }
+  if (CheckAvxUseSWConv(conv_param)) {
+    candidates.push_back(kConvAlgoSWAVX);
+  }
+#endif
+  if (conv_param->kernel_h_ == 1 && conv_param->kernel_w_ == 1) {
+    candidates.push_back(kConvAlgo1x1);
+  } else {
+    candidates.push_back(kConvAlgoIm2Col);
+  }
+  return candidates;
+}
 
+kernel::LiteKernel *ConvolutionDelegateCPUKernel::CreateConvKernelByAlgorithm(int algorithm, int out_unit,
+                                                                              OpParameter *param) {
+  auto ctx = static_cast<const lite::InnerContext *>(this->ms_context_);
+  switch (algorithm) {
+    case kConvAlgoWinograd:
+      return CreateConvolutionWinogradCPUKernel(param, in_tensors_, out_tensors_, ctx, out_unit, origin_weight_,
+                                                origin_bias_);
 #ifdef ENABLE_AVX
-  if (kernel == nullptr && CheckAvxUseSW1x1Conv(conv_param)) {
-    kernel = CreateConv1x1MatmulKernel();
+    case kConvAlgoSW1x1:
+      return CreateConv1x1MatmulKernel(reinterpret_cast<ConvParameter *>(param));
+    case kConvAlgoSWAVX:
+      return new (std::nothrow)
+        kernel::ConvolutionSWAVXCPUKernel(param, in_tensors_, out_tensors_, ctx, origin_weight_, origin_bias_);
+#endif
+    case kConvAlgo1x1:
+      return new (std::nothrow)
+        kernel::Convolution1x1CPUKernel(param, in_tensors_, out_tensors_, ctx, origin_weight_, origin_bias_);
+    case kConvAlgoIm2Col:
+      return CreateConvolutionIm2ColCPUKernel(param, in_tensors_, out_tensors_, ctx, origin_weight_, origin_bias_);
+    default:
+      MS_LOG(ERROR) << "Unsupported conv algorithm " << algorithm << " for " << name_;
+      return nullptr;
   }
+}
 
-  if (kernel == nullptr && CheckAvxUseSWConv(conv_param)) {
-    kernel = new (std::nothrow) kernel::ConvolutionSWAVXCPUKernel(
-      op_parameter_, in_tensors_, out_tensors_, static_cast<const lite::InnerContext *>(this->ms_context_),
-      origin_weight_, origin_bias_);
+kernel::LiteKernel *ConvolutionDelegateCPUKernel::CreateSelectedConvKernel(int algorithm, int out_unit) {
+  auto kernel = CreateConvKernelByAlgorithm(algorithm, out_unit, op_parameter_);
+  if (kernel != nullptr && algorithm == kConvAlgoSW1x1) {
+    // the matmul kernel owns its own parameter, op_parameter_ is freed by the delegate.
+    matmul_param_ = reinterpret_cast<MatMulParameter *>(kernel->op_parameter());
   }
-#endif
+  return kernel;
+}
+
+std::vector<int> ConvolutionDelegateCPUKernel::GetAutoTuneShapeInfo(const ConvParameter *conv_param) const {
+  return {conv_param->input_batch_,
+          conv_param->input_h_,
+          conv_param->input_w_,
+          conv_param->input_channel_,
+          conv_param->output_channel_,
+          conv_param->kernel_h_,
+          conv_param->kernel_w_,
+          conv_param->stride_h_,
+          conv_param->stride_w_,
+          conv_param->dilation_h_,
+          conv_param->dilation_w_,
+          conv_param->pad_u_,
+          conv_param->pad_d_,
+          conv_param->pad_l_,
+          conv_param->pad_r_,
+          static_cast<int>(conv_param->act_type_),
+          ms_context_->thread_num_};
+}
 
+float ConvolutionDelegateCPUKernel::MeasureConvAlgorithm(int algorithm, int out_unit, int thread_num,
+                                                         const lite::AutoTuneConfig &config) {
+  // every candidate owns a copy of the parameter, which its kernel updates and frees.
+  auto param = reinterpret_cast<OpParameter *>(malloc(sizeof(ConvParameter)));
+  if (param == nullptr) {
+    MS_LOG(ERROR) << "Malloc conv parameter for autotune failed.";
+    return -1.0f;
+  }
+  memcpy(param, op_parameter_, sizeof(ConvParameter));
+  param->thread_num_ = thread_num;
+  // the candidates pack the same weight in different layouts, which must not go to the shared packed weights.
+  lite::PrivatePackGuard private_pack;
+  auto kernel = CreateConvKernelByAlgorithm(algorithm, out_unit, param);
   if (kernel == nullptr) {
-    if (conv_param->kernel_h_ == 1 && conv_param->kernel_w_ == 1) {
-      kernel = new (std::nothrow) kernel::Convolution1x1CPUKernel(
-        op_parameter_, in_tensors_, out_tensors_, static_cast<const lite::InnerContext *>(this->ms_context_),
-        origin_weight_, origin_bias_);
-    } else {
-      kernel = CreateConvolutionIm2ColCPUKernel(op_parameter_, in_tensors_, out_tensors_,
-                                                static_cast<const lite::InnerContext *>(this->ms_context_),
-                                                origin_weight_, origin_bias_);
+    free(param);
+    return -1.0f;
+  }
+  if (algorithm == kConvAlgoSW1x1) {
+    free(param);
+  }
+  float cost = -1.0f;
+  if (kernel->Prepare() == RET_OK && kernel->ReSize() == RET_OK) {
+    if (kernel->workspace_size() > 0) {
+      kernel->AllocWorkspace();
+    }
+    if (kernel->workspace_size() == 0 || kernel->workspace() != nullptr) {
+      cost = lite::KernelAutoTuner::Measure([kernel]() { return kernel->Run(); }, config.warm_up_loops_,
+                                            config.loops_);
+    }
+    kernel->FreeWorkspace();
+  }
+  delete kernel;
+  return cost;
+}
+
+int ConvolutionDelegateCPUKernel::AutoTuneConvFp32NHWC(const std::vector<int> &candidates, int out_unit,
+                                                       const lite::AutoTuneConfig &config,
+                                                       lite::AutoTuneChoice *choice) {
+  auto conv_param = reinterpret_cast<ConvParameter *>(op_parameter_);
+  auto tuner = lite::KernelAutoTuner::GetInstance();
+  if (tuner->Init(config.db_path_) != RET_OK) {
+    return RET_ERROR;
+  }
+  auto key = tuner->MakeKey("Conv2DFusion_fp32", GetAutoTuneShapeInfo(conv_param));
+  if (tuner->Lookup(key, choice) && IsContain(candidates, choice->algorithm_) && choice->thread_num_ > 0 &&
+      choice->thread_num_ <= ms_context_->thread_num_) {
+    return RET_OK;
+  }
+
+  // benchmarking needs real buffers, graph tensors are only allocated at run time.
+  std::vector<lite::Tensor *> malloc_tensors;
+  for (auto tensor : {in_tensors_.at(kInputIndex), out_tensors_.front()}) {
+    if (tensor->data() != nullptr) {
+      continue;
+    }
+    if (tensor->MallocData() != RET_OK) {
+      MS_LOG(WARNING) << "Malloc data for autotune failed, use static selection for " << name_;
+      for (auto malloc_tensor : malloc_tensors) {
+        malloc_tensor->FreeData();
+      }
+      return RET_ERROR;
+    }
+    memset(tensor->data(), 0, tensor->Size());
+    malloc_tensors.push_back(tensor);
+  }
+
+  std::vector<int> thread_nums = {ms_context_->thread_num_};
+  for (int thread_num = ms_context_->thread_num_ / C2NUM; thread_num >= 1; thread_num /= C2NUM) {
+    thread_nums.push_back(thread_num);
+  }
+  choice->algorithm_ = -1;
+  for (auto algorithm : candidates) {
+    for (auto thread_num : thread_nums) {
+      auto cost = MeasureConvAlgorithm(algorithm, out_unit, thread_num, config);
+      MS_LOG(DEBUG) << name_ << " autotune algorithm " << algorithm << " thread num " << thread_num << " cost "
+                    << cost << "us";
+      if (cost >= 0 && (choice->algorithm_ < 0 || cost < choice->cost_us_)) {
+        choice->algorithm_ = algorithm;
+        choice->thread_num_ = thread_num;
+        choice->cost_us_ = cost;
+      }
+    }
+  }
+  for (auto tensor : malloc_tensors) {
+    tensor->FreeData();
+  }
+  if (choice->algorithm_ < 0) {
+    MS_LOG(WARNING) << "No conv candidate can be measured, use static selection for " << name_;
+    return RET_ERROR;
+  }
+  tuner->Record(key, *choice);
+  return RET_OK;
+}
+
+kernel::LiteKernel *ConvolutionDelegateCPUKernel::CpuConvFp32NHWCKernelSelect() {
+  kernel::LiteKernel *kernel = nullptr;
+  auto conv_param = reinterpret_cast<ConvParameter *>(op_parameter_);
+
+  int out_unit = 0;
+  auto candidates = GetCandidateAlgorithms(conv_param, &out_unit);
+  auto tune_config = lite::ParseAutoTuneConfig(GetConfig(lite::kAutoTune));
+  if (tune_config.enable_ && weight_const_ && origin_weight_ != nullptr) {
+    lite::AutoTuneChoice choice;
+    if (AutoTuneConvFp32NHWC(candidates, out_unit, tune_config, &choice) == RET_OK) {
+      op_parameter_->thread_num_ = choice.thread_num_;
+      kernel = CreateSelectedConvKernel(choice.algorithm_, out_unit);
+      if (kernel != nullptr) {
+        return kernel;
+      }
+      op_parameter_->thread_num_ = ms_context_->thread_num_;
+    }
+  }
+
+  for (auto algorithm : candidates) {
+    kernel = CreateSelectedConvKernel(algorithm, out_unit);
+    if (kernel != nullptr) {
+      break;
     }
   }
   return kernel;
@@ -18,12 +18,22 @@
 
 #include <vector>
 #include "src/litert/lite_kernel.h"
+#include "src/litert/kernel_autotuner.h"
 #include "nnacl/conv_parameter.h"
 #include "nnacl/matmul_parameter.h"
 #include "nnacl/op_base.h"
 
 using mindspore::lite::InnerContext;
 namespace mindspore::kernel {
+// Implementations the delegate can select for fp32 nhwc convolution, listed by static selection priority.
+enum ConvFp32Algorithm : int {
+  kConvAlgoWinograd = 0,
+  kConvAlgoSW1x1 = 1,
+  kConvAlgoSWAVX = 2,
+  kConvAlgo1x1 = 3,
+  kConvAlgoIm2Col = 4,
+};
+
 class ConvolutionDelegateCPUKernel : public LiteKernel {
  public:
   ConvolutionDelegateCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
@@ -91,7 +101,14 @@ class ConvolutionDelegateCPUKernel : public LiteKernel {
   kernel::LiteKernel *CpuConvFp32KernelSelect();
   kernel::LiteKernel *CpuConvFp32NC4KernelSelect();
   kernel::LiteKernel *CpuConvFp32NHWCKernelSelect();
-  kernel::LiteKernel *CreateConv1x1MatmulKernel();
+  kernel::LiteKernel *CreateConv1x1MatmulKernel(const ConvParameter *conv_param);
+  kernel::LiteKernel *CreateConvKernelByAlgorithm(int algorithm, int out_unit, OpParameter *param);
+  kernel::LiteKernel *CreateSelectedConvKernel(int algorithm, int out_unit);
+  std::vector<int> GetCandidateAlgorithms(ConvParameter *conv_param, int *out_unit);
+  std::vector<int> GetAutoTuneShapeInfo(const ConvParameter *conv_param) const;
+  int AutoTuneConvFp32NHWC(const std::vector<int> &candidates, int out_unit, const lite::AutoTuneConfig &config,
+                           lite::AutoTuneChoice *choice);
+  float MeasureConvAlgorithm(int algorithm, int out_unit, int thread_num, const lite::AutoTuneConfig &config);
   bool CheckAvxUseSW1x1Conv(const ConvParameter *conv_param);
   bool CheckAvxUseSWConv(const ConvParameter *conv_param);
   // If inferShape process can't complete in Init part, initialization of weight and bis will be implemented in runtime
@@ -16,6 +16,9 @@
 
 #include "src/litert/kernel/cpu/fp32/fullconnection_fp32.h"
 #include "src/litert/kernel_registry.h"
+#ifdef ENABLE_SPARSE_COMPUTE
+#include "src/litert/kernel/cpu/fp32_sparse/matmul_sparse_structured_fp32.h"
+#endif
 
 using mindspore::kernel::KERNEL_ARCH;
 using mindspore::lite::KernelRegistrar;
@@ -43,5 +46,19 @@ int FullconnectionCPUKernel::Run() {
   return matmul_base_->Run();
 }
 
-REG_KERNEL(kCPU, kNumberTypeFloat32, PrimitiveType_FullConnection, LiteKernelCreator<FullconnectionCPUKernel>)
+LiteKernel *FullconnectionFp32KernelCreator(const std::vector<lite::Tensor *> &inputs,
+                                            const std::vector<lite::Tensor *> &outputs, OpParameter *parameter,
+                                            const lite::InnerContext *ctx, const kernel::KernelKey &desc) {
+#ifdef ENABLE_SPARSE_COMPUTE
+  if (parameter != nullptr) {
+    auto sparse_kernel = CreateMatmulSparseStructuredCPUKernel(parameter, inputs, outputs, ctx);
+    if (sparse_kernel != nullptr) {
+      return sparse_kernel;
+    }
+  }
+#endif
+  return LiteKernelCreator<FullconnectionCPUKernel>(inputs, outputs, parameter, ctx, desc);
+}
+
+REG_KERNEL(kCPU, kNumberTypeFloat32, PrimitiveType_FullConnection, FullconnectionFp32KernelCreator)
 }  // namespace mindspore::kernel
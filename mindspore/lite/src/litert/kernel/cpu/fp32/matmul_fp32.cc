@@ -40,6 +40,10 @@
 #include "src/litert/kernel/cpu/fp32/matmul_fp32_arm64.h"
 #endif
 
+#ifdef ENABLE_SPARSE_COMPUTE
+#include "src/litert/kernel/cpu/fp32_sparse/matmul_sparse_structured_fp32.h"
+#endif
+
 using mindspore::lite::kCHWDimNumber;
 using mindspore::lite::KernelRegistrar;
 using mindspore::lite::kHWDimNumber;
@@ -111,5 +115,19 @@ MatmulFp32BaseCPUKernel *CreateMatmulFp32CPUKernel(OpParameter *parameter, const
   return kernel;
 }
 
-REG_KERNEL(kCPU, kNumberTypeFloat32, PrimitiveType_MatMulFusion, LiteKernelCreator<MatmulCPUKernel>)
+LiteKernel *MatmulFp32KernelCreator(const std::vector<lite::Tensor *> &inputs,
+                                    const std::vector<lite::Tensor *> &outputs, OpParameter *parameter,
+                                    const lite::InnerContext *ctx, const kernel::KernelKey &desc) {
+#ifdef ENABLE_SPARSE_COMPUTE
+  if (parameter != nullptr) {
+    auto sparse_kernel = CreateMatmulSparseStructuredCPUKernel(parameter, inputs, outputs, ctx);
+    if (sparse_kernel != nullptr) {
+      return sparse_kernel;
+    }
+  }
+#endif
+  return LiteKernelCreator<MatmulCPUKernel>(inputs, outputs, parameter, ctx, desc);
+}
+
+REG_KERNEL(kCPU, kNumberTypeFloat32, PrimitiveType_MatMulFusion, MatmulFp32KernelCreator)
 }  // namespace mindspore::kernel
@@ -0,0 +1,279 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/kernel/cpu/fp32_sparse/matmul_sparse_structured_fp32.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "include/errorcode.h"
+#include "nnacl/fp32/pack_fp32.h"
+#include "nnacl/fp32_sparse/matmul_sparse_structured_fp32.h"
+
+using mindspore::lite::RET_ERROR;
+using mindspore::lite::RET_OK;
+
+namespace mindspore::kernel {
+namespace {
+constexpr size_t kSparseMatmulMinInputNum = 2;
+constexpr size_t kSparseMatmulWeightRank = 2;
+constexpr size_t kSparseMatmulMinInputRank = 2;
+struct SparseNMPattern {
+  int n_;
+  int m_;
+};
+// sparser patterns first, the first one the weight conforms to is used.
+constexpr SparseNMPattern kSparseNMPatterns[] = {{1, 4}, {2, 8}, {2, 4}};
+
+void GetWeightDims(const lite::Tensor *weight, bool b_transpose, int *deep, int *col) {
+  auto shape = weight->shape();
+  *deep = b_transpose ? shape[1] : shape[0];
+  *col = b_transpose ? shape[0] : shape[1];
+}
+}  // namespace
+
+SparseStructuredInfo MatmulSparseStructuredCPUKernel::SelectFormat(const std::vector<lite::Tensor *> &inputs,
+                                                                   const MatMulParameter *param) {
+  SparseStructuredInfo info;
+  if (param == nullptr || param->op_parameter_.is_train_session_ || param->a_transpose_ ||
+      inputs.size() < kSparseMatmulMinInputNum) {
+    return info;
+  }
+  if (param->act_type_ != ActType_No && param->act_type_ != ActType_Relu && param->act_type_ != ActType_Relu6) {
+    return info;
+  }
+  auto input = inputs.at(0);
+  auto weight = inputs.at(kWeightIndex);
+  if (input == nullptr || weight == nullptr || !weight->IsConst() || weight->data_type() != kNumberTypeFloat32 ||
+      weight->shape().size() != kSparseMatmulWeightRank || input->shape().size() < kSparseMatmulMinInputRank) {
+    return info;
+  }
+  int deep = 0;
+  int col = 0;
+  GetWeightDims(weight, param->b_transpose_, &deep, &col);
+  if (deep <= 0 || col <= 0) {
+    return info;
+  }
+  if (inputs.size() > kBiasIndex) {
+    auto bias = inputs.at(kBiasIndex);
+    if (bias == nullptr || !bias->IsConst() || bias->data_type() != kNumberTypeFloat32 ||
+        bias->ElementsNum() != col) {
+      return info;
+    }
+  }
+
+  // The weight of a model whose constants are not loaded yet is left to the dense kernel.
+  auto weight_data = reinterpret_cast<const float *>(weight->data());
+  if (weight_data == nullptr) {
+    return info;
+  }
+  std::vector<int> block_offset(UP_DIV(col, SPARSE_BLOCK_TILE) + 1);
+  auto block_num = SparseBlockCount(weight_data, deep, col, param->b_transpose_, block_offset.data());
+  auto total_block_num = static_cast<float>(block_offset.size() - 1) * deep;
+  info.block_ratio_ = 1.0f - static_cast<float>(block_num) / total_block_num;
+  if (info.block_ratio_ >= kSparseBlockRatioThreshold) {
+    info.format_ = kSparseFormatBlock16x1;
+    return info;
+  }
+  for (auto &pattern : kSparseNMPatterns) {
+    if (static_cast<float>(pattern.n_) / pattern.m_ > 1.0f - kSparseBlockRatioThreshold) {
+      continue;
+    }
+    if (SparseNMCheck(weight_data, deep, col, param->b_transpose_, pattern.n_, pattern.m_)) {
+      info.format_ = kSparseFormatNM;
+      info.n_ = pattern.n_;
+      info.m_ = pattern.m_;
+      return info;
+    }
+  }
+  return info;
+}
+
+MatmulSparseStructuredCPUKernel::~MatmulSparseStructuredCPUKernel() {
+  FreePackedWeight();
+  if (bias_data_ != nullptr) {
+    free(bias_data_);
+    bias_data_ = nullptr;
+  }
+}
+
+void MatmulSparseStructuredCPUKernel::FreePackedWeight() {
+  if (deep_index_ != nullptr) {
+    free(deep_index_);
+    deep_index_ = nullptr;
+  }
+  if (weight_data_ != nullptr) {
+    free(weight_data_);
+    weight_data_ = nullptr;
+  }
+  if (weight_offset_ != nullptr) {
+    free(weight_offset_);
+    weight_offset_ = nullptr;
+  }
+}
+
+int MatmulSparseStructuredCPUKernel::PackWeight() {
+  auto weight = in_tensors_.at(kWeightIndex);
+  auto weight_data = reinterpret_cast<const float *>(weight->data());
+  CHECK_NULL_RETURN(weight_data);
+  FreePackedWeight();
+  if (info_.format_ == kSparseFormatBlock16x1) {
+    block_offset_.resize(UP_DIV(col_, SPARSE_BLOCK_TILE) + 1);
+    auto block_num = SparseBlockCount(weight_data, deep_, col_, params_->b_transpose_, block_offset_.data());
+    // keep one block at least, so that a weight with all zeros still gets valid buffers.
+    auto malloc_num = static_cast<size_t>(std::max(block_num, 1));
+    deep_index_ = reinterpret_cast<int *>(malloc(malloc_num * sizeof(int)));
+    weight_data_ = reinterpret_cast<float *>(malloc(malloc_num * SPARSE_BLOCK_TILE * sizeof(float)));
+    if (deep_index_ == nullptr || weight_data_ == nullptr) {
+      MS_LOG(ERROR) << "Malloc block sparse weight failed.";
+      return lite::RET_MEMORY_FAILED;
+    }
+    SparseBlockPack(weight_data, deep_, col_, params_->b_transpose_, block_offset_.data(), deep_index_, weight_data_);
+    MS_LOG(INFO) << name_ << " uses 16x1 block sparse weight, " << block_num << " of "
+                 << (block_offset_.size() - 1) * deep_ << " blocks are non-zero.";
+    return RET_OK;
+  }
+  MS_CHECK_TRUE_RET(info_.format_ == kSparseFormatNM && info_.n_ > 0 && info_.m_ > info_.n_, RET_ERROR);
+  auto item_num = static_cast<size_t>(col_) * UP_DIV(deep_, info_.m_) * info_.n_;
+  weight_data_ = reinterpret_cast<float *>(malloc(item_num * sizeof(float)));
+  weight_offset_ = reinterpret_cast<uint8_t *>(malloc(item_num * sizeof(uint8_t)));
+  if (weight_data_ == nullptr || weight_offset_ == nullptr) {
+    MS_LOG(ERROR) << "Malloc N:M sparse weight failed.";
+    return lite::RET_MEMORY_FAILED;
+  }
+  SparseNMPack(weight_data, deep_, col_, params_->b_transpose_, info_.n_, info_.m_, weight_data_, weight_offset_);
+  MS_LOG(INFO) << name_ << " uses " << info_.n_ << ":" << info_.m_ << " sparse weight.";
+  return RET_OK;
+}
+
+int MatmulSparseStructuredCPUKernel::PackBias() {
+  auto bias_size = static_cast<size_t>(UP_ROUND(col_, SPARSE_BLOCK_TILE)) * sizeof(float);
+  bias_data_ = reinterpret_cast<float *>(malloc(bias_size));
+  if (bias_data_ == nullptr) {
+    MS_LOG(ERROR) << "Malloc bias failed.";
+    return lite::RET_MEMORY_FAILED;
+  }
+  memset(bias_data_, 0, bias_size);
+  if (in_tensors_.size() > kBiasIndex) {
+    auto bias_tensor = in_tensors_.at(kBiasIndex);
+    CHECK_NULL_RETURN(bias_tensor->data());
+    memcpy(bias_data_, bias_tensor->data(), col_ * sizeof(float));
+  }
+  return RET_OK;
+}
+
+int MatmulSparseStructuredCPUKernel::Prepare() {
+  CHECK_LESS_RETURN(in_tensors_.size(), kSparseMatmulMinInputNum);
+  CHECK_LESS_RETURN(out_tensors_.size(), 1);
+  CHECK_NULL_RETURN(params_);
+  GetWeightDims(in_tensors_.at(kWeightIndex), params_->b_transpose_, &deep_, &col_);
+  MS_CHECK_TRUE_RET(deep_ > 0 && col_ > 0, RET_ERROR);
+  auto ret = PackWeight();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Pack sparse weight failed.";
+    return ret;
+  }
+  ret = PackBias();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Pack bias failed.";
+    return ret;
+  }
+  if (!InferShapeDone()) {
+    return RET_OK;
+  }
+  return ReSize();
+}
+
+int MatmulSparseStructuredCPUKernel::ReSize() {
+  auto input_num = in_tensors_.at(0)->ElementsNum();
+  if (input_num % deep_ != 0) {
+    MS_LOG(ERROR) << "Input element num " << input_num << " is not a multiple of deep " << deep_;
+    return RET_ERROR;
+  }
+  row_ = input_num / deep_;
+  if (out_tensors_.at(0)->ElementsNum() != row_ * col_) {
+    MS_LOG(ERROR) << "Output element num " << out_tensors_.at(0)->ElementsNum() << " does not match " << row_ << "x"
+                  << col_;
+    return RET_ERROR;
+  }
+  auto unit_num = info_.format_ == kSparseFormatBlock16x1 ? UP_DIV(col_, SPARSE_BLOCK_TILE) : col_;
+  thread_count_ = MSMAX(1, MSMIN(op_parameter_->thread_num_, unit_num));
+  task_stride_ = UP_DIV(unit_num, thread_count_);
+  return RET_OK;
+}
+
+int MatmulSparseStructuredCPUKernel::DoCompute(int task_id) {
+  auto unit_num = info_.format_ == kSparseFormatBlock16x1 ? UP_DIV(col_, SPARSE_BLOCK_TILE) : col_;
+  auto start = task_id * task_stride_;
+  auto end = MSMIN(unit_num, start + task_stride_);
+  if (start >= end) {
+    return RET_OK;
+  }
+  auto output = reinterpret_cast<float *>(out_tensors_.at(0)->data());
+  if (info_.format_ == kSparseFormatBlock16x1) {
+    auto input = reinterpret_cast<const float *>(in_tensors_.at(0)->data());
+    SparseBlockMatmulFp32(input, weight_data_, deep_index_, block_offset_.data(), bias_data_, output, row_, deep_,
+                          col_, start, end, params_->act_type_);
+  } else {
+    SparseNMMatmulFp32(input_transposed_, weight_data_, weight_offset_, bias_data_, output, row_, deep_, col_,
+                       info_.n_, info_.m_, start, end, params_->act_type_);
+  }
+  return RET_OK;
+}
+
+int SparseStructuredRun(void *cdata, int task_id, float, float) {
+  CHECK_NULL_RETURN(cdata);
+  auto kernel = reinterpret_cast<MatmulSparseStructuredCPUKernel *>(cdata);
+  auto ret = kernel->DoCompute(task_id);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "SparseStructuredRun error task_id[" << task_id << "] error_code[" << ret << "]";
+  }
+  return ret;
+}
+
+int MatmulSparseStructuredCPUKernel::Run() {
+  CHECK_NULL_RETURN(in_tensors_.at(0)->data());
+  CHECK_NULL_RETURN(out_tensors_.at(0)->data());
+  if (info_.format_ == kSparseFormatNM) {
+    // the N:M kernel vectorizes over rows, so the input is needed in deep x row.
+    input_transposed_ = reinterpret_cast<float *>(
+      ms_context_->allocator->Malloc(static_cast<size_t>(row_) * static_cast<size_t>(deep_) * sizeof(float)));
+    if (input_transposed_ == nullptr) {
+      MS_LOG(ERROR) << "Malloc transposed input failed.";
+      return lite::RET_MEMORY_FAILED;
+    }
+    PackNHWCToNCHWFp32(in_tensors_.at(0)->data(), input_transposed_, 1, row_, deep_, 0, 0);
+  }
+  auto ret = ParallelLaunch(this->ms_context_, SparseStructuredRun, this, thread_count_);
+  if (input_transposed_ != nullptr) {
+    ms_context_->allocator->Free(input_transposed_);
+    input_transposed_ = nullptr;
+  }
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "SparseStructuredRun failed.";
+  }
+  return ret;
+}
+
+LiteKernel *CreateMatmulSparseStructuredCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                                                  const std::vector<lite::Tensor *> &outputs,
+                                                  const lite::InnerContext *ctx) {
+  auto info = MatmulSparseStructuredCPUKernel::SelectFormat(inputs, reinterpret_cast<MatMulParameter *>(parameter));
+  if (info.format_ == kSparseFormatNone) {
+    return nullptr;
+  }
+  return new (std::nothrow) MatmulSparseStructuredCPUKernel(parameter, inputs, outputs, ctx, info);
+}
+}  // namespace mindspore::kernel
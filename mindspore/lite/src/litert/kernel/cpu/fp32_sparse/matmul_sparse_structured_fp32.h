@@ -0,0 +1,81 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
+
+#include <vector>
+#include "nnacl/matmul_parameter.h"
+#include "src/litert/lite_kernel.h"
+
+namespace mindspore::kernel {
+// ratio of zero 16x1 blocks from which the block sparse kernel is faster than the dense gemm.
+constexpr float kSparseBlockRatioThreshold = 0.5f;
+
+enum SparseStructuredFormat { kSparseFormatNone = 0, kSparseFormatBlock16x1, kSparseFormatNM };
+
+typedef struct SparseStructuredInfo {
+  SparseStructuredFormat format_ = kSparseFormatNone;
+  int n_ = 0;
+  int m_ = 0;
+  float block_ratio_ = 0.0f; /**< ratio of zero 16x1 blocks of the weight */
+} SparseStructuredInfo;
+
+// MatmulSparseStructuredCPUKernel runs a MatMul or FullConnection whose const weight is pruned to 16x1 blocks or to
+// N:M, the weight is packed once in Prepare and zero blocks are never loaded at run time.
+class MatmulSparseStructuredCPUKernel : public LiteKernel {
+ public:
+  MatmulSparseStructuredCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                                  const std::vector<lite::Tensor *> &outputs, const lite::InnerContext *ctx,
+                                  const SparseStructuredInfo &info)
+      : LiteKernel(parameter, inputs, outputs, ctx), info_(info) {
+    params_ = reinterpret_cast<MatMulParameter *>(op_parameter_);
+  }
+  ~MatmulSparseStructuredCPUKernel() override;
+  int Prepare() override;
+  int ReSize() override;
+  int Run() override;
+  int DoCompute(int task_id);
+
+  // Returns kSparseFormatNone if the dense kernel should be used.
+  static SparseStructuredInfo SelectFormat(const std::vector<lite::Tensor *> &inputs, const MatMulParameter *param);
+
+ private:
+  int PackWeight();
+  int PackBias();
+  void FreePackedWeight();
+
+  MatMulParameter *params_ = nullptr;
+  SparseStructuredInfo info_;
+  int row_ = 0;
+  int deep_ = 0;
+  int col_ = 0;
+  int thread_count_ = 1;
+  int task_stride_ = 0;
+  std::vector<int> block_offset_;
+  int *deep_index_ = nullptr;
+  float *weight_data_ = nullptr;
+  uint8_t *weight_offset_ = nullptr;
+  float *bias_data_ = nullptr;
+  float *input_transposed_ = nullptr;
+};
+
+// Creates the structured sparse kernel if the weight sparsity makes it worthwhile, otherwise returns nullptr.
+LiteKernel *CreateMatmulSparseStructuredCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                                                  const std::vector<lite::Tensor *> &outputs,
+                                                  const lite::InnerContext *ctx);
+}  // namespace mindspore::kernel
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_SPARSE_MATMUL_SPARSE_STRUCTURED_FP32_H_
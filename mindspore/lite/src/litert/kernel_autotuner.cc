@@ -0,0 +1,244 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/kernel_autotuner.h"
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "src/common/common.h"
+#include "src/common/log_adapter.h"
+#include "src/common/utils.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr const char *kDefaultTuningDbPath = "mslite_kernel_tuning.db";
+constexpr const char *kUnknownCpuModel = "unknown_cpu";
+constexpr char kKeySeparator = '|';
+
+std::string Trim(const std::string &str) {
+  auto begin = str.find_first_not_of(" \t");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  auto end = str.find_last_not_of(" \t\r\n");
+  return str.substr(begin, end - begin + 1);
+}
+
+// key of tuning db can not contain white space, which is the column separator of the db file.
+std::string NormalizeKeyItem(std::string item) {
+  std::replace_if(
+    item.begin(), item.end(), [](char c) { return c == ' ' || c == '\t' || c == kKeySeparator; }, '_');
+  return item;
+}
+}  // namespace
+
+AutoTuneConfig ParseAutoTuneConfig(const std::map<std::string, std::string> &section) {
+  AutoTuneConfig config;
+  auto enable_iter = section.find(kAutoTuneEnable);
+  if (enable_iter != section.end()) {
+    auto enable_opt = GenericParseValue<bool>(enable_iter->second);
+    config.enable_ = !enable_opt.IsNone() && enable_opt.Get();
+  }
+  if (!config.enable_) {
+    return config;
+  }
+  auto path_iter = section.find(kAutoTuneDbPath);
+  config.db_path_ = path_iter != section.end() ? path_iter->second : kDefaultTuningDbPath;
+  auto warm_up_iter = section.find(kAutoTuneWarmUpLoops);
+  if (warm_up_iter != section.end()) {
+    auto warm_up_opt = GenericParseValue<int>(warm_up_iter->second);
+    if (!warm_up_opt.IsNone() && warm_up_opt.Get() >= 0) {
+      config.warm_up_loops_ = warm_up_opt.Get();
+    }
+  }
+  auto loops_iter = section.find(kAutoTuneLoops);
+  if (loops_iter != section.end()) {
+    auto loops_opt = GenericParseValue<int>(loops_iter->second);
+    if (!loops_opt.IsNone() && loops_opt.Get() > 0) {
+      config.loops_ = loops_opt.Get();
+    }
+  }
+  return config;
+}
+
+KernelAutoTuner *KernelAutoTuner::GetInstance() {
+  static KernelAutoTuner instance;
+  return &instance;
+}
+
+std::string KernelAutoTuner::GetCpuModelName() {
+#if defined(__linux__) || defined(__ANDROID__)
+  std::ifstream infile("/proc/cpuinfo", std::ios::in);
+  if (!infile.is_open()) {
+    return kUnknownCpuModel;
+  }
+  // x86 reports "model name", arm reports "Hardware" or only the "CPU part" of each core.
+  std::string cpu_part;
+  std::string line;
+  while (std::getline(infile, line)) {
+    auto pos = line.find(':');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    auto name = Trim(line.substr(0, pos));
+    auto value = Trim(line.substr(pos + 1));
+    if (name == "model name" || name == "Hardware") {
+      return NormalizeKeyItem(value);
+    }
+    if (name == "CPU part" && cpu_part.empty()) {
+      cpu_part = "arm_part_" + value;
+    }
+  }
+  return cpu_part.empty() ? kUnknownCpuModel : NormalizeKeyItem(cpu_part);
+#else
+  return kUnknownCpuModel;
+#endif
+}
+
+int KernelAutoTuner::Init(const std::string &db_path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (cpu_model_.empty()) {
+    cpu_model_ = GetCpuModelName();
+  }
+  if (db_path == db_path_) {
+    return RET_OK;
+  }
+  if (!db_path_.empty() && dirty_) {
+    MS_LOG(WARNING) << "Tuning db changes from " << db_path_ << " to " << db_path << ", unsaved choices are dropped.";
+  }
+  db_path_ = db_path;
+  tuning_db_.clear();
+  dirty_ = false;
+  return LoadDb();
+}
+
+int KernelAutoTuner::LoadDb() {
+  std::ifstream infile(db_path_, std::ios::in);
+  if (!infile.is_open()) {
+    MS_LOG(INFO) << "Tuning db " << db_path_ << " does not exist, all kernels will be tuned.";
+    return RET_OK;
+  }
+  std::string line;
+  size_t line_num = 0;
+  while (std::getline(infile, line)) {
+    line_num++;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream line_stream(line);
+    std::string key;
+    AutoTuneChoice choice;
+    if (!(line_stream >> key >> choice.algorithm_ >> choice.thread_num_ >> choice.cost_us_)) {
+      MS_LOG(WARNING) << "Skip invalid line " << line_num << " of tuning db " << db_path_;
+      continue;
+    }
+    tuning_db_[key] = choice;
+  }
+  MS_LOG(INFO) << "Load " << tuning_db_.size() << " kernel choices from tuning db " << db_path_;
+  return RET_OK;
+}
+
+std::string KernelAutoTuner::MakeKey(const std::string &kernel_type, const std::vector<int> &shape_info) {
+  std::ostringstream key;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cpu_model_.empty()) {
+      cpu_model_ = GetCpuModelName();
+    }
+    key << cpu_model_;
+  }
+  key << kKeySeparator << NormalizeKeyItem(kernel_type) << kKeySeparator;
+  for (size_t i = 0; i < shape_info.size(); ++i) {
+    key << (i == 0 ? "" : ",") << shape_info[i];
+  }
+  return key.str();
+}
+
+bool KernelAutoTuner::Lookup(const std::string &key, AutoTuneChoice *choice) {
+  MS_CHECK_TRUE_RET(choice != nullptr, false);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = tuning_db_.find(key);
+  if (iter == tuning_db_.end()) {
+    return false;
+  }
+  *choice = iter->second;
+  return true;
+}
+
+void KernelAutoTuner::Record(const std::string &key, const AutoTuneChoice &choice) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tuning_db_[key] = choice;
+  dirty_ = true;
+}
+
+int KernelAutoTuner::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!dirty_ || db_path_.empty()) {
+    return RET_OK;
+  }
+  // write to a temporary file first, so that a concurrent loader never sees a half written db. The name is unique to
+  // the process and the flush, so that the tuners sharing the db in other processes do not write the same file.
+  static std::atomic<uint64_t> flush_count{0};
+#ifdef _WIN32
+  auto pid = _getpid();
+#else
+  auto pid = getpid();
+#endif
+  auto tmp_path = db_path_ + ".tmp" + std::to_string(pid) + "_" + std::to_string(flush_count++);
+  std::ofstream outfile(tmp_path, std::ios::out | std::ios::trunc);
+  if (!outfile.is_open()) {
+    MS_LOG(ERROR) << "Open tuning db " << tmp_path << " failed.";
+    return RET_ERROR;
+  }
+  outfile << "# key algorithm thread_num cost_us\n";
+  for (auto &item : tuning_db_) {
+    outfile << item.first << " " << item.second.algorithm_ << " " << item.second.thread_num_ << " "
+            << item.second.cost_us_ << "\n";
+  }
+  outfile.close();
+  if (outfile.fail() || std::rename(tmp_path.c_str(), db_path_.c_str()) != 0) {
+    MS_LOG(ERROR) << "Save tuning db " << db_path_ << " failed.";
+    (void)std::remove(tmp_path.c_str());
+    return RET_ERROR;
+  }
+  dirty_ = false;
+  return RET_OK;
+}
+
+float KernelAutoTuner::Measure(const std::function<int()> &func, int warm_up_loops, int loops) {
+  for (int i = 0; i < warm_up_loops; ++i) {
+    if (func() != RET_OK) {
+      return -1.0f;
+    }
+  }
+  loops = std::max(loops, 1);
+  auto start = GetTimeUs();
+  for (int i = 0; i < loops; ++i) {
+    if (func() != RET_OK) {
+      return -1.0f;
+    }
+  }
+  auto end = GetTimeUs();
+  return static_cast<float>(end - start) / loops;
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,80 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_AUTOTUNER_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_AUTOTUNER_H_
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "include/errorcode.h"
+
+namespace mindspore::lite {
+constexpr int kAutoTuneDefaultWarmUpLoops = 2;
+constexpr int kAutoTuneDefaultLoops = 5;
+
+typedef struct AutoTuneChoice {
+  int algorithm_ = -1;   /**< kernel specific implementation id, e.g. winograd or im2col for conv */
+  int thread_num_ = 0;   /**< thread num the winner was measured with */
+  float cost_us_ = 0.0f; /**< average cost of one run in micro seconds */
+} AutoTuneChoice;
+
+typedef struct AutoTuneConfig {
+  bool enable_ = false;
+  std::string db_path_;
+  int warm_up_loops_ = kAutoTuneDefaultWarmUpLoops;
+  int loops_ = kAutoTuneDefaultLoops;
+} AutoTuneConfig;
+
+// Parses the [autotune] section of the model config file.
+AutoTuneConfig ParseAutoTuneConfig(const std::map<std::string, std::string> &section);
+
+// KernelAutoTuner keeps the per-shape kernel choices measured on this host. Choices are keyed by cpu model, kernel
+// type and shape, and persisted to an on-disk tuning db, so that later model loads reuse them without benchmarking.
+class KernelAutoTuner {
+ public:
+  static KernelAutoTuner *GetInstance();
+  ~KernelAutoTuner() = default;
+
+  // Loads the tuning db once, later calls with the same path are no-ops.
+  int Init(const std::string &db_path);
+  std::string MakeKey(const std::string &kernel_type, const std::vector<int> &shape_info);
+  bool Lookup(const std::string &key, AutoTuneChoice *choice);
+  void Record(const std::string &key, const AutoTuneChoice &choice);
+  // Writes the tuning db back to disk if new choices were recorded since the last flush.
+  int Flush();
+
+  // Runs func warm_up_loops + loops times and returns the average cost of the measured loops in micro seconds, or a
+  // negative value if func failed.
+  static float Measure(const std::function<int()> &func, int warm_up_loops, int loops);
+  static std::string GetCpuModelName();
+
+ private:
+  KernelAutoTuner() = default;
+  int LoadDb();
+
+  std::mutex mutex_;
+  std::string db_path_;
+  std::string cpu_model_;
+  std::unordered_map<std::string, AutoTuneChoice> tuning_db_;
+  bool dirty_ = false;
+};
+}  // namespace mindspore::lite
+
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_KERNEL_AUTOTUNER_H_
@@ -389,8 +389,13 @@ int LiteOpActor::InitInputData() {
 
 void LiteOpActor::AsyncOutput(OpContext<Tensor> *context) {
   auto output_size = output_data_arrows_.size();
+  bool use_handle = output_actors_.size() == output_size;
   for (size_t i = 0; i < output_size; ++i) {
     auto data = outputs_data_[i];
+    if (use_handle && output_actors_[i] != nullptr) {
+      Async(output_actors_[i], &mindspore::OpActor<Tensor>::RunOpData, data.get(), context);
+      continue;
+    }
     Async(output_data_arrows_[i]->to_op_id_, get_actor_mgr(), &mindspore::OpActor<Tensor>::RunOpData, data.get(),
           context);
   }
@@ -416,6 +421,14 @@ int LiteOpActor::PrepareOutputData() {
     }
     outputs_data_[i] = data;
   }
+  // all actors of the graph are spawned before PostInit, so the receivers can be resolved once here.
+  output_actors_.assign(output_data_arrows_.size(), nullptr);
+  auto actor_mgr = get_actor_mgr();
+  if (actor_mgr != nullptr) {
+    for (size_t i = 0; i < output_data_arrows_.size(); i++) {
+      output_actors_[i] = actor_mgr->GetActor(output_data_arrows_[i]->to_op_id_).get();
+    }
+  }
   return RET_OK;
 }
 
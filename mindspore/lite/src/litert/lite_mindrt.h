@@ -93,6 +93,8 @@ class LiteOpActor : public OpActor<lite::Tensor> {
   kernel::KernelExec *kernel_;
   std::vector<size_t> results_index_{};
   std::vector<OpDataPtr<Tensor>> outputs_data_{};
+  // handles of the receivers of output_data_arrows_, so that AsyncOutput needs no name lookup.
+  std::vector<const ActorBase *> output_actors_{};
   std::vector<Tensor *> inputs_data_{};
   std::unordered_map<Tensor *, Tensor *> *isolate_input_map_ = nullptr; /* real obj in session */
   lite::InnerContext *ctx_ = nullptr;
@@ -19,6 +19,7 @@
 #include <vector>
 #include <utility>
 #include "src/litert/pack_weight_manager.h"
+#include "src/litert/kernel_autotuner.h"
 #include "src/litert/runtime_pass.h"
 #include "include/errorcode.h"
 #include "src/common/log_adapter.h"
@@ -556,6 +557,9 @@ int LiteSession::CompileGraph(Model *model) {
     is_running_.store(false);
     return ret;
   }
+  if (KernelAutoTuner::GetInstance()->Flush() != RET_OK) {
+    MS_LOG(WARNING) << "Save kernel tuning db failed, kernels will be tuned again at next load.";
+  }
 
   if (is_train_session_) {
     is_running_.store(false);
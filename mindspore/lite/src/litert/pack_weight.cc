@@ -64,6 +64,60 @@ STATUS PackWeight::InitWeightManagerByBuf(const char *model_buf, size_t model_si
     buf_model_weight_[model_buf] = model_const_weight;
     buf_model_weight_[model_buf]->allocator = allocator;
   }
+  LoadPackWeightCache(model_size, model_const_weight);
+  return RET_OK;
+}
+
+void PackWeight::SetPackWeightCachePath(const std::string &cache_path) {
+  std::lock_guard<std::mutex> lock(mtx_weight_);
+  cache_path_ = cache_path;
+}
+
+void PackWeight::LoadPackWeightCache(size_t model_size, ModelConstWeight *weight) {
+  weight->model_size = model_size;
+  if (cache_path_.empty()) {
+    return;
+  }
+  auto cache = std::make_shared<PackWeightCache>();
+  auto file_path = PackWeightCache::GetNumaFilePath(cache_path_, weight->numa_id);
+  if (cache->Load(file_path, model_size, weight->numa_id) == RET_OK) {
+    weight->cache = cache;
+  }
+}
+
+STATUS PackWeight::StorePackWeightCache() {
+  std::lock_guard<std::mutex> lock(mtx_weight_);
+  if (cache_path_.empty()) {
+    return RET_OK;
+  }
+  for (auto &item : buf_model_weight_) {
+    auto &model_weight = item.second;
+    // a mapped cache is complete, it was written from a fully packed model.
+    if (model_weight == nullptr || model_weight->cache != nullptr) {
+      continue;
+    }
+    std::vector<PackedTensorData> packed_tensors;
+    for (auto &pair : model_weight->origin_and_packed_pair) {
+      auto info_iter = model_weight->origin_tensor_info.find(pair.first);
+      auto size_iter = model_weight->packed_size.find(pair.first);
+      auto hash_iter = model_weight->origin_hash.find(pair.first);
+      if (pair.second == nullptr || info_iter == model_weight->origin_tensor_info.end() ||
+          size_iter == model_weight->packed_size.end() || hash_iter == model_weight->origin_hash.end()) {
+        continue;
+      }
+      packed_tensors.push_back(
+        {info_iter->second.first, info_iter->second.second, hash_iter->second, pair.second, size_iter->second});
+    }
+    if (packed_tensors.empty()) {
+      continue;
+    }
+    auto file_path = PackWeightCache::GetNumaFilePath(cache_path_, model_weight->numa_id);
+    auto ret = PackWeightCache::Store(file_path, model_weight->model_size, model_weight->numa_id, packed_tensors);
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "Store packed weight cache failed.";
+      return ret;
+    }
+  }
   return RET_OK;
 }
 
@@ -80,7 +134,8 @@ char *PackWeight::GetNumaModelBuf(const char *model_buf, int numa_id) {
   return model_buf_map_[model_buf][it];
 }
 
-STATUS PackWeight::StoreOriginTensorData(const char *model_buf, const void *origin_tensor_data) {
+STATUS PackWeight::StoreOriginTensorData(const char *model_buf, const void *origin_tensor_data, int tensor_index,
+                                         size_t origin_size) {
   std::lock_guard<std::mutex> lock(mtx_weight_);
   if (buf_model_weight_.find(model_buf) == buf_model_weight_.end()) {
     MS_LOG(ERROR) << "can not find model buf in store origin Tensor";
@@ -93,6 +148,7 @@ STATUS PackWeight::StoreOriginTensorData(const char *model_buf, const void *orig
     return RET_OK;
   }
   packed_pair.insert(std::make_pair(origin_tensor_data, nullptr));
+  model_weight->origin_tensor_info[origin_tensor_data] = std::make_pair(tensor_index, origin_size);
   return RET_OK;
 }
 
@@ -118,6 +174,11 @@ void *PackWeight::ReplaceFp16Data(void *origin_fp16_data, size_t size) {
         origin_and_packed_pair.insert(std::make_pair(data, nullptr));
         model_weight->fp16_fp32_data.insert(data);
         origin_and_packed_pair.erase(origin_fp16_data);
+        auto info_iter = model_weight->origin_tensor_info.find(origin_fp16_data);
+        if (info_iter != model_weight->origin_tensor_info.end()) {
+          model_weight->origin_tensor_info[data] = std::make_pair(info_iter->second.first, size);
+          model_weight->origin_tensor_info.erase(info_iter);
+        }
         fp16_fp32_data_pair_.insert(std::make_pair(origin_fp16_data, data));
         return data;
       }
@@ -170,17 +231,37 @@ void *PackWeight::GetPackData(const void *tensor_data, const size_t size, bool *
     if (packed_tensor_data != nullptr) {
       *is_packed = true;
       return packed_tensor_data;
-    } else {
-      auto weight_allocator = model_weight->allocator;
-      packed_tensor_data = weight_allocator->Malloc(size);
-      if (packed_tensor_data == nullptr) {
-        MS_LOG(ERROR) << "malloc failed.";
-        return nullptr;
+    }
+    auto cached_iter = model_weight->cached_packed_data.find(tensor_data);
+    if (cached_iter != model_weight->cached_packed_data.end()) {
+      *is_packed = true;
+      return const_cast<void *>(cached_iter->second);
+    }
+    auto info_iter = model_weight->origin_tensor_info.find(tensor_data);
+    if (!cache_path_.empty() && info_iter != model_weight->origin_tensor_info.end()) {
+      auto hash = PackWeightCache::DataHash(tensor_data, info_iter->second.second);
+      model_weight->origin_hash[tensor_data] = hash;
+      const void *cached_data = nullptr;
+      if (model_weight->cache != nullptr) {
+        cached_data = model_weight->cache->GetPackedData(info_iter->second.first, info_iter->second.second, hash, size);
       }
-      origin_packed_weight[tensor_data] = packed_tensor_data;
-      *is_packed = false;
-      return packed_tensor_data;
+      if (cached_data != nullptr) {
+        // packed data in the read-only mapped cache file is never written, nor freed by allocator.
+        model_weight->cached_packed_data[tensor_data] = cached_data;
+        *is_packed = true;
+        return const_cast<void *>(cached_data);
+      }
+    }
+    auto weight_allocator = model_weight->allocator;
+    packed_tensor_data = weight_allocator->Malloc(size);
+    if (packed_tensor_data == nullptr) {
+      MS_LOG(ERROR) << "malloc failed.";
+      return nullptr;
     }
+    origin_packed_weight[tensor_data] = packed_tensor_data;
+    model_weight->packed_size[tensor_data] = size;
+    *is_packed = false;
+    return packed_tensor_data;
   }
   *is_packed = false;
   MS_LOG(ERROR) << "can not find tensor data in origin tensor data.";
@@ -199,6 +280,7 @@ void PackWeight::FreePackedWeight(ModelConstWeight *weight) {
     }
   }
   weight->origin_and_packed_pair.clear();
+  weight->cached_packed_data.clear();
 }
 
 void PackWeight::FreeTensorData(ModelConstWeight *weight) {
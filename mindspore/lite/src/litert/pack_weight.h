@@ -27,6 +27,7 @@
 #include <memory>
 #include "src/tensor.h"
 #include "src/litert/lite_session.h"
+#include "src/litert/pack_weight_cache.h"
 namespace mindspore::lite {
 struct ModelConstWeight {
   // origin tensor data <-> packed tensor data
@@ -35,6 +36,16 @@ struct ModelConstWeight {
   int numa_id = -1;
   std::unordered_map<int, void *> tensors_data;
   std::set<void *> fp16_fp32_data;
+  // origin tensor data <-> tensor index and origin size, the key of packed data in packed weight cache
+  std::unordered_map<const void *, std::pair<int, size_t>> origin_tensor_info;
+  // origin tensor data <-> packed size
+  std::unordered_map<const void *, size_t> packed_size;
+  // origin tensor data <-> hash of the origin data taken before packing, validates the packed weight cache
+  std::unordered_map<const void *, uint64_t> origin_hash;
+  // origin tensor data <-> packed data mapped from packed weight cache, which is never freed by allocator
+  std::unordered_map<const void *, const void *> cached_packed_data;
+  size_t model_size = 0;
+  std::shared_ptr<PackWeightCache> cache = nullptr;
 };
 
 class PackWeight {
@@ -43,19 +54,24 @@ class PackWeight {
   ~PackWeight();
   STATUS InitWeightManagerByBuf(const char *model_buf, size_t model_size, int numa_id = -1, bool copy_buf = false);
   char *GetNumaModelBuf(const char *model_buf, int numa_id);
-  STATUS StoreOriginTensorData(const char *model_buf, const void *origin_tensor_data);
+  STATUS StoreOriginTensorData(const char *model_buf, const void *origin_tensor_data, int tensor_index,
+                               size_t origin_size);
   void *GetPackData(const void *tensor_data, const size_t size, bool *is_packed);
   STATUS ReplaceOriginTensorData(const char *model_buf, std::vector<Tensor *> *tensors, int tensor_index);
   void *ReplaceFp16Data(void *origin_fp16_data, size_t size);
   void FreePackWeight(std::vector<char *> model_bufs, bool all);
   void DeleteOriginModelBufInfo(const char *model_buf);
+  void SetPackWeightCachePath(const std::string &cache_path);
+  STATUS StorePackWeightCache();
 
  private:
+  void LoadPackWeightCache(size_t model_size, ModelConstWeight *weight);
   void FreePackedWeight(ModelConstWeight *weight);
   void FreeTensorData(ModelConstWeight *weight);
   void FreeFp16ToFp32Data(ModelConstWeight *weight);
 
   bool copy_buf_ = false;
+  std::string cache_path_;
   std::mutex mtx_weight_;
   std::unordered_map<const char *, ModelConstWeight *> buf_model_weight_;
   std::unordered_map<const char *, std::vector<int>> numa_model_buf_;
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/pack_weight_cache.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "src/common/log_adapter.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr size_t kPackWeightCacheAlign = 64;
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+constexpr size_t kHashFoldShift = 32;
+
+size_t AlignUp(size_t size) {
+  return (size + kPackWeightCacheAlign - 1) / kPackWeightCacheAlign * kPackWeightCacheAlign;
+}
+}  // namespace
+
+uint64_t PackWeightCache::DataHash(const void *data, size_t size) {
+  uint64_t hash = (kFnvOffsetBasis ^ static_cast<uint64_t>(size)) * kFnvPrime;
+  if (data == nullptr) {
+    return hash;
+  }
+  // fnv-1a on 8-byte words, folding the high half back after each multiply so every bit of a word is mixed.
+  auto bytes = static_cast<const uint8_t *>(data);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(uint64_t));
+    hash = (hash ^ word) * kFnvPrime;
+    hash ^= hash >> kHashFoldShift;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+std::string PackWeightCache::GetNumaFilePath(const std::string &cache_path, int numa_id) {
+  // every numa node maps its own file, so the shared page cache copy is first touched by workers on that node.
+  return numa_id < 0 ? cache_path : cache_path + ".numa" + std::to_string(numa_id);
+}
+
+PackWeightCache::~PackWeightCache() { Unmap(); }
+
+void PackWeightCache::Unmap() {
+#ifndef _WIN32
+  if (map_addr_ != nullptr) {
+    (void)munmap(map_addr_, map_size_);
+  }
+#endif
+  map_addr_ = nullptr;
+  map_size_ = 0;
+  entries_.clear();
+}
+
+int PackWeightCache::Load(const std::string &file_path, size_t model_size, int numa_id) {
+#ifdef _WIN32
+  MS_LOG(WARNING) << "Packed weight cache is not supported on windows.";
+  return RET_NOT_SUPPORT;
+#else
+  Unmap();
+  auto fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    MS_LOG(INFO) << "Packed weight cache " << file_path << " does not exist.";
+    return RET_ERROR;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(PackWeightCacheHeader)) {
+    MS_LOG(WARNING) << "Packed weight cache " << file_path << " is invalid.";
+    close(fd);
+    return RET_ERROR;
+  }
+  map_size_ = static_cast<size_t>(file_stat.st_size);
+  auto addr = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    MS_LOG(WARNING) << "Map packed weight cache " << file_path << " failed.";
+    map_size_ = 0;
+    return RET_ERROR;
+  }
+  map_addr_ = addr;
+
+  auto header = reinterpret_cast<const PackWeightCacheHeader *>(map_addr_);
+  if (memcmp(header->magic_, kPackWeightCacheMagic, kPackWeightCacheMagicLen) != 0 ||
+      header->model_size_ != model_size || header->numa_id_ != numa_id) {
+    MS_LOG(WARNING) << "Packed weight cache " << file_path << " does not match current model, ignore it.";
+    Unmap();
+    return RET_ERROR;
+  }
+  auto entry_end =
+    sizeof(PackWeightCacheHeader) + static_cast<size_t>(header->entry_num_) * sizeof(PackWeightCacheEntry);
+  if (entry_end > map_size_) {
+    MS_LOG(WARNING) << "Packed weight cache " << file_path << " is truncated.";
+    Unmap();
+    return RET_ERROR;
+  }
+  auto entries = reinterpret_cast<const PackWeightCacheEntry *>(static_cast<char *>(map_addr_) +
+                                                                 sizeof(PackWeightCacheHeader));
+  for (uint32_t i = 0; i < header->entry_num_; ++i) {
+    auto &entry = entries[i];
+    if (entry.offset_ < entry_end || entry.offset_ + entry.size_ > map_size_) {
+      MS_LOG(WARNING) << "Packed weight cache " << file_path << " has invalid entry " << i;
+      Unmap();
+      return RET_ERROR;
+    }
+    entries_[entry.tensor_index_] = entry;
+  }
+  MS_LOG(INFO) << "Map " << entries_.size() << " packed weights from " << file_path;
+  return RET_OK;
+#endif
+}
+
+const void *PackWeightCache::GetPackedData(int tensor_index, size_t origin_size, uint64_t origin_hash,
+                                           size_t size) const {
+  auto iter = entries_.find(tensor_index);
+  if (map_addr_ == nullptr || iter == entries_.end()) {
+    return nullptr;
+  }
+  if (iter->second.size_ != size) {
+    MS_LOG(WARNING) << "Packed size of tensor " << tensor_index << " changes from " << iter->second.size_ << " to "
+                    << size << ", repack it.";
+    return nullptr;
+  }
+  if (iter->second.origin_size_ != origin_size || iter->second.origin_hash_ != origin_hash) {
+    MS_LOG(WARNING) << "Origin data of tensor " << tensor_index << " changes, repack it.";
+    return nullptr;
+  }
+  return static_cast<const char *>(map_addr_) + iter->second.offset_;
+}
+
+int PackWeightCache::Store(const std::string &file_path, size_t model_size, int numa_id,
+                           const std::vector<PackedTensorData> &packed_tensors) {
+  PackWeightCacheHeader header;
+  memcpy(header.magic_, kPackWeightCacheMagic, kPackWeightCacheMagicLen);
+  header.model_size_ = model_size;
+  header.numa_id_ = numa_id;
+  header.entry_num_ = static_cast<uint32_t>(packed_tensors.size());
+
+  std::vector<PackWeightCacheEntry> entries;
+  size_t offset = AlignUp(sizeof(PackWeightCacheHeader) + packed_tensors.size() * sizeof(PackWeightCacheEntry));
+  for (auto &packed_tensor : packed_tensors) {
+    PackWeightCacheEntry entry;
+    entry.tensor_index_ = packed_tensor.tensor_index_;
+    entry.reserved_ = 0;
+    entry.origin_size_ = packed_tensor.origin_size_;
+    entry.origin_hash_ = packed_tensor.origin_hash_;
+    entry.offset_ = offset;
+    entry.size_ = packed_tensor.size_;
+    entries.push_back(entry);
+    offset = AlignUp(offset + packed_tensor.size_);
+  }
+
+  // other processes may be loading the cache at the same time, publish it by rename only when it is complete.
+#ifdef _WIN32
+  auto tmp_path = file_path + ".tmp";
+#else
+  auto tmp_path = file_path + ".tmp" + std::to_string(getpid());
+#endif
+  std::ofstream ofs(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    MS_LOG(ERROR) << "Open " << tmp_path << " failed.";
+    return RET_ERROR;
+  }
+  (void)ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  (void)ofs.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(PackWeightCacheEntry));
+  static const char kPadding[kPackWeightCacheAlign] = {0};
+  for (size_t i = 0; i < packed_tensors.size(); ++i) {
+    auto pos = static_cast<size_t>(ofs.tellp());
+    (void)ofs.write(kPadding, entries[i].offset_ - pos);
+    (void)ofs.write(static_cast<const char *>(packed_tensors[i].data_), packed_tensors[i].size_);
+  }
+  ofs.close();
+  if (ofs.fail() || std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+    MS_LOG(ERROR) << "Write packed weight cache " << file_path << " failed.";
+    (void)std::remove(tmp_path.c_str());
+    return RET_ERROR;
+  }
+  MS_LOG(INFO) << "Save " << packed_tensors.size() << " packed weights to " << file_path;
+  return RET_OK;
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_CACHE_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_CACHE_H_
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "include/errorcode.h"
+
+namespace mindspore::lite {
+constexpr char kPackWeightCacheMagic[] = "MSPWC02";
+constexpr size_t kPackWeightCacheMagicLen = 8;
+
+#pragma pack(push, 1)
+typedef struct PackWeightCacheHeader {
+  char magic_[kPackWeightCacheMagicLen];
+  uint64_t model_size_;
+  int32_t numa_id_;
+  uint32_t entry_num_;
+} PackWeightCacheHeader;
+
+typedef struct PackWeightCacheEntry {
+  int32_t tensor_index_;
+  uint32_t reserved_;
+  uint64_t origin_size_;
+  uint64_t origin_hash_; /**< hash of the whole origin data the packed data is packed from */
+  uint64_t offset_; /**< offset of the packed data from the beginning of the file */
+  uint64_t size_;
+} PackWeightCacheEntry;
+#pragma pack(pop)
+
+typedef struct PackedTensorData {
+  int tensor_index_;
+  size_t origin_size_;
+  uint64_t origin_hash_;
+  const void *data_;
+  size_t size_;
+} PackedTensorData;
+
+// PackWeightCache is the on-disk form of the packed weights of one model on one numa node. The file is written once,
+// later processes map it read-only, so that all replicas of a model share one page cache copy of the packed weights
+// and skip repacking at cold start. Packed data is keyed by the tensor index and validated against the size and the
+// hash of the whole origin data, so a weight changed in place of the same size is repacked instead of taken stale.
+//
+// layout: | header | entry * entry_num | packed data aligned to 64 bytes ... |
+class PackWeightCache {
+ public:
+  PackWeightCache() = default;
+  ~PackWeightCache();
+  PackWeightCache(const PackWeightCache &) = delete;
+  PackWeightCache &operator=(const PackWeightCache &) = delete;
+
+  // Maps the cache file, fails if it does not exist or was built from a model of another size or another numa node.
+  int Load(const std::string &file_path, size_t model_size, int numa_id);
+  // Returns nullptr unless the entry of tensor_index was packed from the same origin data into the same size.
+  const void *GetPackedData(int tensor_index, size_t origin_size, uint64_t origin_hash, size_t size) const;
+  bool IsLoaded() const { return map_addr_ != nullptr; }
+
+  static int Store(const std::string &file_path, size_t model_size, int numa_id,
+                   const std::vector<PackedTensorData> &packed_tensors);
+  static std::string GetNumaFilePath(const std::string &cache_path, int numa_id);
+  // Hashes every byte of the data, each weight is hashed once when it would otherwise be packed.
+  static uint64_t DataHash(const void *data, size_t size);
+
+ private:
+  void Unmap();
+
+  void *map_addr_ = nullptr;
+  size_t map_size_ = 0;
+  std::unordered_map<int, PackWeightCacheEntry> entries_;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_CACHE_H_
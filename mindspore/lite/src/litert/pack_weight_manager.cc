@@ -21,7 +21,13 @@ namespace {
 #ifndef __ANDROID__
 constexpr size_t kMemAlignSize = 64;
 #endif
+thread_local bool private_pack = false;
 }  // namespace
+
+PrivatePackGuard::PrivatePackGuard() : prev_private_pack_(private_pack) { private_pack = true; }
+
+PrivatePackGuard::~PrivatePackGuard() { private_pack = prev_private_pack_; }
+
 PackWeightManager *PackWeightManager::GetInstance() {
   static PackWeightManager instance;
   return &instance;
@@ -53,6 +59,29 @@ STATUS PackWeightManager::InitPackWeightByBuf(const char *model_buf, size_t mode
   return RET_OK;
 }
 
+void PackWeightManager::SetPackWeightCachePath(const std::string &cache_path) {
+#ifdef SHARING_MODEL_WEIGHT
+  if (pack_weight_ == nullptr) {
+    pack_weight_ = std::make_shared<PackWeight>();
+    if (pack_weight_ == nullptr) {
+      MS_LOG(ERROR) << "pack_weight_ is nullptr.";
+      return;
+    }
+  }
+  pack_weight_->SetPackWeightCachePath(cache_path);
+#endif
+  return;
+}
+
+STATUS PackWeightManager::StorePackWeightCache() {
+#ifdef SHARING_MODEL_WEIGHT
+  if (pack_weight_ != nullptr) {
+    return pack_weight_->StorePackWeightCache();
+  }
+#endif
+  return RET_OK;
+}
+
 STATUS PackWeightManager::InitPackWeight(const char *model_buf, size_t model_size, int numa_id) {
 #ifdef SHARING_MODEL_WEIGHT
   if (pack_weight_ == nullptr) {
@@ -104,7 +133,8 @@ STATUS PackWeightManager::StoreOriginTensorData(Model *model, std::vector<Tensor
           return RET_ERROR;
         }
       }
-      auto status = pack_weight_->StoreOriginTensorData(lite_model->buf, all_tensors->at(tensor_index)->data());
+      auto tensor = all_tensors->at(tensor_index);
+      auto status = pack_weight_->StoreOriginTensorData(lite_model->buf, tensor->data(), tensor_index, tensor->Size());
       if (status != RET_OK) {
         MS_LOG(DEBUG) << "data not packed.";
         return RET_ERROR;
@@ -155,6 +185,10 @@ void *PackWeightManager::MallocData(size_t size) {
 }
 
 void *PackWeightManager::GetPackData(const void *tensor_data, const size_t size, bool *is_packed) {
+  if (private_pack) {
+    *is_packed = false;
+    return MallocData(size);
+  }
 #ifdef SHARING_MODEL_WEIGHT
   if (pack_weight_ == nullptr) {
     void *data = MallocData(size);
@@ -180,6 +214,10 @@ void PackWeightManager::FreeData(void *tensor_data) {
 }
 
 void PackWeightManager::Free(void *tensor_data) {
+  if (private_pack) {
+    FreeData(tensor_data);
+    return;
+  }
 #ifdef SHARING_MODEL_WEIGHT
   if (pack_weight_ == nullptr) {
     FreeData(tensor_data);
@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_MANAGER_H_
 #define MINDSPORE_LITE_SRC_RUNTIME_PACK_WEIGHT_MANAGER_H_
 #include <memory>
+#include <string>
 #include <vector>
 #include "include/model.h"
 #include "include/errorcode.h"
@@ -25,6 +26,17 @@
 #include "src/litert/pack_weight.h"
 #endif
 namespace mindspore::lite {
+// Kernels created and destroyed on this thread while the guard is alive pack their weights into private buffers, which
+// are neither taken from nor shared with the other kernels, such as the candidates benchmarked by the autotune.
+class PrivatePackGuard {
+ public:
+  PrivatePackGuard();
+  ~PrivatePackGuard();
+
+ private:
+  bool prev_private_pack_;
+};
+
 class PackWeightManager {
  public:
   static PackWeightManager *GetInstance();
@@ -39,6 +51,9 @@ class PackWeightManager {
   void *ReplaceFp16Data(void *origin_fp16_data, size_t size, bool *replace);
   void FreePackWeight(std::vector<char *> model_bufs);
   void DeleteOriginModelBufInfo(const char *model_buf);
+  // Packed weights are loaded from and stored to cache_path, must be set before InitPackWeight.
+  void SetPackWeightCachePath(const std::string &cache_path);
+  STATUS StorePackWeightCache();
 
  private:
   void *MallocData(size_t size);
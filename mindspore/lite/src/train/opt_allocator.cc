@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 #include "src/train/opt_allocator.h"
+#include <algorithm>
 #include <limits>
+#include <numeric>
 #include "nnacl/op_base.h"
 
 namespace mindspore {
@@ -86,4 +88,106 @@ void OptAllocator::Free(size_t addr) {
   alloc_.erase(addr);
   Reorder(addr);
 }
+
+size_t OptPlanner::AddBlock(size_t size, int start, int end) {
+  Block block;
+  block.size = UP_DIV(size, align_size_) * align_size_;
+  block.lifetimes.emplace_back(start, end);
+  blocks_.push_back(block);
+  return blocks_.size() - 1;
+}
+
+void OptPlanner::AddLifetime(size_t id, int start, int end) { blocks_.at(id).lifetimes.emplace_back(start, end); }
+
+void OptPlanner::ExtendLifetime(size_t id, int end) {
+  auto &lifetime = blocks_.at(id).lifetimes.back();
+  lifetime.second = std::max(lifetime.second, end);
+}
+
+bool OptPlanner::Overlap(const Block &lhs, const Block &rhs) const {
+  for (auto &l : lhs.lifetimes) {
+    for (auto &r : rhs.lifetimes) {
+      if (l.first <= r.second && r.first <= l.second) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+size_t OptPlanner::PlaceInOrder(const std::vector<size_t> &order, std::vector<size_t> *offsets) const {
+  std::vector<size_t> placed;
+  size_t total = 0;
+  for (auto id : order) {
+    auto &block = blocks_[id];
+    // address ranges of the placed blocks alive together with this one
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (auto other : placed) {
+      if (Overlap(block, blocks_[other])) {
+        ranges.emplace_back(offsets->at(other), offsets->at(other) + blocks_[other].size);
+      }
+    }
+    std::sort(ranges.begin(), ranges.end());
+    size_t best_addr = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t addr = 0;
+    for (auto &range : ranges) {
+      if (range.first > addr) {
+        size_t gap = range.first - addr;
+        if (gap >= block.size && gap < best_gap) {
+          best_gap = gap;
+          best_addr = addr;
+        }
+      }
+      addr = std::max(addr, range.second);
+    }
+    if (best_addr == std::numeric_limits<size_t>::max()) {
+      best_addr = addr;
+    }
+    offsets->at(id) = best_addr;
+    total = std::max(total, best_addr + block.size);
+    placed.push_back(id);
+  }
+  return total;
+}
+
+size_t OptPlanner::Plan() {
+  std::vector<size_t> order(blocks_.size());
+  std::iota(order.begin(), order.end(), 0);
+  auto first_start = [this](size_t id) { return blocks_[id].lifetimes.front().first; };
+  auto length = [this](size_t id) {
+    int steps = 0;
+    for (auto &lifetime : blocks_[id].lifetimes) {
+      steps += lifetime.second - lifetime.first + 1;
+    }
+    return steps;
+  };
+  std::vector<std::vector<size_t>> orders;
+  // largest first
+  std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+    return blocks_[lhs].size > blocks_[rhs].size;
+  });
+  orders.push_back(order);
+  // longest lived first, so that they are packed at the bottom of the arena
+  std::stable_sort(order.begin(), order.end(), [&length](size_t lhs, size_t rhs) { return length(lhs) > length(rhs); });
+  orders.push_back(order);
+  // execution order, which is what the online OptAllocator sees
+  std::stable_sort(order.begin(), order.end(),
+                   [&first_start](size_t lhs, size_t rhs) { return first_start(lhs) < first_start(rhs); });
+  orders.push_back(order);
+
+  total_size_ = std::numeric_limits<size_t>::max();
+  for (auto &candidate : orders) {
+    std::vector<size_t> offsets(blocks_.size(), 0);
+    auto total = PlaceInOrder(candidate, &offsets);
+    if (total < total_size_) {
+      total_size_ = total;
+      offsets_ = offsets;
+    }
+  }
+  if (blocks_.empty()) {
+    total_size_ = 0;
+  }
+  return total_size_;
+}
 }  // namespace mindspore
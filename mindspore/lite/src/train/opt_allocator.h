@@ -18,6 +18,8 @@
 #define MINDSPORE_LITE_SRC_TRAIN_OPT_ALLOCATOR_H_
 
 #include <map>
+#include <utility>
+#include <vector>
 #include "include/api/allocator.h"
 
 namespace mindspore {
@@ -37,5 +39,33 @@ class OptAllocator {
   size_t heap_ = 0;
   size_t align_size_;
 };
+
+// OptPlanner places blocks whose lifetimes are all known in advance into one arena, in the spirit of SOMAS: blocks are
+// placed in a greedy order, each one at the best fitting gap between the placed blocks alive at the same time. Several
+// orders are tried and the smallest arena is kept. A block may have more than one lifetime, e.g. a recomputed tensor.
+class OptPlanner {
+ public:
+  explicit OptPlanner(size_t aligned_size = 32) : align_size_(aligned_size) {}
+  ~OptPlanner() = default;
+  // returns the id of the new block, lifetimes are inclusive execution steps.
+  size_t AddBlock(size_t size, int start, int end);
+  void AddLifetime(size_t id, int start, int end);
+  void ExtendLifetime(size_t id, int end);
+  size_t Plan();
+  size_t Offset(size_t id) const { return offsets_.at(id); }
+  size_t total_size() const { return total_size_; }
+
+ private:
+  struct Block {
+    size_t size;
+    std::vector<std::pair<int, int>> lifetimes;
+  };
+  bool Overlap(const Block &lhs, const Block &rhs) const;
+  size_t PlaceInOrder(const std::vector<size_t> &order, std::vector<size_t> *offsets) const;
+  std::vector<Block> blocks_;
+  std::vector<size_t> offsets_;
+  size_t total_size_ = 0;
+  size_t align_size_;
+};
 };      // namespace mindspore
 #endif  // MINDSPORE_LITE_SRC_TRAIN_OPT_ALLOCATOR_H_
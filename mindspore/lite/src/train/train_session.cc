@@ -53,6 +53,13 @@ void FreeGradients(const std::vector<lite::Tensor *> &gradients) {
 const char *kGradName = "Gradients";
 const char *kOptimizerName = "optimizer";
 
+// cheap and stateless kernels whose outputs are recomputed in the backward pass instead of kept alive
+std::set<schema::PrimitiveType> recomputeSupportedKernels = {
+  mindspore::schema::PrimitiveType_Activation, mindspore::schema::PrimitiveType_AddFusion,
+  mindspore::schema::PrimitiveType_SubFusion,  mindspore::schema::PrimitiveType_MulFusion,
+  mindspore::schema::PrimitiveType_BiasAdd,    mindspore::schema::PrimitiveType_Square,
+  mindspore::schema::PrimitiveType_Neg,        mindspore::schema::PrimitiveType_Abs};
+
 TrainSession::TrainSession() {
   is_train_session_ = true;
   InitCallBack();
@@ -96,6 +103,8 @@ void TrainSession::RestoreOps(const std::vector<CreatorOp> &restore) {
 }
 
 int TrainSession::AllocWorkSpace() {
+  // with the static allocator the workspaces are planned in the tensors arena by AllocTensors
+  if (IS_STATIC_ALLOCATOR(allocator_)) return RET_OK;
   size_t workspace_size = 0;
   for (auto kernel : this->train_kernels_) {
     if (workspace_size < static_cast<kernel::LiteKernel *>(kernel->kernel())->workspace_size()) {
@@ -261,41 +270,83 @@ int TrainSession::UpdateWeights(std::vector<lite::Tensor *> modify_tensors) {
 
 int TrainSession::AllocTensors(const std::vector<kernel::KernelExec *> &kernels) {
   if (!IS_STATIC_ALLOCATOR(allocator_)) return RET_OK;
-  OptAllocator allocator;
+  // uses of every definition of a tensor, a tensor of a recomputed kernel is defined more than once
+  std::unordered_map<lite::Tensor *, std::vector<int>> def_uses;
+  // uses in the kernel graph, the remaining of init_ref_count keeps outputs alive after the run
+  std::unordered_map<lite::Tensor *, int> graph_uses;
+  std::set<kernel::KernelExec *> seen;
+  for (auto kernel : kernels) {
+    bool first_run = seen.insert(kernel).second;
+    for (auto tensor : kernel->in_tensors()) {
+      auto iter = def_uses.find(tensor);
+      if (iter != def_uses.end()) {
+        iter->second.back()++;
+        graph_uses[tensor] += first_run ? 1 : 0;
+      }
+    }
+    for (auto tensor : kernel->out_tensors()) {
+      def_uses[tensor].push_back(0);
+    }
+  }
+
+  OptPlanner planner;
   std::unordered_map<lite::Tensor *, int> ref_count;
-  std::unordered_map<lite::Tensor *, size_t> offset_map;
-  int counter = 0;
-  uint32_t input_idx = 0;
-  for (auto &kernel : kernels) {
+  std::unordered_map<lite::Tensor *, size_t> block_map;
+  std::unordered_map<lite::Tensor *, size_t> def_index;
+  std::unordered_map<kernel::LiteKernel *, size_t> workspace_map;
+  int last_step = static_cast<int>(kernels.size());
+  for (int step = 0; step < last_step; step++) {
+    auto kernel = kernels[step];
     for (size_t i = 0; i < kernel->out_tensors().size(); i++) {
       auto tensor = kernel->out_tensors().at(i);
-      bool in_place = false;
-      if (counter != 0) {
-        in_place = IsInPlaceTensor(kernel, i, ref_count, &input_idx);
-      }
-      counter++;
-      size_t offset;
+      auto &uses = def_uses[tensor];
+      auto def = def_index[tensor]++;
+      bool last_def = def + 1 == uses.size();
+      // the references beyond the uses in the graph, e.g. of graph outputs, are kept as in init_ref_count
+      int extra_uses = last_def ? std::max(tensor->init_ref_count() - graph_uses[tensor], 0) : 0;
+      // unused outputs are kept as well, they may be read as outputs after the run
+      bool persistent = last_def && (extra_uses > 0 || graph_uses[tensor] == 0 || IsPersistentTensor(tensor));
+      bool recomputed = uses.size() > 1;
+      uint32_t input_idx = 0;
+      bool in_place = !recomputed && step != 0 && IsInPlaceTensor(kernel, i, ref_count, &input_idx) &&
+                      def_uses[kernel->in_tensors().at(input_idx)].size() == 1;
+      size_t block;
       if (in_place) {
-        offset = GetInplaceTensorOffset(kernel, offset_map, &ref_count, input_idx);
+        // the output takes over the block of an input at its last use, e.g. accumulating gradients with AddN
+        auto in_tensor = kernel->in_tensors().at(input_idx);
+        ref_count[in_tensor]++;
+        block = block_map.at(in_tensor);
+      } else if (block_map.find(tensor) != block_map.end()) {
+        block = block_map.at(tensor);
+        planner.AddLifetime(block, step, step);
+      } else {
+        block = planner.AddBlock(tensor->Size(), step, step);
+      }
+      if (persistent) {
+        planner.ExtendLifetime(block, last_step);
+      }
+      block_map[tensor] = block;
+      ref_count[tensor] = uses[def] + extra_uses;
+    }
+    auto lite_kernel = static_cast<kernel::LiteKernel *>(kernel->kernel());
+    if (lite_kernel->workspace_size() > 0 && !lite_kernel->ws_allocated_) {
+      auto iter = workspace_map.find(lite_kernel);
+      if (iter == workspace_map.end()) {
+        workspace_map[lite_kernel] = planner.AddBlock(lite_kernel->workspace_size(), step, step);
       } else {
-        size_t size = tensor->Size();
-        offset = allocator.Malloc(size);
+        planner.AddLifetime(iter->second, step, step);
       }
-      offset_map[tensor] = offset;
-      ref_count[tensor] = tensor->init_ref_count();
     }
     for (auto tensor : kernel->in_tensors()) {
-      if (tensor->category() == lite::Category::VAR) {
-        int count = ref_count[tensor] - 1;
-        ref_count[tensor] = count;
-        if (count == 0) {
-          allocator.Free(offset_map[tensor]);
-        }
+      auto iter = block_map.find(tensor);
+      if (tensor->category() == lite::Category::VAR && iter != block_map.end()) {
+        ref_count[tensor]--;
+        planner.ExtendLifetime(iter->second, step);
       }
     }
   }
   // Set Tensor data
-  auto size = allocator.total_size();
+  auto size = planner.Plan();
   if (size > tensors_data_size_) {
     free(tensors_data_);
     tensors_data_ = nullptr;
@@ -311,15 +362,104 @@ int TrainSession::AllocTensors(const std::vector<kernel::KernelExec *> &kernels)
     tensors_data_ = buf;
     tensors_data_size_ = size;
   }
-  for (auto kernel : train_kernels_) {
-    for (auto tensor : kernel->out_tensors()) {
-      auto it = offset_map.find(tensor);
-      if (it != offset_map.end()) {
-        tensor->set_data(reinterpret_cast<void *>(reinterpret_cast<uint8_t *>(tensors_data_) + it->second));
+  for (auto &item : block_map) {
+    item.first->set_data(reinterpret_cast<void *>(reinterpret_cast<uint8_t *>(tensors_data_) +
+                                                  planner.Offset(item.second)));
+  }
+  for (auto &item : workspace_map) {
+    item.first->set_workspace(reinterpret_cast<void *>(reinterpret_cast<uint8_t *>(tensors_data_) +
+                                                       planner.Offset(item.second)));
+  }
+  return RET_OK;
+}
+
+bool TrainSession::IsRecomputeKernel(kernel::KernelExec *kernel, const std::vector<kernel::KernelExec *> &kernels,
+                                     const std::unordered_map<lite::Tensor *, size_t> &last_use,
+                                     size_t *recompute_pos) {
+  if (recomputeSupportedKernels.find(kernel->type()) == recomputeSupportedKernels.end() || IsGradKernel(kernel) ||
+      IsLossKernel(kernel) || kernel->out_tensors().size() != 1) {
+    return false;
+  }
+  auto tensor = kernel->out_tensors().front();
+  if (tensor->category() != lite::Category::VAR || IsPersistentTensor(tensor)) {
+    return false;
+  }
+  auto pos = static_cast<size_t>(std::find(kernels.begin(), kernels.end(), kernel) - kernels.begin());
+  size_t forward_end = pos;
+  size_t grad_begin = kernels.size();
+  for (size_t i = pos + 1; i < kernels.size() && grad_begin == kernels.size(); i++) {
+    auto &in_tensors = kernels[i]->in_tensors();
+    if (std::find(in_tensors.begin(), in_tensors.end(), tensor) == in_tensors.end()) {
+      continue;
+    }
+    if (IsGradKernel(kernels[i])) {
+      grad_begin = i;
+    } else {
+      forward_end = i;
+    }
+  }
+  // only worth it if the tensor would be idle between the forward and the backward pass
+  if (grad_begin == kernels.size() || grad_begin <= forward_end + 1) {
+    return false;
+  }
+  for (auto in_tensor : kernel->in_tensors()) {
+    // inputs must still hold the same data when recomputing: either live anyway or never rewritten
+    auto iter = last_use.find(in_tensor);
+    if (iter != last_use.end() && iter->second < grad_begin) {
+      return false;
+    }
+    for (size_t i = 0; i < grad_begin; i++) {
+      auto &in_tensors = kernels[i]->in_tensors();
+      if (IsMaskOutput(kernels[i]) && std::find(in_tensors.begin(), in_tensors.end(), in_tensor) != in_tensors.end()) {
+        return false;
       }
     }
   }
-  return RET_OK;
+  *recompute_pos = grad_begin;
+  return true;
+}
+
+void TrainSession::CompileTrainSchedule() {
+  train_schedule_ = train_kernels_;
+  if (!cfg_.recompute_activations_ || !IS_STATIC_ALLOCATOR(allocator_) || context_->IsCpuFloat16Enabled()) {
+    return;
+  }
+  // last use of every tensor produced by a kernel, graph inputs and weights are not in the map
+  std::unordered_map<lite::Tensor *, size_t> last_use;
+  for (size_t i = 0; i < train_kernels_.size(); i++) {
+    for (auto tensor : train_kernels_[i]->out_tensors()) {
+      last_use[tensor] = tensor->IsGraphOutput() ? train_kernels_.size() : i;
+    }
+    for (auto tensor : train_kernels_[i]->in_tensors()) {
+      auto iter = last_use.find(tensor);
+      if (iter != last_use.end()) {
+        iter->second = std::max(iter->second, i);
+      }
+    }
+  }
+  std::map<size_t, std::vector<kernel::KernelExec *>> recompute_before;
+  std::set<lite::Tensor *> recomputed;
+  for (auto kernel : train_kernels_) {
+    size_t pos = 0;
+    bool chained = std::any_of(kernel->in_tensors().begin(), kernel->in_tensors().end(),
+                               [&recomputed](lite::Tensor *tensor) { return recomputed.count(tensor) > 0; });
+    if (!chained && IsRecomputeKernel(kernel, train_kernels_, last_use, &pos)) {
+      recompute_before[pos].push_back(kernel);
+      recomputed.insert(kernel->out_tensors().front());
+    }
+  }
+  if (recompute_before.empty()) {
+    return;
+  }
+  train_schedule_.clear();
+  for (size_t i = 0; i < train_kernels_.size(); i++) {
+    auto iter = recompute_before.find(i);
+    if (iter != recompute_before.end()) {
+      train_schedule_.insert(train_schedule_.end(), iter->second.begin(), iter->second.end());
+    }
+    train_schedule_.push_back(train_kernels_[i]);
+  }
+  MS_LOG(INFO) << recomputed.size() << " activations are recomputed in the backward pass";
 }
 
 int TrainSession::CompileGraph(lite::Model *model) { return lite::RET_ERROR; }
@@ -356,12 +496,13 @@ int TrainSession::CompileTrainGraph(std::shared_ptr<Model> model) {
     MS_LOG(ERROR) << "CompileInferenceKernels failed.";
     return RET_ERROR;
   }
+  CompileTrainSchedule();  // Prepare the train kernels with the recomputed ones
   ret = AllocWorkSpace();
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "failed to allocate space";
     return RET_ERROR;
   }
-  ret = AllocTensors(train_kernels_);
+  ret = AllocTensors(train_schedule_);
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "failed to allocate space";
     return RET_ERROR;
@@ -562,7 +703,7 @@ int TrainSession::RunGraph(const KernelCallBack &before, const KernelCallBack &a
     MS_LOG(ERROR) << "context is null";
     return lite::RET_NULL_PTR;
   }
-  auto &run_kernels = (train_mode_) ? train_kernels_ : inference_kernels_;
+  auto &run_kernels = (train_mode_) ? train_schedule_ : inference_kernels_;
   if (context_->IsCpuFloat16Enabled()) {
     ret = MixPrecisionExecKernels(before, after, run_kernels);
   } else {
@@ -611,7 +752,7 @@ int TrainSession::Train() {
     }
   }
   // allocate tensors
-  auto ret = AllocTensors(train_kernels_);
+  auto ret = AllocTensors(train_schedule_);
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "failed to allocate tensor space";
     return RET_ERROR;
@@ -1087,7 +1228,7 @@ int TrainSession::Resize(const std::vector<lite::Tensor *> &inputs, const std::v
     MS_LOG(ERROR) << "failed to allocate space";
     return RET_ERROR;
   }
-  ret = AllocTensors(train_kernels_);
+  ret = AllocTensors(train_schedule_);
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "train alloc failed after resize.";
     return RET_ERROR;
@@ -1274,7 +1415,8 @@ std::set<schema::PrimitiveType> inPlaceSupportedKernels = {
   mindspore::schema::PrimitiveType_Eltwise,    mindspore::schema::PrimitiveType_SquaredDifference,
   mindspore::schema::PrimitiveType_ExpandDims, mindspore::schema::PrimitiveType_Cast,
   mindspore::schema::PrimitiveType_Flatten,    mindspore::schema::PrimitiveType_FlattenGrad,
-  mindspore::schema::PrimitiveType_Squeeze,    mindspore::schema::PrimitiveType_Unsqueeze};
+  mindspore::schema::PrimitiveType_Squeeze,    mindspore::schema::PrimitiveType_Unsqueeze,
+  mindspore::schema::PrimitiveType_AddN};
 
 bool TrainSession::IsInPlaceKernel(kernel::KernelExec *kernel) {
   if (inPlaceSupportedKernels.find(kernel->type()) != inPlaceSupportedKernels.end() &&
@@ -1285,15 +1427,32 @@ bool TrainSession::IsInPlaceKernel(kernel::KernelExec *kernel) {
   return false;
 }
 
+bool TrainSession::IsPersistentTensor(lite::Tensor *tensor) const {
+  if (tensor->IsGraphOutput() || std::find(outputs_.begin(), outputs_.end(), tensor) != outputs_.end()) {
+    return true;
+  }
+  return std::any_of(eval_output_node_map_.begin(), eval_output_node_map_.end(), [tensor](const auto &outputs) {
+    return std::find(outputs.second.begin(), outputs.second.end(), tensor) != outputs.second.end();
+  });
+}
+
 bool TrainSession::IsInPlaceTensor(kernel::KernelExec *kernel, uint32_t idx,
                                    const std::unordered_map<lite::Tensor *, int> &ref_count, uint32_t *input_idx) {
   if (IsInPlaceKernel(kernel)) {
     auto out_tensor = kernel->out_tensors().at(idx);
+    // outputs are read after the run, they never share a buffer
+    if (IsPersistentTensor(out_tensor)) {
+      return false;
+    }
     for (size_t i = 0; i < kernel->in_tensors().size(); i++) {
       auto tensor = kernel->in_tensors().at(i);
+      // AddN reads the inputs after the second one once the output is written
+      if (kernel->type() == schema::PrimitiveType_AddN && i >= C2NUM) {
+        break;
+      }
       if ((tensor->category() == lite::Category::VAR) && (ref_count.find(tensor) != ref_count.end()) &&
           (tensor->init_ref_count() == 1 || (tensor->init_ref_count() > 1 && ref_count.at(tensor) == 1)) &&
-          (out_tensor->Size() == tensor->Size())) {
+          (out_tensor->Size() == tensor->Size()) && !IsPersistentTensor(tensor)) {
         *input_idx = static_cast<uint32_t>(i);
         return true;
       }
@@ -1301,13 +1460,5 @@ bool TrainSession::IsInPlaceTensor(kernel::KernelExec *kernel, uint32_t idx,
   }
   return false;
 }
-
-size_t TrainSession::GetInplaceTensorOffset(kernel::KernelExec *kernel,
-                                            const std::unordered_map<lite::Tensor *, size_t> &offset_map,
-                                            std::unordered_map<lite::Tensor *, int> *ref_count, uint32_t input_idx) {
-  auto tensor = kernel->in_tensors().at(input_idx);
-  ref_count->at(tensor) = ref_count->at(tensor) + 1;
-  return offset_map.at(tensor);
-}
 }  // namespace lite
 }  // namespace mindspore
@@ -133,6 +133,8 @@ class TrainSession : virtual public lite::LiteSession {
 
   std::vector<kernel::KernelExec *> inference_kernels_;
   std::vector<kernel::KernelExec *> train_kernels_;
+  // train_kernels_ with the recomputed kernels inserted again before their first gradient consumer
+  std::vector<kernel::KernelExec *> train_schedule_;
   TrainCfg cfg_;
 
  private:
@@ -152,12 +154,13 @@ class TrainSession : virtual public lite::LiteSession {
   bool AllInputsNeedScale(kernel::KernelExec *kernel);
   void FreeWorkSpace();
   int AllocTensors(const std::vector<kernel::KernelExec *> &kernels);
+  void CompileTrainSchedule();
+  bool IsRecomputeKernel(kernel::KernelExec *kernel, const std::vector<kernel::KernelExec *> &kernels,
+                         const std::unordered_map<lite::Tensor *, size_t> &last_use, size_t *recompute_pos);
+  bool IsPersistentTensor(lite::Tensor *tensor) const;
   bool IsInPlaceKernel(kernel::KernelExec *kernel);
   bool IsInPlaceTensor(kernel::KernelExec *kernel, uint32_t idx,
                        const std::unordered_map<lite::Tensor *, int> &ref_count, uint32_t *input_idx);
-  size_t GetInplaceTensorOffset(kernel::KernelExec *kernel,
-                                const std::unordered_map<lite::Tensor *, size_t> &offset_map,
-                                std::unordered_map<lite::Tensor *, int> *ref_count, uint32_t input_idx);
 
   std::map<Tensor *, Tensor *> restored_origin_tensors_;
   int virtual_batch_idx_ = 0;
@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 // #include <sys/time.h>
+#include <array>
+#include <atomic>
+#include <thread>
 #include "actor/actor.h"
 #include "actor/op_actor.h"
 #include "async/uuid_base.h"
 #include "async/future.h"
+#include "async/message_pool.h"
 #include "src/litert/lite_mindrt.h"
 #include "thread/hqueue.h"
 #include "thread/actor_threadpool.h"
@@ -158,4 +162,56 @@ TEST_F(LiteMindRtTest, ActorThreadPoolTest) {
   }
 }
 
+TEST_F(LiteMindRtTest, MessagePoolTest) {
+  auto small = [](ActorBase *) {};
+  auto cached = MessagePool::CachedSlots();
+  auto msg = new (std::nothrow) LocalMessageAsync<decltype(small)>(std::move(small));
+  ASSERT_NE(msg, nullptr);
+  delete msg;
+  ASSERT_EQ(MessagePool::CachedSlots(), cached + 1);
+  auto reused = new (std::nothrow) LocalMessageAsync<decltype(small)>(std::move(small));
+  ASSERT_EQ(MessagePool::CachedSlots(), cached);
+  delete reused;
+
+  std::array<char, MessagePool::kSlotSize> payload{};
+  auto large = [payload](ActorBase *) { (void)payload; };
+  cached = MessagePool::CachedSlots();
+  auto large_msg = new (std::nothrow) LocalMessageAsync<decltype(large)>(std::move(large));
+  ASSERT_NE(large_msg, nullptr);
+  delete large_msg;
+  ASSERT_EQ(MessagePool::CachedSlots(), cached);
+}
+
+class CountActor : public ActorBase {
+ public:
+  explicit CountActor(const std::string &nm, ActorThreadPool *pool) : ActorBase(nm, pool) {}
+  void Add(int value) { count_ += value; }
+
+  std::atomic<int> count_{0};
+};
+
+TEST_F(LiteMindRtTest, LocalMessageTest) {
+  Initialize("", "", "", "", 2);
+  auto pool = ActorThreadPool::CreateThreadPool(2);
+  auto actor = std::make_shared<CountActor>("count_actor", pool);
+  AID aid = Spawn(actor);
+  const int msg_num = 200000;
+
+  auto send = [&actor, msg_num](const std::function<void()> &send_one) {
+    actor->count_ = 0;
+    for (int i = 0; i < msg_num; i++) {
+      send_one();
+    }
+    while (actor->count_.load() < msg_num) {
+      std::this_thread::yield();
+    }
+  };
+  send([&aid]() { Async(aid, &CountActor::Add, 1); });
+  ASSERT_EQ(actor->count_.load(), msg_num);
+  send([&actor]() { Async(actor.get(), &CountActor::Add, 1); });
+  ASSERT_EQ(actor->count_.load(), msg_num);
+
+  Finalize();
+}
+
 }  // namespace mindspore
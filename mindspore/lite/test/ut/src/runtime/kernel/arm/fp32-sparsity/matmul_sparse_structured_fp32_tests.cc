@@ -0,0 +1,215 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "common/common_test.h"
+#include "nnacl/matmul_parameter.h"
+#include "nnacl/fp32_sparse/matmul_sparse_structured_fp32.h"
+#include "src/tensor.h"
+#include "src/litert/inner_context.h"
+#include "src/litert/kernel/cpu/fp32_sparse/matmul_sparse_structured_fp32.h"
+
+namespace mindspore {
+using mindspore::lite::Tensor;
+
+class TestSparseStructuredFp32 : public mindspore::CommonTest {
+ public:
+  TestSparseStructuredFp32() = default;
+
+ protected:
+  // weight is col x deep, as FullConnection keeps it.
+  std::vector<float> RefMatmul(const std::vector<float> &a, const std::vector<float> &weight,
+                               const std::vector<float> &bias, int row, int deep, int col) {
+    std::vector<float> out(row * col);
+    for (int r = 0; r < row; ++r) {
+      for (int c = 0; c < col; ++c) {
+        float acc = bias[c];
+        for (int k = 0; k < deep; ++k) {
+          acc += a[r * deep + k] * weight[c * deep + k];
+        }
+        out[r * col + c] = acc > 0.0f ? acc : 0.0f;
+      }
+    }
+    return out;
+  }
+
+  std::vector<float> RandomData(int num) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> data(num);
+    for (auto &value : data) {
+      value = dist(engine_);
+    }
+    return data;
+  }
+
+  // zeros three quarters of the 16x1 blocks.
+  std::vector<float> BlockSparseWeight(int deep, int col) {
+    auto weight = RandomData(deep * col);
+    for (int c = 0; c < col; ++c) {
+      for (int k = 0; k < deep; ++k) {
+        if ((k + c / SPARSE_BLOCK_TILE) % 4 != 0) {
+          weight[c * deep + k] = 0.0f;
+        }
+      }
+    }
+    return weight;
+  }
+
+  // keeps 2 of every 4 input channels, shifted by output channel, so that no 16x1 block is all zero.
+  std::vector<float> NMSparseWeight(int deep, int col) {
+    auto weight = RandomData(deep * col);
+    for (int c = 0; c < col; ++c) {
+      for (int k = 0; k < deep; ++k) {
+        if ((k + c) % 4 >= 2) {
+          weight[c * deep + k] = 0.0f;
+        }
+      }
+    }
+    return weight;
+  }
+
+  float RunKernel(const std::vector<float> &a, const std::vector<float> &weight, const std::vector<float> &bias,
+                  int row, int deep, int col, kernel::SparseStructuredFormat expect_format) {
+    auto in_t = new Tensor(kNumberTypeFloat32, {row, deep}, mindspore::NHWC, lite::Category::VAR);
+    in_t->MallocData();
+    memcpy(in_t->MutableData(), a.data(), a.size() * sizeof(float));
+    auto weight_t = new Tensor(kNumberTypeFloat32, {col, deep}, mindspore::NHWC, lite::Category::CONST_TENSOR);
+    weight_t->MallocData();
+    memcpy(weight_t->MutableData(), weight.data(), weight.size() * sizeof(float));
+    auto bias_t = new Tensor(kNumberTypeFloat32, {col}, mindspore::NHWC, lite::Category::CONST_TENSOR);
+    bias_t->MallocData();
+    memcpy(bias_t->MutableData(), bias.data(), bias.size() * sizeof(float));
+    auto out_t = new Tensor(kNumberTypeFloat32, {row, col}, mindspore::NHWC, lite::Category::VAR);
+    out_t->MallocData();
+    std::vector<lite::Tensor *> inputs = {in_t, weight_t, bias_t};
+    std::vector<lite::Tensor *> outputs = {out_t};
+
+    auto param = new MatMulParameter();
+    param->b_transpose_ = true;
+    param->act_type_ = ActType_Relu;
+    auto ctx = new lite::InnerContext;
+    ctx->thread_num_ = 2;
+    EXPECT_EQ(lite::RET_OK, ctx->Init());
+    auto info = kernel::MatmulSparseStructuredCPUKernel::SelectFormat(inputs, param);
+    EXPECT_EQ(info.format_, expect_format);
+    auto kernel = kernel::CreateMatmulSparseStructuredCPUKernel(reinterpret_cast<OpParameter *>(param), inputs,
+                                                                outputs, ctx);
+    float error = -1.0f;
+    if (kernel != nullptr) {
+      EXPECT_EQ(lite::RET_OK, kernel->Prepare());
+      EXPECT_EQ(lite::RET_OK, kernel->Run());
+      auto expect = RefMatmul(a, weight, bias, row, deep, col);
+      auto out = reinterpret_cast<float *>(out_t->MutableData());
+      error = 0.0f;
+      for (int i = 0; i < row * col; ++i) {
+        error = std::max(error, std::abs(out[i] - expect[i]));
+      }
+      delete kernel;
+    } else {
+      delete param;
+    }
+    delete ctx;
+    for (auto t : inputs) delete t;
+    for (auto t : outputs) delete t;
+    return error;
+  }
+
+  std::mt19937 engine_{2022};
+};
+
+TEST_F(TestSparseStructuredFp32, BlockPack) {
+  const int deep = 3;
+  const int col = 20;
+  std::vector<float> weight(deep * col, 0.0f);
+  weight[1 * col + 2] = 1.0f;   // tile 0, deep 1
+  weight[2 * col + 17] = 2.0f;  // tile 1, deep 2
+  weight[0 * col + 19] = 3.0f;  // tile 1, deep 0
+  int block_offset[3] = {0};
+  ASSERT_EQ(3, SparseBlockCount(weight.data(), deep, col, false, block_offset));
+  ASSERT_EQ(1, block_offset[1]);
+  int deep_index[3] = {0};
+  float data[3 * SPARSE_BLOCK_TILE] = {0};
+  SparseBlockPack(weight.data(), deep, col, false, block_offset, deep_index, data);
+  ASSERT_EQ(1, deep_index[0]);
+  ASSERT_EQ(0, deep_index[1]);
+  ASSERT_EQ(2, deep_index[2]);
+  ASSERT_EQ(1.0f, data[2]);
+  ASSERT_EQ(3.0f, data[SPARSE_BLOCK_TILE + 3]);
+  ASSERT_EQ(2.0f, data[2 * SPARSE_BLOCK_TILE + 1]);
+  ASSERT_EQ(0.0f, data[2 * SPARSE_BLOCK_TILE + 4]);  // padding of the last tile
+}
+
+TEST_F(TestSparseStructuredFp32, NMCheck) {
+  const int deep = 6;
+  const int col = 2;
+  std::vector<float> weight = {1, 0, 2, 0, 3, 0, 0, 1, 1, 0, 0, 5};
+  ASSERT_TRUE(SparseNMCheck(weight.data(), deep, col, true, 2, 4));
+  ASSERT_FALSE(SparseNMCheck(weight.data(), deep, col, true, 1, 4));
+  std::vector<float> data(col * 2 * 2);
+  std::vector<uint8_t> offset(col * 2 * 2);
+  SparseNMPack(weight.data(), deep, col, true, 2, 4, data.data(), offset.data());
+  std::vector<float> expect_data = {1, 2, 3, 0, 1, 1, 5, 0};
+  std::vector<uint8_t> expect_offset = {0, 2, 0, 0, 1, 2, 1, 0};
+  ASSERT_EQ(expect_data, data);
+  ASSERT_EQ(expect_offset, offset);
+}
+
+TEST_F(TestSparseStructuredFp32, BlockSparseKernel) {
+  const int row = 7;
+  const int deep = 40;
+  const int col = 50;
+  auto error = RunKernel(RandomData(row * deep), BlockSparseWeight(deep, col), RandomData(col), row, deep, col,
+                         kernel::kSparseFormatBlock16x1);
+  ASSERT_GE(error, 0.0f);
+  ASSERT_LE(error, 1e-4);
+}
+
+TEST_F(TestSparseStructuredFp32, NMSparseKernel) {
+  const int row = 21;
+  const int deep = 38;
+  const int col = 9;
+  auto error = RunKernel(RandomData(row * deep), NMSparseWeight(deep, col), RandomData(col), row, deep, col,
+                         kernel::kSparseFormatNM);
+  ASSERT_GE(error, 0.0f);
+  ASSERT_LE(error, 1e-4);
+}
+
+TEST_F(TestSparseStructuredFp32, DenseWeightFallback) {
+  const int row = 4;
+  const int deep = 16;
+  const int col = 16;
+  auto error = RunKernel(RandomData(row * deep), RandomData(deep * col), RandomData(col), row, deep, col,
+                         kernel::kSparseFormatNone);
+  ASSERT_LT(error, 0.0f);
+}
+
+TEST_F(TestSparseStructuredFp32, NullWeightFallback) {
+  const int deep = 16;
+  const int col = 16;
+  auto in_t = new Tensor(kNumberTypeFloat32, {4, deep}, mindspore::NHWC, lite::Category::VAR);
+  auto weight_t = new Tensor(kNumberTypeFloat32, {col, deep}, mindspore::NHWC, lite::Category::CONST_TENSOR);
+  std::vector<lite::Tensor *> inputs = {in_t, weight_t};
+  MatMulParameter param{};
+  param.b_transpose_ = true;
+  param.act_type_ = ActType_No;
+  auto info = kernel::MatmulSparseStructuredCPUKernel::SelectFormat(inputs, &param);
+  EXPECT_EQ(info.format_, kernel::kSparseFormatNone);
+  for (auto t : inputs) delete t;
+}
+}  // namespace mindspore
@@ -0,0 +1,156 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "src/common/common.h"
+#include "src/litert/kernel_autotuner.h"
+#include "src/litert/kernel_registry.h"
+#include "nnacl/conv_parameter.h"
+
+namespace mindspore {
+namespace {
+constexpr const char *kConvAutoTuneDbPath = "./conv_autotune_fp32_test.db";
+constexpr int kBatch = 1;
+constexpr int kHeight = 6;
+constexpr int kWidth = 6;
+constexpr int kInChannel = 4;
+constexpr int kOutChannel = 8;
+constexpr int kKernelSize = 3;
+constexpr int kThreadNum = 2;
+
+ConvParameter *CreateConvParam() {
+  auto conv_param = reinterpret_cast<ConvParameter *>(malloc(sizeof(ConvParameter)));
+  memset(conv_param, 0, sizeof(ConvParameter));
+  conv_param->op_parameter_.type_ = schema::PrimitiveType_Conv2DFusion;
+  conv_param->op_parameter_.thread_num_ = kThreadNum;
+  conv_param->kernel_h_ = conv_param->kernel_w_ = kKernelSize;
+  conv_param->stride_h_ = conv_param->stride_w_ = 1;
+  conv_param->dilation_h_ = conv_param->dilation_w_ = 1;
+  conv_param->pad_u_ = conv_param->pad_d_ = conv_param->pad_l_ = conv_param->pad_r_ = 1;
+  conv_param->group_ = 1;
+  conv_param->input_channel_ = kInChannel;
+  conv_param->output_channel_ = kOutChannel;
+  conv_param->act_type_ = ActType_No;
+  return conv_param;
+}
+
+// nhwc input, ohwi weight, same padding.
+std::vector<float> NaiveConv(const std::vector<float> &input, const std::vector<float> &weight,
+                             const std::vector<float> &bias) {
+  std::vector<float> output(kBatch * kHeight * kWidth * kOutChannel, 0);
+  for (int h = 0; h < kHeight; ++h) {
+    for (int w = 0; w < kWidth; ++w) {
+      for (int oc = 0; oc < kOutChannel; ++oc) {
+        float sum = bias[oc];
+        for (int kh = 0; kh < kKernelSize; ++kh) {
+          for (int kw = 0; kw < kKernelSize; ++kw) {
+            int ih = h + kh - 1;
+            int iw = w + kw - 1;
+            if (ih < 0 || ih >= kHeight || iw < 0 || iw >= kWidth) {
+              continue;
+            }
+            for (int ic = 0; ic < kInChannel; ++ic) {
+              sum += input[(ih * kWidth + iw) * kInChannel + ic] *
+                     weight[((oc * kKernelSize + kh) * kKernelSize + kw) * kInChannel + ic];
+            }
+          }
+        }
+        output[(h * kWidth + w) * kOutChannel + oc] = sum;
+      }
+    }
+  }
+  return output;
+}
+}  // namespace
+
+class TestConvAutoTuneFp32 : public mindspore::CommonTest {
+ public:
+  TestConvAutoTuneFp32() = default;
+  void SetUp() override { (void)std::remove(kConvAutoTuneDbPath); }
+  void TearDown() override { (void)std::remove(kConvAutoTuneDbPath); }
+};
+
+/// Feature: Autotune of the fp32 convolution.
+/// Description: Benchmark the candidates of a conv at load time, then load the conv again with the recorded choice.
+/// Expectation: Both kernels compute the same output as the reference, and the choice is stored in the tuning db.
+TEST_F(TestConvAutoTuneFp32, AutoTuneAndReuse) {
+  std::vector<float> input_data(kBatch * kHeight * kWidth * kInChannel);
+  std::vector<float> weight_data(kOutChannel * kKernelSize * kKernelSize * kInChannel);
+  std::vector<float> bias_data(kOutChannel);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>(i % 7) * 0.25f - 0.5f;
+  }
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<float>(i % 5) * 0.1f - 0.2f;
+  }
+  for (size_t i = 0; i < bias_data.size(); ++i) {
+    bias_data[i] = static_cast<float>(i) * 0.01f;
+  }
+  auto expect = NaiveConv(input_data, weight_data, bias_data);
+
+  std::map<std::string, std::map<std::string, std::string>> config;
+  config[lite::kAutoTune][lite::kAutoTuneEnable] = "true";
+  config[lite::kAutoTune][lite::kAutoTuneDbPath] = kConvAutoTuneDbPath;
+  config[lite::kAutoTune][lite::kAutoTuneWarmUpLoops] = "1";
+  config[lite::kAutoTune][lite::kAutoTuneLoops] = "2";
+
+  auto ctx = new lite::InnerContext();
+  ctx->thread_num_ = kThreadNum;
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  kernel::KernelKey desc = {kernel::KERNEL_ARCH::kCPU, kNumberTypeFloat32, NHWC, schema::PrimitiveType_Conv2DFusion};
+  auto creator = lite::KernelRegistry::GetInstance()->GetCreator(desc);
+  ASSERT_NE(creator, nullptr);
+
+  // the first load benchmarks the candidates, the second one takes the choice recorded by the first.
+  for (int load = 0; load < 2; ++load) {
+    lite::Tensor input(kNumberTypeFloat32, {kBatch, kHeight, kWidth, kInChannel}, NHWC);
+    lite::Tensor weight(kNumberTypeFloat32, {kOutChannel, kKernelSize, kKernelSize, kInChannel}, NHWC,
+                        lite::Category::CONST_TENSOR);
+    lite::Tensor bias(kNumberTypeFloat32, {kOutChannel}, NHWC, lite::Category::CONST_TENSOR);
+    lite::Tensor output(kNumberTypeFloat32, {kBatch, kHeight, kWidth, kOutChannel}, NHWC);
+    ASSERT_EQ(weight.MallocData(), lite::RET_OK);
+    ASSERT_EQ(bias.MallocData(), lite::RET_OK);
+    memcpy(weight.data(), weight_data.data(), weight.Size());
+    memcpy(bias.data(), bias_data.data(), bias.Size());
+    std::vector<lite::Tensor *> inputs = {&input, &weight, &bias};
+    std::vector<lite::Tensor *> outputs = {&output};
+
+    auto kernel = creator(inputs, outputs, reinterpret_cast<OpParameter *>(CreateConvParam()), ctx, desc);
+    ASSERT_NE(kernel, nullptr);
+    kernel->SetConfig(&config);
+    ASSERT_EQ(kernel->Prepare(), lite::RET_OK);
+    if (load == 0) {
+      ASSERT_EQ(lite::KernelAutoTuner::GetInstance()->Flush(), lite::RET_OK);
+      std::ifstream db(kConvAutoTuneDbPath);
+      ASSERT_TRUE(db.good());
+    }
+
+    // the graph tensors are only allocated at run time.
+    ASSERT_EQ(input.MallocData(), lite::RET_OK);
+    ASSERT_EQ(output.MallocData(), lite::RET_OK);
+    memcpy(input.data(), input_data.data(), input.Size());
+    ASSERT_EQ(kernel->Run(), lite::RET_OK);
+    ASSERT_EQ(0, CompareOutputData(reinterpret_cast<float *>(output.data()), expect.data(), expect.size(), 0.0001));
+    delete kernel;
+  }
+  delete ctx;
+}
+}  // namespace mindspore
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vector>
+#include "common/common_test.h"
+#include "src/train/opt_allocator.h"
+
+namespace mindspore {
+class TestOptPlanner : public mindspore::CommonTest {
+ public:
+  TestOptPlanner() {}
+};
+
+TEST_F(TestOptPlanner, DisjointLifetimesShareMemory) {
+  OptPlanner planner(32);
+  auto a = planner.AddBlock(100, 0, 5);
+  auto b = planner.AddBlock(64, 1, 2);
+  auto c = planner.AddBlock(64, 3, 4);
+  ASSERT_EQ(planner.Plan(), 192u);
+  ASSERT_EQ(planner.Offset(b), planner.Offset(c));
+  ASSERT_NE(planner.Offset(a), planner.Offset(b));
+}
+
+TEST_F(TestOptPlanner, RecomputedBlockHasTwoLifetimes) {
+  OptPlanner planner(32);
+  // a forward activation, recomputed at step 6 for the backward pass
+  auto act = planner.AddBlock(64, 0, 1);
+  planner.AddLifetime(act, 6, 7);
+  auto mid = planner.AddBlock(64, 2, 5);
+  auto grad = planner.AddBlock(64, 5, 7);
+  ASSERT_EQ(planner.Plan(), 128u);
+  ASSERT_EQ(planner.Offset(act), planner.Offset(mid));
+  ASSERT_NE(planner.Offset(grad), planner.Offset(mid));
+}
+
+TEST_F(TestOptPlanner, NoOverlapOfLiveBlocks) {
+  OptPlanner planner(32);
+  std::vector<std::vector<int>> lifetimes = {{0, 9}, {0, 2}, {1, 4}, {3, 6}, {5, 9}, {2, 8}, {7, 9}};
+  std::vector<size_t> sizes = {32, 96, 64, 128, 32, 64, 96};
+  std::vector<size_t> ids;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    ids.push_back(planner.AddBlock(sizes[i], lifetimes[i][0], lifetimes[i][1]));
+  }
+  planner.ExtendLifetime(ids[1], 3);
+  lifetimes[1][1] = 3;
+  auto total = planner.Plan();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ASSERT_LE(planner.Offset(ids[i]) + sizes[i], total);
+    for (size_t j = i + 1; j < ids.size(); ++j) {
+      bool alive_together = lifetimes[i][0] <= lifetimes[j][1] && lifetimes[j][0] <= lifetimes[i][1];
+      bool share_memory = planner.Offset(ids[i]) < planner.Offset(ids[j]) + sizes[j] &&
+                          planner.Offset(ids[j]) < planner.Offset(ids[i]) + sizes[i];
+      ASSERT_FALSE(alive_together && share_memory);
+    }
+  }
+}
+}  // namespace mindspore
@@ -0,0 +1,245 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "schema/inner/model_generated.h"
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "include/train/train_cfg.h"
+#include "src/litert/inner_context.h"
+#include "src/train/static_allocator.h"
+#define private public
+#define protected public
+#include "src/train/train_session.h"
+#undef protected
+#undef private
+
+namespace mindspore {
+namespace {
+constexpr int kRow = 4;
+constexpr int kCol = 16;
+constexpr int kElementNum = kRow * kCol;
+constexpr size_t kTensorSize = kElementNum * sizeof(float);
+
+constexpr char kRelu[] = "Default/relu";
+constexpr char kMul[] = "Default/mul";
+constexpr char kSquareGrad0[] = "Gradients/Default/Square_grad/mul0";
+constexpr char kSquareGrad1[] = "Gradients/Default/Square_grad/mul1";
+constexpr char kSquareGrad2[] = "Gradients/Default/Square_grad/mul2";
+constexpr char kAddN[] = "Gradients/Default/Square_grad/AddN";
+constexpr char kMulGrad[] = "Gradients/Default/mul_grad";
+
+float InputValue(int i) { return static_cast<float>(i % 7 - 3); }
+
+std::unique_ptr<schema::CNodeT> CreateNode(const std::string &name, schema::PrimitiveType type,
+                                           const std::vector<uint32_t> &inputs, uint32_t output) {
+  auto node = std::make_unique<schema::CNodeT>();
+  node->name = name;
+  node->inputIndex = inputs;
+  node->outputIndex = {output};
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = type;
+  switch (type) {
+    case schema::PrimitiveType_Activation: {
+      auto primitive = new schema::ActivationT;
+      primitive->activation_type = schema::ActivationType_RELU;
+      node->primitive->value.value = primitive;
+      break;
+    }
+    case schema::PrimitiveType_MulFusion:
+      node->primitive->value.value = new schema::MulFusionT;
+      break;
+    case schema::PrimitiveType_Square:
+      node->primitive->value.value = new schema::SquareT;
+      break;
+    default:
+      node->primitive->value.value = new schema::AddNT;
+      break;
+  }
+  return node;
+}
+
+// x -> relu -> a, a * w -> b, square(b) -> c is the loss. The gradient part reads a again after a peak of three
+// gradients, which AddN accumulates, so relu is worth recomputing:
+//   g0 = c * w, g1 = g0 * w, g2 = g0 * w, g = AddN(g1, g2, g0), out = g * a.
+std::shared_ptr<lite::Model> BuildTrainModel() {
+  enum : uint32_t { kX, kW, kA, kB, kC, kG0, kG1, kG2, kG, kOut, kTensorNum };
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  meta_graph->nodes.emplace_back(CreateNode(kRelu, schema::PrimitiveType_Activation, {kX}, kA));
+  meta_graph->nodes.emplace_back(CreateNode(kMul, schema::PrimitiveType_MulFusion, {kA, kW}, kB));
+  meta_graph->nodes.emplace_back(CreateNode("Default/loss_fct/Square", schema::PrimitiveType_Square, {kB}, kC));
+  meta_graph->nodes.emplace_back(CreateNode(kSquareGrad0, schema::PrimitiveType_MulFusion, {kC, kW}, kG0));
+  meta_graph->nodes.emplace_back(CreateNode(kSquareGrad1, schema::PrimitiveType_MulFusion, {kG0, kW}, kG1));
+  meta_graph->nodes.emplace_back(CreateNode(kSquareGrad2, schema::PrimitiveType_MulFusion, {kG0, kW}, kG2));
+  meta_graph->nodes.emplace_back(CreateNode(kAddN, schema::PrimitiveType_AddN, {kG1, kG2, kG0}, kG));
+  meta_graph->nodes.emplace_back(CreateNode(kMulGrad, schema::PrimitiveType_MulFusion, {kG, kA}, kOut));
+  meta_graph->inputIndex = {kX};
+  meta_graph->outputIndex = {kC, kOut};
+
+  for (uint32_t i = 0; i < kTensorNum; i++) {
+    auto tensor = std::make_unique<schema::TensorT>();
+    tensor->nodeType = lite::NodeType_Parameter;
+    tensor->format = schema::Format_NHWC;
+    tensor->dataType = TypeId::kNumberTypeFloat32;
+    tensor->dims = {kRow, kCol};
+    tensor->offset = -1;
+    if (i == kW) {
+      tensor->nodeType = lite::NodeType_ValueNode;
+      std::vector<float> weight(kElementNum, 0.5f);
+      tensor->data.resize(kTensorSize);
+      memcpy(tensor->data.data(), weight.data(), kTensorSize);
+    }
+    meta_graph->allTensors.emplace_back(std::move(tensor));
+  }
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, meta_graph.get());
+  builder.Finish(offset);
+  auto content = reinterpret_cast<char *>(builder.GetBufferPointer());
+  return std::shared_ptr<lite::Model>(lite::Model::Import(content, builder.GetSize()));
+}
+}  // namespace
+
+class TrainSessionAllocTest : public mindspore::CommonTest {
+ public:
+  TrainSessionAllocTest() {}
+
+ protected:
+  std::shared_ptr<lite::TrainSession> CreateSession(bool recompute) {
+    auto model = BuildTrainModel();
+    if (model == nullptr) {
+      return nullptr;
+    }
+    auto context = std::make_shared<lite::InnerContext>();
+    context->thread_num_ = 1;
+    context->allocator = std::make_shared<StaticAllocator>();
+    lite::TrainCfg cfg;
+    cfg.recompute_activations_ = recompute;
+    auto session = std::make_shared<lite::TrainSession>();
+    if (session->TrainInit(context, &cfg) != lite::RET_OK || session->CompileTrainGraph(model) != lite::RET_OK) {
+      return nullptr;
+    }
+    return session;
+  }
+
+  static kernel::KernelExec *FindKernel(const std::vector<kernel::KernelExec *> &kernels, const std::string &name) {
+    auto iter = std::find_if(kernels.begin(), kernels.end(),
+                             [&name](const kernel::KernelExec *kernel) { return kernel->name() == name; });
+    return iter == kernels.end() ? nullptr : *iter;
+  }
+
+  static lite::Tensor *Output(const lite::TrainSession &session, const std::string &name) {
+    auto kernel = FindKernel(session.train_kernels_, name);
+    return kernel == nullptr ? nullptr : kernel->out_tensors().front();
+  }
+
+  static int RunTrain(lite::TrainSession *session) {
+    auto ret = session->Train();
+    if (ret != lite::RET_OK) {
+      return ret;
+    }
+    auto input = session->GetInputs().front();
+    auto data = reinterpret_cast<float *>(input->MutableData());
+    for (int i = 0; i < kElementNum; i++) {
+      data[i] = InputValue(i);
+    }
+    return session->RunGraph();
+  }
+};
+
+TEST_F(TrainSessionAllocTest, RecomputeActivation) {
+  auto plain = CreateSession(false);
+  ASSERT_NE(plain, nullptr);
+  auto recompute = CreateSession(true);
+  ASSERT_NE(recompute, nullptr);
+
+  auto relu_num = [](const std::vector<kernel::KernelExec *> &kernels) {
+    return std::count_if(kernels.begin(), kernels.end(),
+                         [](const kernel::KernelExec *kernel) { return kernel->name() == kRelu; });
+  };
+  ASSERT_EQ(plain->train_schedule_.size(), plain->train_kernels_.size());
+  ASSERT_EQ(relu_num(plain->train_schedule_), 1);
+  // relu runs again right before the first gradient reading its output.
+  ASSERT_EQ(recompute->train_schedule_.size(), recompute->train_kernels_.size() + 1);
+  ASSERT_EQ(relu_num(recompute->train_schedule_), 2);
+  auto grad = std::find_if(recompute->train_schedule_.begin(), recompute->train_schedule_.end(),
+                           [](const kernel::KernelExec *kernel) { return kernel->name() == kMulGrad; });
+  ASSERT_NE(grad, recompute->train_schedule_.begin());
+  ASSERT_EQ((*(grad - 1))->name(), kRelu);
+  // the relu output is not live while g0, g1 and g2 peak, so the arena holds one tensor less.
+  ASSERT_LT(recompute->tensors_data_size_, plain->tensors_data_size_);
+
+  ASSERT_EQ(RunTrain(plain.get()), lite::RET_OK);
+  ASSERT_EQ(RunTrain(recompute.get()), lite::RET_OK);
+  auto plain_out = reinterpret_cast<float *>(Output(*plain, kMulGrad)->data());
+  auto recompute_out = reinterpret_cast<float *>(Output(*recompute, kMulGrad)->data());
+  ASSERT_NE(plain_out, nullptr);
+  ASSERT_NE(recompute_out, nullptr);
+  for (int i = 0; i < kElementNum; i++) {
+    // out = square(relu(x) * 0.5) * relu(x)
+    auto a = std::max(InputValue(i), 0.0f);
+    auto b = a * 0.5f;
+    ASSERT_FLOAT_EQ(plain_out[i], b * b * a);
+    ASSERT_FLOAT_EQ(recompute_out[i], plain_out[i]);
+  }
+}
+
+TEST_F(TrainSessionAllocTest, InPlaceAddN) {
+  auto session = CreateSession(false);
+  ASSERT_NE(session, nullptr);
+  auto add_n = FindKernel(session->train_kernels_, kAddN);
+  ASSERT_NE(add_n, nullptr);
+  // the output takes over the buffer of the first input, which is read for the last time by AddN.
+  ASSERT_EQ(add_n->out_tensors().front()->data(), add_n->in_tensors().at(0)->data());
+  // g0, the third input, is read after the output is written, so it keeps its own buffer.
+  ASSERT_NE(add_n->out_tensors().front()->data(), add_n->in_tensors().at(2)->data());
+}
+
+TEST_F(TrainSessionAllocTest, PersistentEvalOutput) {
+  for (bool recompute : {false, true}) {
+    auto session = CreateSession(recompute);
+    ASSERT_NE(session, nullptr);
+    ASSERT_EQ(session->eval_output_node_map_.size(), 1);
+    ASSERT_NE(session->eval_output_node_map_.find(kMul), session->eval_output_node_map_.end());
+    auto eval_output = Output(*session, kMul);
+    ASSERT_NE(eval_output, nullptr);
+
+    // the eval output is live until the end of the step, so no other tensor of the arena overlaps it.
+    auto begin = reinterpret_cast<uint8_t *>(eval_output->data());
+    ASSERT_NE(begin, nullptr);
+    for (auto kernel : session->train_schedule_) {
+      for (auto tensor : kernel->out_tensors()) {
+        if (tensor == eval_output) {
+          continue;
+        }
+        auto other = reinterpret_cast<uint8_t *>(tensor->data());
+        ASSERT_TRUE(other + tensor->Size() <= begin || begin + kTensorSize <= other) << tensor->tensor_name();
+      }
+    }
+
+    // the gradients run after it do not overwrite it, it still holds the prediction of the step.
+    ASSERT_EQ(RunTrain(session.get()), lite::RET_OK);
+    auto prediction = reinterpret_cast<float *>(eval_output->data());
+    for (int i = 0; i < kElementNum; i++) {
+      ASSERT_FLOAT_EQ(prediction[i], std::max(InputValue(i), 0.0f) * 0.5f);
+    }
+  }
+}
+}  // namespace mindspore
@@ -0,0 +1,92 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <map>
+#include <string>
+#include "common/common_test.h"
+#include "src/common/common.h"
+#include "src/litert/kernel_autotuner.h"
+
+namespace mindspore {
+namespace {
+constexpr const char *kTestDbPath = "./kernel_autotuner_test.db";
+constexpr const char *kOtherDbPath = "./kernel_autotuner_test_other.db";
+}  // namespace
+class KernelAutoTunerTest : public mindspore::CommonTest {
+ public:
+  KernelAutoTunerTest() = default;
+  void SetUp() override {
+    (void)std::remove(kTestDbPath);
+    (void)std::remove(kOtherDbPath);
+  }
+  void TearDown() override {
+    (void)std::remove(kTestDbPath);
+    (void)std::remove(kOtherDbPath);
+  }
+};
+
+TEST_F(KernelAutoTunerTest, test_parse_config) {
+  std::map<std::string, std::string> section;
+  auto config = lite::ParseAutoTuneConfig(section);
+  ASSERT_FALSE(config.enable_);
+
+  section[lite::kAutoTuneEnable] = "true";
+  section[lite::kAutoTuneDbPath] = kTestDbPath;
+  section[lite::kAutoTuneLoops] = "3";
+  section[lite::kAutoTuneWarmUpLoops] = "invalid";
+  config = lite::ParseAutoTuneConfig(section);
+  ASSERT_TRUE(config.enable_);
+  ASSERT_EQ(config.db_path_, kTestDbPath);
+  ASSERT_EQ(config.loops_, 3);
+  ASSERT_EQ(config.warm_up_loops_, lite::kAutoTuneDefaultWarmUpLoops);
+}
+
+TEST_F(KernelAutoTunerTest, test_record_and_reload) {
+  auto tuner = lite::KernelAutoTuner::GetInstance();
+  ASSERT_EQ(tuner->Init(kTestDbPath), lite::RET_OK);
+  auto key = tuner->MakeKey("Conv2DFusion fp32", {1, 224, 224, 3, 32});
+  ASSERT_EQ(key.find(' '), std::string::npos);
+  lite::AutoTuneChoice choice;
+  ASSERT_FALSE(tuner->Lookup(key, &choice));
+
+  lite::AutoTuneChoice winner = {1, 4, 12.5f};
+  tuner->Record(key, winner);
+  ASSERT_EQ(tuner->Flush(), lite::RET_OK);
+
+  // switch to another db and back, the recorded choice must come from the file.
+  ASSERT_EQ(tuner->Init(kOtherDbPath), lite::RET_OK);
+  ASSERT_FALSE(tuner->Lookup(key, &choice));
+  ASSERT_EQ(tuner->Init(kTestDbPath), lite::RET_OK);
+  ASSERT_TRUE(tuner->Lookup(key, &choice));
+  ASSERT_EQ(choice.algorithm_, winner.algorithm_);
+  ASSERT_EQ(choice.thread_num_, winner.thread_num_);
+  ASSERT_FLOAT_EQ(choice.cost_us_, winner.cost_us_);
+}
+
+TEST_F(KernelAutoTunerTest, test_measure) {
+  int count = 0;
+  auto cost = lite::KernelAutoTuner::Measure(
+    [&count]() {
+      count++;
+      return lite::RET_OK;
+    },
+    2, 3);
+  ASSERT_GE(cost, 0.0f);
+  ASSERT_EQ(count, 5);
+  cost = lite::KernelAutoTuner::Measure([]() { return lite::RET_ERROR; }, 0, 1);
+  ASSERT_LT(cost, 0.0f);
+}
+}  // namespace mindspore
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "src/litert/pack_weight_cache.h"
+#include "src/litert/pack_weight.h"
+
+namespace mindspore {
+namespace {
+constexpr const char *kTestCachePath = "./pack_weight_cache_test.bin";
+constexpr size_t kModelSize = 256;
+constexpr size_t kWeightOffsets[] = {16, 128};
+constexpr size_t kWeightSize = 64;
+constexpr size_t kPackedSize = 96;
+
+std::vector<char> CreateModelBuf() {
+  std::vector<char> model_buf(kModelSize);
+  for (size_t i = 0; i < model_buf.size(); ++i) {
+    model_buf[i] = static_cast<char>(i % 31);
+  }
+  return model_buf;
+}
+
+std::vector<char> CreatePackedData(int tensor_index) {
+  return std::vector<char>(kPackedSize, static_cast<char>(tensor_index + 1));
+}
+
+// Register the weights of the model buf and get their packed data, packing the weights not found in the cache.
+// Returns the number of weights taken from the cache.
+size_t GetPackedWeights(lite::PackWeight *pack_weight, const char *model_buf) {
+  size_t cached_num = 0;
+  for (size_t i = 0; i < sizeof(kWeightOffsets) / sizeof(kWeightOffsets[0]); ++i) {
+    EXPECT_EQ(pack_weight->StoreOriginTensorData(model_buf, model_buf + kWeightOffsets[i], i, kWeightSize),
+              lite::RET_OK);
+  }
+  for (size_t i = 0; i < sizeof(kWeightOffsets) / sizeof(kWeightOffsets[0]); ++i) {
+    bool is_packed = false;
+    auto packed = pack_weight->GetPackData(model_buf + kWeightOffsets[i], kPackedSize, &is_packed);
+    EXPECT_NE(packed, nullptr);
+    auto expected = CreatePackedData(i);
+    if (is_packed) {
+      ++cached_num;
+    } else {
+      memcpy(packed, expected.data(), expected.size());
+    }
+    EXPECT_EQ(memcmp(packed, expected.data(), expected.size()), 0);
+  }
+  return cached_num;
+}
+}  // namespace
+
+class PackWeightCacheTest : public mindspore::CommonTest {
+ public:
+  PackWeightCacheTest() = default;
+  void SetUp() override { (void)std::remove(kTestCachePath); }
+  void TearDown() override { (void)std::remove(kTestCachePath); }
+};
+
+TEST_F(PackWeightCacheTest, test_data_hash) {
+  auto model_buf = CreateModelBuf();
+  auto hash = lite::PackWeightCache::DataHash(model_buf.data(), model_buf.size());
+  ASSERT_EQ(hash, lite::PackWeightCache::DataHash(model_buf.data(), model_buf.size()));
+  ASSERT_NE(hash, lite::PackWeightCache::DataHash(model_buf.data(), model_buf.size() - 1));
+  // every byte takes part in the hash, including the ones in the middle of a large buffer and the tail.
+  for (size_t i : {size_t(0), kModelSize / 2 + 3, kModelSize - 1}) {
+    auto changed = model_buf;
+    changed[i] ^= 0x40;
+    ASSERT_NE(hash, lite::PackWeightCache::DataHash(changed.data(), changed.size())) << "index " << i;
+  }
+}
+
+TEST_F(PackWeightCacheTest, test_store_and_load) {
+  auto origin = CreateModelBuf();
+  auto origin_hash = lite::PackWeightCache::DataHash(origin.data(), kWeightSize);
+  auto packed = CreatePackedData(0);
+  std::vector<lite::PackedTensorData> packed_tensors = {{3, kWeightSize, origin_hash, packed.data(), kPackedSize}};
+  ASSERT_EQ(lite::PackWeightCache::Store(kTestCachePath, kModelSize, 0, packed_tensors), lite::RET_OK);
+
+  lite::PackWeightCache cache;
+  ASSERT_NE(cache.Load(kTestCachePath, kModelSize + 1, 0), lite::RET_OK);
+  ASSERT_FALSE(cache.IsLoaded());
+  ASSERT_NE(cache.Load(kTestCachePath, kModelSize, 1), lite::RET_OK);
+  ASSERT_EQ(cache.Load(kTestCachePath, kModelSize, 0), lite::RET_OK);
+  ASSERT_TRUE(cache.IsLoaded());
+  auto data = cache.GetPackedData(3, kWeightSize, origin_hash, kPackedSize);
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(memcmp(data, packed.data(), kPackedSize), 0);
+
+  // another tensor index, another packed size, another origin size or origin data of the same size are repacked.
+  ASSERT_EQ(cache.GetPackedData(2, kWeightSize, origin_hash, kPackedSize), nullptr);
+  ASSERT_EQ(cache.GetPackedData(3, kWeightSize, origin_hash, kPackedSize + 1), nullptr);
+  ASSERT_EQ(cache.GetPackedData(3, kWeightSize - 1, origin_hash, kPackedSize), nullptr);
+  origin[kWeightSize / 2] ^= 0x40;
+  auto changed_hash = lite::PackWeightCache::DataHash(origin.data(), kWeightSize);
+  ASSERT_EQ(cache.GetPackedData(3, kWeightSize, changed_hash, kPackedSize), nullptr);
+}
+
+TEST_F(PackWeightCacheTest, test_pack_weight_with_cache) {
+  auto model_buf = CreateModelBuf();
+  {
+    lite::PackWeight pack_weight;
+    pack_weight.SetPackWeightCachePath(kTestCachePath);
+    ASSERT_EQ(pack_weight.InitWeightManagerByBuf(model_buf.data(), model_buf.size()), lite::RET_OK);
+    ASSERT_EQ(GetPackedWeights(&pack_weight, model_buf.data()), 0);
+    ASSERT_EQ(pack_weight.StorePackWeightCache(), lite::RET_OK);
+  }
+  {
+    lite::PackWeight pack_weight;
+    pack_weight.SetPackWeightCachePath(kTestCachePath);
+    ASSERT_EQ(pack_weight.InitWeightManagerByBuf(model_buf.data(), model_buf.size()), lite::RET_OK);
+    ASSERT_EQ(GetPackedWeights(&pack_weight, model_buf.data()), 2);
+  }
+  // the second weight changes in place without changing the model size, only the first one is taken from the cache.
+  model_buf[kWeightOffsets[1] + kWeightSize - 1] ^= 0x40;
+  {
+    lite::PackWeight pack_weight;
+    pack_weight.SetPackWeightCachePath(kTestCachePath);
+    ASSERT_EQ(pack_weight.InitWeightManagerByBuf(model_buf.data(), model_buf.size()), lite::RET_OK);
+    ASSERT_EQ(GetPackedWeights(&pack_weight, model_buf.data()), 1);
+  }
+}
+}  // namespace mindspore
@@ -0,0 +1,174 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "tools/benchmark/perf_report.h"
+
+namespace mindspore {
+namespace {
+constexpr const char *kCsvReport = "./perf_report_test.csv";
+constexpr const char *kJsonReport = "./perf_report_test.json";
+constexpr size_t kCsvColumnNum = 13;
+
+std::vector<std::string> ReadLines(const std::string &file) {
+  std::ifstream in(file);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(in, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+std::vector<std::string> SplitCsv(const std::string &line) {
+  std::vector<std::string> fields;
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    fields.push_back(field);
+  }
+  if (!line.empty() && line.back() == ',') {
+    fields.emplace_back();
+  }
+  return fields;
+}
+}  // namespace
+
+class PerfReportTest : public mindspore::CommonTest {
+ public:
+  PerfReportTest() = default;
+  void SetUp() override {
+    // MatMul of [2, 3] and [3, 4], then Relu of its [2, 4] output.
+    a_ = MSTensor::CreateTensor("a", DataType::kNumberTypeFloat32, {2, 3}, nullptr, 0);
+    b_ = MSTensor::CreateTensor("b", DataType::kNumberTypeFloat32, {3, 4}, nullptr, 0);
+    c_ = MSTensor::CreateTensor("c", DataType::kNumberTypeFloat32, {2, 4}, nullptr, 0);
+    ASSERT_NE(a_, nullptr);
+    ASSERT_NE(b_, nullptr);
+    ASSERT_NE(c_, nullptr);
+  }
+  void TearDown() override {
+    MSTensor::DestroyTensorPtr(a_);
+    MSTensor::DestroyTensorPtr(b_);
+    MSTensor::DestroyTensorPtr(c_);
+    (void)std::remove(kCsvReport);
+    (void)std::remove(kJsonReport);
+  }
+
+ protected:
+  void RunOps(lite::PerfReporter *reporter, const std::string &matmul_name) {
+    for (int i = 0; i < 2; ++i) {
+      reporter->OpBegin(matmul_name);
+      reporter->OpEnd(matmul_name, "MatMulFusion", {*a_, *b_}, {*c_});
+    }
+    reporter->OpBegin("relu");
+    reporter->OpEnd("relu", "Activation", {*c_}, {*c_});
+  }
+
+  MSTensor *a_ = nullptr;
+  MSTensor *b_ = nullptr;
+  MSTensor *c_ = nullptr;
+};
+
+TEST_F(PerfReportTest, EstimateFlops) {
+  // 2 * M * N * K.
+  ASSERT_DOUBLE_EQ(lite::PerfReporter::EstimateFlops("MatMulFusion", {*a_, *b_}, {*c_}), 48);
+  // one operation per output element.
+  ASSERT_DOUBLE_EQ(lite::PerfReporter::EstimateFlops("Activation", {*c_}, {*c_}), 8);
+  ASSERT_DOUBLE_EQ(lite::PerfReporter::EstimateFlops("Reshape", {*a_}, {*a_}), 0);
+  ASSERT_DOUBLE_EQ(lite::PerfReporter::EstimateFlops("MatMulFusion", {*a_, *b_}, {}), 0);
+  // every tensor is touched once.
+  ASSERT_DOUBLE_EQ(lite::PerfReporter::EstimateBytes({*a_, *b_}, {*c_}), (6 + 12 + 8) * sizeof(float));
+}
+
+TEST_F(PerfReportTest, AggregateCsv) {
+  lite::PerfReporter reporter(1, 100, 10);
+  ASSERT_EQ(reporter.Init(false), lite::RET_OK);
+  RunOps(&reporter, "matmul");
+  // an end without begin is not recorded.
+  reporter.OpEnd("orphan", "Activation", {*c_}, {*c_});
+  ASSERT_EQ(reporter.WriteReport(kCsvReport), lite::RET_OK);
+
+  auto lines = ReadLines(kCsvReport);
+  ASSERT_EQ(lines.size(), 3);
+  auto header = SplitCsv(lines[0]);
+  ASSERT_EQ(header.size(), kCsvColumnNum);
+  ASSERT_EQ(header[0], "opName");
+  ASSERT_EQ(header[2], "calledTimes");
+  ASSERT_EQ(header[kCsvColumnNum - 1], "bound");
+
+  // the ops are reported in the order they first ran, each once with all its calls.
+  auto matmul = SplitCsv(lines[1]);
+  ASSERT_EQ(matmul.size(), kCsvColumnNum);
+  ASSERT_EQ(matmul[0], "matmul");
+  ASSERT_EQ(matmul[1], "MatMulFusion");
+  ASSERT_EQ(matmul[2], "2");
+  ASSERT_EQ(matmul[4], "48");
+  ASSERT_EQ(matmul[5], "104");
+  // no hardware counters are opened, the ipc and cache miss rate are left empty.
+  ASSERT_EQ(matmul[10], "");
+  ASSERT_EQ(matmul[11], "");
+  // 48 / 104 FLOPs per byte is below the ridge point of 100 / 10.
+  ASSERT_EQ(matmul[12], "memory");
+
+  auto relu = SplitCsv(lines[2]);
+  ASSERT_EQ(relu.size(), kCsvColumnNum);
+  ASSERT_EQ(relu[0], "relu");
+  ASSERT_EQ(relu[2], "1");
+  ASSERT_EQ(relu[4], "8");
+}
+
+TEST_F(PerfReportTest, WriteJson) {
+  lite::PerfReporter reporter(1, 0, 0);
+  ASSERT_EQ(reporter.Init(false), lite::RET_OK);
+  RunOps(&reporter, "mat\"mul");
+  ASSERT_EQ(reporter.WriteReport(kJsonReport), lite::RET_OK);
+
+  auto lines = ReadLines(kJsonReport);
+  ASSERT_EQ(lines.size(), 4);
+  ASSERT_EQ(lines[0], "[");
+  ASSERT_EQ(lines[3], "]");
+  ASSERT_EQ(lines[1].find("  {\"opName\": \"mat\\\"mul\", \"opType\": \"MatMulFusion\", \"calledTimes\": 2,"), 0);
+  ASSERT_EQ(lines[1].back(), ',');
+  ASSERT_NE(lines[1].find("\"flops\": 48, \"bytes\": 104,"), std::string::npos);
+  // the peaks are unknown, so the bound is not decided, and there is no counter field.
+  ASSERT_NE(lines[1].find("\"bound\": \"-\"}"), std::string::npos);
+  ASSERT_EQ(lines[1].find("\"ipc\""), std::string::npos);
+  ASSERT_EQ(lines[2].find("  {\"opName\": \"relu\", \"opType\": \"Activation\", \"calledTimes\": 1,"), 0);
+  ASSERT_EQ(lines[2].back(), '}');
+}
+
+TEST_F(PerfReportTest, EscapeCsvName) {
+  lite::PerfReporter reporter(1, 0, 0);
+  ASSERT_EQ(reporter.Init(false), lite::RET_OK);
+  RunOps(&reporter, "mat,\"mul\"");
+  ASSERT_EQ(reporter.WriteReport(kCsvReport), lite::RET_OK);
+  auto lines = ReadLines(kCsvReport);
+  ASSERT_EQ(lines.size(), 3);
+  ASSERT_EQ(lines[1].find("\"mat,\"\"mul\"\"\",MatMulFusion,2,"), 0);
+}
+
+TEST_F(PerfReportTest, UnknownFormat) {
+  lite::PerfReporter reporter(1, 0, 0);
+  ASSERT_EQ(reporter.Init(false), lite::RET_OK);
+  RunOps(&reporter, "matmul");
+  ASSERT_EQ(reporter.WriteReport("./perf_report_test.txt"), lite::RET_ERROR);
+}
+}  // namespace mindspore
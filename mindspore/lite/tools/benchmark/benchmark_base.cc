@@ -405,6 +405,8 @@ int BenchmarkBase::InitCallbackParameter() {
     ret = InitTimeProfilingCallbackParameter();
   } else if (flags_->perf_profiling_) {
     ret = InitPerfProfilingCallbackParameter();
+  } else if (flags_->perf_report_) {
+    ret = InitPerfReportCallbackParameter();
   } else if (flags_->print_tensor_data_) {
     ret = InitPrintTensorDataCallbackParameter();
   } else if (flags_->dump_tensor_data_) {
@@ -134,6 +134,11 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
     AddFlag(&BenchmarkFlags::perf_profiling_, "perfProfiling",
             "Perf event profiling(only instructions statics enabled currently)", false);
     AddFlag(&BenchmarkFlags::perf_event_, "perfEvent", "CYCLE|CACHE|STALL", "CYCLE");
+    AddFlag(&BenchmarkFlags::perf_report_, "perfReport", "Write a per operator roofline report", false);
+    AddFlag(&BenchmarkFlags::perf_report_file_, "perfReportFile", "Roofline report file, .csv | .json",
+            "perf_report.csv");
+    AddFlag(&BenchmarkFlags::peak_gflops_, "peakGFlops", "Peak GFLOP/s of the device, used to classify the bound", 0.0);
+    AddFlag(&BenchmarkFlags::peak_gbps_, "peakGBps", "Peak memory GB/s of the device, used to classify the bound", 0.0);
     // MarkAccuracy
     AddFlag(&BenchmarkFlags::benchmark_data_file_, "benchmarkDataFile", "Benchmark data file path", "");
     AddFlag(&BenchmarkFlags::benchmark_data_type_, "benchmarkDataType",
@@ -205,6 +210,10 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
   bool time_profiling_ = false;
   bool perf_profiling_ = false;
   std::string perf_event_ = "CYCLE";
+  bool perf_report_ = false;
+  std::string perf_report_file_ = "perf_report.csv";
+  double peak_gflops_ = 0.0;
+  double peak_gbps_ = 0.0;
   bool dump_tensor_data_ = false;
   bool print_tensor_data_ = false;
   std::string decrypt_key_str_;
@@ -249,6 +258,8 @@ class MS_API BenchmarkBase {
 
   virtual int InitPerfProfilingCallbackParameter() = 0;
 
+  virtual int InitPerfReportCallbackParameter() = 0;
+
   virtual int InitDumpTensorDataCallbackParameter() = 0;
 
   virtual int InitPrintTensorDataCallbackParameter() = 0;
@@ -403,6 +403,11 @@ int BenchmarkCApi::InitPerfProfilingCallbackParameter() {
   return RET_ERROR;
 }
 
+int BenchmarkCApi::InitPerfReportCallbackParameter() {
+  BENCHMARK_LOG_ERROR("Unsupported feature.");
+  return RET_ERROR;
+}
+
 int BenchmarkCApi::InitPrintTensorDataCallbackParameter() {
   BENCHMARK_LOG_ERROR("Unsupported feature.");
   return RET_ERROR;
@@ -58,6 +58,7 @@ class MS_API BenchmarkCApi : public BenchmarkBase {
 
   int InitTimeProfilingCallbackParameter() override;
   int InitPerfProfilingCallbackParameter() override;
+  int InitPerfReportCallbackParameter() override;
   int InitDumpTensorDataCallbackParameter() override;
   int InitPrintTensorDataCallbackParameter() override;
 
@@ -884,6 +884,12 @@ int BenchmarkUnifiedApi::MarkPerformance() {
       PrintPerfResult(per_op_type, op_perf_by_type_);
     }
 #endif
+  } else if (flags_->perf_report_ && perf_reporter_ != nullptr) {
+    if (perf_reporter_->WriteReport(flags_->perf_report_file_) != RET_OK) {
+      MS_LOG(ERROR) << "Write perf report failed.";
+      std::cerr << "Write perf report failed." << std::endl;
+      return RET_ERROR;
+    }
   }
 
   if (flags_->loop_count_ > 0) {
@@ -1391,6 +1397,27 @@ int BenchmarkUnifiedApi::InitTimeProfilingCallbackParameter() {
   return RET_OK;
 }
 
+int BenchmarkUnifiedApi::InitPerfReportCallbackParameter() {
+  perf_reporter_ = std::make_unique<PerfReporter>(flags_->num_threads_, flags_->peak_gflops_, flags_->peak_gbps_);
+  // hardware counters follow the calling thread, which runs all kernels only if ops are not run in parallel.
+  if (perf_reporter_->Init(flags_->inter_op_parallel_num_ <= 1) != RET_OK) {
+    MS_LOG(ERROR) << "Init perf reporter failed.";
+    return RET_ERROR;
+  }
+  ms_before_call_back_ = [this](const std::vector<mindspore::MSTensor> &, const std::vector<mindspore::MSTensor> &,
+                                const MSCallBackParam &call_param) {
+    perf_reporter_->OpBegin(call_param.node_name);
+    return true;
+  };
+  ms_after_call_back_ = [this](const std::vector<mindspore::MSTensor> &after_inputs,
+                               const std::vector<mindspore::MSTensor> &after_outputs,
+                               const MSCallBackParam &call_param) {
+    perf_reporter_->OpEnd(call_param.node_name, call_param.node_type, after_inputs, after_outputs);
+    return true;
+  };
+  return RET_OK;
+}
+
 int BenchmarkUnifiedApi::InitPerfProfilingCallbackParameter() {
 #ifndef ENABLE_ARM64
   MS_LOG(ERROR) << "Only support perf_profiling on arm64.";
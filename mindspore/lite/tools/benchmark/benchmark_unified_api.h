@@ -34,6 +34,7 @@
 #include <nlohmann/json.hpp>
 #endif
 #include "tools/benchmark/benchmark_base.h"
+#include "tools/benchmark/perf_report.h"
 #include "tools/common/flag_parser.h"
 #include "src/common/file_utils.h"
 #include "src/common/utils.h"
@@ -90,6 +91,8 @@ class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
 
   int InitPerfProfilingCallbackParameter() override;
 
+  int InitPerfReportCallbackParameter() override;
+
   int InitDumpTensorDataCallbackParameter() override;
 
   int InitPrintTensorDataCallbackParameter() override;
@@ -129,6 +132,7 @@ class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
 
   MSKernelCallBack ms_before_call_back_ = nullptr;
   MSKernelCallBack ms_after_call_back_ = nullptr;
+  std::unique_ptr<PerfReporter> perf_reporter_ = nullptr;
 #ifdef PARALLEL_INFERENCE
   std::vector<std::vector<int64_t>> resize_dims_;
   std::vector<std::vector<void *>> all_inputs_data_;
@@ -0,0 +1,337 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/benchmark/perf_report.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include "include/errorcode.h"
+#include "src/common/log_adapter.h"
+#include "thread/threadpool.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mindspore::lite {
+namespace {
+constexpr int kMatrixDims = 2;
+constexpr double kNsPerMs = 1e6;
+// ops which only move data, they are reported with zero FLOPs.
+const char *const kDataMovementOps[] = {
+  "Reshape",   "Transpose", "Concat",       "Gather",       "Split",       "Slice",      "StridedSlice",
+  "Squeeze",   "Unsqueeze", "ExpandDims",   "Shape",        "PadFusion",   "TileFusion", "Cast",
+  "GatherNd",  "ScatterNd", "Flatten",      "SpaceToBatch", "BatchToSpace", "DepthToSpace"};
+
+bool StartsWith(const std::string &str, const std::string &prefix) {
+  return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+double ElementNum(const MSTensor &tensor) { return tensor == nullptr ? 0 : static_cast<double>(tensor.ElementNum()); }
+
+// product of the last two dims, or of all dims if the tensor has less.
+double MatrixElementNum(const MSTensor &tensor) {
+  auto shape = tensor.Shape();
+  double num = 1;
+  for (size_t i = shape.size() > kMatrixDims ? shape.size() - kMatrixDims : 0; i < shape.size(); ++i) {
+    num *= static_cast<double>(shape[i]);
+  }
+  return num;
+}
+
+std::string JsonEscape(const std::string &str) {
+  std::string out;
+  for (auto c : str) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+    }
+    out.push_back(c);
+  }
+  return out;
+}
+
+std::string CsvEscape(const std::string &str) {
+  if (str.find_first_of(",\"") == std::string::npos) {
+    return str;
+  }
+  std::string out = "\"";
+  for (auto c : str) {
+    if (c == '"') {
+      out.push_back('"');
+    }
+    out.push_back(c);
+  }
+  return out + "\"";
+}
+
+bool EndsWith(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}  // namespace
+
+PerfReporter::~PerfReporter() {
+  ThreadPool::EnableStatistics(false);
+#ifdef __linux__
+  for (auto fd : counter_fds_) {
+    if (fd >= 0) {
+      (void)close(fd);
+    }
+  }
+#endif
+}
+
+int PerfReporter::Init(bool use_counters) {
+  ThreadPool::EnableStatistics(true);
+#ifdef __linux__
+  if (!use_counters) {
+    return RET_OK;
+  }
+  const uint64_t configs[kPerfCounterNum] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+  for (int i = 0; i < kPerfCounterNum; ++i) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(struct perf_event_attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(struct perf_event_attr);
+    attr.config = configs[i];
+    attr.disabled = i == 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    counter_fds_[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : counter_fds_[0], 0));
+    if (counter_fds_[i] < 0) {
+      // counters are optional, e.g. perf_event_paranoid forbids them or the cpu does not expose them.
+      MS_LOG(WARNING) << "Open perf event " << configs[i] << " failed, the report will have no hardware counters.";
+      for (int j = 0; j < i; ++j) {
+        (void)close(counter_fds_[j]);
+        counter_fds_[j] = -1;
+      }
+      return RET_OK;
+    }
+  }
+  (void)ioctl(counter_fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  (void)ioctl(counter_fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  has_counters_ = true;
+#endif
+  return RET_OK;
+}
+
+bool PerfReporter::ReadCounters(uint64_t *counters) const {
+#ifdef __linux__
+  if (!has_counters_) {
+    return false;
+  }
+  uint64_t values[kPerfCounterNum + 1] = {0};
+  if (read(counter_fds_[0], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+    return false;
+  }
+  for (int i = 0; i < kPerfCounterNum; ++i) {
+    counters[i] = values[i + 1];
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void PerfReporter::OpBegin(const std::string &name) {
+  OpPerfStart start;
+  (void)ReadCounters(start.counters);
+  start.busy_ns = ThreadPool::GetStatistics().busy_ns;
+  start.time = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  op_start_[name] = start;
+}
+
+void PerfReporter::OpEnd(const std::string &name, const std::string &type, const std::vector<MSTensor> &inputs,
+                         const std::vector<MSTensor> &outputs) {
+  auto end_time = std::chrono::steady_clock::now();
+  auto busy_ns = ThreadPool::GetStatistics().busy_ns;
+  uint64_t counters[kPerfCounterNum] = {0};
+  bool counted = ReadCounters(counters);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto start = op_start_.find(name);
+  if (start == op_start_.end()) {
+    return;
+  }
+  auto iter = op_records_.find(name);
+  if (iter == op_records_.end()) {
+    op_order_.push_back(name);
+    iter = op_records_.emplace(name, OpPerfRecord()).first;
+    iter->second.type = type;
+  }
+  auto &record = iter->second;
+  // shapes may change between calls after resize, so keep the last ones.
+  record.flops = EstimateFlops(type, inputs, outputs);
+  record.bytes = EstimateBytes(inputs, outputs);
+  record.calls++;
+  record.total_ns += std::chrono::duration<double, std::nano>(end_time - start->second.time).count();
+  record.busy_ns += static_cast<double>(busy_ns - start->second.busy_ns);
+  if (counted) {
+    for (int i = 0; i < kPerfCounterNum; ++i) {
+      record.counters[i] += counters[i] - start->second.counters[i];
+    }
+  }
+  op_start_.erase(start);
+}
+
+double PerfReporter::EstimateFlops(const std::string &type, const std::vector<MSTensor> &inputs,
+                                   const std::vector<MSTensor> &outputs) {
+  if (outputs.empty()) {
+    return 0;
+  }
+  for (auto op : kDataMovementOps) {
+    if (type == op) {
+      return 0;
+    }
+  }
+  double out_num = 0;
+  for (auto &output : outputs) {
+    out_num += ElementNum(output);
+  }
+  if ((StartsWith(type, "MatMul") || type == "BatchMatMul") && inputs.size() >= kMatrixDims) {
+    // (M * K) * (K * N) / (M * N) = K * K whatever the transpose attributes are.
+    auto out_matrix = MatrixElementNum(outputs[0]);
+    if (out_matrix <= 0) {
+      return 0;
+    }
+    auto deep = std::sqrt(MatrixElementNum(inputs[0]) * MatrixElementNum(inputs[1]) / out_matrix);
+    return 2 * out_num * std::round(deep);
+  }
+  if (type == "FullConnection" && inputs.size() >= kMatrixDims) {
+    auto out_shape = outputs[0].Shape();
+    if (out_shape.empty() || out_shape.back() <= 0) {
+      return 0;
+    }
+    return 2 * out_num * ElementNum(inputs[1]) / static_cast<double>(out_shape.back());
+  }
+  if (StartsWith(type, "Conv2dTranspose") && inputs.size() >= kMatrixDims) {
+    // every input element is scattered to kernel_h * kernel_w * out_channel / group outputs, weight is OHWI.
+    auto in_shape = inputs[0].Shape();
+    if (in_shape.empty() || in_shape.back() <= 0) {
+      return 0;
+    }
+    return 2 * ElementNum(inputs[0]) * ElementNum(inputs[1]) / static_cast<double>(in_shape.back());
+  }
+  if (StartsWith(type, "Conv2D") && inputs.size() >= kMatrixDims) {
+    // every output element reduces kernel_h * kernel_w * in_channel / group inputs, weight is OHWI.
+    auto weight_shape = inputs[1].Shape();
+    if (weight_shape.empty() || weight_shape.front() <= 0) {
+      return 0;
+    }
+    return 2 * out_num * ElementNum(inputs[1]) / static_cast<double>(weight_shape.front());
+  }
+  if (StartsWith(type, "AvgPool") || StartsWith(type, "MaxPool") || StartsWith(type, "Reduce")) {
+    double in_num = 0;
+    for (auto &input : inputs) {
+      in_num += ElementNum(input);
+    }
+    return in_num;
+  }
+  // element-wise ops and activations, one operation per output element.
+  return out_num;
+}
+
+double PerfReporter::EstimateBytes(const std::vector<MSTensor> &inputs, const std::vector<MSTensor> &outputs) {
+  // every tensor is assumed to be touched once, which is a lower bound of the traffic.
+  double bytes = 0;
+  for (auto &tensor : inputs) {
+    bytes += tensor == nullptr ? 0 : static_cast<double>(tensor.DataSize());
+  }
+  for (auto &tensor : outputs) {
+    bytes += tensor == nullptr ? 0 : static_cast<double>(tensor.DataSize());
+  }
+  return bytes;
+}
+
+std::string PerfReporter::Bound(double intensity) const {
+  if (peak_gflops_ <= 0 || peak_gbps_ <= 0) {
+    return "-";
+  }
+  // ridge point of the roofline, in FLOPs per byte.
+  return intensity < peak_gflops_ / peak_gbps_ ? "memory" : "compute";
+}
+
+int PerfReporter::WriteReport(const std::string &file) const {
+  bool json = EndsWith(file, ".json");
+  if (!json && !EndsWith(file, ".csv")) {
+    MS_LOG(ERROR) << "Perf report file should end with .csv or .json: " << file;
+    return RET_ERROR;
+  }
+  std::ofstream out(file);
+  if (!out.is_open()) {
+    MS_LOG(ERROR) << "Open perf report file failed: " << file;
+    return RET_ERROR;
+  }
+  out << std::setprecision(6);
+  if (json) {
+    out << "[\n";
+  } else {
+    out << "opName,opType,calledTimes,avg(ms),flops,bytes,intensity(flop/byte),gflops/s,gb/s,threadUtil,ipc,"
+           "cacheMissRate,bound\n";
+  }
+  bool first = true;
+  for (auto &name : op_order_) {
+    auto &record = op_records_.at(name);
+    if (record.calls == 0) {
+      continue;
+    }
+    double avg_ns = record.total_ns / record.calls;
+    double intensity = record.bytes > 0 ? record.flops / record.bytes : 0;
+    double gflops = avg_ns > 0 ? record.flops / avg_ns : 0;  // flops per ns equals GFLOP/s
+    double gbps = avg_ns > 0 ? record.bytes / avg_ns : 0;
+    double util = record.total_ns > 0 ? record.busy_ns / (record.total_ns * std::max(thread_num_, 1)) : 0;
+    double ipc = record.counters[kPerfCycles] > 0 ? static_cast<double>(record.counters[kPerfInstructions]) /
+                                                        static_cast<double>(record.counters[kPerfCycles])
+                                                  : 0;
+    double miss_rate = record.counters[kPerfCacheRefs] > 0 ? static_cast<double>(record.counters[kPerfCacheMisses]) /
+                                                                 static_cast<double>(record.counters[kPerfCacheRefs])
+                                                           : 0;
+    if (json) {
+      out << (first ? "" : ",\n") << "  {\"opName\": \"" << JsonEscape(name) << "\", \"opType\": \""
+          << JsonEscape(record.type) << "\", \"calledTimes\": " << record.calls << ", \"avgMs\": " << avg_ns / kNsPerMs
+          << ", \"flops\": " << record.flops << ", \"bytes\": " << record.bytes << ", \"intensity\": " << intensity
+          << ", \"gflops\": " << gflops << ", \"gbps\": " << gbps << ", \"threadUtil\": " << util;
+      if (has_counters_) {
+        out << ", \"ipc\": " << ipc << ", \"cacheMissRate\": " << miss_rate;
+      }
+      out << ", \"bound\": \"" << Bound(intensity) << "\"}";
+    } else {
+      out << CsvEscape(name) << "," << CsvEscape(record.type) << "," << record.calls << "," << avg_ns / kNsPerMs << ","
+          << record.flops << "," << record.bytes << "," << intensity << "," << gflops << "," << gbps << "," << util
+          << ",";
+      if (has_counters_) {
+        out << ipc << "," << miss_rate;
+      } else {
+        out << ",";
+      }
+      out << "," << Bound(intensity) << "\n";
+    }
+    first = false;
+  }
+  if (json) {
+    out << "\n]\n";
+  }
+  out.close();
+  std::cout << "Perf report of " << op_order_.size() << " ops is saved to: " << file << std::endl;
+  return RET_OK;
+}
+}  // namespace mindspore::lite
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_TOOLS_BENCHMARK_PERF_REPORT_H_
+#define MINDSPORE_LITE_TOOLS_BENCHMARK_PERF_REPORT_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "include/api/types.h"
+
+namespace mindspore::lite {
+enum PerfCounterIndex { kPerfCycles = 0, kPerfInstructions, kPerfCacheRefs, kPerfCacheMisses, kPerfCounterNum };
+
+struct OpPerfRecord {
+  std::string type;
+  int calls = 0;
+  double total_ns = 0;
+  double flops = 0;  // per call
+  double bytes = 0;  // per call
+  double busy_ns = 0;
+  uint64_t counters[kPerfCounterNum] = {0};
+};
+
+struct OpPerfStart {
+  std::chrono::steady_clock::time_point time;
+  uint64_t busy_ns = 0;
+  uint64_t counters[kPerfCounterNum] = {0};
+};
+
+// PerfReporter records, for every kernel, the FLOPs and bytes derived from the tensor shapes, the achieved GFLOP/s and
+// GB/s, the utilization of the kernel thread pool and the hardware counters of the calling thread if perf_event_open
+// is available, and writes them as a roofline table.
+class PerfReporter {
+ public:
+  PerfReporter(int thread_num, double peak_gflops, double peak_gbps)
+      : thread_num_(thread_num), peak_gflops_(peak_gflops), peak_gbps_(peak_gbps) {}
+  ~PerfReporter();
+
+  // counters are only opened if use_counters, since they only follow the thread running the kernels.
+  int Init(bool use_counters);
+  void OpBegin(const std::string &name);
+  void OpEnd(const std::string &name, const std::string &type, const std::vector<MSTensor> &inputs,
+             const std::vector<MSTensor> &outputs);
+  // CSV if the file name ends with ".csv", JSON if it ends with ".json".
+  int WriteReport(const std::string &file) const;
+
+  static double EstimateFlops(const std::string &type, const std::vector<MSTensor> &inputs,
+                              const std::vector<MSTensor> &outputs);
+  static double EstimateBytes(const std::vector<MSTensor> &inputs, const std::vector<MSTensor> &outputs);
+
+ private:
+  bool ReadCounters(uint64_t *counters) const;
+  std::string Bound(double intensity) const;
+
+  int thread_num_ = 1;
+  double peak_gflops_ = 0;
+  double peak_gbps_ = 0;
+  int counter_fds_[kPerfCounterNum] = {-1, -1, -1, -1};
+  bool has_counters_ = false;
+  std::mutex mutex_;
+  std::map<std::string, OpPerfStart> op_start_;
+  std::vector<std::string> op_order_;
+  std::map<std::string, OpPerfRecord> op_records_;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_TOOLS_BENCHMARK_PERF_REPORT_H_
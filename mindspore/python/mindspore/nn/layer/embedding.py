@@ -15,6 +15,8 @@
 """embedding"""
 from __future__ import absolute_import
 
+import os
+import numpy as np
 import mindspore.common.dtype as mstype
 from mindspore import log as logger
 from mindspore.common.tensor import Tensor
@@ -149,6 +151,49 @@ class Embedding(Cell):
         return s
 
 
+def _pserver_embedding_sharding():
+    """The policy to shard the embedding table rows over Parameter Servers, the same as the embedding cache runtime."""
+    return "hash" if os.getenv("MS_DEV_EMBEDDING_CACHE_SHARDING") == "hash" else "range"
+
+
+def _pserver_embedding_rows(vocab_size, server_num, sharding):
+    """The origin ids put in the rows of each Parameter Server's embedding table slice."""
+    if sharding == "hash":
+        return [np.arange(i, vocab_size, server_num) for i in range(server_num)]
+    slice_sizes = [vocab_size // server_num + (1 if i < vocab_size % server_num else 0) for i in range(server_num)]
+    offsets = np.cumsum([0] + slice_sizes)
+    return [np.arange(offsets[i], offsets[i + 1]) for i in range(server_num)]
+
+
+def _convert_pserver_embedding_tables(tables, src_sharding, dst_sharding):
+    """
+    Convert the embedding table slices of all the Parameter Servers from one sharding policy to another, e.g. to load
+    the checkpoints saved with the "range" sharding into the servers sharded by "hash". The slice of server i is named
+    "embedding_table_server_i" under the "range" sharding and "embedding_table_server_hash_i" under the "hash" sharding.
+
+    Args:
+        tables (list[numpy.ndarray]): The embedding table slices ordered by the server rank id.
+        src_sharding (str): The sharding policy of the input slices, "range" or "hash".
+        dst_sharding (str): The sharding policy of the output slices, "range" or "hash".
+
+    Returns:
+        list[numpy.ndarray], the embedding table slices ordered by the server rank id.
+    """
+    for sharding in (src_sharding, dst_sharding):
+        if sharding not in ("range", "hash"):
+            raise ValueError(f"The sharding policy should be 'range' or 'hash', but got {sharding}.")
+    server_num = len(tables)
+    if server_num == 0:
+        raise ValueError("The Parameter Server number is zero.")
+    vocab_size = sum(table.shape[0] for table in tables)
+    full_table = np.empty((vocab_size,) + tuple(tables[0].shape[1:]), dtype=tables[0].dtype)
+    for table, rows in zip(tables, _pserver_embedding_rows(vocab_size, server_num, src_sharding)):
+        if table.shape[0] != rows.shape[0]:
+            raise ValueError(f"The embedding table slices do not match the {src_sharding} sharding.")
+        full_table[rows] = table
+    return [full_table[rows] for rows in _pserver_embedding_rows(vocab_size, server_num, dst_sharding)]
+
+
 @constexpr
 def _make_axis_range(start, end):
     axis = tuple(range(start, end))
@@ -389,12 +434,16 @@ class EmbeddingLookup(Cell):
             for i in range(rest_vocab_size):
                 self.embedding_table_vocab_dim_list[i] += 1
 
+        # The rows of the slices are in different orders under different sharding policies, so the slices are named
+        # differently to never load a checkpoint into the slices of another sharding policy.
+        name_prefix = "embedding_table_server_hash_" if _pserver_embedding_sharding() == "hash" \
+            else "embedding_table_server_"
         offset = 0
         for i in range(server_num):
             self.embedding_table_list.append(Parameter(initializer(param_init,
                                                                    [self.embedding_table_vocab_dim_list[i],
                                                                     self.embedding_size]),
-                                                       name="embedding_table_server_" + str(i)))
+                                                       name=name_prefix + str(i)))
 
             self.embedding_offset.append(offset)
             offset += self.embedding_table_vocab_dim_list[i]
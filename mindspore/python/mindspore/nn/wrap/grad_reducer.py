@@ -58,6 +58,7 @@ def _init_allreduce_operators(length, split_indices, group=GlobalComm.WORLD_COMM
             op_fusion_id = -1
         op.add_prim_attr('fusion', op_fusion_id)
         op.add_prim_attr('index', index[i])
+        op.add_prim_attr('gradient_reduce', True)
         op_list = op_list + (op,)
     return op_list
 
@@ -81,6 +82,7 @@ def _init_allreduce_operators_by_parameters(parameters, split_indices, group, fu
         op = AllReduce('sum', group)
         op.add_prim_attr('fusion', comm_fusion)
         op.add_prim_attr('index', index)
+        op.add_prim_attr('gradient_reduce', True)
         index += 1
         op_list = op_list + (op,)
 
@@ -404,6 +406,7 @@ class DistributedGradReducer(Cell):
             if not param_fusion:
                 self.split_fusion = False
                 self.allreduce = AllReduce('sum', group).add_prim_attr('fusion', fusion_type)
+                self.allreduce.add_prim_attr('gradient_reduce', True)
         self.allgather = AllGather(group)
         ps_filter = lambda x: x.is_param_ps
         self.ps_parameters = tuple(ps_filter(x) for x in parameters)
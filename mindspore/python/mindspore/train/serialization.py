@@ -252,6 +252,67 @@ def _exec_save(ckpt_file_name, data_list, enc_key=None, enc_mode="AES-GCM"):
         raise e
 
 
+class _FlatCheckpointWriter:
+    """
+    Save the parameters into sharded flat tensor files in background, together with a manifest named
+    `prefix.manifest`. Only the parameters changed since the last save of this writer are written if `incremental`
+    is True, the manifest refers to the files of the earlier checkpoints for the others, so those files should be kept
+    while the incremental checkpoints are in use.
+    """
+
+    def __init__(self, directory, shard_num=4):
+        from mindspore._c_expression import CheckpointWriter_
+        directory = os.path.realpath(directory)
+        os.makedirs(directory, exist_ok=True)
+        self._writer = CheckpointWriter_(directory, Validator.check_positive_int(shard_num, "shard_num"))
+
+    def save(self, save_obj, prefix, incremental=True):
+        """Take the snapshot of the parameters of `save_obj` and return without waiting for the files."""
+        if isinstance(save_obj, nn.Cell):
+            save_obj.init_parameters_data()
+            params = [param for _, param in save_obj.parameters_and_names()]
+        else:
+            params = list(save_obj)
+        names = []
+        tensors = []
+        for param in params:
+            if isinstance(param, Parameter):
+                param.init_data()
+            names.append(param.name)
+            tensors.append(param)
+        self._writer.Save(prefix, names, tensors, Validator.check_bool(incremental))
+
+    def wait(self):
+        """Wait for the last checkpoint to be written, returns whether it is saved successfully."""
+        return self._writer.Wait()
+
+
+def _load_flat_checkpoint(manifest_file, verify=False):
+    """
+    Load the parameters of a checkpoint saved by `_FlatCheckpointWriter` from its manifest. The tensor files are mapped
+    into memory instead of being read, so the data of a parameter is only read from disk when it is used. The data of
+    all the parameters is hashed and checked in parallel if `verify` is True.
+    """
+    from mindspore._c_expression import _load_tensor_file
+    manifest_file = os.path.realpath(manifest_file)
+    with open(manifest_file, "r") as f:
+        manifest = json.load(f)
+    directory = os.path.dirname(manifest_file)
+    tensor_files = {}
+    parameter_dict = OrderedDict()
+    for item in manifest["tensors"]:
+        file_name = item["file"]
+        if file_name not in tensor_files:
+            tensor_files[file_name] = dict(_load_tensor_file(os.path.join(directory, file_name),
+                                                             Validator.check_bool(verify)))
+        tensors = tensor_files[file_name]
+        name = item["name"]
+        if name not in tensors:
+            raise ValueError("The parameter {} is not found in the tensor file {}.".format(name, file_name))
+        parameter_dict[name] = Parameter(Tensor(tensors[name], internal=True), name=name)
+    return parameter_dict
+
+
 def _check_save_obj_and_ckpt_file_name(save_obj, ckpt_file_name):
     """Check save_obj and ckpt_file_name for save_checkpoint."""
     if not isinstance(save_obj, nn.Cell) and not isinstance(save_obj, list):
@@ -0,0 +1,67 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+
+"""measure the bandwidth of AllReduce on CPU"""
+
+import time
+
+import numpy as np
+
+from mindspore import Tensor
+from mindspore import context
+from mindspore import nn
+from mindspore.ops import operations as P
+from mindspore.communication.management import init, get_group_size, get_rank
+
+context.set_context(mode=context.GRAPH_MODE, device_target='CPU')
+context.set_ps_context(enable_ssl=False)
+init()
+context.set_auto_parallel_context(parallel_mode="data_parallel", gradients_mean=True, device_num=get_group_size())
+
+DATA_SIZES = (1 << 10, 1 << 16, 1 << 20, 1 << 24)
+WARMUP_STEPS = 2
+BENCHMARK_STEPS = 10
+
+
+class Net(nn.Cell):
+    def __init__(self):
+        super(Net, self).__init__()
+        self.all_reduce = P.AllReduce()
+
+    def construct(self, x):
+        return self.all_reduce(x)
+
+
+def run_all_reduce_benchmark():
+    """ Run all reduce on growing buffers and print the bus bandwidth of each size"""
+    rank_size = get_group_size()
+    for data_num in DATA_SIZES:
+        net = Net()
+        x_input = Tensor(np.full((data_num,), get_rank() + 1, np.float32))
+        for _ in range(WARMUP_STEPS):
+            output = net(x_input)
+        begin = time.time()
+        for _ in range(BENCHMARK_STEPS):
+            output = net(x_input)
+        cost = (time.time() - begin) / BENCHMARK_STEPS
+        assert np.all(output.asnumpy() == rank_size * (rank_size + 1) / 2)
+        # The ring moves 2 * (n - 1) / n of the buffer through every rank.
+        bus_bandwidth = data_num * 4 * 2 * (rank_size - 1) / rank_size / cost / (1 << 30)
+        if get_rank() == 0:
+            print(f"[PROF] AllReduce {data_num * 4} bytes on {rank_size} ranks: {cost * 1000:.3f} ms, "
+                  f"bus bandwidth {bus_bandwidth:.3f} GB/s", flush=True)
+
+
+run_all_reduce_benchmark()
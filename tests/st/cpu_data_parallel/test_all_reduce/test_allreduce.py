@@ -54,3 +54,35 @@ def test_allreduce_small_scale_data():
         return
     return_code = os.system("bash build_allreduce_net_cluster.sh run_allreduce_small_scale_data.py 8081")
     assert return_code == 0
+
+
+@pytest.mark.level1
+@pytest.mark.platform_x86_cpu
+@pytest.mark.env_onecard
+def test_allreduce_benchmark():
+    """
+    Feature: CPU data parallel.
+    Description: Run allreduce of growing sizes on 4 local processes, with the ranks of the host reducing through shared
+        memory, and print the bandwidth.
+    Expectation: Each node obtains all node reduced result.
+    """
+    if sys.platform != 'linux':
+        return
+    os.environ['MS_DEV_CPU_HIERARCHICAL_ALLREDUCE'] = '1'
+    try:
+        return_code = os.system("bash build_allreduce_net_cluster.sh run_allreduce_benchmark.py 8129 4")
+    finally:
+        del os.environ['MS_DEV_CPU_HIERARCHICAL_ALLREDUCE']
+    if return_code != 0:
+        os.system(f"echo '\n**************** Worker Log ****************'")
+        os.system(f"grep -E 'ERROR|Error|error' -C 15 ./worker*.log")
+        os.system(f"echo '\n**************** Scheduler Log ****************'")
+        os.system(f"grep -E 'ERROR|Error|error' -C 15 ./scheduler.log")
+    assert return_code == 0
+
+    # Rank 0 reports the bandwidth of every buffer size.
+    with open("./worker_0.log", "r") as log:
+        prof_lines = [line.strip() for line in log if "[PROF] AllReduce" in line]
+    for line in prof_lines:
+        print(line)
+    assert len(prof_lines) == 4
@@ -0,0 +1,179 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#define private public
+#include "runtime/device/file_offload.h"
+#undef private
+
+namespace mindspore::device {
+namespace {
+constexpr char kOffloadPath[] = "./file_offload_test";
+}  // namespace
+
+class TestFileOffload : public UT::Common {
+ public:
+  TestFileOffload() = default;
+  // The file is unlinked once opened, so the directory is empty when the stores are destroyed.
+  void TearDown() override { (void)rmdir(kOffloadPath); }
+};
+
+/// Feature: Offload memory to files.
+/// Description: Write the data of several keys to the files and load them back with and without prefetching.
+/// Expectation: The loaded data is the same as the written data, and released keys are not stored any more.
+TEST_F(TestFileOffload, test_write_and_load) {
+  constexpr size_t kKeyNum = 4;
+  constexpr size_t kDataSize = 10000;
+  FileOffloadStore store(kOffloadPath, 2, 0);
+  std::vector<uint8_t> keys(kKeyNum);
+  for (size_t i = 0; i < kKeyNum; ++i) {
+    auto buffer = static_cast<uint8_t *>(store.AllocBuffer(kDataSize));
+    ASSERT_NE(buffer, nullptr);
+    (void)memset(buffer, static_cast<int>(i + 1), kDataSize);
+    store.AsyncWrite(&keys[i], buffer, kDataSize);
+    ASSERT_TRUE(store.Contains(&keys[i]));
+  }
+  store.Prefetch(&keys[0]);
+  store.Prefetch(&keys[1]);
+  for (size_t i = 0; i < kKeyNum; ++i) {
+    auto data = static_cast<uint8_t *>(store.Load(&keys[i]));
+    ASSERT_NE(data, nullptr);
+    std::vector<uint8_t> expected(kDataSize, static_cast<uint8_t>(i + 1));
+    ASSERT_EQ(memcmp(data, expected.data(), kDataSize), 0);
+    store.Release(&keys[i]);
+    ASSERT_FALSE(store.Contains(&keys[i]));
+    ASSERT_EQ(store.Load(&keys[i]), nullptr);
+  }
+  store.Clear();
+}
+
+/// Feature: Offload memory to files.
+/// Description: Write the data of a key again while it is being prefetched.
+/// Expectation: The key holds the data written last.
+TEST_F(TestFileOffload, test_overwrite) {
+  constexpr size_t kDataSize = 4096;
+  FileOffloadStore store(kOffloadPath, 1, 0);
+  uint8_t key = 0;
+  for (int value = 1; value <= 3; ++value) {
+    auto buffer = store.AllocBuffer(kDataSize);
+    (void)memset(buffer, value, kDataSize);
+    store.AsyncWrite(&key, buffer, kDataSize);
+    store.Prefetch(&key);
+  }
+  auto data = static_cast<uint8_t *>(store.Load(&key));
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(data[0], 3);
+  ASSERT_EQ(data[kDataSize - 1], 3);
+  store.Release(&key);
+}
+
+/// Feature: Offload memory to files.
+/// Description: Remove a key while its data is being written, and reserve the host memory up to the limit.
+/// Expectation: The removed key is not stored any more, and the host memory beyond the limit is not reserved.
+TEST_F(TestFileOffload, test_remove_and_host_mem_limit) {
+  constexpr size_t kDataSize = 4096;
+  FileOffloadStore store(kOffloadPath, 1, kDataSize);
+  uint8_t key = 0;
+  store.AsyncWrite(&key, store.AllocBuffer(kDataSize), kDataSize);
+  store.Remove(&key);
+  ASSERT_FALSE(store.Contains(&key));
+  ASSERT_EQ(store.Load(&key), nullptr);
+  ASSERT_TRUE(store.entries_.empty());
+
+  ASSERT_TRUE(store.ReserveHostMem(kDataSize - 1));
+  ASSERT_FALSE(store.ReserveHostMem(2));
+  ASSERT_TRUE(store.ReserveHostMem(1));
+  store.ReleaseHostMem(kDataSize);
+  ASSERT_TRUE(store.ReserveHostMem(kDataSize));
+}
+
+/// Feature: Offload memory to files.
+/// Description: Write keys of different sizes to the file of the store, remove some of them and write other keys.
+/// Expectation: The keys take the extents freed by the removed keys, and the file shrinks when its end is freed.
+TEST_F(TestFileOffload, test_shared_file_extents) {
+  constexpr size_t kBlockSize = 4096;
+  FileOffloadStore store(kOffloadPath, 1, 0);
+  std::vector<uint8_t> keys(4);
+  auto write = [&store](const void *key, size_t size, int value) {
+    auto buffer = store.AllocBuffer(size);
+    (void)memset(buffer, value, size);
+    store.AsyncWrite(key, buffer, size);
+  };
+  auto check = [&store](const void *key, size_t size, int value) {
+    auto data = static_cast<uint8_t *>(store.Load(key));
+    ASSERT_NE(data, nullptr);
+    std::vector<uint8_t> expected(size, static_cast<uint8_t>(value));
+    ASSERT_EQ(memcmp(data, expected.data(), size), 0);
+  };
+  write(&keys[0], kBlockSize, 1);
+  write(&keys[1], 2 * kBlockSize + 1, 2);
+  write(&keys[2], kBlockSize, 3);
+  ASSERT_EQ(store.entries_[&keys[1]]->offset, kBlockSize);
+  ASSERT_EQ(store.entries_[&keys[2]]->offset, 4 * kBlockSize);
+  ASSERT_EQ(store.file_size_, 5 * kBlockSize);
+
+  // The removal runs on the only I/O thread before the first load of a key queued after it.
+  store.Remove(&keys[1]);
+  check(&keys[0], kBlockSize, 1);
+  ASSERT_EQ(store.free_extents_.size(), 1);
+  write(&keys[3], kBlockSize, 4);
+  ASSERT_EQ(store.entries_[&keys[3]]->offset, kBlockSize);
+  ASSERT_EQ(store.free_extents_[2 * kBlockSize], 2 * kBlockSize);
+  check(&keys[2], kBlockSize, 3);
+
+  // The extent of key 2 is merged with the free one before it and given back with the end of the file.
+  store.Remove(&keys[2]);
+  check(&keys[3], kBlockSize, 4);
+  ASSERT_TRUE(store.free_extents_.empty());
+  ASSERT_EQ(store.file_size_, 2 * kBlockSize);
+
+  // A larger write of key 0 moves it to a new extent.
+  store.Release(&keys[0]);
+  write(&keys[0], 2 * kBlockSize, 5);
+  ASSERT_EQ(store.entries_[&keys[0]]->offset, 2 * kBlockSize);
+  ASSERT_EQ(store.free_extents_[0], kBlockSize);
+  check(&keys[0], 2 * kBlockSize, 5);
+  store.Clear();
+  ASSERT_EQ(store.file_size_, 0);
+}
+
+/// Feature: Offload memory to files.
+/// Description: Free buffers beyond the total size of the buffers kept for reuse.
+/// Expectation: Only the buffers within the size are kept, and they are freed when the store is cleared.
+TEST_F(TestFileOffload, test_free_buffer_limit) {
+  constexpr size_t kLargeSize = 200 << 20;
+  constexpr size_t kSmallSize = 4096;
+  FileOffloadStore store(kOffloadPath, 1, 0);
+  auto large0 = store.AllocBuffer(kLargeSize);
+  auto large1 = store.AllocBuffer(kLargeSize);
+  auto small = store.AllocBuffer(kSmallSize);
+  store.FreeBuffer(large0, kLargeSize);
+  store.FreeBuffer(large1, kLargeSize);
+  store.FreeBuffer(small, kSmallSize);
+  ASSERT_EQ(store.free_buffer_size_, kLargeSize + kSmallSize);
+  ASSERT_EQ(store.free_buffers_[kLargeSize].size(), 1);
+  ASSERT_EQ(store.AllocBuffer(kSmallSize), small);
+  ASSERT_EQ(store.free_buffer_size_, kLargeSize);
+  store.FreeBuffer(small, kSmallSize);
+  store.Clear();
+  ASSERT_EQ(store.free_buffer_size_, 0);
+  ASSERT_TRUE(store.free_buffers_.empty());
+}
+}  // namespace mindspore::device
@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 
+#include <unistd.h>
+#include <cstring>
 #include <vector>
 #include <map>
 #include "common/common_test.h"
+#define private public
 #include "runtime/device/memory_scheduler.h"
+#undef private
 namespace mindspore::device {
 constexpr size_t kDeviceMemSize = 5;
 constexpr size_t kMaxVirtualCount = 1024;
@@ -64,9 +68,13 @@ class MemoryManagerStub : public MemoryManager {
     return ret;
   }
 
-  void SwapIn(const void *host_ptr, void *device_ptr, size_t mem_size, void *stream) override {}
+  void SwapIn(const void *host_ptr, void *device_ptr, size_t mem_size, void *stream) override {
+    (void)memcpy(device_ptr, host_ptr, mem_size);
+  }
 
-  void SwapOut(const void *device_ptr, void *host_ptr, size_t mem_size, void *stream) override {}
+  void SwapOut(const void *device_ptr, void *host_ptr, size_t mem_size, void *stream) override {
+    (void)memcpy(host_ptr, device_ptr, mem_size);
+  }
 
  protected:
   uint8_t *MallocStaticMem(size_t size, bool communication_mem, uint32_t graph_id) { return nullptr; }
@@ -283,4 +291,72 @@ scheduler->Optimize();
 // run
 Run(scheduler);
 }
-}  // namespace mindspore::device
\ No newline at end of file
+
+/// Feature: AutoMemoryOffload
+/// Description: Swap out memory beyond the host memory limit of the offload store to the file, prefetch it, read it
+/// back through Get and SwapIn, then free a key whose data is only in the file.
+/// Expectation: The data read back is the data swapped out, the host memory of the graphs sharing the store is limited
+/// together, and the file of the freed key is removed.
+TEST_F(TestMemScheduler, test_swap_out_to_file) {
+  constexpr char kOffloadPath[] = "./mem_scheduler_offload_test";
+  std::shared_ptr<MemHandler> mem_handler = std::make_shared<MemHandler>(std::make_shared<MemoryManagerStub>());
+  auto file_store = std::make_shared<FileOffloadStore>(kOffloadPath, 1, 1);
+  AutoMemoryOffload offload(mem_handler);
+  AutoMemoryOffload other_offload(mem_handler);
+  offload.file_store_ = file_store;
+  other_offload.file_store_ = file_store;
+  std::vector<uint8_t> keys(4);
+  uint8_t stream = 0;
+  auto swap_out = [&keys, &stream](AutoMemoryOffload *mem_offload, size_t index) {
+    auto device_ptr = static_cast<uint8_t *>(mem_offload->Malloc(&keys[index], 1, &stream, {}));
+    ASSERT_NE(device_ptr, nullptr);
+    *device_ptr = static_cast<uint8_t>(index + 1);
+    mem_offload->SwapOut(&keys[index], &stream);
+    mem_offload->Free(&keys[index]);
+  };
+
+  // The first key fits in the host memory limit, the others go to the file, including the one of the other graph.
+  swap_out(&offload, 0);
+  ASSERT_EQ(offload.host_swap_size_, 1);
+  ASSERT_FALSE(file_store->Contains(&keys[0]));
+  swap_out(&offload, 1);
+  swap_out(&offload, 2);
+  swap_out(&other_offload, 3);
+  ASSERT_EQ(offload.host_swap_size_, 1);
+  ASSERT_EQ(other_offload.host_swap_size_, 0);
+  for (size_t i = 1; i < keys.size(); ++i) {
+    ASSERT_TRUE(file_store->Contains(&keys[i]));
+  }
+
+  offload.Prefetch(&keys[1]);
+  ASSERT_TRUE(file_store->FindEntry(&keys[1])->read.valid());
+  auto device_ptr = static_cast<uint8_t *>(offload.Get(&keys[1], &stream));
+  ASSERT_NE(device_ptr, nullptr);
+  ASSERT_EQ(*device_ptr, 2);
+  ASSERT_FALSE(file_store->Contains(&keys[1]));
+  offload.Free(&keys[1]);
+
+  device_ptr = static_cast<uint8_t *>(offload.Malloc(&keys[2], 1, &stream, {}));
+  ASSERT_NE(device_ptr, nullptr);
+  ASSERT_EQ(offload.SwapIn(&keys[2], &stream), device_ptr);
+  ASSERT_EQ(*device_ptr, 3);
+  ASSERT_FALSE(file_store->Contains(&keys[2]));
+  offload.Free(&keys[2]);
+
+  device_ptr = static_cast<uint8_t *>(offload.Get(&keys[0], &stream));
+  ASSERT_NE(device_ptr, nullptr);
+  ASSERT_EQ(*device_ptr, 1);
+  ASSERT_EQ(offload.host_swap_size_, 0);
+  offload.Free(&keys[0]);
+
+  // The key freed while its data is only in the file is not swapped in any more.
+  other_offload.ReleaseSwappedOutMem(&keys[3]);
+  ASSERT_EQ(file_store->FindEntry(&keys[3]), nullptr);
+  offload.Clear();
+  ASSERT_TRUE(file_store->entries_.empty());
+  file_store = nullptr;
+  offload.file_store_ = nullptr;
+  other_offload.file_store_ = nullptr;
+  (void)rmdir(kOffloadPath);
+}
+}  // namespace mindspore::device
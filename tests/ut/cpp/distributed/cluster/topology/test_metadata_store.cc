@@ -0,0 +1,139 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "common/common_test.h"
+#include "distributed/cluster/topology/metadata_store.h"
+
+namespace mindspore {
+namespace distributed {
+namespace cluster {
+namespace topology {
+class TestMetadataStore : public UT::Common {
+ public:
+  TestMetadataStore() = default;
+  virtual ~TestMetadataStore() = default;
+
+  void SetUp() override { (void)remove(kLogFile); }
+  void TearDown() override { (void)remove(kLogFile); }
+
+ protected:
+  static constexpr char kLogFile[] = "metadata_store_test.wal";
+};
+
+/// Feature: test reading and writing the metadata store of meta server node.
+/// Description: put, get and delete some metadata without the write-ahead log.
+/// Expectation: the metadata could be read after written and could not be read after deleted.
+TEST_F(TestMetadataStore, PutGetDelete) {
+  MetadataStore store;
+  std::string value;
+  ASSERT_FALSE(store.Get("actor_0", &value));
+  ASSERT_TRUE(store.Put("actor_0", "127.0.0.1:8080"));
+  ASSERT_TRUE(store.Put("actor_1", std::string("\0\1\2", 3)));
+  ASSERT_TRUE(store.Get("actor_0", &value));
+  ASSERT_EQ("127.0.0.1:8080", value);
+  ASSERT_TRUE(store.Get("actor_1", &value));
+  ASSERT_EQ(std::string("\0\1\2", 3), value);
+  ASSERT_TRUE(store.Delete("actor_0"));
+  ASSERT_FALSE(store.Delete("actor_0"));
+  ASSERT_FALSE(store.Get("actor_0", &value));
+  ASSERT_EQ(1, store.size());
+}
+
+/// Feature: test recovering the metadata store from the write-ahead log.
+/// Description: write some metadata with the log opened, append a torn record and open the log in a new store.
+/// Expectation: the new store recovers all the complete writes and deletes, and the torn record is dropped.
+TEST_F(TestMetadataStore, RecoverFromLog) {
+  {
+    MetadataStore store;
+    ASSERT_TRUE(store.Open(kLogFile));
+    ASSERT_TRUE(store.Put("key_0", "value_0"));
+    ASSERT_TRUE(store.Put("key_1", "value_1"));
+    ASSERT_TRUE(store.Put("key_0", "value_2"));
+    ASSERT_TRUE(store.Delete("key_1"));
+  }
+  {
+    std::ofstream log(kLogFile, std::ios::binary | std::ios::app);
+    log << "P\x05";
+  }
+
+  MetadataStore store;
+  ASSERT_TRUE(store.Open(kLogFile));
+  std::string value;
+  ASSERT_EQ(1, store.size());
+  ASSERT_TRUE(store.Get("key_0", &value));
+  ASSERT_EQ("value_2", value);
+  ASSERT_FALSE(store.Get("key_1", &value));
+
+  // The records appended after the torn tail is dropped are recovered too.
+  ASSERT_TRUE(store.Put("key_3", "value_3"));
+  MetadataStore recovered;
+  ASSERT_TRUE(recovered.Open(kLogFile));
+  ASSERT_EQ(2, recovered.size());
+  ASSERT_TRUE(recovered.Get("key_3", &value));
+  ASSERT_EQ("value_3", value);
+}
+
+/// Feature: test compacting the write-ahead log of the metadata store.
+/// Description: overwrite the same metadata many times and compact the log.
+/// Expectation: the log shrinks and the metadata recovered from it is the latest one.
+TEST_F(TestMetadataStore, CompactLog) {
+  MetadataStore store;
+  ASSERT_TRUE(store.Open(kLogFile));
+  const size_t write_num = 2000;
+  for (size_t i = 0; i < write_num; ++i) {
+    ASSERT_TRUE(store.Put("flag", std::to_string(i)));
+  }
+  ASSERT_TRUE(store.Compact());
+  std::ifstream log(kLogFile, std::ios::binary | std::ios::ate);
+  ASSERT_LT(static_cast<size_t>(log.tellg()), 64);
+
+  MetadataStore recovered;
+  ASSERT_TRUE(recovered.Open(kLogFile));
+  std::string value;
+  ASSERT_TRUE(recovered.Get("flag", &value));
+  ASSERT_EQ(std::to_string(write_num - 1), value);
+}
+
+/// Feature: test starting the metadata store for the first time on the log left by a former cluster.
+/// Description: write some metadata, open the log with truncation in a new store and write another metadata.
+/// Expectation: the metadata of the former cluster is discarded, and only the new metadata is recovered afterwards.
+TEST_F(TestMetadataStore, TruncateOnFirstStart) {
+  {
+    MetadataStore store;
+    ASSERT_TRUE(store.Open(kLogFile));
+    ASSERT_TRUE(store.Put("stale", "value_0"));
+  }
+  MetadataStore store;
+  ASSERT_TRUE(store.Open(kLogFile, true));
+  ASSERT_EQ(0, store.size());
+  ASSERT_TRUE(store.Put("fresh", "value_1"));
+
+  MetadataStore recovered;
+  ASSERT_TRUE(recovered.Open(kLogFile));
+  std::string value;
+  ASSERT_EQ(1, recovered.size());
+  ASSERT_FALSE(recovered.Get("stale", &value));
+  ASSERT_TRUE(recovered.Get("fresh", &value));
+  ASSERT_EQ("value_1", value);
+}
+}  // namespace topology
+}  // namespace cluster
+}  // namespace distributed
+}  // namespace mindspore
@@ -21,6 +21,8 @@
 #include <vector>
 #include <string>
 #include <random>
+#include <set>
+#include <utility>
 
 #include "include/common/random.h"
 #include "distributed/embedding_cache/embedding_cache_utils.h"
@@ -94,6 +96,106 @@ TEST_F(TestEmbeddingCache, test_random_number_gen) {
   }
   ASSERT_TRUE(numbers.size() == count);
 }
+
+/// Feature: test the hot id tracker.
+/// Description: record batches with skewed ids and select the hot ids periodically.
+/// Expectation: the most frequent ids in the range are selected in descending order of frequency.
+TEST_F(TestEmbeddingCache, test_hot_id_tracker) {
+  const size_t hot_id_num = 2;
+  const size_t refresh_interval = 2;
+  distributed::HotIdTracker tracker(hot_id_num, refresh_interval);
+
+  std::vector<int> batch_ids = {3, 7, 7, 5, 7, 3, 100, 100, 100, 100};
+  const int begin = 0;
+  const int end = 10;
+  EXPECT_FALSE(tracker.Record(batch_ids.data(), batch_ids.size(), begin, end));
+  EXPECT_TRUE(tracker.hot_ids().empty());
+  EXPECT_TRUE(tracker.Record(batch_ids.data(), batch_ids.size(), begin, end));
+  EXPECT_EQ(tracker.hot_ids(), std::vector<int>({7, 3}));
+
+  // The decayed frequencies are overtaken by the new hot id.
+  std::vector<int> new_batch_ids = {5, 5, 5, 5, 5};
+  EXPECT_FALSE(tracker.Record(new_batch_ids.data(), new_batch_ids.size(), begin, end));
+  EXPECT_TRUE(tracker.Record(new_batch_ids.data(), new_batch_ids.size(), begin, end));
+  EXPECT_EQ(tracker.hot_ids(), std::vector<int>({5, 7}));
+}
+
+/// Feature: test collecting the hot ids reconciled to remote.
+/// Description: select the hot ids, put some of them in the local host cache and one of those in the device cache.
+/// Expectation: only the hot ids in the local host cache and not in the device cache are collected, with their host
+/// cache indices.
+TEST_F(TestEmbeddingCache, test_hot_id_reconcile) {
+  const size_t hot_id_num = 3;
+  const size_t refresh_interval = 1;
+  distributed::HotIdTracker tracker(hot_id_num, refresh_interval);
+  std::vector<int> batch_ids = {3, 7, 7, 5, 7, 3};
+  const int begin = 0;
+  const int end = 10;
+  EXPECT_TRUE(tracker.Record(batch_ids.data(), batch_ids.size(), begin, end));
+  EXPECT_EQ(tracker.hot_ids(), std::vector<int>({7, 3, 5}));
+
+  const size_t capacity = 8;
+  const size_t data_step = 1;
+  const size_t graph_running_step = 0;
+  std::vector<int> swap_out_index(capacity);
+  std::vector<int> swap_out_ids(capacity);
+  size_t swap_out_size = 0;
+  bool need_wait_graph = false;
+  distributed::EmbeddingHashMap host_hash_map(0, capacity);
+  distributed::EmbeddingHashMap device_hash_map(0, capacity);
+  for (int id : {3, 7}) {
+    EXPECT_NE(host_hash_map.ParseData(id, swap_out_index.data(), swap_out_ids.data(), data_step, graph_running_step,
+                                      &swap_out_size, &need_wait_graph),
+              distributed::INVALID_INDEX_VALUE);
+  }
+  // The device copy of id 3 is newer than its host copy.
+  EXPECT_NE(device_hash_map.ParseData(3, swap_out_index.data(), swap_out_ids.data(), data_step, graph_running_step,
+                                      &swap_out_size, &need_wait_graph),
+            distributed::INVALID_INDEX_VALUE);
+
+  std::vector<int> ids;
+  std::vector<int> host_indices;
+  tracker.CollectHostResidentIds(host_hash_map, device_hash_map, &ids, &host_indices);
+  EXPECT_EQ(ids, std::vector<int>({7}));
+  EXPECT_EQ(host_indices, std::vector<int>({host_hash_map.hash_id_to_index().at(7)}));
+}
+
+/// Feature: test sharding the embedding table rows over servers.
+/// Description: locate every id of a table with 10 rows over 3 servers by the range and the hash policy.
+/// Expectation: each policy maps the ids to distinct rows, the servers get the same number of rows under both policies,
+/// and the ids out of the table are rejected.
+TEST_F(TestEmbeddingCache, test_remote_sharding) {
+  const size_t vocab_size = 10;
+  const size_t server_num = 3;
+  distributed::RemoteEmbeddingSharding range(vocab_size, server_num, distributed::RemoteShardingPolicy::kRange);
+  distributed::RemoteEmbeddingSharding hash(vocab_size, server_num, distributed::RemoteShardingPolicy::kHash);
+  std::vector<std::pair<size_t, size_t>> expected_bounds = {{0, 3}, {4, 6}, {7, 9}};
+  EXPECT_EQ(range.slice_bounds(), expected_bounds);
+  EXPECT_EQ(hash.slice_bounds(), expected_bounds);
+
+  size_t server_rank_id = 0;
+  int row = 0;
+  EXPECT_TRUE(range.Locate(5, &server_rank_id, &row));
+  EXPECT_EQ(server_rank_id, 1);
+  EXPECT_EQ(row, 1);
+  EXPECT_TRUE(hash.Locate(5, &server_rank_id, &row));
+  EXPECT_EQ(server_rank_id, 2);
+  EXPECT_EQ(row, 1);
+  for (const auto *sharding : {&range, &hash}) {
+    std::set<std::pair<size_t, int>> rows;
+    for (int id = 0; id < SizeToInt(vocab_size); ++id) {
+      ASSERT_TRUE(sharding->Locate(id, &server_rank_id, &row));
+      ASSERT_LT(server_rank_id, server_num);
+      const auto &bound = expected_bounds[server_rank_id];
+      ASSERT_GE(row, 0);
+      ASSERT_LE(IntToSize(row), bound.second - bound.first);
+      (void)rows.emplace(server_rank_id, row);
+    }
+    EXPECT_EQ(rows.size(), vocab_size);
+    EXPECT_FALSE(sharding->Locate(-1, &server_rank_id, &row));
+    EXPECT_FALSE(sharding->Locate(SizeToInt(vocab_size), &server_rank_id, &row));
+  }
+}
 }  // namespace persistent
 }  // namespace distributed
 }  // namespace mindspore
@@ -0,0 +1,286 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "common/common_test.h"
+#include "base/float16.h"
+#include "ir/func_graph.h"
+#include "mindspore/core/ops/core_ops.h"
+#include "ops/assign.h"
+#include "ops/mat_mul.h"
+#include "utils/flags.h"
+#define private public
+#define protected public
+#include "plugin/device/cpu/kernel/mkldnn/mkl_primitive_cache.h"
+#undef private
+#undef protected
+#include "plugin/device/cpu/kernel/assign_cpu_kernel.h"
+#include "plugin/device/cpu/kernel/matmul_cpu_kernel.h"
+#include "plugin/device/cpu/hal/device/cpu_device_address.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+constexpr int64_t kDimM = 16;
+constexpr int64_t kDimK = 64;
+constexpr int64_t kDimN = 48;
+
+AddressPtr CreateKernelAddress(void *addr, size_t size) {
+  auto kernel_addr = std::make_shared<Address>();
+  kernel_addr->addr = addr;
+  kernel_addr->size = size;
+  return kernel_addr;
+}
+
+KernelTensorPtr CreateKernelTensor(const std::vector<int64_t> &shape) {
+  auto shape_ab = std::make_shared<abstract::Shape>(shape);
+  auto new_abstract = std::make_shared<abstract::AbstractTensor>(kFloat32, shape_ab);
+  TensorInfo tensor_info{mindspore::Format::NCHW, new_abstract, shape};
+  auto kernel_tensor = std::make_shared<KernelTensor>();
+  kernel_tensor->SetTensorInfo(tensor_info);
+  return kernel_tensor;
+}
+
+std::vector<float> NaiveMatMul(const std::vector<float> &a, const float *b) {
+  std::vector<float> out(kDimM * kDimN, 0);
+  for (int64_t m = 0; m < kDimM; ++m) {
+    for (int64_t n = 0; n < kDimN; ++n) {
+      for (int64_t k = 0; k < kDimK; ++k) {
+        out[m * kDimN + n] += a[m * kDimK + k] * b[k * kDimN + n];
+      }
+    }
+  }
+  return out;
+}
+
+// The MatMul whose second input is a weight, so that it is prepacked.
+std::shared_ptr<MatMulCpuKernelMod> CreateMatMul() {
+  auto matmul = std::make_shared<MatMulCpuKernelMod>("MatMul");
+  matmul->set_weight_inputs({false, true});
+  auto op = std::make_shared<ops::MatMul>();
+  op->Init(false, false);
+  std::vector<KernelTensorPtr> input_tensors = {CreateKernelTensor({kDimM, kDimK}), CreateKernelTensor({kDimK, kDimN})};
+  std::vector<KernelTensorPtr> output_tensors = {CreateKernelTensor({kDimM, kDimN})};
+  EXPECT_TRUE(matmul->Init(op, input_tensors, output_tensors));
+  EXPECT_EQ(matmul->Resize(op, input_tensors, output_tensors, {}), 0);
+  return matmul;
+}
+
+std::vector<float> CreateData(size_t size, size_t period) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<float>(i % period) - static_cast<float>(period / 2);
+  }
+  return data;
+}
+
+void ExpectNear(const std::vector<float> &expected, const std::vector<float> &actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_LT(std::fabs(expected[i] - actual[i]), 1e-3) << "index " << i;
+  }
+}
+}  // namespace
+
+class MKLPrimitiveCacheTest : public UT::Common {
+ public:
+  MKLPrimitiveCacheTest() = default;
+  virtual ~MKLPrimitiveCacheTest() = default;
+
+  void SetUp() override {
+    auto &cache = MKLPrimitiveCache::GetInstance();
+    capacity_ = cache.capacity_;
+    cache.Clear();
+  }
+  void TearDown() override {
+    auto &cache = MKLPrimitiveCache::GetInstance();
+    cache.capacity_ = capacity_;
+    cache.Clear();
+  }
+
+ protected:
+  size_t capacity_{0};
+};
+
+/// Feature: test the LRU of the dnnl primitive cache.
+/// Description: put three primitives into a cache of capacity 2, using the first one before putting the third.
+/// Expectation: the least recently used primitive is evicted, and a capacity of 0 keeps nothing.
+TEST_F(MKLPrimitiveCacheTest, PrimitiveLru) {
+  auto &cache = MKLPrimitiveCache::GetInstance();
+  cache.capacity_ = 2;
+  auto first = std::make_shared<dnnl::primitive>();
+  auto second = std::make_shared<dnnl::primitive>();
+  auto third = std::make_shared<dnnl::primitive>();
+  cache.Put("first", first);
+  cache.Put("second", second);
+  ASSERT_EQ(cache.Get("first"), first);
+  cache.Put("third", third);
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(cache.Get("second"), nullptr);
+  ASSERT_EQ(cache.Get("first"), first);
+  ASSERT_EQ(cache.Get("third"), third);
+
+  // Putting an existing key replaces the primitive without evicting the others.
+  cache.Put("first", second);
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(cache.Get("first"), second);
+  ASSERT_EQ(cache.Get("third"), third);
+
+  cache.Clear();
+  cache.capacity_ = 0;
+  cache.Put("first", first);
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_EQ(cache.Get("first"), nullptr);
+}
+
+/// Feature: test the versions of the packed weights.
+/// Description: get the version of an address, update it, update an untracked address, then remove the address.
+/// Expectation: the version only changes on update of the address, and a removed address gets a version never used.
+TEST_F(MKLPrimitiveCacheTest, WeightVersion) {
+  auto &versions = MKLWeightVersion::GetInstance();
+  float weight = 0;
+  float other = 0;
+  auto size = versions.size();
+  auto first = versions.Get(&weight);
+  ASSERT_EQ(versions.size(), size + 1);
+  ASSERT_EQ(versions.Get(&weight), first);
+  versions.Update(&other);
+  ASSERT_EQ(versions.size(), size + 1);
+  ASSERT_EQ(versions.Get(&weight), first);
+  versions.Update(&weight);
+  auto second = versions.Get(&weight);
+  ASSERT_NE(second, first);
+
+  versions.Remove(&weight);
+  ASSERT_EQ(versions.size(), size);
+  auto third = versions.Get(&weight);
+  ASSERT_NE(third, first);
+  ASSERT_NE(third, second);
+  versions.Remove(&weight);
+}
+
+/// Feature: test the weights prepacked by the MatMul kernel.
+/// Description: launch a MatMul whose second input is a weight, then update the weight through every way the runtime
+/// writes it: the host sync with type conversion, the host sync sharing the host memory, an op writing it in place and
+/// a new weight allocated at the freed address.
+/// Expectation: the output of every launch is computed from the latest weight.
+TEST_F(MKLPrimitiveCacheTest, MatMulWeightUpdate) {
+  auto a = CreateData(kDimM * kDimK, 7);
+  auto b = CreateData(kDimK * kDimN, 5);
+  std::vector<float> out(kDimM * kDimN);
+  auto matmul = CreateMatMul();
+
+  auto weight_size = b.size() * sizeof(float);
+  auto device_address =
+    std::make_shared<device::cpu::CPUDeviceAddress>(b.data(), weight_size, kOpFormat_DEFAULT, kNumberTypeFloat32);
+  auto launch = [&]() {
+    std::vector<AddressPtr> inputs = {CreateKernelAddress(a.data(), a.size() * sizeof(float)),
+                                      CreateKernelAddress(device_address->GetMutablePtr(), weight_size)};
+    std::vector<AddressPtr> outputs = {CreateKernelAddress(out.data(), out.size() * sizeof(float))};
+    ASSERT_TRUE(matmul->Launch(inputs, {}, outputs));
+    ExpectNear(NaiveMatMul(a, static_cast<float *>(device_address->GetMutablePtr())), out);
+  };
+  launch();
+  launch();
+
+  // The host sync converting the data type.
+  std::vector<float16> half_b(b.size());
+  for (size_t i = 0; i < b.size(); ++i) {
+    half_b[i] = float16(static_cast<float>(i % 3));
+  }
+  auto half_size = half_b.size() * sizeof(float16);
+  ASSERT_TRUE(
+    device_address->SyncHostToDevice({kDimK, kDimN}, half_size, kNumberTypeFloat16, half_b.data(), kOpFormat_DEFAULT));
+  ASSERT_EQ(b[1], 1);
+  launch();
+
+  // The host sync of the same type, which shares the host memory.
+  std::vector<float> host_b(b.size(), 0.5);
+  ASSERT_TRUE(device_address->SyncHostToDevice({kDimK, kDimN}, weight_size, kNumberTypeFloat32, host_b.data(),
+                                               kOpFormat_DEFAULT));
+  ASSERT_EQ(device_address->GetMutablePtr(), host_b.data());
+  launch();
+  host_b[0] = 4;
+  ASSERT_TRUE(device_address->SyncHostToDevice({kDimK, kDimN}, weight_size, kNumberTypeFloat32, host_b.data(),
+                                               kOpFormat_DEFAULT));
+  launch();
+
+  // The ops updating the weight in place bump the version after launch.
+  host_b[1] = -4;
+  MKLWeightVersion::GetInstance().Update(host_b.data());
+  launch();
+
+  // The address is freed and allocated to another weight.
+  MKLWeightVersion::GetInstance().Remove(host_b.data());
+  host_b[2] = 8;
+  launch();
+  MKLWeightVersion::GetInstance().Remove(host_b.data());
+}
+
+/// Feature: test the weights prepacked by the MatMul kernel in training.
+/// Description: launch a MatMul on a weight, update the weight by an Assign step, which writes its input in place
+/// without ref outputs like the optimizers, then launch the MatMul again.
+/// Expectation: the MatMul does not change the version of the weight, the Assign does, and the second MatMul is
+/// computed from the assigned weight.
+TEST_F(MKLPrimitiveCacheTest, MatMulAfterAssign) {
+  auto a = CreateData(kDimM * kDimK, 7);
+  auto b = CreateData(kDimK * kDimN, 5);
+  auto value = CreateData(kDimK * kDimN, 3);
+  std::vector<float> out(kDimM * kDimN);
+  auto weight_size = b.size() * sizeof(float);
+  auto matmul = CreateMatMul();
+  auto assign = std::make_shared<AssignCpuKernelMod>();
+  auto assign_op = std::make_shared<ops::Assign>();
+  std::vector<KernelTensorPtr> assign_inputs = {CreateKernelTensor({kDimK, kDimN}), CreateKernelTensor({kDimK, kDimN})};
+  std::vector<KernelTensorPtr> assign_outputs = {CreateKernelTensor({kDimK, kDimN})};
+  ASSERT_TRUE(assign->Init(assign_op, assign_inputs, assign_outputs));
+  ASSERT_EQ(assign->Resize(assign_op, assign_inputs, assign_outputs, {}), 0);
+
+  // The primitives of the optimizers and Assign have the side effect on memory instead of ref outputs.
+  auto graph = std::make_shared<FuncGraph>();
+  auto assign_prim = std::make_shared<Primitive>(prim::kPrimAssign->name());
+  (void)assign_prim->AddAttr(GRAPH_FLAG_SIDE_EFFECT_MEM, MakeValue(true));
+  auto assign_node = graph->NewCNode({NewValueNode(assign_prim), graph->add_parameter(), graph->add_parameter()});
+  auto matmul_node =
+    graph->NewCNode({NewValueNode(std::make_shared<Primitive>(prim::kPrimMatMul->name())), graph->add_parameter(),
+                     graph->add_parameter()});
+
+  auto &versions = MKLWeightVersion::GetInstance();
+  std::vector<AddressPtr> matmul_inputs = {CreateKernelAddress(a.data(), a.size() * sizeof(float)),
+                                           CreateKernelAddress(b.data(), weight_size)};
+  std::vector<AddressPtr> matmul_outputs = {CreateKernelAddress(out.data(), out.size() * sizeof(float))};
+  ASSERT_TRUE(matmul->Launch(matmul_inputs, {}, matmul_outputs));
+  ExpectNear(NaiveMatMul(a, b.data()), out);
+  auto version = versions.Get(b.data());
+  versions.UpdateWrittenBy(matmul_node, matmul_inputs, matmul_outputs);
+  ASSERT_EQ(versions.Get(b.data()), version);
+
+  std::vector<float> assign_out(b.size());
+  std::vector<AddressPtr> inputs = {CreateKernelAddress(b.data(), weight_size),
+                                    CreateKernelAddress(value.data(), weight_size)};
+  std::vector<AddressPtr> outputs = {CreateKernelAddress(assign_out.data(), weight_size)};
+  ASSERT_TRUE(assign->Launch(inputs, {}, outputs));
+  versions.UpdateWrittenBy(assign_node, inputs, outputs);
+  ASSERT_NE(versions.Get(b.data()), version);
+  ASSERT_EQ(b, value);
+  ASSERT_TRUE(matmul->Launch(matmul_inputs, {}, matmul_outputs));
+  ExpectNear(NaiveMatMul(a, value.data()), out);
+  versions.Remove(b.data());
+}
+}  // namespace kernel
+}  // namespace mindspore
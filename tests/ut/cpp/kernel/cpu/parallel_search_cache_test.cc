@@ -0,0 +1,129 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include "common/common_test.h"
+#define private public
+#define protected public
+#include "kernel/parallel_search_cache.h"
+#undef private
+#undef protected
+#include "plugin/device/cpu/kernel/cpu_kernel.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+constexpr size_t kAvgCount = 5;
+
+// Launch until the search of the block size is finished, returns the number of launches.
+size_t LaunchUntilSearched(size_t count, ParallelSearchInfo *search_info) {
+  auto task = [](size_t start, size_t end) {};
+  size_t launch_num = 0;
+  do {
+    ParallelLaunchAutoSearch(task, count, nullptr, search_info);
+    ++launch_num;
+  } while (search_info->search_count < kAvgCount * search_info->max_pow);
+  return launch_num;
+}
+}  // namespace
+
+class ParallelSearchCacheTest : public UT::Common {
+ public:
+  ParallelSearchCacheTest() = default;
+  virtual ~ParallelSearchCacheTest() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/parallel_search_cache_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    directory_ = dir_template;
+  }
+  void TearDown() override { (void)system(("rm -rf " + directory_).c_str()); }
+
+ protected:
+  std::string directory_;
+};
+
+/// Feature: test the shared block size search of the parallel launches.
+/// Description: launch a kernel until the search is finished, then launch another kernel of the same key.
+/// Expectation: the second kernel takes the searched block size at the first launch and never searches.
+TEST_F(ParallelSearchCacheTest, SkipWarmUp) {
+  ParallelSearchInfo first;
+  first.kernel_key = "ParallelSearchCacheTest_Float32_Float32";
+  auto first_launch_num = LaunchUntilSearched(4096, &first);
+  ASSERT_GT(first_launch_num, kAvgCount);
+
+  ParallelSearchInfo second;
+  second.kernel_key = first.kernel_key;
+  ASSERT_EQ(LaunchUntilSearched(5000, &second), 1);
+  ASSERT_EQ(second.best_pow, first.best_pow);
+
+  // The kernels of the other keys or without key still search.
+  ParallelSearchInfo other;
+  other.kernel_key = "ParallelSearchCacheTest_Float16_Float16";
+  ASSERT_GT(LaunchUntilSearched(4096, &other), kAvgCount);
+  ParallelSearchInfo no_key;
+  ASSERT_GT(LaunchUntilSearched(4096, &no_key), kAvgCount);
+}
+
+/// Feature: test the persistent parallel search cache.
+/// Description: put results into a cache and save it, then open the file with another cache.
+/// Expectation: the results are loaded by key, and the count is bucketed by its power of 2.
+TEST_F(ParallelSearchCacheTest, SaveAndLoad) {
+  std::string file_name = directory_ + "/graph_cache/parallel_search_cache.json";
+  auto key = ParallelSearchCache::MakeKey("Add_Float32_Float32", 1000, 8);
+  ASSERT_EQ(key, ParallelSearchCache::MakeKey("Add_Float32_Float32", 600, 8));
+  ASSERT_NE(key, ParallelSearchCache::MakeKey("Add_Float32_Float32", 1024, 8));
+  ASSERT_NE(key, ParallelSearchCache::MakeKey("Add_Float32_Float32", 1000, 4));
+  {
+    ParallelSearchCache cache;
+    cache.Open(file_name);
+    size_t best_pow = 0;
+    ASSERT_FALSE(cache.Get(key, &best_pow));
+    cache.Put(key, 3);
+    ASSERT_TRUE(cache.Save());
+  }
+
+  ParallelSearchCache cache;
+  cache.Open(file_name);
+  size_t best_pow = 0;
+  ASSERT_TRUE(cache.Get(key, &best_pow));
+  ASSERT_EQ(best_pow, 3);
+}
+
+/// Feature: test the persistent parallel search cache.
+/// Description: open a corrupted cache file.
+/// Expectation: the file is ignored and replaced by the next save.
+TEST_F(ParallelSearchCacheTest, CorruptedFile) {
+  std::string file_name = directory_ + "/parallel_search_cache.json";
+  std::ofstream(file_name) << "{\"version\": 1, \"results\": {";
+  auto key = ParallelSearchCache::MakeKey("ReLU_Float32_Float32", 64, 2);
+  size_t best_pow = 0;
+  {
+    ParallelSearchCache cache;
+    cache.Open(file_name);
+    ASSERT_FALSE(cache.Get(key, &best_pow));
+    cache.Put(key, 1);
+    ASSERT_TRUE(cache.Save());
+  }
+  ParallelSearchCache cache;
+  cache.Open(file_name);
+  ASSERT_TRUE(cache.Get(key, &best_pow));
+}
+}  // namespace kernel
+}  // namespace mindspore
@@ -0,0 +1,239 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "plugin/device/cpu/kernel/rl/priority_replay_buffer.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+constexpr size_t kStateDim = 4;
+constexpr float kAlpha = 0.6;
+constexpr float kBeta = 0.4;
+}  // namespace
+
+class PriorityReplayBufferTest : public UT::Common {
+ public:
+  PriorityReplayBufferTest() = default;
+
+  // The transition is a state of kStateDim floats and an action, the state is filled with value, value + 1, ...
+  static std::vector<size_t> Schema() { return {kStateDim * sizeof(float), sizeof(int)}; }
+
+  static void Push(PriorityReplayBuffer *buffer, float value) {
+    std::vector<float> state(kStateDim);
+    for (size_t i = 0; i < kStateDim; i++) {
+      state[i] = value + i;
+    }
+    int action = static_cast<int>(value);
+    std::vector<AddressPtr> items = {std::make_shared<Address>(state.data(), state.size() * sizeof(float)),
+                                     std::make_shared<Address>(&action, sizeof(int))};
+    (void)buffer->Push(items);
+  }
+
+  // Sample a batch, and check that every transition is copied as a whole.
+  static void Sample(PriorityReplayBuffer *buffer, size_t batch_size, std::vector<size_t> *indices,
+                     std::vector<float> *weights, std::vector<float> *states) {
+    indices->resize(batch_size);
+    weights->resize(batch_size);
+    states->resize(batch_size * kStateDim);
+    std::vector<int> actions(batch_size);
+    std::vector<AddressPtr> transition = {
+      std::make_shared<Address>(states->data(), states->size() * sizeof(float)),
+      std::make_shared<Address>(actions.data(), actions.size() * sizeof(int))};
+    EXPECT_TRUE(buffer->Sample(batch_size, kBeta, indices->data(), weights->data(), transition));
+    for (size_t i = 0; i < batch_size; i++) {
+      const float *state = states->data() + i * kStateDim;
+      for (size_t j = 1; j < kStateDim; j++) {
+        EXPECT_EQ(state[j], state[0] + j);
+      }
+      EXPECT_EQ(actions[i], static_cast<int>(state[0]));
+      EXPECT_GT((*weights)[i], 0.0f);
+      EXPECT_LE((*weights)[i], 1.0f + 1e-5f);
+    }
+  }
+};
+
+/// Feature: test the batched search of the priority tree.
+/// Description: search a batch of random prefix sums on a tree of random priorities.
+/// Expectation: the batched search finds the same leaves as the search of the prefix sums one by one.
+TEST_F(PriorityReplayBufferTest, BatchedPrefixSumIdx) {
+  constexpr size_t kCapacity = 1000;
+  constexpr size_t kBatchSize = 257;
+  PriorityTree tree(kCapacity);
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(0.1, 2.0);
+  for (size_t i = 0; i < kCapacity; i++) {
+    float priority = dist(engine);
+    tree.Insert(i, {priority, priority});
+  }
+
+  std::uniform_real_distribution<float> mass_dist(0, tree.Root().sum_priority);
+  std::vector<float> masses(kBatchSize);
+  for (auto &mass : masses) {
+    mass = mass_dist(engine);
+  }
+  std::vector<float> prefix_sums = masses;
+  std::vector<size_t> indices(kBatchSize);
+  tree.GetPrefixSumIdx(prefix_sums.data(), kBatchSize, indices.data());
+  for (size_t i = 0; i < kBatchSize; i++) {
+    EXPECT_EQ(indices[i], tree.GetPrefixSumIdx(masses[i]));
+  }
+}
+
+/// Feature: test the priority replay buffer of small capacity.
+/// Description: push more transitions than the capacity, then sample a batch.
+/// Expectation: the buffer keeps a single shard, and the sampled transitions are the latest ones at their indices.
+TEST_F(PriorityReplayBufferTest, SingleShard) {
+  constexpr size_t kCapacity = 200;
+  constexpr size_t kPushNum = 300;
+  constexpr size_t kBatchSize = 64;
+  PriorityReplayBuffer buffer(1, kAlpha, kCapacity, Schema());
+  EXPECT_EQ(buffer.shard_num(), 1);
+  for (size_t i = 0; i < kPushNum; i++) {
+    Push(&buffer, static_cast<float>(i));
+  }
+  EXPECT_EQ(buffer.size(), kCapacity);
+
+  std::vector<size_t> indices;
+  std::vector<float> weights;
+  std::vector<float> states;
+  Sample(&buffer, kBatchSize, &indices, &weights, &states);
+  for (size_t i = 0; i < kBatchSize; i++) {
+    ASSERT_LT(indices[i], kCapacity);
+    // The first transitions are overridden by the ones pushed after the buffer is full.
+    size_t expect = indices[i] < kPushNum - kCapacity ? indices[i] + kCapacity : indices[i];
+    EXPECT_EQ(states[i * kStateDim], static_cast<float>(expect));
+  }
+}
+
+/// Feature: test the priority updates of the sharded priority replay buffer.
+/// Description: give a high priority to a few transitions spread over the shards, then sample a batch.
+/// Expectation: nearly all the samples are the transitions of high priority, at the indices they were updated.
+TEST_F(PriorityReplayBufferTest, ShardedUpdatePriorities) {
+  constexpr size_t kCapacity = 1 << 18;
+  constexpr size_t kBatchSize = 128;
+  PriorityReplayBuffer buffer(1, 1.0, kCapacity, Schema());
+  ASSERT_GT(buffer.shard_num(), 1);
+  for (size_t i = 0; i < kCapacity; i++) {
+    Push(&buffer, static_cast<float>(i));
+  }
+
+  std::vector<size_t> high_indices = {3, kCapacity / 3, kCapacity / 2 + 7, kCapacity - 1};
+  std::vector<size_t> update_indices(kCapacity);
+  std::vector<float> priorities(kCapacity, 1e-6);
+  for (size_t i = 0; i < kCapacity; i++) {
+    update_indices[i] = i;
+  }
+  for (auto idx : high_indices) {
+    priorities[idx] = 1e6;
+  }
+  EXPECT_TRUE(buffer.UpdatePriorities(update_indices, priorities));
+
+  std::vector<size_t> indices;
+  std::vector<float> weights;
+  std::vector<float> states;
+  Sample(&buffer, kBatchSize, &indices, &weights, &states);
+  size_t hit_num = 0;
+  for (size_t i = 0; i < kBatchSize; i++) {
+    if (std::find(high_indices.begin(), high_indices.end(), indices[i]) != high_indices.end()) {
+      hit_num++;
+    }
+  }
+  EXPECT_GE(hit_num, kBatchSize - 1);
+
+  // The sampled transitions are found again at their indices.
+  std::vector<size_t> same_indices;
+  std::vector<float> same_weights;
+  std::vector<float> same_states;
+  Sample(&buffer, kBatchSize, &same_indices, &same_weights, &same_states);
+  for (size_t i = 0; i < kBatchSize; i++) {
+    for (size_t j = 0; j < kBatchSize; j++) {
+      if (same_indices[i] == indices[j]) {
+        EXPECT_EQ(same_states[i * kStateDim], states[j * kStateDim]);
+      }
+    }
+  }
+}
+
+/// Feature: test the throughput of the priority replay buffer of 1M capacity.
+/// Description: several actors push transitions while the learner samples batches and updates their priorities.
+/// Expectation: the buffer is filled, and every sampled transition is consistent.
+TEST_F(PriorityReplayBufferTest, ConcurrentThroughput) {
+  constexpr size_t kCapacity = 1 << 20;
+  constexpr size_t kActorNum = 4;
+  constexpr size_t kBatchSize = 256;
+  PriorityReplayBuffer buffer(1, kAlpha, kCapacity, Schema());
+  // Give the learner transitions to sample from the beginning.
+  Push(&buffer, 0);
+
+  std::atomic<size_t> running_actors{kActorNum};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> actors;
+  for (size_t actor = 0; actor < kActorNum; actor++) {
+    actors.emplace_back([&buffer, &running_actors, actor]() {
+      for (size_t i = actor; i < kCapacity; i += kActorNum) {
+        Push(&buffer, static_cast<float>(i));
+      }
+      running_actors--;
+    });
+  }
+
+  size_t batch_num = 0;
+  std::vector<size_t> indices;
+  std::vector<float> weights;
+  std::vector<float> states;
+  std::vector<float> priorities(kBatchSize);
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(0.1, 10.0);
+  while (running_actors > 0) {
+    Sample(&buffer, kBatchSize, &indices, &weights, &states);
+    for (auto &priority : priorities) {
+      priority = dist(engine);
+    }
+    EXPECT_TRUE(buffer.UpdatePriorities(indices, priorities));
+    batch_num++;
+  }
+  for (auto &actor : actors) {
+    actor.join();
+  }
+  auto push_end = std::chrono::steady_clock::now();
+  EXPECT_EQ(buffer.size(), kCapacity);
+
+  constexpr size_t kSampleNum = 200;
+  auto sample_start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < kSampleNum; i++) {
+    Sample(&buffer, kBatchSize, &indices, &weights, &states);
+  }
+  auto sample_end = std::chrono::steady_clock::now();
+  for (auto idx : indices) {
+    EXPECT_LT(idx, kCapacity);
+  }
+
+  auto push_ms = std::chrono::duration_cast<std::chrono::milliseconds>(push_end - start).count();
+  auto sample_us = std::chrono::duration_cast<std::chrono::microseconds>(sample_end - sample_start).count();
+  MS_LOG(INFO) << "Shard num: " << buffer.shard_num() << ", " << kCapacity << " transitions pushed by " << kActorNum
+               << " actors in " << push_ms << " ms while " << batch_num << " batches were sampled, "
+               << sample_us / kSampleNum << " us per batch of " << kBatchSize << " at full capacity.";
+}
+}  // namespace kernel
+}  // namespace mindspore
@@ -0,0 +1,224 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#define private public
+#define protected public
+#include "kernel/kernel_select_cache.h"
+#undef private
+#undef protected
+#include "kernel/common_utils.h"
+#include "include/common/utils/utils.h"
+#include "utils/ms_context.h"
+
+namespace mindspore {
+namespace kernel {
+namespace {
+constexpr char kFingerprint[] = "0";
+}  // namespace
+
+class KernelSelectCacheTest : public UT::Common {
+ public:
+  KernelSelectCacheTest() = default;
+  virtual ~KernelSelectCacheTest() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/kernel_select_cache_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    directory_ = dir_template;
+  }
+  void TearDown() override { (void)system(("rm -rf " + directory_).c_str()); }
+
+ protected:
+  KernelBuildInfoPtr MakeBuildInfo(TypeId type) {
+    KernelBuildInfo::KernelBuildInfoBuilder builder;
+    builder.SetKernelType(CPU_KERNEL);
+    builder.SetInputsFormat({kOpFormat_DEFAULT, kOpFormat_DEFAULT});
+    builder.SetInputsDeviceType({type, type});
+    builder.SetOutputsFormat({kOpFormat_DEFAULT});
+    builder.SetOutputsDeviceType({type});
+    return builder.Build();
+  }
+
+  std::string directory_;
+};
+
+/// Feature: test the persistent kernel selection cache.
+/// Description: put selections into a cache and save it, then open the file with another cache.
+/// Expectation: the selections are loaded by signature, and the returned build info is a copy.
+TEST_F(KernelSelectCacheTest, SaveAndLoad) {
+  std::string file_name = directory_ + "/graph_cache/kernel_select_cache.json";
+  auto add_fp32 = KernelSelectCache::MakeSignature(kCPUDevice, "Add", kFingerprint,
+                                                   {kNumberTypeFloat32, kNumberTypeFloat32}, {kNumberTypeFloat32}, {});
+  auto add_fp16 = KernelSelectCache::MakeSignature(kCPUDevice, "Add", kFingerprint,
+                                                   {kNumberTypeFloat16, kNumberTypeFloat16}, {kNumberTypeFloat16}, {});
+  ASSERT_NE(add_fp32, add_fp16);
+  {
+    KernelSelectCache cache;
+    cache.Open(file_name);
+    ASSERT_EQ(cache.Get(add_fp32), nullptr);
+    cache.Put(add_fp32, MakeBuildInfo(kNumberTypeFloat32));
+    cache.Put(add_fp16, MakeBuildInfo(kNumberTypeFloat16));
+    ASSERT_TRUE(cache.Save());
+  }
+
+  KernelSelectCache cache;
+  cache.Open(file_name);
+  auto build_info = cache.Get(add_fp16);
+  ASSERT_NE(build_info, nullptr);
+  ASSERT_EQ(*build_info, *MakeBuildInfo(kNumberTypeFloat16));
+  build_info->SetOutputDeviceType(kNumberTypeFloat32, 0);
+  ASSERT_EQ(*cache.Get(add_fp16), *MakeBuildInfo(kNumberTypeFloat16));
+  ASSERT_EQ(*cache.Get(add_fp32), *MakeBuildInfo(kNumberTypeFloat32));
+}
+
+/// Feature: test the persistent kernel selection cache.
+/// Description: open a corrupted cache file.
+/// Expectation: the file is ignored and replaced by the next save.
+TEST_F(KernelSelectCacheTest, CorruptedFile) {
+  std::string file_name = directory_ + "/kernel_select_cache.json";
+  std::ofstream(file_name) << "{\"key\": \"kernel selection cache|1|" << MSVERSION << "\", \"contents\": [";
+  auto signature =
+    KernelSelectCache::MakeSignature(kCPUDevice, "ReLU", kFingerprint, {kNumberTypeFloat32}, {kNumberTypeFloat32}, {});
+  {
+    KernelSelectCache cache;
+    cache.Open(file_name);
+    ASSERT_EQ(cache.Get(signature), nullptr);
+    cache.Put(signature, MakeBuildInfo(kNumberTypeFloat32));
+    ASSERT_TRUE(cache.Save());
+  }
+  KernelSelectCache cache;
+  cache.Open(file_name);
+  ASSERT_NE(cache.Get(signature), nullptr);
+}
+
+/// Feature: test the persistent kernel selection cache.
+/// Description: open a file saved by another MindSpore version, then open a valid file without loading it.
+/// Expectation: neither file is loaded, and the file opened without loading is replaced by the next save.
+TEST_F(KernelSelectCacheTest, SkipStaleFile) {
+  std::string file_name = directory_ + "/kernel_select_cache.json";
+  auto signature =
+    KernelSelectCache::MakeSignature(kCPUDevice, "ReLU", kFingerprint, {kNumberTypeFloat32}, {kNumberTypeFloat32}, {});
+  {
+    KernelSelectCache cache;
+    cache.Open(file_name);
+    cache.Put(signature, MakeBuildInfo(kNumberTypeFloat32));
+    ASSERT_TRUE(cache.Save());
+  }
+  std::string contents;
+  {
+    std::ifstream ifs(file_name);
+    contents.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  }
+  auto version_pos = contents.find(MSVERSION);
+  ASSERT_NE(version_pos, std::string::npos);
+  std::ofstream(file_name) << contents.substr(0, version_pos) << "0.0.0"
+                           << contents.substr(version_pos + strlen(MSVERSION));
+  {
+    KernelSelectCache cache;
+    cache.Open(file_name);
+    ASSERT_EQ(cache.Get(signature), nullptr);
+  }
+
+  std::ofstream(file_name) << contents;
+  auto relu_fp16 =
+    KernelSelectCache::MakeSignature(kCPUDevice, "ReLU", kFingerprint, {kNumberTypeFloat16}, {kNumberTypeFloat16}, {});
+  {
+    KernelSelectCache cache;
+    cache.Open(file_name, false);
+    ASSERT_EQ(cache.Get(signature), nullptr);
+    cache.Put(relu_fp16, MakeBuildInfo(kNumberTypeFloat16));
+    ASSERT_TRUE(cache.Save());
+  }
+  KernelSelectCache cache;
+  cache.Open(file_name);
+  ASSERT_EQ(cache.Get(signature), nullptr);
+  ASSERT_NE(cache.Get(relu_fp16), nullptr);
+}
+
+/// Feature: test the persistent kernel selection cache.
+/// Description: open a saved file and save it without new selections, then put a known and a new selection.
+/// Expectation: the file is only written again after the new selection is put.
+TEST_F(KernelSelectCacheTest, SaveOnlyChanged) {
+  std::string file_name = directory_ + "/kernel_select_cache.json";
+  auto relu_fp32 =
+    KernelSelectCache::MakeSignature(kCPUDevice, "ReLU", kFingerprint, {kNumberTypeFloat32}, {kNumberTypeFloat32}, {});
+  auto relu_fp16 =
+    KernelSelectCache::MakeSignature(kCPUDevice, "ReLU", kFingerprint, {kNumberTypeFloat16}, {kNumberTypeFloat16}, {});
+  {
+    KernelSelectCache cache;
+    cache.Open(file_name);
+    cache.Put(relu_fp32, MakeBuildInfo(kNumberTypeFloat32));
+    ASSERT_TRUE(cache.Save());
+  }
+  KernelSelectCache cache;
+  cache.Open(file_name);
+  ASSERT_NE(cache.Get(relu_fp32), nullptr);
+  // Remove the file to see whether it is written again.
+  ASSERT_EQ(std::remove(file_name.c_str()), 0);
+  ASSERT_TRUE(cache.Save());
+  ASSERT_FALSE(std::ifstream(file_name).good());
+  cache.Put(relu_fp32, MakeBuildInfo(kNumberTypeFloat32));
+  ASSERT_TRUE(cache.Save());
+  ASSERT_FALSE(std::ifstream(file_name).good());
+
+  cache.Put(relu_fp16, MakeBuildInfo(kNumberTypeFloat16));
+  ASSERT_TRUE(cache.Save());
+  ASSERT_TRUE(std::ifstream(file_name).good());
+  KernelSelectCache saved_cache;
+  saved_cache.Open(file_name);
+  ASSERT_NE(saved_cache.Get(relu_fp32), nullptr);
+  ASSERT_NE(saved_cache.Get(relu_fp16), nullptr);
+}
+
+/// Feature: test the fingerprint of the registered kernels in the kernel selection signature.
+/// Description: make the fingerprints of kernel attr lists differing in a data type, a format and a ref map.
+/// Expectation: the same kernel attrs get the same fingerprint, the changed ones get another fingerprint.
+TEST_F(KernelSelectCacheTest, RegistryFingerprint) {
+  auto make_attrs = []() {
+    return std::vector<KernelAttr>{
+      KernelAttr().AddInputAttr(kNumberTypeFloat32).AddInputAttr(kNumberTypeFloat32).AddOutputAttr(kNumberTypeFloat32),
+      KernelAttr().AddInputAttr(kNumberTypeInt32).AddInputAttr(kNumberTypeInt32).AddOutputAttr(kNumberTypeInt32)};
+  };
+  auto fingerprint = KernelSelectCache::RegistryFingerprint(make_attrs());
+  ASSERT_EQ(fingerprint, KernelSelectCache::RegistryFingerprint(make_attrs()));
+  ASSERT_NE(fingerprint, KernelSelectCache::RegistryFingerprint({}));
+
+  auto changed_type = make_attrs();
+  changed_type[1].SetOutputAttr(0, kNumberTypeInt64, kOpFormat_DEFAULT);
+  ASSERT_NE(fingerprint, KernelSelectCache::RegistryFingerprint(changed_type));
+  auto changed_format = make_attrs();
+  changed_format[0].SetInputAttr(0, kNumberTypeFloat32, kOpFormat_NHWC);
+  ASSERT_NE(fingerprint, KernelSelectCache::RegistryFingerprint(changed_format));
+  auto changed_ref = make_attrs();
+  (void)changed_ref[0].AddOutInRef(0, 0);
+  ASSERT_NE(fingerprint, KernelSelectCache::RegistryFingerprint(changed_ref));
+
+  auto changed_fingerprint = KernelSelectCache::RegistryFingerprint(changed_type);
+  ASSERT_NE(KernelSelectCache::MakeSignature(kCPUDevice, "Add", fingerprint, {kNumberTypeFloat32}, {}, {}),
+            KernelSelectCache::MakeSignature(kCPUDevice, "Add", changed_fingerprint, {kNumberTypeFloat32}, {}, {}));
+}
+}  // namespace kernel
+}  // namespace mindspore
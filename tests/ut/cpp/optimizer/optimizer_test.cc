@@ -15,6 +15,7 @@
  */
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include "common/common_test.h"
 #include "common/py_func_graph_fetcher.h"
@@ -62,5 +63,22 @@ TEST_F(TestOptOptimizer, test_step_opt) {
   auto after = optimizer->step(before);
 }
 
+/// Feature: test the fixed point of optimizer.
+/// Description: run an optimizer whose second pass changes the graph in the first two rounds only.
+/// Expectation: the passes after the last change are not run again once every pass has seen the unchanged graph.
+TEST_F(TestOptOptimizer, test_step_fixed_point) {
+  std::vector<size_t> run_num(3, 0);
+  auto make_pass = [&run_num](size_t index, size_t change_num) {
+    return OptPassConfig([&run_num, index, change_num](const FuncGraphPtr &, const OptimizerPtr &) {
+      return ++run_num[index] <= change_num;
+    });
+  };
+  pipeline::ResourcePtr res = std::make_shared<pipeline::Resource>();
+  auto optimizer =
+    Optimizer::MakeOptimizer("ut_test", res, {{"a", make_pass(0, 0)}, {"b", make_pass(1, 2)}, {"c", make_pass(2, 0)}});
+  (void)optimizer->step(std::make_shared<FuncGraph>(), false);
+  ASSERT_EQ(run_num, std::vector<size_t>({3, 3, 2}));
+}
+
 }  // namespace opt
 }  // namespace mindspore
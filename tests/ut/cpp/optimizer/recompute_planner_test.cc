@@ -0,0 +1,145 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "common/common_test.h"
+#include "frontend/optimizer/recompute_planner.h"
+
+namespace mindspore {
+namespace opt {
+namespace {
+constexpr size_t kActivationSize = 100;
+}  // namespace
+
+class TestRecomputePlanner : public UT::Common {
+ public:
+  TestRecomputePlanner() = default;
+
+  // The forward activation produced at step, which is used by the next forward step and the backward step user.
+  static ActivationInfo Forward(size_t step, size_t backward_user, double flops, const std::vector<size_t> &inputs) {
+    ActivationInfo activation;
+    activation.size = kActivationSize;
+    activation.start = step;
+    activation.end = backward_user;
+    activation.recomputable = true;
+    activation.last_forward_use = step + 1;
+    activation.first_backward_use = backward_user;
+    activation.flops = flops;
+    activation.inputs = inputs;
+    return activation;
+  }
+};
+
+/// Feature: test the recompute planner.
+/// Description: four forward activations are kept for the backward pass in the reverse order, the budget only holds
+/// three of them.
+/// Expectation: the cheapest activation released at the peak is recomputed, and the peak fits the budget.
+TEST_F(TestRecomputePlanner, PlanWithinBudget) {
+  RecomputePlanner planner;
+  (void)planner.AddActivation(Forward(0, 8, 1e6, {}));
+  (void)planner.AddActivation(Forward(1, 7, 10, {0}));
+  (void)planner.AddActivation(Forward(2, 6, 1e6, {1}));
+  (void)planner.AddActivation(Forward(3, 5, 10, {2}));
+  ASSERT_EQ(planner.PeakMemory(), 4 * kActivationSize);
+
+  auto planned = planner.Plan(3 * kActivationSize);
+  ASSERT_EQ(planned.size(), 1);
+  EXPECT_EQ(planned[0], 1);
+  EXPECT_EQ(planner.PeakMemory(), 3 * kActivationSize);
+  EXPECT_DOUBLE_EQ(planner.ExtraFlops(), 10);
+
+  // Nothing more is needed once the peak fits the budget.
+  EXPECT_TRUE(planner.Plan(3 * kActivationSize).empty());
+}
+
+/// Feature: test the recompute planner.
+/// Description: recompute an activation whose large input is only used by the forward pass.
+/// Expectation: the recomputation would keep the large input alive until the backward pass, so it is not picked.
+TEST_F(TestRecomputePlanner, RejectLongerInputLifetime) {
+  RecomputePlanner planner;
+  ActivationInfo large_input;
+  large_input.size = 5 * kActivationSize;
+  large_input.start = 0;
+  large_input.end = 1;
+  (void)planner.AddActivation(large_input);
+  (void)planner.AddActivation(Forward(1, 7, 10, {0}));
+  (void)planner.AddActivation(Forward(2, 6, 10, {1}));
+  (void)planner.AddActivation(Forward(3, 5, 10, {2}));
+  size_t peak = planner.PeakMemory();
+  ASSERT_EQ(peak, 6 * kActivationSize);
+
+  auto planned = planner.Plan(kActivationSize);
+  for (auto id : planned) {
+    EXPECT_NE(id, 1);
+  }
+  EXPECT_FALSE(planner.recomputed(1));
+  EXPECT_EQ(planner.PeakMemory(), peak);
+}
+
+/// Feature: test the recompute planner.
+/// Description: mark a chain of activations recomputed as the user annotations do.
+/// Expectation: the recomputed input of a recomputed activation is recomputed before it, and the peak drops.
+TEST_F(TestRecomputePlanner, RecomputedChain) {
+  RecomputePlanner planner;
+  (void)planner.AddActivation(Forward(0, 8, 1, {}));
+  (void)planner.AddActivation(Forward(1, 7, 1, {0}));
+  (void)planner.AddActivation(Forward(2, 6, 1, {1}));
+  (void)planner.AddActivation(Forward(3, 5, 1, {2}));
+  planner.SetRecomputed(1);
+  planner.SetRecomputed(2);
+  // The activation 1 is recomputed at step 6 for the recomputation of the activation 2.
+  EXPECT_EQ(planner.PeakMemory(), 3 * kActivationSize);
+  EXPECT_DOUBLE_EQ(planner.ExtraFlops(), 2);
+  EXPECT_TRUE(planner.Plan(4 * kActivationSize).empty());
+}
+/// Feature: test the recompute planner.
+/// Description: mark activations recomputed which have no backward users, one is the input of a recomputed activation
+/// and the other is not used by any recomputed activation.
+/// Expectation: the input is released after the forward pass and recomputed for its user, the other one is kept as
+/// usual, and only the flops of the activations actually recomputed are counted.
+TEST_F(TestRecomputePlanner, RecomputedWithoutBackwardUsers) {
+  constexpr size_t kStepNum = 10;
+  RecomputePlanner planner;
+  ActivationInfo pulled_input;
+  pulled_input.size = kActivationSize;
+  pulled_input.start = 0;
+  pulled_input.end = 1;
+  pulled_input.last_forward_use = 1;
+  pulled_input.first_backward_use = kStepNum;
+  pulled_input.flops = 1;
+  (void)planner.AddActivation(pulled_input);
+  (void)planner.AddActivation(Forward(1, 8, 10, {0}));
+  ActivationInfo kept;
+  kept.size = kActivationSize + kActivationSize / 2;
+  kept.start = 3;
+  kept.end = 7;
+  (void)planner.AddActivation(kept);
+  ActivationInfo unused;
+  unused.size = kActivationSize;
+  unused.start = 0;
+  unused.end = 0;
+  unused.first_backward_use = kStepNum;
+  unused.flops = 100;
+  (void)planner.AddActivation(unused);
+  planner.SetRecomputed(0);
+  planner.SetRecomputed(1);
+  planner.SetRecomputed(3);
+  // The activation 0 is not alive with the kept activation, it is recomputed at step 8 for the activation 1.
+  EXPECT_EQ(planner.PeakMemory(), 2 * kActivationSize);
+  EXPECT_DOUBLE_EQ(planner.ExtraFlops(), 11);
+}
+}  // namespace opt
+}  // namespace mindspore
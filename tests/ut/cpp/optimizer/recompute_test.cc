@@ -0,0 +1,122 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "abstract/abstract_value.h"
+#include "frontend/optimizer/recompute.h"
+#include "include/common/utils/utils.h"
+#include "ir/func_graph.h"
+#include "ir/manager.h"
+#include "mindspore/core/ops/core_ops.h"
+
+namespace mindspore {
+namespace opt {
+namespace {
+constexpr char kMemoryBudgetEnv[] = "MS_DEV_RECOMPUTE_MEMORY_BUDGET";
+// Each activation is a float32 tensor of 4 MB.
+const ShapeVector kShape = {1024, 1024};
+
+AbstractBasePtr CreateAbstract() { return std::make_shared<abstract::AbstractTensor>(kFloat32, kShape); }
+
+CNodePtr NewNode(const FuncGraphPtr &graph, const PrimitivePtr &prim, const std::vector<AnfNodePtr> &inputs,
+                 bool is_bprop) {
+  std::vector<AnfNodePtr> node_inputs = {NewValueNode(prim)};
+  (void)node_inputs.insert(node_inputs.end(), inputs.begin(), inputs.end());
+  auto node = graph->NewCNode(node_inputs);
+  node->set_abstract(CreateAbstract());
+  if (is_bprop) {
+    node->set_fullname_with_scope("Gradients/Default/" + prim->name());
+  }
+  return node;
+}
+
+bool IsRecomputed(const CNodePtr &node) {
+  auto value = node->GetAttr(kAttrRecompute);
+  return value != nullptr && value->isa<BoolImm>() && GetValue<bool>(value);
+}
+}  // namespace
+
+class TestRecompute : public UT::Common {
+ public:
+  TestRecompute() = default;
+
+  // Three forward activations, the first one is used by the backward pass through a depend, the others are used by
+  // the first backward node. The peak memory of the activations is 16 MB when the first backward node runs.
+  void SetUp() override {
+    graph_ = std::make_shared<FuncGraph>();
+    auto x = graph_->add_parameter();
+    x->set_abstract(CreateAbstract());
+    a_ = NewNode(graph_, prim::kPrimExp, {x}, false);
+    b_ = NewNode(graph_, prim::kPrimExp, {a_}, false);
+    c_ = NewNode(graph_, prim::kPrimExp, {b_}, false);
+    auto d = NewNode(graph_, prim::kPrimMul, {c_, b_}, true);
+    depend_ = NewNode(graph_, prim::kPrimDepend, {a_, d}, true);
+    e_ = NewNode(graph_, prim::kPrimMul, {d, depend_}, true);
+    graph_->set_output(e_);
+    mng_ = Manage(graph_);
+  }
+  void TearDown() override { (void)unsetenv(kMemoryBudgetEnv); }
+
+ protected:
+  FuncGraphPtr graph_;
+  FuncGraphManagerPtr mng_;
+  CNodePtr a_;
+  CNodePtr b_;
+  CNodePtr c_;
+  CNodePtr depend_;
+  CNodePtr e_;
+};
+
+/// Feature: test the automatic recomputation with a memory budget.
+/// Description: insert the recomputed nodes of the graph whose peak memory of 16 MB exceeds the budget of 13 MB.
+/// Expectation: only the first activation, which is released at the peak, is set the recompute attr, and the backward
+/// pass reads a duplicated node instead of it.
+TEST_F(TestRecompute, PlanWithMemoryBudget) {
+  (void)setenv(kMemoryBudgetEnv, "13", 1);
+  InsertRecomputedNodes(graph_);
+  EXPECT_TRUE(IsRecomputed(a_));
+  EXPECT_FALSE(IsRecomputed(b_));
+  EXPECT_FALSE(IsRecomputed(c_));
+
+  auto output = graph_->output()->cast<CNodePtr>();
+  ASSERT_NE(output, nullptr);
+  auto new_depend = output->input(kIndex2)->cast<CNodePtr>();
+  ASSERT_NE(new_depend, nullptr);
+  ASSERT_TRUE(IsPrimitiveCNode(new_depend, prim::kPrimDepend));
+  auto recomputed = new_depend->input(kIndex1)->cast<CNodePtr>();
+  ASSERT_NE(recomputed, nullptr);
+  EXPECT_NE(recomputed, a_);
+  EXPECT_TRUE(IsPrimitiveCNode(recomputed, prim::kPrimExp));
+  EXPECT_TRUE(recomputed->HasAttr("duplicated"));
+}
+
+/// Feature: test the automatic recomputation with a memory budget.
+/// Description: insert the recomputed nodes of the graph whose peak memory fits the budget of 16 MB.
+/// Expectation: no activation is set the recompute attr and the graph is unchanged.
+TEST_F(TestRecompute, PeakWithinMemoryBudget) {
+  (void)setenv(kMemoryBudgetEnv, "16", 1);
+  InsertRecomputedNodes(graph_);
+  for (const auto &node : {a_, b_, c_}) {
+    EXPECT_FALSE(IsRecomputed(node));
+  }
+  EXPECT_EQ(graph_->output(), e_);
+  EXPECT_EQ(e_->input(kIndex2), depend_);
+}
+}  // namespace opt
+}  // namespace mindspore
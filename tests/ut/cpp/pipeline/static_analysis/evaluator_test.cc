@@ -61,6 +61,48 @@ TEST_F(TestEvaluatorCacheMap, test_evaluator_cache_map) {
   ASSERT_TRUE(iter == cache.end());
 }
 
+/// Feature: Sharded cache of the infer threads.
+/// Description: Several threads update the same entries of an EvaluatorAttrCache at the same time.
+/// Expectation: Every entry is kept, and the updates of the same key are not lost.
+TEST_F(TestEvaluatorCacheMap, test_evaluator_attr_cache_multi_thread) {
+  EvaluatorAttrCache cache;
+  constexpr int64_t kKeyNum = 64;
+  constexpr size_t kThreadNum = 4;
+  std::vector<AbstractBasePtrList> keys;
+  for (int64_t i = 0; i < kKeyNum; ++i) {
+    keys.push_back({FromValue(i, false)});
+  }
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&cache, &keys]() {
+      for (const auto &key : keys) {
+        cache.update(key, [](AttrValueMapPtr *attrs) {
+          if (*attrs == nullptr) {
+            *attrs = std::make_shared<AttrValueMap>();
+          }
+          auto iter = (*attrs)->find("count");
+          int64_t count = iter == (*attrs)->end() ? 0 : GetValue<int64_t>(iter->second);
+          (**attrs)["count"] = MakeValue(count + 1);
+        });
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(cache.size(), keys.size());
+  for (const auto &key : keys) {
+    auto attrs = cache.get(key);
+    ASSERT_NE(attrs, nullptr);
+    ASSERT_EQ(GetValue<int64_t>((*attrs)["count"]), static_cast<int64_t>(kThreadNum));
+  }
+  cache.update(keys[0], [](AttrValueMapPtr *attrs) { *attrs = nullptr; });
+  ASSERT_EQ(cache.get(keys[0]), nullptr);
+  ASSERT_EQ(cache.size(), keys.size() - 1);
+  cache.clear();
+  ASSERT_TRUE(cache.empty());
+}
+
 /* skip ut test cases temporarily
 class TestStandardEvaluator : public UT::Common {
  public:
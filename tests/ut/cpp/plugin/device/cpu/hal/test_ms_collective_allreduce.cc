@@ -0,0 +1,242 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/common_test.h"
+#define private public
+#include "plugin/device/cpu/hal/hardware/allreduce_impl.h"
+#undef private
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+using MessagePtr = std::shared_ptr<std::vector<unsigned char>>;
+constexpr auto kReceiveTimeout = std::chrono::seconds(30);
+
+// The messages between the ranks of one process, a queue for each pair of sender and receiver.
+class Mailbox {
+ public:
+  explicit Mailbox(size_t rank_size) : rank_size_(rank_size), queues_(rank_size * rank_size) {}
+
+  void Put(size_t from, size_t to, const void *data, size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_[from * rank_size_ + to].push_back(std::make_shared<std::vector<unsigned char>>(bytes, bytes + size));
+    cond_.notify_all();
+  }
+
+  bool Take(size_t from, size_t to, MessagePtr *output) {
+    auto &queue = queues_[from * rank_size_ + to];
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cond_.wait_for(lock, kReceiveTimeout, [&queue]() { return !queue.empty(); })) {
+      return false;
+    }
+    *output = queue.front();
+    queue.pop_front();
+    return true;
+  }
+
+ private:
+  size_t rank_size_;
+  std::vector<std::deque<MessagePtr>> queues_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+// The launcher of one rank, whose messages go through the mailbox instead of the collective node.
+class FakeLauncher : public AllReduceLauncher {
+ public:
+  FakeLauncher(Mailbox *mailbox, size_t rank_id, size_t rank_size, size_t segment_num) : mailbox_(mailbox) {
+    rank_id_ = rank_id;
+    rank_size_ = rank_size;
+    segment_num_ = segment_num;
+  }
+  ~FakeLauncher() override = default;
+
+  uint64_t SendAsync(uint32_t rank, const void *data, size_t size) const override {
+    mailbox_->Put(rank_id_, rank, data, size);
+    return 0;
+  }
+  bool WaitSend(uint64_t) const override { return true; }
+  bool Receive(uint32_t rank, MessagePtr *output) const override { return mailbox_->Take(rank, rank_id_, output); }
+
+ private:
+  Mailbox *mailbox_;
+};
+
+std::vector<std::unique_ptr<FakeLauncher>> CreateLaunchers(Mailbox *mailbox, size_t rank_size, size_t segment_num) {
+  std::vector<std::unique_ptr<FakeLauncher>> launchers;
+  for (size_t rank = 0; rank < rank_size; ++rank) {
+    launchers.push_back(std::make_unique<FakeLauncher>(mailbox, rank, rank_size, segment_num));
+  }
+  return launchers;
+}
+
+// Run func on a thread for every rank, and return whether all of them succeeded.
+bool RunOnRanks(size_t rank_size, const std::function<bool(size_t)> &func) {
+  std::vector<char> results(rank_size, 0);
+  std::vector<std::thread> threads;
+  for (size_t rank = 0; rank < rank_size; ++rank) {
+    threads.emplace_back([&func, &results, rank]() { results[rank] = func(rank) ? 1 : 0; });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return std::all_of(results.begin(), results.end(), [](char result) { return result != 0; });
+}
+
+// The integers keep every sum exact in float32 and in fp16.
+std::vector<std::vector<float>> CreateInputs(size_t rank_size, size_t data_num) {
+  std::vector<std::vector<float>> inputs(rank_size, std::vector<float>(data_num));
+  for (size_t rank = 0; rank < rank_size; ++rank) {
+    for (size_t i = 0; i < data_num; ++i) {
+      inputs[rank][i] = static_cast<float>(i % 13 + rank);
+    }
+  }
+  return inputs;
+}
+
+float ExpectedSum(size_t rank_size, size_t i) {
+  return static_cast<float>(rank_size * (i % 13) + rank_size * (rank_size - 1) / 2);
+}
+}  // namespace
+
+class TestMSCollectiveAllReduce : public UT::Common {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+/// Feature: the ring allreduce of the cpu collective communication.
+/// Description: reduce buffers split into chunks of uneven sizes and pipelined in many segments, in float32, on the
+/// fp16 wire, and a buffer smaller than the rank number.
+/// Expectation: every rank gets the sum of the inputs of all the ranks.
+TEST_F(TestMSCollectiveAllReduce, RingAllReduce) {
+  constexpr size_t kRankSize = 4;
+  constexpr size_t kSegmentNum = 16;
+  for (size_t data_num : {size_t(1003), size_t(3)}) {
+    for (auto wire_type : {CompressionType::kNone, CompressionType::kFp16}) {
+      Mailbox mailbox(kRankSize);
+      auto launchers = CreateLaunchers(&mailbox, kRankSize, kSegmentNum);
+      auto inputs = CreateInputs(kRankSize, data_num);
+      std::vector<std::vector<float>> outputs(kRankSize, std::vector<float>(data_num));
+      ASSERT_TRUE(RunOnRanks(kRankSize, [&](size_t rank) {
+        auto data_size = data_num * sizeof(float);
+        if (wire_type == CompressionType::kNone) {
+          return launchers[rank]->Execute(inputs[rank].data(), outputs[rank].data(), data_size);
+        }
+        return launchers[rank]->RingAllReduce(inputs[rank].data(), outputs[rank].data(), data_size, wire_type);
+      }));
+      for (size_t rank = 0; rank < kRankSize; ++rank) {
+        for (size_t i = 0; i < data_num; ++i) {
+          ASSERT_EQ(outputs[rank][i], ExpectedSum(kRankSize, i)) << "rank " << rank << ", index " << i;
+        }
+      }
+    }
+  }
+}
+
+/// Feature: the ring reduce scatter of the cpu collective communication.
+/// Description: reduce blocks pipelined in several segments and scatter them to three ranks.
+/// Expectation: rank i gets the sum of the i-th blocks of all the ranks.
+TEST_F(TestMSCollectiveAllReduce, ReduceScatter) {
+  constexpr size_t kRankSize = 3;
+  constexpr size_t kSegmentNum = 8;
+  constexpr size_t kBlockNum = 101;
+  Mailbox mailbox(kRankSize);
+  auto launchers = CreateLaunchers(&mailbox, kRankSize, kSegmentNum);
+  auto inputs = CreateInputs(kRankSize, kBlockNum * kRankSize);
+  std::vector<std::vector<float>> outputs(kRankSize, std::vector<float>(kBlockNum));
+  ASSERT_TRUE(RunOnRanks(kRankSize, [&](size_t rank) {
+    return launchers[rank]->ReduceScatter(inputs[rank].data(), outputs[rank].data(), kBlockNum * sizeof(float));
+  }));
+  for (size_t rank = 0; rank < kRankSize; ++rank) {
+    for (size_t i = 0; i < kBlockNum; ++i) {
+      ASSERT_EQ(outputs[rank][i], ExpectedSum(kRankSize, rank * kBlockNum + i)) << "rank " << rank << ", index " << i;
+    }
+  }
+}
+
+/// Feature: the all to all of the cpu collective communication.
+/// Description: every rank of four sends a distinct block of bytes to every rank, including itself.
+/// Expectation: the i-th block of the output of rank j is the j-th block of the input of rank i.
+TEST_F(TestMSCollectiveAllReduce, AllToAll) {
+  constexpr size_t kRankSize = 4;
+  constexpr size_t kBlockSize = 67;
+  Mailbox mailbox(kRankSize);
+  auto launchers = CreateLaunchers(&mailbox, kRankSize, 1);
+  std::vector<std::vector<uint8_t>> inputs(kRankSize, std::vector<uint8_t>(kBlockSize * kRankSize));
+  for (size_t rank = 0; rank < kRankSize; ++rank) {
+    for (size_t i = 0; i < inputs[rank].size(); ++i) {
+      inputs[rank][i] = static_cast<uint8_t>(rank * 31 + i);
+    }
+  }
+  std::vector<std::vector<uint8_t>> outputs(kRankSize, std::vector<uint8_t>(kBlockSize * kRankSize));
+  ASSERT_TRUE(RunOnRanks(kRankSize, [&](size_t rank) {
+    return launchers[rank]->AllToAll(inputs[rank].data(), outputs[rank].data(), kBlockSize);
+  }));
+  for (size_t rank = 0; rank < kRankSize; ++rank) {
+    for (size_t peer = 0; peer < kRankSize; ++peer) {
+      for (size_t i = 0; i < kBlockSize; ++i) {
+        ASSERT_EQ(outputs[rank][peer * kBlockSize + i], inputs[peer][rank * kBlockSize + i])
+          << "rank " << rank << ", peer " << peer << ", index " << i;
+      }
+    }
+  }
+}
+
+/// Feature: the hierarchical allreduce of the cpu collective communication.
+/// Description: four ranks on two hosts share the name of the shared memory of their host, then reduce a buffer larger
+/// than the shared memory slot through it, the first ranks of the hosts running the ring between them.
+/// Expectation: every rank gets the sum of the inputs of all the ranks.
+TEST_F(TestMSCollectiveAllReduce, HierarchicalAllReduce) {
+  constexpr size_t kRankSize = 4;
+  constexpr size_t kSegmentNum = 4096;
+  const std::vector<std::vector<uint32_t>> hosts = {{0, 1}, {2, 3}};
+  Mailbox mailbox(kRankSize);
+  auto launchers = CreateLaunchers(&mailbox, kRankSize, kSegmentNum);
+  for (size_t rank = 0; rank < kRankSize; ++rank) {
+    launchers[rank]->local_ranks_ = hosts[rank / hosts[0].size()];
+    launchers[rank]->leader_ranks_ = {hosts[0][0], hosts[1][0]};
+  }
+  ASSERT_TRUE(RunOnRanks(kRankSize, [&](size_t rank) { return launchers[rank]->InitShmSegment(); }));
+
+  size_t data_num = (4 << 20) / sizeof(float) + 37;
+  auto inputs = CreateInputs(kRankSize, data_num);
+  std::vector<std::vector<float>> outputs(kRankSize, std::vector<float>(data_num));
+  ASSERT_TRUE(RunOnRanks(kRankSize, [&](size_t rank) {
+    launchers[rank]->hierarchical_ = true;
+    return launchers[rank]->Execute(inputs[rank].data(), outputs[rank].data(), data_num * sizeof(float));
+  }));
+  for (size_t rank = 0; rank < kRankSize; ++rank) {
+    for (size_t i = 0; i < data_num; ++i) {
+      ASSERT_EQ(outputs[rank][i], ExpectedSum(kRankSize, i)) << "rank " << rank << ", index " << i;
+    }
+  }
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,137 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include <gtest/gtest.h>
+#include "plugin/device/cpu/hal/hardware/ms_collective_compressor.h"
+#include "common/common_test.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+class TestMSCollectiveCompressor : public UT::Common {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+/// Feature: gradient compression of the cpu collective communication.
+/// Description: parse the compression of several groups from one config.
+/// Expectation: each group gets its own compression and the default parameters.
+TEST_F(TestMSCollectiveCompressor, ParseCompressionConfig) {
+  std::string config = "group_a:fp16;mccl_world_group:topk:0.05;group_b:onebit:0.9;group_c:topk";
+  auto world = ParseCompressionConfig(config, "mccl_world_group");
+  EXPECT_EQ(world.type, CompressionType::kTopK);
+  EXPECT_FLOAT_EQ(world.param, 0.05);
+  EXPECT_EQ(ParseCompressionConfig(config, "group_a").type, CompressionType::kFp16);
+  EXPECT_FLOAT_EQ(ParseCompressionConfig(config, "group_b").param, 0.9);
+  EXPECT_FLOAT_EQ(ParseCompressionConfig(config, "group_c").param, 0.01);
+  EXPECT_EQ(ParseCompressionConfig(config, "group_d").type, CompressionType::kNone);
+  EXPECT_ANY_THROW(ParseCompressionConfig("group_a:fp8", "group_a"));
+}
+
+/// Feature: gradient compression of the cpu collective communication.
+/// Description: cast floats to fp16 and bf16 and back.
+/// Expectation: the values are rounded to nearest even, and the special values are kept.
+TEST_F(TestMSCollectiveCompressor, HalfConversion) {
+  std::vector<float> input = {0, -0.0, 1, -2.5, 65504, 1e6, 5.96e-8, 1.0009766, INFINITY, NAN};
+  std::vector<uint16_t> half(input.size());
+  std::vector<float> output(input.size());
+  Float32ToHalf(input.data(), input.size(), half.data(), false);
+  HalfToFloat32(half.data(), half.size(), output.data(), false);
+  std::vector<uint16_t> expect_fp16 = {0x0000, 0x8000, 0x3C00, 0xC100, 0x7BFF, 0x7C00, 0x0001, 0x3C01, 0x7C00};
+  for (size_t i = 0; i < expect_fp16.size(); ++i) {
+    EXPECT_EQ(half[i], expect_fp16[i]);
+  }
+  EXPECT_FLOAT_EQ(output[2], 1);
+  EXPECT_FLOAT_EQ(output[3], -2.5);
+  EXPECT_TRUE(std::isinf(output[5]));
+  EXPECT_TRUE(std::isnan(output[9]));
+
+  Float32ToHalf(input.data(), input.size(), half.data(), true);
+  HalfToFloat32(half.data(), half.size(), output.data(), true);
+  EXPECT_EQ(half[2], 0x3F80);
+  EXPECT_FLOAT_EQ(output[3], -2.5);
+  EXPECT_FLOAT_EQ(output[5], 999424);
+  EXPECT_TRUE(std::isnan(output[9]));
+}
+
+/// Feature: gradient compression of the cpu collective communication.
+/// Description: send the same gradient many times with top-k and 1-bit compression.
+/// Expectation: the error feedback makes the sum of the received gradients close to the sum of the sent ones, and
+/// the payloads are much smaller than the gradient.
+TEST_F(TestMSCollectiveCompressor, ErrorFeedback) {
+  size_t num = 1000;
+  size_t steps = 200;
+  std::vector<float> gradient(num);
+  for (size_t i = 0; i < num; ++i) {
+    gradient[i] = std::sin(static_cast<float>(i)) * 0.01 + 0.001;
+  }
+  std::vector<CompressionConfig> configs = {{CompressionType::kTopK, 0.05f}, {CompressionType::kOneBit, 0}};
+  for (const auto &config : configs) {
+    GradientCompressor compressor(config);
+    std::vector<float> received(num, 0);
+    std::vector<uint8_t> payload;
+    for (size_t step = 0; step < steps; ++step) {
+      ASSERT_TRUE(compressor.Compress(gradient.data(), gradient.data(), num, &payload));
+      ASSERT_TRUE(compressor.DecompressAdd(payload.data(), payload.size(), received.data(), num));
+    }
+    EXPECT_LT(payload.size(), num * sizeof(float) / 8);
+    double error = 0;
+    double total = 0;
+    for (size_t i = 0; i < num; ++i) {
+      error += std::fabs(received[i] - gradient[i] * steps);
+      total += std::fabs(gradient[i] * steps);
+    }
+    EXPECT_LT(error / total, 0.05);
+  }
+}
+
+/// Feature: gradient compression of the cpu collective communication.
+/// Description: compress more gradients than the residuals kept, reusing the first gradient before a new one comes.
+/// Expectation: the least recently used residual is dropped, so the number of residuals is bounded, and a dropped
+/// gradient restarts from an empty residual.
+TEST_F(TestMSCollectiveCompressor, ResidualEviction) {
+  size_t num = 100;
+  std::vector<std::vector<float>> gradients(3, std::vector<float>(num, 1));
+  GradientCompressor compressor({CompressionType::kTopK, 0.01f}, 2);
+  std::vector<uint8_t> payload;
+  ASSERT_TRUE(compressor.Compress(gradients[0].data(), gradients[0].data(), num, &payload));
+  ASSERT_TRUE(compressor.Compress(gradients[1].data(), gradients[1].data(), num, &payload));
+  ASSERT_TRUE(compressor.Compress(gradients[0].data(), gradients[0].data(), num, &payload));
+  ASSERT_TRUE(compressor.Compress(gradients[2].data(), gradients[2].data(), num, &payload));
+  EXPECT_EQ(compressor.residual_num(), 2);
+
+  // The residual of the first gradient is kept, so the element sent accumulates the unsent gradient of two steps.
+  std::vector<float> received(num, 0);
+  ASSERT_TRUE(compressor.Compress(gradients[0].data(), gradients[0].data(), num, &payload));
+  ASSERT_TRUE(compressor.DecompressAdd(payload.data(), payload.size(), received.data(), num));
+  EXPECT_FLOAT_EQ(std::accumulate(received.begin(), received.end(), 0.0f), 3);
+  // The residual of the second gradient is dropped, so it restarts from its gradient of this step.
+  received.assign(num, 0);
+  ASSERT_TRUE(compressor.Compress(gradients[1].data(), gradients[1].data(), num, &payload));
+  ASSERT_TRUE(compressor.DecompressAdd(payload.data(), payload.size(), received.data(), num));
+  EXPECT_FLOAT_EQ(std::accumulate(received.begin(), received.end(), 0.0f), 1);
+  EXPECT_EQ(compressor.residual_num(), 2);
+
+  compressor.ClearResiduals();
+  EXPECT_EQ(compressor.residual_num(), 0);
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
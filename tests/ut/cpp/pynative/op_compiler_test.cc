@@ -0,0 +1,125 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#define private public
+#include "runtime/pynative/op_executor.h"
+#include "runtime/pynative/op_compiler.h"
+#undef private
+
+namespace mindspore::pynative {
+namespace {
+constexpr char kReplicaNumEnv[] = "MS_DEV_PYNATIVE_OP_GRAPH_REPLICA_NUM";
+constexpr char kGraphInfo[] = "op_compiler_test_op";
+
+OpCompilerInfoPtr CreateCompilerInfo(GraphId graph_id) {
+  return std::make_shared<OpCompilerInfo>(kGraphInfo, graph_id, nullptr, std::vector<KernelWithIndex>(), nullptr,
+                                          false);
+}
+
+void SetInQueue(GraphId graph_id, bool in_queue) {
+  auto &op_executor = runtime::OpExecutor::GetInstance();
+  std::lock_guard<std::mutex> lock(op_executor.actor_mutex_);
+  if (in_queue) {
+    (void)op_executor.actor_in_queue_.insert(graph_id);
+  } else {
+    (void)op_executor.actor_in_queue_.erase(graph_id);
+  }
+}
+}  // namespace
+
+class TestOpCompiler : public UT::Common {
+ public:
+  TestOpCompiler() = default;
+  virtual ~TestOpCompiler() = default;
+
+  void SetUp() override { max_replica_num_ = OpCompiler::GetInstance().max_replica_num_; }
+  void TearDown() override {
+    auto &op_compiler = OpCompiler::GetInstance();
+    op_compiler.max_replica_num_ = max_replica_num_;
+    op_compiler.ClearOpCache(kGraphInfo);
+    for (GraphId graph_id : queued_ids_) {
+      SetInQueue(graph_id, false);
+    }
+  }
+
+ protected:
+  void Queue(GraphId graph_id) {
+    SetInQueue(graph_id, true);
+    queued_ids_.push_back(graph_id);
+  }
+
+  size_t max_replica_num_{0};
+  std::vector<GraphId> queued_ids_;
+};
+
+/// Feature: test the number of graph replicas of an operator.
+/// Description: create the op compiler without the env, with a valid number and with numbers out of range.
+/// Expectation: the default number is small, and a number out of [1, 8] falls back to it.
+TEST_F(TestOpCompiler, ReplicaNumEnv) {
+  (void)unsetenv(kReplicaNumEnv);
+  auto default_num = OpCompiler().max_replica_num_;
+  ASSERT_GE(default_num, 1);
+  ASSERT_LE(default_num, 8);
+  (void)setenv(kReplicaNumEnv, "4", 1);
+  ASSERT_EQ(OpCompiler().max_replica_num_, 4);
+  for (const char *invalid : {"0", "-1", "9", "invalid"}) {
+    (void)setenv(kReplicaNumEnv, invalid, 1);
+    ASSERT_EQ(OpCompiler().max_replica_num_, default_num) << invalid;
+  }
+  (void)unsetenv(kReplicaNumEnv);
+}
+
+/// Feature: test the graph replicas of an operator whose launches are still in the run queue.
+/// Description: cache replicas of an operator while the former ones are queued, then lower the max replica number.
+/// Expectation: an idle replica is reused, one more replica is compiled only below the max number, the first replica
+/// is waited for when all of them are queued, and the oldest replicas are dropped beyond the max number.
+TEST_F(TestOpCompiler, GraphReplicas) {
+  auto &op_compiler = OpCompiler::GetInstance();
+  op_compiler.max_replica_num_ = 2;
+  auto &replicas = op_compiler.op_compiler_infos_[kGraphInfo];
+  ASSERT_EQ(op_compiler.GetCachedCompilerInfo(replicas), nullptr);
+
+  auto first = CreateCompilerInfo(10001);
+  op_compiler.CacheCompilerInfo(first);
+  ASSERT_EQ(op_compiler.GetCachedCompilerInfo(replicas), first);
+  Queue(first->graph_id_);
+  ASSERT_EQ(op_compiler.GetCachedCompilerInfo(replicas), nullptr);
+
+  auto second = CreateCompilerInfo(10002);
+  op_compiler.CacheCompilerInfo(second);
+  ASSERT_EQ(op_compiler.GetCachedCompilerInfo(replicas), second);
+  Queue(second->graph_id_);
+  ASSERT_EQ(op_compiler.GetCachedCompilerInfo(replicas), first);
+
+  auto third = CreateCompilerInfo(10003);
+  op_compiler.CacheCompilerInfo(third);
+  ASSERT_EQ(replicas.size(), 2);
+  ASSERT_EQ(replicas.front(), second);
+  ASSERT_EQ(op_compiler.GetCachedCompilerInfo(replicas), third);
+
+  op_compiler.max_replica_num_ = 1;
+  auto fourth = CreateCompilerInfo(10004);
+  op_compiler.CacheCompilerInfo(fourth);
+  ASSERT_EQ(replicas.size(), 1);
+  ASSERT_EQ(replicas.front(), fourth);
+  Queue(fourth->graph_id_);
+  ASSERT_EQ(op_compiler.GetCachedCompilerInfo(replicas), fourth);
+}
+}  // namespace mindspore::pynative
@@ -0,0 +1,196 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "runtime/pynative/spsc_queue.h"
+#define private public
+#include "runtime/pynative/op_executor.h"
+#undef private
+
+namespace mindspore::runtime {
+namespace {
+constexpr size_t kRunQueueCapacity = 1024;
+
+// The run task calling a function, all the tasks share the same context.
+class FuncOpTask : public OpTask {
+ public:
+  explicit FuncOpTask(const std::function<void()> &func)
+      : OpTask(std::make_shared<OpTaskContext>(0, nullptr, std::vector<session::KernelWithIndex>(), nullptr, nullptr,
+                                               false),
+               kRunTask),
+        func_(func) {}
+  ~FuncOpTask() override = default;
+  void Run() override { func_(); }
+
+ private:
+  std::function<void()> func_;
+};
+
+void PushTask(const std::function<void()> &func) {
+  OpExecutor::GetInstance().PushOpRunTask(std::make_shared<FuncOpTask>(func));
+}
+
+// Push a task blocking the worker until the returned promise is set.
+std::shared_ptr<std::promise<void>> PushBlockingTask() {
+  auto latch = std::make_shared<std::promise<void>>();
+  auto future = latch->get_future().share();
+  PushTask([future]() { future.wait(); });
+  return latch;
+}
+}  // namespace
+
+class TestOpExecutor : public UT::Common {
+ public:
+  TestOpExecutor() = default;
+  virtual ~TestOpExecutor() = default;
+
+  void TearDown() override { OpExecutor::GetInstance().Wait(); }
+};
+
+/// Feature: test the single producer single consumer queue of the run tasks.
+/// Description: fill a small queue, pop it across the wrap around, then pass many items between two threads.
+/// Expectation: the full queue rejects the push, and the items are popped once each in the order pushed.
+TEST_F(TestOpExecutor, SpscQueue) {
+  SpscQueue<int> queue(4);
+  ASSERT_EQ(queue.Capacity(), 4);
+  int item = 0;
+  ASSERT_FALSE(queue.Pop(&item));
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(queue.Push(round * 4 + i));
+    }
+    ASSERT_FALSE(queue.Push(-1));
+    ASSERT_EQ(queue.Size(), 4);
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(queue.Pop(&item));
+      ASSERT_EQ(item, round * 4 + i);
+    }
+    ASSERT_TRUE(queue.Empty());
+  }
+
+  constexpr int kItemNum = 100000;
+  SpscQueue<int> shared_queue(64);
+  std::atomic<int> mismatch_num{0};
+  std::thread consumer([&shared_queue, &mismatch_num]() {
+    for (int expected = 0; expected < kItemNum;) {
+      int value = -1;
+      if (shared_queue.Pop(&value)) {
+        mismatch_num += (value != expected) ? 1 : 0;
+        ++expected;
+      }
+    }
+  });
+  for (int i = 0; i < kItemNum;) {
+    if (shared_queue.Push(int(i))) {
+      ++i;
+    }
+  }
+  consumer.join();
+  ASSERT_EQ(mismatch_num.load(), 0);
+  ASSERT_TRUE(shared_queue.Empty());
+}
+
+/// Feature: test parking and notifying the threads of the op executor.
+/// Description: let several threads wait for a blocked task, then push a task after the worker parks, then fill the
+/// queue while the worker is blocked.
+/// Expectation: every waiter is woken when the tasks finish, the parked worker runs the new task, and the producer
+/// waits for the free slots instead of losing tasks.
+TEST_F(TestOpExecutor, ParkAndNotify) {
+  auto &executor = OpExecutor::GetInstance();
+  auto latch = PushBlockingTask();
+  std::atomic<size_t> woken_num{0};
+  std::vector<std::thread> waiters;
+  for (size_t i = 0; i < 3; ++i) {
+    waiters.emplace_back([&executor, &woken_num]() {
+      executor.WaitForRun();
+      (void)woken_num.fetch_add(1);
+    });
+  }
+  // Wait until all the waiters are parked.
+  while (executor.parked_waiter_num_.load() < waiters.size()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(woken_num.load(), 0);
+  latch->set_value();
+  for (auto &waiter : waiters) {
+    waiter.join();
+  }
+  ASSERT_EQ(woken_num.load(), waiters.size());
+  ASSERT_EQ(executor.parked_waiter_num_.load(), 0);
+
+  while (!executor.worker_parked_.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::atomic<bool> ran{false};
+  PushTask([&ran]() { ran = true; });
+  executor.Wait();
+  ASSERT_TRUE(ran.load());
+
+  // The queue is full while the worker is blocked, so the producer parks until the worker takes the tasks.
+  latch = PushBlockingTask();
+  std::thread releaser([latch]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    latch->set_value();
+  });
+  constexpr size_t kTaskNum = 2 * kRunQueueCapacity;
+  std::atomic<size_t> run_num{0};
+  for (size_t i = 0; i < kTaskNum; ++i) {
+    PushTask([&run_num]() { (void)run_num.fetch_add(1); });
+  }
+  executor.Wait();
+  releaser.join();
+  ASSERT_EQ(run_num.load(), kTaskNum);
+  ASSERT_GE(executor.max_run_queue_depth(), kRunQueueCapacity);
+}
+
+/// Feature: test dropping the run tasks of the former epochs.
+/// Description: queue tasks behind a blocked task and clear the queue, then queue tasks behind a failed task.
+/// Expectation: the cleared tasks and the tasks behind the failure are dropped but still finished, the failure is
+/// raised by Wait, and the tasks pushed afterwards run.
+TEST_F(TestOpExecutor, DropFormerEpoch) {
+  auto &executor = OpExecutor::GetInstance();
+  std::atomic<size_t> run_num{0};
+  auto count = [&run_num]() { (void)run_num.fetch_add(1); };
+  auto latch = PushBlockingTask();
+  PushTask(count);
+  PushTask(count);
+  executor.ClearRunOpTasks();
+  PushTask(count);
+  latch->set_value();
+  executor.Wait();
+  ASSERT_EQ(run_num.load(), 1);
+  ASSERT_TRUE(executor.RunQueueEmpty());
+  ASSERT_FALSE(executor.ActorInQueue(0));
+
+  latch = PushBlockingTask();
+  PushTask([]() { MS_LOG(EXCEPTION) << "The task failed."; });
+  PushTask(count);
+  latch->set_value();
+  ASSERT_ANY_THROW(executor.Wait());
+  ASSERT_EQ(run_num.load(), 1);
+  ASSERT_TRUE(executor.RunQueueEmpty());
+
+  PushTask(count);
+  executor.Wait();
+  ASSERT_EQ(run_num.load(), 2);
+}
+}  // namespace mindspore::runtime
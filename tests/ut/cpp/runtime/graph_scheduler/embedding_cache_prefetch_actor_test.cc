@@ -0,0 +1,233 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "runtime/hardware/device_context.h"
+#define private public
+#include "runtime/graph_scheduler/actor/embedding_cache/embedding_cache_prefetch_actor.h"
+#undef private
+
+namespace mindspore {
+namespace runtime {
+namespace {
+constexpr size_t kBatchIdsNum = 8;
+constexpr size_t kCacheVocabSize = 16;
+constexpr size_t kEmbeddingSize = 4;
+constexpr size_t kWaitTimeoutMs = 50;
+constexpr size_t kLongWaitTimeoutMs = 30000;
+
+class PrefetchDeviceResManager : public device::DeviceResManager {
+ public:
+  PrefetchDeviceResManager() = default;
+  ~PrefetchDeviceResManager() override = default;
+
+  void *AllocateMemory(size_t) const override { return nullptr; }
+  void FreeMemory(void *const) const override {}
+  device::DeviceAddressPtr CreateDeviceAddress(void *const, size_t, const std::string &, TypeId,
+                                               const ShapeVector &) const override {
+    return nullptr;
+  }
+  bool BindDeviceToCurrentThread() const override {
+    ++bind_num_;
+    return true;
+  }
+
+  mutable std::atomic<size_t> bind_num_{0};
+};
+
+class PrefetchKernelExecutor : public device::KernelExecutor {
+ public:
+  PrefetchKernelExecutor() = default;
+  ~PrefetchKernelExecutor() override = default;
+};
+
+class PrefetchDeviceContext : public device::DeviceInterface<PrefetchKernelExecutor, PrefetchDeviceResManager> {
+ public:
+  explicit PrefetchDeviceContext(const device::DeviceContextKey &device_context_key)
+      : DeviceInterface(device_context_key) {}
+  ~PrefetchDeviceContext() override = default;
+
+  void Initialize() override {}
+  device::RunMode GetRunMode(const FuncGraphPtr &) const override { return device::RunMode::kKernelMode; }
+};
+
+// Run func in another thread and report whether it returns within the timeout.
+class AsyncCall {
+ public:
+  explicit AsyncCall(const std::function<bool()> &func)
+      : thread_([this, func]() {
+          result_ = func();
+          done_ = true;
+        }) {}
+  ~AsyncCall() {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  bool WaitDone(size_t timeout_ms) const {
+    auto start = std::chrono::steady_clock::now();
+    while (!done_) {
+      if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeout_ms)) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+  bool result() const { return result_; }
+
+ private:
+  std::atomic_bool done_{false};
+  std::atomic_bool result_{false};
+  std::thread thread_;
+};
+}  // namespace
+
+class EmbeddingCachePrefetchActorTest : public UT::Common {
+ public:
+  EmbeddingCachePrefetchActorTest() = default;
+  ~EmbeddingCachePrefetchActorTest() override = default;
+
+  void SetUp() override {
+    device_context_ = std::make_shared<PrefetchDeviceContext>(device::DeviceContextKey{"CPU", 0});
+    actor_ = std::make_shared<EmbeddingCachePrefetchActor>(device_context_.get());
+    actor_->embedding_device_cache_ = std::make_shared<EmbeddingDeviceCache>(kBatchIdsNum, kCacheVocabSize);
+    actor_->embedding_host_cache_ = std::make_shared<EmbeddingHostCache>(kBatchIdsNum, kCacheVocabSize);
+    actor_->local_host_cache_size_ = kCacheVocabSize;
+    actor_->running_ = true;
+  }
+  void TearDown() override {
+    {
+      std::lock_guard<std::mutex> locker(actor_->update_mutex_);
+      actor_->running_ = false;
+    }
+    actor_->update_cond_.notify_all();
+  }
+
+ protected:
+  std::shared_ptr<PrefetchDeviceContext> device_context_;
+  std::shared_ptr<EmbeddingCachePrefetchActor> actor_;
+};
+
+/// Feature: test the swap buffers between the cache miss analysis and the cache update of the embedding cache.
+/// Description: commit the swap information of more batches than the prefetch depth, update the caches one by one,
+/// wait for the cache update of a graph step, then stop the actor while a commit waits.
+/// Expectation: a commit waits for a free swap buffer, the buffers are reused in order, the graph waits until its
+/// step is updated, and the waiting commit fails once the actor stops.
+TEST_F(EmbeddingCachePrefetchActorTest, SwapBufferPipeline) {
+  constexpr size_t kPrefetchDepth = 2;
+  actor_->prefetch_depth_ = kPrefetchDepth;
+  actor_->swap_buffers_.resize(kPrefetchDepth);
+  auto commit = [this](size_t data_step) {
+    actor_->data_step_ = data_step;
+    return actor_->CommitCacheSwapInfo();
+  };
+  ASSERT_TRUE(commit(1));
+  ASSERT_TRUE(commit(2));
+  ASSERT_EQ(actor_->committed_step_, kPrefetchDepth);
+
+  // All the swap buffers are used, so the third batch waits for the cache update of the first one.
+  {
+    AsyncCall third_commit([&commit]() { return commit(3); });
+    ASSERT_FALSE(third_commit.WaitDone(kWaitTimeoutMs));
+    ASSERT_TRUE(actor_->UpdateOldestCache());
+    ASSERT_TRUE(third_commit.WaitDone(kLongWaitTimeoutMs));
+    ASSERT_TRUE(third_commit.result());
+  }
+  ASSERT_EQ(actor_->committed_step_, 3);
+  ASSERT_EQ(actor_->updated_step_, 1);
+  ASSERT_EQ(actor_->swap_buffers_[0].data_step_, 3);
+  ASSERT_EQ(actor_->swap_buffers_[1].data_step_, 2);
+
+  // The graph of step 2 waits until the cache update of the second batch finishes.
+  actor_->graph_step_ = 2;
+  {
+    AsyncCall wait_update([this]() {
+      actor_->WaitCacheUpdate();
+      return true;
+    });
+    ASSERT_FALSE(wait_update.WaitDone(kWaitTimeoutMs));
+    ASSERT_TRUE(actor_->UpdateOldestCache());
+    ASSERT_TRUE(wait_update.WaitDone(kLongWaitTimeoutMs));
+  }
+  ASSERT_EQ(actor_->updated_step_, 2);
+
+  // Stopping the actor releases the commit waiting for a free swap buffer.
+  ASSERT_TRUE(commit(4));
+  {
+    AsyncCall fifth_commit([&commit]() { return commit(5); });
+    ASSERT_FALSE(fifth_commit.WaitDone(kWaitTimeoutMs));
+    {
+      std::lock_guard<std::mutex> locker(actor_->update_mutex_);
+      actor_->running_ = false;
+    }
+    actor_->update_cond_.notify_all();
+    ASSERT_TRUE(fifth_commit.WaitDone(kLongWaitTimeoutMs));
+    ASSERT_FALSE(fifth_commit.result());
+  }
+  ASSERT_EQ(actor_->committed_step_, 4);
+}
+
+/// Feature: test the cache update of the embedding cache, whose remote pulling and device swapping run on the common
+/// thread pool.
+/// Description: update the local host cache of two tables with the new ids of a batch, repeat it for several steps.
+/// Expectation: the rows of the new ids are initialized in every table, the other rows are untouched, and the
+/// thread swapping the device cache is bound to the device in every update.
+TEST_F(EmbeddingCachePrefetchActorTest, UpdateCacheOnThreadPool) {
+  constexpr size_t kStepNum = 3;
+  std::vector<float> init_values = {0.5, -2};
+  for (size_t i = 0; i < init_values.size(); ++i) {
+    HashTableInfo hash_info;
+    hash_info.cache_vocab_size = kCacheVocabSize;
+    hash_info.host_cache_vocab_size = kCacheVocabSize;
+    hash_info.embedding_size = kEmbeddingSize;
+    hash_info.host_address =
+      std::shared_ptr<float>(new float[kCacheVocabSize * kEmbeddingSize](), std::default_delete<float[]>());
+    hash_info.param_init_info_.param_type_ = distributed::kAccumulation;
+    hash_info.param_init_info_.init_val_ = init_values[i];
+    actor_->hash_tables_["table_" + std::to_string(i)] = hash_info;
+  }
+
+  CacheSwapInfo swap_info;
+  swap_info.new_id_index_ = {1, 3, 6};
+  swap_info.statistics_info_.new_id_size_ = swap_info.new_id_index_.size();
+  for (size_t step = 0; step < kStepNum; ++step) {
+    swap_info.data_step_ = step;
+    ASSERT_TRUE(actor_->UpdateCache(swap_info));
+  }
+  auto res_manager = static_cast<PrefetchDeviceResManager *>(device_context_->device_res_manager_.get());
+  ASSERT_EQ(res_manager->bind_num_.load(), kStepNum * init_values.size());
+
+  for (size_t i = 0; i < init_values.size(); ++i) {
+    const auto *table = actor_->hash_tables_["table_" + std::to_string(i)].host_address.get();
+    for (size_t row = 0; row < kCacheVocabSize; ++row) {
+      bool is_new_id = row == 1 || row == 3 || row == 6;
+      for (size_t col = 0; col < kEmbeddingSize; ++col) {
+        ASSERT_EQ(table[row * kEmbeddingSize + col], is_new_id ? init_values[i] : 0) << "row " << row;
+      }
+    }
+  }
+}
+}  // namespace runtime
+}  // namespace mindspore
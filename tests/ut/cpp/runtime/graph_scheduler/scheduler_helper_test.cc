@@ -158,5 +158,43 @@ TEST_F(SchedulerHelperTest, AddMemoryFreeSign) {
   ASSERT_NE(from_actor->memory_free_insert_position(), nullptr);
   ASSERT_EQ(from_actor->memory_free_insert_position(), to_actor.get());
 }
+
+/// Feature: Linearized execution of kernel actors.
+/// Description: Test the common interface of BuildLinearizedActor.
+/// Expectation: The kernel actors are scheduled in the topological order and the internal arrow is not sent.
+TEST_F(SchedulerHelperTest, BuildLinearizedActor) {
+  auto memory_manager_actor = std::make_shared<MemoryManagerActor>();
+  MS_EXCEPTION_IF_NULL(memory_manager_actor);
+  auto kernel_graph = std::make_shared<KernelGraph>();
+  MS_EXCEPTION_IF_NULL(kernel_graph);
+  std::vector<AnfNodePtr> inputs{NewValueNode(prim::kPrimLess)};
+  auto backend_node1 = kernel_graph->NewCNode(inputs);
+  MS_EXCEPTION_IF_NULL(backend_node1);
+  auto backend_node2 = kernel_graph->NewCNode(inputs);
+  MS_EXCEPTION_IF_NULL(backend_node2);
+  std::set<size_t> ref_input_indexes;
+  std::set<size_t> ref_output_indexes;
+
+  auto from_actor =
+    std::make_shared<KernelActor>("from_actor", backend_node1, nullptr, memory_manager_actor->GetAID(), nullptr,
+                                  nullptr, GraphExecutionStrategy::kPipeline, ref_input_indexes, ref_output_indexes);
+  auto to_actor =
+    std::make_shared<KernelActor>("to_actor", backend_node2, nullptr, memory_manager_actor->GetAID(), nullptr, nullptr,
+                                  GraphExecutionStrategy::kPipeline, ref_input_indexes, ref_output_indexes);
+  SchedulerHelper::AddDataArrow(from_actor.get(), to_actor.get(), 0, 0);
+
+  // The execution order is reversed to the data dependency.
+  auto linearized_actor = SchedulerHelper::BuildLinearizedActor({to_actor, from_actor});
+  ASSERT_NE(linearized_actor, nullptr);
+  ASSERT_EQ(2, linearized_actor->launch_schedule().size());
+  ASSERT_EQ(from_actor.get(), linearized_actor->launch_schedule()[0]);
+  ASSERT_EQ(to_actor.get(), linearized_actor->launch_schedule()[1]);
+  ASSERT_EQ(0, linearized_actor->input_data_arrow_aids().size());
+  ASSERT_EQ(1, from_actor->output_data_arrows().size());
+  ASSERT_TRUE(TEST_FLAG(from_actor->output_data_arrows()[0]->flag_, kOutputDataFlagLinearized));
+
+  // The kernel actors in the linearized actor can't be linearized again.
+  ASSERT_EQ(SchedulerHelper::BuildLinearizedActor({from_actor, to_actor}), nullptr);
+}
 }  // namespace runtime
 }  // namespace mindspore
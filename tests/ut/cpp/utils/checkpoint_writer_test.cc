@@ -0,0 +1,228 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "common/common_test.h"
+#include "include/common/utils/checkpoint/checkpoint_writer.h"
+
+namespace mindspore {
+namespace checkpoint {
+class TestCheckpointWriter : public UT::Common {
+ public:
+  TestCheckpointWriter() = default;
+  virtual ~TestCheckpointWriter() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/checkpoint_writer_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    directory_ = dir_template;
+  }
+  void TearDown() override { (void)system(("rm -rf " + directory_).c_str()); }
+
+ protected:
+  tensor::TensorPtr MakeTensor(const ShapeVector &shape, float start) {
+    auto tensor = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, shape);
+    auto data = static_cast<float *>(tensor->data_c());
+    for (size_t i = 0; i < tensor->DataSize(); ++i) {
+      data[i] = start + i;
+    }
+    return tensor;
+  }
+
+  // Read all the tensors of a checkpoint through its manifest.
+  std::map<std::string, std::vector<float>> LoadCheckpoint(const std::string &prefix) {
+    std::ifstream manifest_file(directory_ + "/" + prefix + kManifestSuffix);
+    auto manifest = nlohmann::json::parse(manifest_file);
+    std::map<std::string, std::vector<float>> result;
+    for (const auto &item : manifest.at("tensors")) {
+      std::string file_name = directory_ + "/" + item.at("file").get<std::string>();
+      std::vector<TensorFileEntry> entries;
+      EXPECT_TRUE(ReadTensorFileIndex(file_name, &entries));
+      std::ifstream ifs(file_name, std::ios::binary);
+      for (const auto &entry : entries) {
+        if (entry.name != item.at("name").get<std::string>()) {
+          continue;
+        }
+        std::vector<float> values(entry.nbytes / sizeof(float));
+        ifs.seekg(static_cast<std::streamoff>(entry.offset));
+        ifs.read(reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(entry.nbytes));
+        EXPECT_EQ(entry.hash, TensorFileHash(values.data(), entry.nbytes));
+        result[entry.name] = values;
+      }
+    }
+    return result;
+  }
+
+  std::string directory_;
+};
+
+/// Feature: test encoding and decoding the index of tensor file.
+/// Description: encode the entries of some tensors and decode them, then decode a truncated index.
+/// Expectation: the decoded entries equal the encoded ones, and the truncated index is rejected.
+TEST_F(TestCheckpointWriter, TensorFileIndex) {
+  std::vector<TensorFileEntry> entries(2);
+  entries[0] = {"conv.weight", kNumberTypeFloat16, {64, 3, 7, 7}, kTensorFileAlignment, 18816, 1};
+  entries[1] = {"scalar", kNumberTypeInt32, {}, 2 * kTensorFileAlignment, 4, 2};
+  auto index = EncodeTensorFileIndex(entries);
+  std::vector<TensorFileEntry> decoded;
+  ASSERT_TRUE(DecodeTensorFileIndex(index.data(), index.size(), 2, &decoded));
+  ASSERT_EQ(2, decoded.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    ASSERT_EQ(entries[i].name, decoded[i].name);
+    ASSERT_EQ(entries[i].type, decoded[i].type);
+    ASSERT_EQ(entries[i].shape, decoded[i].shape);
+    ASSERT_EQ(entries[i].offset, decoded[i].offset);
+    ASSERT_EQ(entries[i].nbytes, decoded[i].nbytes);
+    ASSERT_EQ(entries[i].hash, decoded[i].hash);
+  }
+  ASSERT_FALSE(DecodeTensorFileIndex(index.data(), index.size() - 1, 2, &decoded));
+  ASSERT_NE(TensorFileHash("abcdefgh", 8), TensorFileHash("abcdefgi", 8));
+}
+
+/// Feature: test saving checkpoints with the checkpoint writer.
+/// Description: save a full checkpoint, change one tensor and save an incremental checkpoint.
+/// Expectation: both checkpoints can be read back, and the incremental one only writes the changed tensor.
+TEST_F(TestCheckpointWriter, IncrementalSave) {
+  std::vector<std::string> names = {"weight", "bias", "empty", "moment"};
+  std::vector<tensor::TensorPtr> tensors = {MakeTensor({256, 33}, 0), MakeTensor({33}, 1), MakeTensor({0}, 0),
+                                            MakeTensor({1000, 3}, 2)};
+  CheckpointWriter writer(directory_, 2);
+  writer.Save("step_1", names, tensors, true);
+  // The snapshot has been taken, so the change after saving does not affect the checkpoint.
+  static_cast<float *>(tensors[1]->data_c())[0] = -1;
+  ASSERT_TRUE(writer.Wait());
+
+  auto step_1 = LoadCheckpoint("step_1");
+  ASSERT_EQ(4, step_1.size());
+  ASSERT_EQ(1, step_1["bias"][0]);
+  ASSERT_EQ(256 * 33 - 1, step_1["weight"].back());
+  ASSERT_TRUE(step_1["empty"].empty());
+
+  writer.Save("step_2", names, tensors, true);
+  ASSERT_TRUE(writer.Wait());
+  auto step_2 = LoadCheckpoint("step_2");
+  ASSERT_EQ(4, step_2.size());
+  ASSERT_EQ(-1, step_2["bias"][0]);
+  ASSERT_EQ(step_1["weight"], step_2["weight"]);
+  ASSERT_EQ(step_1["moment"], step_2["moment"]);
+
+  // Only the changed tensor is written by the incremental save.
+  std::vector<TensorFileEntry> entries;
+  ASSERT_TRUE(ReadTensorFileIndex(directory_ + "/step_2_1_0" + kTensorFileSuffix, &entries));
+  ASSERT_EQ(1, entries.size());
+  ASSERT_EQ("bias", entries[0].name);
+  ASSERT_NE(0, access((directory_ + "/step_2_1_1" + kTensorFileSuffix).c_str(), F_OK));
+}
+
+/// Feature: test saving checkpoints with a reused prefix.
+/// Description: save a checkpoint, save an incremental one, then save both prefixes again with changed tensors, and
+/// save with another writer in the same directory.
+/// Expectation: every manifest refers to the data of its own save, the earlier files are never overwritten.
+TEST_F(TestCheckpointWriter, ReusedPrefix) {
+  std::vector<std::string> names = {"weight", "bias"};
+  std::vector<tensor::TensorPtr> tensors = {MakeTensor({64, 33}, 0), MakeTensor({33}, 1)};
+  CheckpointWriter writer(directory_, 1);
+  writer.Save("last", names, tensors, true);
+  ASSERT_TRUE(writer.Wait());
+  writer.Save("best", names, tensors, true);
+  ASSERT_TRUE(writer.Wait());
+  auto best = LoadCheckpoint("best");
+
+  // "best" refers to the files of "last" for both tensors, saving "last" again must keep them.
+  static_cast<float *>(tensors[1]->data_c())[0] = -1;
+  writer.Save("last", names, tensors, true);
+  ASSERT_TRUE(writer.Wait());
+  ASSERT_EQ(best, LoadCheckpoint("best"));
+  auto last = LoadCheckpoint("last");
+  ASSERT_EQ(-1, last["bias"][0]);
+  ASSERT_EQ(best["weight"], last["weight"]);
+
+  // A new writer knows nothing about the saved files, and must not overwrite them either.
+  static_cast<float *>(tensors[0]->data_c())[0] = -2;
+  CheckpointWriter new_writer(directory_, 1);
+  new_writer.Save("last", names, tensors, true);
+  ASSERT_TRUE(new_writer.Wait());
+  ASSERT_EQ(best, LoadCheckpoint("best"));
+  ASSERT_EQ(-2, LoadCheckpoint("last")["weight"][0]);
+}
+
+/// Feature: test the failure of the background writing.
+/// Description: save a tensor whose name is not valid UTF-8, so the manifest can not be dumped.
+/// Expectation: the failure is reported by Wait instead of terminating the process, and no manifest is left.
+TEST_F(TestCheckpointWriter, InvalidName) {
+  CheckpointWriter writer(directory_, 1);
+  writer.Save("invalid", {"weight\xff"}, {MakeTensor({4}, 0)}, false);
+  ASSERT_FALSE(writer.Wait());
+  ASSERT_NE(0, access((directory_ + "/invalid" + kManifestSuffix).c_str(), F_OK));
+  ASSERT_NE(0, access((directory_ + "/invalid" + kManifestSuffix + ".tmp").c_str(), F_OK));
+
+  writer.Save("valid", {"weight"}, {MakeTensor({4}, 0)}, false);
+  ASSERT_TRUE(writer.Wait());
+  ASSERT_EQ(1, LoadCheckpoint("valid").size());
+}
+
+/// Feature: test loading tensor files by mapping them.
+/// Description: load the tensor files of a checkpoint with verification, write a loaded tensor, then corrupt the file.
+/// Expectation: the loaded tensors equal the saved ones, writing a tensor does not change the file, and the corrupted
+/// file fails the verification.
+TEST_F(TestCheckpointWriter, LoadTensorFile) {
+  std::vector<std::string> names = {"weight", "bias", "moment"};
+  std::vector<tensor::TensorPtr> tensors = {MakeTensor({256, 33}, 0), MakeTensor({33}, 1), MakeTensor({1000, 3}, 2)};
+  CheckpointWriter writer(directory_, 2);
+  writer.Save("step_1", names, tensors, false);
+  ASSERT_TRUE(writer.Wait());
+
+  std::map<std::string, tensor::TensorPtr> loaded;
+  for (const auto &shard : {"/step_1_0_0", "/step_1_0_1"}) {
+    std::vector<std::pair<std::string, tensor::TensorPtr>> shard_tensors;
+    ASSERT_TRUE(LoadTensorFile(directory_ + shard + kTensorFileSuffix, true, &shard_tensors));
+    loaded.insert(shard_tensors.begin(), shard_tensors.end());
+  }
+  ASSERT_EQ(3, loaded.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto &tensor = loaded[names[i]];
+    ASSERT_EQ(tensors[i]->shape(), tensor->shape());
+    ASSERT_EQ(0, memcmp(tensors[i]->data_c(), tensor->data_c(), tensors[i]->Size()));
+  }
+
+  std::string file_name = directory_ + "/step_1_0_0" + kTensorFileSuffix;
+  std::vector<std::pair<std::string, tensor::TensorPtr>> shard_tensors;
+  ASSERT_TRUE(LoadTensorFile(file_name, false, &shard_tensors));
+  static_cast<float *>(shard_tensors[0].second->data_c())[0] = -1;
+  shard_tensors.clear();
+  ASSERT_TRUE(LoadTensorFile(file_name, true, &shard_tensors));
+  ASSERT_NE(-1, static_cast<float *>(shard_tensors[0].second->data_c())[0]);
+
+  std::vector<TensorFileEntry> entries;
+  ASSERT_TRUE(ReadTensorFileIndex(file_name, &entries));
+  std::fstream file(file_name, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(static_cast<std::streamoff>(entries[0].offset));
+  file.put('x');
+  file.close();
+  ASSERT_FALSE(LoadTensorFile(file_name, true, &shard_tensors));
+  ASSERT_TRUE(LoadTensorFile(file_name, false, &shard_tensors));
+}
+}  // namespace checkpoint
+}  // namespace mindspore
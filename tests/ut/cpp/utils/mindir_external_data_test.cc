@@ -0,0 +1,107 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "load_mindir/anf_model_parser.h"
+
+namespace mindspore {
+class TestMindIRExternalData : public UT::Common {
+ public:
+  TestMindIRExternalData() = default;
+  virtual ~TestMindIRExternalData() = default;
+
+  void SetUp() override {
+    char dir_template[] = "/tmp/mindir_external_data_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    directory_ = dir_template;
+  }
+  void TearDown() override {
+    MSANFModelParser::LoadTensorMapClear();
+    (void)system(("rm -rf " + directory_).c_str());
+  }
+
+ protected:
+  // Write the external data file, whose first byte is the byte order, and a model returning the parameter in it.
+  mind_ir::ModelProto MakeModel(const std::string &param_name, const std::vector<float> &data) {
+    constexpr int64_t kDataOffset = 64;
+    std::vector<char> content(kDataOffset + data.size() * sizeof(float), 0);
+    content[0] = 1;
+    (void)memcpy(content.data() + kDataOffset, data.data(), data.size() * sizeof(float));
+    std::ofstream file(directory_ + "/" + kDataFileName, std::ios::binary);
+    (void)file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    file.close();
+
+    mind_ir::ModelProto model;
+    model.set_producer_name("MindSpore");
+    model.set_model_version("1.0");
+    model.set_little_endian(true);
+    auto graph = model.mutable_graph();
+    graph->set_name("external_data_graph");
+    auto param = graph->add_parameter();
+    param->set_name(param_name);
+    param->set_data_type(mind_ir::TensorProto_DataType_FLOAT);
+    param->add_dims(static_cast<int64_t>(data.size()));
+    auto external_data = param->mutable_external_data();
+    external_data->set_location(kDataFileName);
+    external_data->set_offset(kDataOffset);
+    external_data->set_length(static_cast<int64_t>(data.size() * sizeof(float)));
+    graph->add_output()->set_name(param_name);
+    return model;
+  }
+
+  std::vector<float> GetParameterData(const FuncGraphPtr &graph) {
+    EXPECT_NE(graph, nullptr);
+    EXPECT_EQ(graph->parameters().size(), 1);
+    auto param = graph->parameters()[0]->cast<ParameterPtr>();
+    EXPECT_NE(param, nullptr);
+    auto tensor = param->default_param()->cast<tensor::TensorPtr>();
+    EXPECT_NE(tensor, nullptr);
+    auto data = static_cast<const float *>(tensor->data_c());
+    return std::vector<float>(data, data + tensor->DataSize());
+  }
+
+  const std::string kDataFileName = "external_data_graph.data";
+  std::string directory_;
+};
+
+/// Feature: Load the external data of MindIR.
+/// Description: Parse a MindIR whose parameter is in an external data file, then parse it again incrementally.
+/// Expectation: Both graphs get the data of the file, the second one through the tensor of the first load.
+TEST_F(TestMindIRExternalData, test_load_external_data) {
+  std::vector<float> data = {1.0f, 2.5f, -3.0f, 4.25f, 5.0f, -6.5f};
+  auto model = MakeModel("test_load_external_data.weight", data);
+
+  MSANFModelParser parser;
+  parser.SetMindIRPath(directory_);
+  parser.SetIncLoad();
+  auto graph = parser.Parse(model, {});
+  ASSERT_NE(graph, nullptr);
+  ASSERT_EQ(GetParameterData(graph), data);
+
+  MSANFModelParser inc_parser;
+  inc_parser.SetMindIRPath(directory_);
+  inc_parser.SetIncLoad();
+  auto inc_graph = inc_parser.Parse(model, {});
+  ASSERT_NE(inc_graph, nullptr);
+  ASSERT_EQ(GetParameterData(inc_graph), data);
+}
+}  // namespace mindspore
@@ -20,6 +20,7 @@ from mindspore import Tensor
 from mindspore.common import dtype
 from mindspore.common.api import _cell_graph_executor
 from mindspore.nn import Embedding, MultiFieldEmbeddingLookup
+from mindspore.nn.layer.embedding import _convert_pserver_embedding_tables
 from ..ut_filter import non_graph_engine
 
 
@@ -97,3 +98,23 @@ def test_check_multifield_embedding_false_value_shape():
 def test_print_embedding():
     net = Embedding(20000, 768, False)
     print(net)
+
+
+def test_convert_pserver_embedding_tables():
+    """
+    Feature: convert the embedding table slices of Parameter Servers between sharding policies.
+    Description: slice a table of 10 rows over 3 servers by range, convert the slices to hash and back.
+    Expectation: server i holds the rows i, i + 3, ... under hash, and the range slices are restored.
+    """
+    full_table = np.arange(20, dtype=np.float32).reshape(10, 2)
+    range_tables = [full_table[0:4], full_table[4:7], full_table[7:10]]
+    hash_tables = _convert_pserver_embedding_tables(range_tables, "range", "hash")
+    for i, table in enumerate(hash_tables):
+        assert np.array_equal(table, full_table[i::3])
+    restored_tables = _convert_pserver_embedding_tables(hash_tables, "hash", "range")
+    for restored, origin in zip(restored_tables, range_tables):
+        assert np.array_equal(restored, origin)
+    with pytest.raises(ValueError):
+        _convert_pserver_embedding_tables(range_tables, "range", "mod")
+    with pytest.raises(ValueError):
+        _convert_pserver_embedding_tables(range_tables[::-1], "hash", "range")
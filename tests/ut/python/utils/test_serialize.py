@@ -16,6 +16,7 @@
 import os
 import platform
 import stat
+import tempfile
 import time
 import secrets
 
@@ -34,7 +35,7 @@ from mindspore.nn.optim.momentum import Momentum
 from mindspore.ops import operations as P
 from mindspore.train.callback import ModelCheckpoint, CheckpointConfig, LossMonitor, _CheckpointManager
 from mindspore.train.serialization import save_checkpoint, load_checkpoint, load_param_into_net, \
-     export, _save_graph, load
+     export, _save_graph, load, _FlatCheckpointWriter, _load_flat_checkpoint
 from tests.security_utils import security_off_wrap
 from ..ut_filter import non_graph_engine
 
@@ -424,6 +425,38 @@ def test_save_checkpoint_for_network():
     load_checkpoint("new_ckpt.ckpt")
 
 
+def test_flat_checkpoint_writer():
+    """
+    Feature: save parameters with the flat checkpoint writer.
+    Description: save a checkpoint, change one parameter, then save an incremental one with a reused prefix.
+    Expectation: every checkpoint loads the parameters of its own save, and a failed save is reported by wait.
+    """
+    weight = Parameter(Tensor(np.arange(64 * 33).reshape(64, 33).astype(np.float32)), name="fc.weight")
+    bias = Parameter(Tensor(np.ones(33).astype(np.float32)), name="fc.bias")
+    with tempfile.TemporaryDirectory() as directory:
+        writer = _FlatCheckpointWriter(directory, shard_num=2)
+        writer.save([weight, bias], "best")
+        assert writer.wait()
+        bias.set_data(Tensor(np.zeros(33).astype(np.float32)))
+        writer.save([weight, bias], "last")
+        assert writer.wait()
+        writer.save([weight, bias], "best", incremental=True)
+        assert writer.wait()
+
+        for prefix in ["best", "last"]:
+            params = _load_flat_checkpoint(os.path.join(directory, prefix + ".manifest"), verify=True)
+            assert list(params.keys()) == ["fc.weight", "fc.bias"]
+            assert np.array_equal(params["fc.weight"].asnumpy(), weight.asnumpy())
+            assert np.array_equal(params["fc.bias"].asnumpy(), bias.asnumpy())
+
+
+    with tempfile.TemporaryDirectory() as directory:
+        writer = _FlatCheckpointWriter(os.path.join(directory, "removed"))
+        os.rmdir(os.path.join(directory, "removed"))
+        writer.save([weight, bias], "failed")
+        assert not writer.wait()
+
+
 def test_load_checkpoint_empty_file():
     context.set_context(mode=context.GRAPH_MODE)
     os.mknod("empty.ckpt")